@@ -0,0 +1,103 @@
+#include "alloc_track.h"
+
+#ifndef NO_ALLOC_TRACKING
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace alloc {
+
+namespace {
+
+// Plain data with constant initialisation: usable from the very first
+// allocation, before any constructor has run, on any thread.
+static thread_local Counts t_counts = {};
+static thread_local int t_allow = 0; // AllowScope nesting
+static std::atomic<unsigned long> g_allocs{0}, g_bytes{0}, g_frees{0}, g_allowed{0};
+static Counts g_last_total = {}, g_frame = {}; // GL thread
+
+// Plain malloc / free underneath: a block some library allocates past these
+// hooks and frees through them (or the other way round) is still freed fine.
+static void* allocate(std::size_t size) {
+	void* p = std::malloc(size ? size : 1);
+	if (!p) return nullptr;
+	t_counts.allocs++;
+	t_counts.bytes += size;
+	g_allocs.fetch_add(1, std::memory_order_relaxed);
+	g_bytes.fetch_add(size, std::memory_order_relaxed);
+	if (t_allow) {
+		t_counts.allowed++;
+		g_allowed.fetch_add(1, std::memory_order_relaxed);
+	}
+	return p;
+}
+
+static void release(void* p) {
+	if (!p) return;
+	t_counts.frees++;
+	g_frees.fetch_add(1, std::memory_order_relaxed);
+	std::free(p);
+}
+
+} // namespace
+
+Counts thread_counts() { return t_counts; }
+
+Counts frame_counts() { return g_frame; }
+
+void end_frame() {
+	Counts total = {g_allocs.load(std::memory_order_relaxed), g_bytes.load(std::memory_order_relaxed),
+	                g_frees.load(std::memory_order_relaxed), g_allowed.load(std::memory_order_relaxed)};
+	g_frame.allocs = total.allocs - g_last_total.allocs;
+	g_frame.bytes = total.bytes - g_last_total.bytes;
+	g_frame.frees = total.frees - g_last_total.frees;
+	g_frame.allowed = total.allowed - g_last_total.allowed;
+	g_last_total = total;
+}
+
+AllowScope::AllowScope() { t_allow++; }
+
+AllowScope::~AllowScope() { t_allow--; }
+
+} // namespace alloc
+
+void* operator new(std::size_t size) {
+	void* p = alloc::allocate(size);
+	if (!p) throw std::bad_alloc();
+	return p;
+}
+
+void* operator new[](std::size_t size) { return operator new(size); }
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept { return alloc::allocate(size); }
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept { return alloc::allocate(size); }
+
+void operator delete(void* p) noexcept { alloc::release(p); }
+
+void operator delete[](void* p) noexcept { alloc::release(p); }
+
+void operator delete(void* p, const std::nothrow_t&) noexcept { alloc::release(p); }
+
+void operator delete[](void* p, const std::nothrow_t&) noexcept { alloc::release(p); }
+
+// Sized: C++14 code calls these, and libraries built for it call them from
+// a C++11 program too.
+void operator delete(void* p, std::size_t) noexcept { alloc::release(p); }
+
+void operator delete[](void* p, std::size_t) noexcept { alloc::release(p); }
+
+#else
+
+namespace alloc {
+
+Counts thread_counts() { return Counts(); }
+Counts frame_counts() { return Counts(); }
+void end_frame() {}
+AllowScope::AllowScope() {}
+AllowScope::~AllowScope() {}
+
+} // namespace alloc
+
+#endif
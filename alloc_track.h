@@ -0,0 +1,82 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+namespace alloc {
+
+// ALLOCATION TRACKING
+// The global operator new / delete are replaced to count heap allocations,
+// per thread and for the whole process. Profiler scopes take differences of
+// the thread counts, so each scope in the F3 table and the --profile CSV
+// shows what it allocated; end_frame() turns the process totals into
+// per-frame numbers. Built with -DNO_ALLOC_TRACKING (the Release target is)
+// the hooks aren't compiled and everything reads zero.
+
+struct Counts {
+	unsigned long allocs;  // operator new calls
+	unsigned long bytes;   // Bytes they asked for
+	unsigned long frees;
+	unsigned long allowed; // Of 'allocs', made inside an AllowScope
+
+	void add(const Counts& other) {
+		allocs += other.allocs;
+		bytes += other.bytes;
+		frees += other.frees;
+		allowed += other.allowed;
+	}
+};
+
+#ifndef NO_ALLOC_TRACKING
+const bool TRACKING_ENABLED = true;
+#else
+const bool TRACKING_ENABLED = false;
+#endif
+
+// Everything the calling thread has allocated so far; never reset, so
+// callers take differences (see prof::CpuScope).
+Counts thread_counts();
+
+// All threads, between the last two end_frame() calls.
+Counts frame_counts();
+
+// GL thread, once per frame drawn.
+void end_frame();
+
+// The allocations --assert-no-alloc lets through after the warm-up: those
+// the calling thread makes while one of these is alive. They still count,
+// and also as Counts::allowed. Only for growth that stops on its own: a
+// buffer kept across frames growing to the largest frame seen so far (see
+// push_kept()), or a driver compiling a variant for state it hasn't seen.
+class AllowScope {
+public:
+	AllowScope();
+	~AllowScope();
+
+private:
+	AllowScope(const AllowScope&);
+	AllowScope& operator=(const AllowScope&);
+};
+
+// push_back() and reserve() for vectors kept across frames, which allow the
+// growth (and only that) when the vector is full. Both grow geometrically,
+// as push_back() does.
+template <typename T>
+void push_kept(std::vector<T>& v, const T& value) {
+	if (v.size() == v.capacity()) {
+		AllowScope grow;
+		v.push_back(value);
+		return;
+	}
+	v.push_back(value);
+}
+
+template <typename T>
+void reserve_kept(std::vector<T>& v, size_t n) {
+	if (n <= v.capacity()) return;
+	AllowScope grow;
+	v.reserve(std::max(n, 2 * v.capacity()));
+}
+
+} // namespace alloc
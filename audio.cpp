@@ -1,12 +1,19 @@
 #include "audio.h"
+#include "metrics.h"
+#include "trace.h"
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <cmath>
+#include <condition_variable>
 #include <cstdint>
 #include <cstring>
 #include <fstream>
 #include <iostream>
-#include <unordered_set>
-#include <unordered_map>
+#include <mutex>
+#include <string>
+#include <thread>
 #include <vector>
 
 #ifdef USE_OPENAL
@@ -23,37 +30,6 @@ namespace audio {
 
 namespace {
 
-struct WavData {
-	std::vector<std::uint8_t> pcm;
-	int channels = 0;
-	int sampleRate = 0;
-	int bitsPerSample = 0;
-};
-
-static bool g_inited = false;
-
-#ifdef USE_OPENAL
-static ALCdevice* g_device = nullptr;
-static ALCcontext* g_context = nullptr;
-static std::unordered_map<std::string, ALuint> g_bufferCache;
-static std::unordered_set<std::string> g_missingSounds;
-static std::vector<ALuint> g_sources;
-static Vec3 g_listenerPos{0, 0, 0};
-
-static ALuint g_uiSource = 0;
-static ALuint g_stepSource = 0;
-static ALuint g_actionSource = 0;
-
-static float len(Vec3 v) {
-	return std::sqrt(v.x * v.x + v.y * v.y + v.z * v.z);
-}
-
-static Vec3 normalize(Vec3 v) {
-	float l = len(v);
-	if (l <= 1e-6f) return {0.0f, 0.0f, -1.0f};
-	return {v.x / l, v.y / l, v.z / l};
-}
-
 static bool read_u32_le(std::istream& in, std::uint32_t& out) {
 	std::uint8_t b[4]{};
 	if (!in.read(reinterpret_cast<char*>(b), 4)) return false;
@@ -68,10 +44,19 @@ static bool read_u16_le(std::istream& in, std::uint16_t& out) {
 	return true;
 }
 
-static bool load_wav_file(const std::string& path, WavData& wav) {
-	std::ifstream in(path, std::ios::binary);
-	if (!in) return false;
+// The format of a WAV file and where its samples are: read_wav_header()
+// leaves the stream at 'dataStart'.
+struct WavFormat {
+	std::uint16_t audioFormat; // 1 = PCM, 3 = IEEE float
+	int channels;
+	int sampleRate;
+	int bitsPerSample;     // In the file
+	std::streamoff dataStart;
+	std::uint32_t dataBytes;
+};
 
+// False if 'in' isn't a WAV that load_wav_file() can read.
+static bool read_wav_header(std::istream& in, WavFormat& fmt) {
 	char riff[4]{};
 	if (!in.read(riff, 4)) return false;
 	if (std::string(riff, 4) != "RIFF") return false;
@@ -86,8 +71,6 @@ static bool load_wav_file(const std::string& path, WavData& wav) {
 
 	bool haveFmt = false;
 	bool haveData = false;
-	std::uint16_t audioFormat = 0;
-	std::vector<std::uint8_t> rawData;
 
 	while (in && !(haveFmt && haveData)) {
 		char chunkId[4]{};
@@ -103,7 +86,7 @@ static bool load_wav_file(const std::string& path, WavData& wav) {
 			std::uint16_t blockAlign = 0;
 			std::uint16_t bitsPerSample = 0;
 
-			if (!read_u16_le(in, audioFormat)) return false;
+			if (!read_u16_le(in, fmt.audioFormat)) return false;
 			if (!read_u16_le(in, numChannels)) return false;
 			if (!read_u32_le(in, sampleRate)) return false;
 			if (!read_u32_le(in, byteRate)) return false;
@@ -116,13 +99,15 @@ static bool load_wav_file(const std::string& path, WavData& wav) {
 			std::uint32_t remaining = chunkSize > 16 ? (chunkSize - 16) : 0;
 			if (remaining) in.seekg(remaining, std::ios::cur);
 
-			wav.channels = (int)numChannels;
-			wav.sampleRate = (int)sampleRate;
-			wav.bitsPerSample = (int)bitsPerSample;
+			fmt.channels = (int)numChannels;
+			fmt.sampleRate = (int)sampleRate;
+			fmt.bitsPerSample = (int)bitsPerSample;
 			haveFmt = true;
 		} else if (id == "data") {
-			rawData.resize(chunkSize);
-			if (!in.read(reinterpret_cast<char*>(rawData.data()), chunkSize)) return false;
+			// Only noted: the samples are read from here later
+			fmt.dataStart = in.tellg();
+			fmt.dataBytes = chunkSize;
+			in.seekg(chunkSize, std::ios::cur);
 			haveData = true;
 		} else {
 			in.seekg(chunkSize, std::ios::cur);
@@ -133,109 +118,211 @@ static bool load_wav_file(const std::string& path, WavData& wav) {
 	}
 
 	if (!haveFmt || !haveData) return false;
-	if (!((wav.channels == 1) || (wav.channels == 2))) return false;
-	if (!((audioFormat == 1) || (audioFormat == 3))) return false; // 1=PCM, 3=IEEE float
-	if (!((wav.bitsPerSample == 8) || (wav.bitsPerSample == 16) || (wav.bitsPerSample == 24) || (wav.bitsPerSample == 32))) return false;
-
-	// Convert uncommon formats to 16-bit PCM for reliable OpenAL upload.
-	if (wav.bitsPerSample == 8) {
-		wav.pcm = std::move(rawData);
-		return true;
-	}
-
-	if (wav.bitsPerSample == 16 && audioFormat == 1) {
-		wav.pcm = std::move(rawData);
-		return true;
-	}
+	if (!((fmt.channels == 1) || (fmt.channels == 2))) return false;
+	if (!((fmt.audioFormat == 1) || (fmt.audioFormat == 3))) return false;
+	if (!((fmt.bitsPerSample == 8) || (fmt.bitsPerSample == 16) || (fmt.bitsPerSample == 24) || (fmt.bitsPerSample == 32))) return false;
+	if (fmt.audioFormat == 3 && fmt.bitsPerSample != 32) return false;
+
+	in.clear();
+	in.seekg(fmt.dataStart);
+	return (bool)in;
+}
 
-	// Convert to signed 16-bit little-endian.
-	std::vector<std::uint8_t> out;
-	out.reserve((rawData.size() / (wav.bitsPerSample / 8)) * 2);
+// 8-bit and 16-bit PCM go to OpenAL as they are; the rest is converted.
+static bool needs_conversion(const WavFormat& fmt) {
+	return !(fmt.bitsPerSample == 8 || (fmt.bitsPerSample == 16 && fmt.audioFormat == 1));
+}
 
-	auto push_i16_le = [&](std::int16_t s) {
-		out.push_back((std::uint8_t)(s & 0xFF));
-		out.push_back((std::uint8_t)((s >> 8) & 0xFF));
-	};
+static void put_i16_le(std::uint8_t* out, int v) {
+	if (v > 32767) v = 32767;
+	if (v < -32768) v = -32768;
+	out[0] = (std::uint8_t)(v & 0xFF);
+	out[1] = (std::uint8_t)((v >> 8) & 0xFF);
+}
 
-	if (audioFormat == 3 && wav.bitsPerSample == 32) {
+// Converts 'bytes' of samples in a format needs_conversion() is true for to
+// signed 16-bit little-endian in 'out', which must have room for them.
+// Returns the bytes written. A partial last sample is dropped.
+static size_t convert_to_16(const WavFormat& fmt, const std::uint8_t* raw, size_t bytes, std::uint8_t* out) {
+	std::uint8_t* start = out;
+	if (fmt.audioFormat == 3) {
 		// IEEE float32 [-1,1] -> int16
-		for (size_t i = 0; i + 3 < rawData.size(); i += 4) {
+		for (size_t i = 0; i + 3 < bytes; i += 4, out += 2) {
 			float f = 0.0f;
-			std::memcpy(&f, rawData.data() + i, 4);
+			std::memcpy(&f, raw + i, 4);
 			if (f > 1.0f) f = 1.0f;
 			if (f < -1.0f) f = -1.0f;
-			int v = (int)std::lround(f * 32767.0f);
-			if (v > 32767) v = 32767;
-			if (v < -32768) v = -32768;
-			push_i16_le((std::int16_t)v);
+			put_i16_le(out, (int)std::lround(f * 32767.0f));
 		}
-		wav.pcm = std::move(out);
-		wav.bitsPerSample = 16;
-		return true;
-	}
-
-	if (audioFormat == 1 && wav.bitsPerSample == 24) {
+	} else if (fmt.bitsPerSample == 24) {
 		// Signed 24-bit PCM -> int16 (drop lowest 8 bits)
-		for (size_t i = 0; i + 2 < rawData.size(); i += 3) {
-			int v = (int)rawData[i] | ((int)rawData[i + 1] << 8) | ((int)rawData[i + 2] << 16);
+		for (size_t i = 0; i + 2 < bytes; i += 3, out += 2) {
+			int v = (int)raw[i] | ((int)raw[i + 1] << 8) | ((int)raw[i + 2] << 16);
 			// sign extend 24-bit
 			if (v & 0x800000) v |= ~0xFFFFFF;
-			v >>= 8;
-			if (v > 32767) v = 32767;
-			if (v < -32768) v = -32768;
-			push_i16_le((std::int16_t)v);
+			put_i16_le(out, v >> 8);
 		}
-		wav.pcm = std::move(out);
-		wav.bitsPerSample = 16;
-		return true;
-	}
-
-	if (audioFormat == 1 && wav.bitsPerSample == 32) {
+	} else {
 		// Signed 32-bit PCM -> int16 (drop lowest 16 bits)
-		for (size_t i = 0; i + 3 < rawData.size(); i += 4) {
-			std::int32_t v = (std::int32_t)((std::uint32_t)rawData[i] |
-				((std::uint32_t)rawData[i + 1] << 8) |
-				((std::uint32_t)rawData[i + 2] << 16) |
-				((std::uint32_t)rawData[i + 3] << 24));
-			v >>= 16;
-			if (v > 32767) v = 32767;
-			if (v < -32768) v = -32768;
-			push_i16_le((std::int16_t)v);
+		for (size_t i = 0; i + 3 < bytes; i += 4, out += 2) {
+			std::int32_t v = (std::int32_t)((std::uint32_t)raw[i] |
+				((std::uint32_t)raw[i + 1] << 8) |
+				((std::uint32_t)raw[i + 2] << 16) |
+				((std::uint32_t)raw[i + 3] << 24));
+			put_i16_le(out, v >> 16);
 		}
-		wav.pcm = std::move(out);
-		wav.bitsPerSample = 16;
+	}
+	return (size_t)(out - start);
+}
+
+} // namespace
+
+bool load_wav_file(const std::string& path, WavData& wav) {
+	std::ifstream in(path, std::ios::binary);
+	if (!in) return false;
+	WavFormat fmt = WavFormat();
+	if (!read_wav_header(in, fmt)) return false;
+
+	std::vector<std::uint8_t> rawData(fmt.dataBytes);
+	if (!in.read(reinterpret_cast<char*>(rawData.data()), fmt.dataBytes)) return false;
+
+	wav.channels = fmt.channels;
+	wav.sampleRate = fmt.sampleRate;
+	wav.bitsPerSample = fmt.bitsPerSample;
+	if (!needs_conversion(fmt)) {
+		wav.pcm = std::move(rawData);
 		return true;
 	}
 
-	return false;
+	// Convert uncommon formats to 16-bit PCM for reliable OpenAL upload.
+	wav.pcm.resize(rawData.size() / (fmt.bitsPerSample / 8) * 2);
+	wav.pcm.resize(convert_to_16(fmt, rawData.data(), rawData.size(), wav.pcm.data()));
+	wav.bitsPerSample = 16;
+	return true;
 }
 
-static ALenum to_al_format(const WavData& wav) {
-	if (wav.channels == 1 && wav.bitsPerSample == 8) return AL_FORMAT_MONO8;
-	if (wav.channels == 1 && wav.bitsPerSample == 16) return AL_FORMAT_MONO16;
-	if (wav.channels == 2 && wav.bitsPerSample == 8) return AL_FORMAT_STEREO8;
-	if (wav.channels == 2 && wav.bitsPerSample == 16) return AL_FORMAT_STEREO16;
-	return 0;
+namespace {
+
+static bool g_inited = false; // The thread that called init() may use OpenAL
+static std::atomic<bool> g_ready(false); // Any thread may: the API is live
+
+#ifdef USE_OPENAL
+static ALCdevice* g_device = nullptr;
+static ALCcontext* g_context = nullptr;
+// Every sound asked for, loaded or not (buffer 0). A handful, so a linear
+// search: unlike a map keyed on std::string it finds a path without
+// building a string, so playing a cached sound doesn't allocate.
+struct CachedSound {
+	std::string path;
+	ALuint buffer;
+};
+static std::vector<CachedSound> g_sounds;
+static Vec3 g_listenerPos{0, 0, 0};
+
+// Every source is made once, in init(): MAX_VOICES of them, fewer if the
+// implementation has no more. A free list hands one out in O(1), and
+// update() returns the ones whose sound has ended, checking only the busy
+// ones, once a step; playing a sound queries no source state. With none
+// free, the busy voice of lowest priority is stolen, the oldest of equals.
+const int MAX_VOICES = 16;
+const int CHANNELS = 3;
+
+struct Voice {
+	ALuint source;
+	int priority;          // channel_priority() of what it plays
+	unsigned long started; // g_plays when it started, for its age
+	bool busy;
+	int stream;            // g_streams index if it plays one, else -1
+};
+static Voice g_voices[MAX_VOICES];
+static int g_voiceCount = 0;
+static int g_free[MAX_VOICES]; // Idle voices, a stack
+static int g_freeCount = 0;
+static int g_channelVoice[CHANNELS] = {-1, -1, -1}; // By Channel; -1 = none
+static unsigned long g_plays = 0;
+static std::atomic<int> g_busy(0); // Read by the HUD on the GL thread
+
+// Long tracks (ambience, narration) are never loaded whole. A decoder
+// thread reads each in chunks of STREAM_FRAMES frames into a ring of
+// STREAM_BUFFERS slots, converted as load_wav_file() does; update() uploads
+// the filled slots to the stream's AL buffers, queues them on its voice and
+// hands the played ones back to the decoder. A stream's memory is its ring,
+// however long the track. Slots go round in order: EMPTY, FILLING (the
+// decoder's), FILLED, QUEUED (OpenAL's), EMPTY again.
+const int MAX_STREAMS = 2;
+const int STREAM_BUFFERS = 4;
+const size_t STREAM_FRAMES = 8192; // 0.19 s at 44.1 kHz, the ring 0.74 s
+const int STREAM_PRIORITY = 3;     // May take any one-shot's voice
+
+enum SlotState { SLOT_EMPTY, SLOT_FILLING, SLOT_FILLED, SLOT_QUEUED };
+enum StreamState { STREAM_FREE, STREAM_PLAYING, STREAM_STOPPING };
+
+struct Stream {
+	StreamState state = STREAM_FREE;
+	int id = 0; // play_stream()'s handle
+	bool loop = false;
+	bool ended = false; // The decoder has read it all
+	SlotState slots[STREAM_BUFFERS];
+	int fillNext = 0;  // Slot the decoder fills next
+	int queueNext = 0; // Slot update() queues next
+	int playNext = 0;  // Slot the source finishes next
+	int queued = 0;    // Slots in the source's queue
+	// The decoder's while a slot is FILLING; set by play_stream() otherwise
+	std::ifstream file;
+	WavFormat fmt;
+	std::uint32_t dataRead = 0;
+	std::vector<std::uint8_t> raw; // A chunk as read, when converted
+	std::vector<std::uint8_t> pcm[STREAM_BUFFERS];
+	size_t pcmBytes[STREAM_BUFFERS];
+	// update()'s
+	ALuint buffers[STREAM_BUFFERS] = {};
+	ALenum format = 0;
+	int voice = -1;
+};
+static Stream g_streams[MAX_STREAMS];
+static int g_streamIds = 0;
+static std::mutex g_streamLock; // Guards every Stream's state and slots
+static std::condition_variable g_decoderWake;
+static std::thread g_decoder;
+static bool g_decoderQuit = false;
+
+static float len(Vec3 v) {
+	return std::sqrt(v.x * v.x + v.y * v.y + v.z * v.z);
 }
 
-static ALuint get_buffer(const std::string& soundPath) {
-	if (g_missingSounds.find(soundPath) != g_missingSounds.end())
-		return 0;
+static Vec3 normalize(Vec3 v) {
+	float l = len(v);
+	if (l <= 1e-6f) return {0.0f, 0.0f, -1.0f};
+	return {v.x / l, v.y / l, v.z / l};
+}
+
+static ALenum to_al_format(int channels, int bitsPerSample) {
+	if (channels == 1 && bitsPerSample == 8) return AL_FORMAT_MONO8;
+	if (channels == 1 && bitsPerSample == 16) return AL_FORMAT_MONO16;
+	if (channels == 2 && bitsPerSample == 8) return AL_FORMAT_STEREO8;
+	if (channels == 2 && bitsPerSample == 16) return AL_FORMAT_STEREO16;
+	return 0;
+}
 
-	auto it = g_bufferCache.find(soundPath);
-	if (it != g_bufferCache.end()) return it->second;
+static ALuint get_buffer(const char* soundPath) {
+	for (const CachedSound& cached : g_sounds) {
+		if (cached.path == soundPath) return cached.buffer;
+	}
+	g_sounds.push_back({soundPath, 0}); // A failure isn't retried either
 
+	// First use: read and upload the whole file now, on the calling thread.
+	trace::Scope timing("load sound", "audio", soundPath);
 	WavData wav;
 	if (!load_wav_file(soundPath, wav)) {
 		std::cerr << "[audio] Failed to load WAV: " << soundPath << "\n";
-		g_missingSounds.insert(soundPath);
+		metrics::asset_loaded(metrics::ASSET_SOUND, false);
 		return 0;
 	}
 
-	ALenum format = to_al_format(wav);
+	ALenum format = to_al_format(wav.channels, wav.bitsPerSample);
 	if (format == 0) {
 		std::cerr << "[audio] Unsupported WAV format: " << soundPath << "\n";
-		g_missingSounds.insert(soundPath);
+		metrics::asset_loaded(metrics::ASSET_SOUND, false);
 		return 0;
 	}
 
@@ -247,41 +334,317 @@ static ALuint get_buffer(const std::string& soundPath) {
 	if (err != AL_NO_ERROR) {
 		std::cerr << "[audio] OpenAL error loading buffer: " << soundPath << "\n";
 		if (buffer) alDeleteBuffers(1, &buffer);
-		g_missingSounds.insert(soundPath);
+		metrics::asset_loaded(metrics::ASSET_SOUND, false);
 		return 0;
 	}
 
-	g_bufferCache.emplace(soundPath, buffer);
+	g_sounds.back().buffer = buffer;
+	metrics::asset_loaded(metrics::ASSET_SOUND, true);
 	return buffer;
 }
 
-static ALuint acquire_source() {
-	for (ALuint src : g_sources) {
-		ALint state = 0;
-		alGetSourcei(src, AL_SOURCE_STATE, &state);
-		if (state != AL_PLAYING) return src;
+// A channel plays one sound at a time, so a new one cuts the last short.
+// What the player did (ACTION) outranks UI clicks, which outrank steps.
+static int channel_priority(Channel channel) {
+	switch (channel) {
+	case Channel::UI: return 1;
+	case Channel::STEP: return 0;
+	case Channel::ACTION: return 2;
+	default: return 2;
+	}
+}
+
+static void release_voice(int v) {
+	if (!g_voices[v].busy) return;
+	g_voices[v].busy = false;
+	g_free[g_freeCount++] = v;
+	g_busy--;
+	for (int& playing : g_channelVoice) {
+		if (playing == v) playing = -1;
+	}
+}
+
+static void stop_voice(int v) {
+	alSourceStop(g_voices[v].source);
+	release_voice(v);
+}
+
+// A voice for a sound of 'priority': a free one, or else the lowest, oldest
+// busy one if it ranks no higher. -1 if every voice outranks the sound.
+static int acquire_voice(int priority) {
+	if (!g_freeCount) {
+		int victim = -1;
+		for (int v = 0; v < g_voiceCount; v++) {
+			const Voice& voice = g_voices[v];
+			if (voice.priority > priority || voice.stream >= 0) continue; // See release_stream()
+			if (victim < 0 || voice.priority < g_voices[victim].priority ||
+				(voice.priority == g_voices[victim].priority && voice.started < g_voices[victim].started))
+				victim = v;
+		}
+		if (victim < 0) return -1;
+		stop_voice(victim);
 	}
+	int v = g_free[--g_freeCount];
+	g_voices[v].priority = priority;
+	g_voices[v].started = ++g_plays;
+	g_voices[v].busy = true;
+	g_busy++;
+	return v;
+}
 
-	ALuint src = 0;
-	alGenSources(1, &src);
-	if (!src) return 0;
-	g_sources.push_back(src);
+// Stops what 'channel' plays and gives it a voice with 'buffer' on; 0 if
+// there is none to be had.
+static ALuint start_channel(Channel channel, ALuint buffer) {
+	int& playing = g_channelVoice[(int)channel];
+	if (playing >= 0) stop_voice(playing);
+	int v = acquire_voice(channel_priority(channel));
+	if (v < 0) return 0;
+	playing = v;
+	ALuint src = g_voices[v].source;
+	alSourcei(src, AL_BUFFER, (ALint)buffer);
 	return src;
 }
 
-static ALuint channel_source(Channel channel) {
-	switch (channel) {
-	case Channel::UI: return g_uiSource;
-	case Channel::STEP: return g_stepSource;
-	case Channel::ACTION: return g_actionSource;
-	default: return g_actionSource;
+// Reads stream 's''s next chunk into 'slot', from the top again at the end
+// if it loops. False at the end. Decoder thread, 'slot' being FILLING.
+static bool fill_slot(Stream& s, int slot) {
+	trace::Scope timing("decode chunk", "audio");
+	const size_t frameBytes = (size_t)(s.fmt.channels * s.fmt.bitsPerSample / 8);
+	if (s.loop && s.fmt.dataBytes - s.dataRead < frameBytes) {
+		s.file.clear();
+		s.file.seekg(s.fmt.dataStart);
+		s.dataRead = 0;
+	}
+	size_t want = std::min(STREAM_FRAMES, (s.fmt.dataBytes - s.dataRead) / frameBytes) * frameBytes;
+	if (!want) return false;
+
+	bool convert = needs_conversion(s.fmt);
+	std::uint8_t* to = convert ? s.raw.data() : s.pcm[slot].data();
+	s.file.read(reinterpret_cast<char*>(to), (std::streamsize)want);
+	size_t got = (size_t)s.file.gcount() / frameBytes * frameBytes;
+	s.dataRead = got < want ? s.fmt.dataBytes : s.dataRead + (std::uint32_t)want; // Cut short: ends
+	if (!got) return false;
+	s.pcmBytes[slot] = convert ? convert_to_16(s.fmt, s.raw.data(), got, s.pcm[slot].data()) : got;
+	return true;
+}
+
+static void decode_streams() {
+	trace::name_thread("audio decoder");
+	std::unique_lock<std::mutex> lock(g_streamLock);
+	while (!g_decoderQuit) {
+		Stream* work = nullptr;
+		for (Stream& s : g_streams) {
+			if (s.state == STREAM_PLAYING && !s.ended && s.slots[s.fillNext] == SLOT_EMPTY) {
+				work = &s;
+				break;
+			}
+		}
+		if (!work) {
+			g_decoderWake.wait(lock);
+			continue;
+		}
+		int slot = work->fillNext;
+		work->slots[slot] = SLOT_FILLING;
+		lock.unlock();
+		bool filled = fill_slot(*work, slot);
+		lock.lock();
+		work->slots[slot] = filled ? SLOT_FILLED : SLOT_EMPTY;
+		if (filled) work->fillNext = (slot + 1) % STREAM_BUFFERS;
+		else work->ended = true;
+	}
+}
+
+// Stream voices are never stolen: the stream's buffers stay queued on them.
+// g_streamLock held, and no slot FILLING.
+static void release_stream(Stream& s) {
+	Voice& voice = g_voices[s.voice];
+	alSourceStop(voice.source);
+	alSourcei(voice.source, AL_BUFFER, 0); // Unqueues them all
+	voice.stream = -1;
+	release_voice(s.voice);
+	s.voice = -1;
+	s.file.close();
+	s.state = STREAM_FREE;
+}
+
+// Hands the decoder the slots 's''s source has played and queues the ones
+// it filled. g_streamLock held.
+static void update_stream(Stream& s) {
+	ALuint src = g_voices[s.voice].source;
+	ALint processed = 0;
+	alGetSourcei(src, AL_BUFFERS_PROCESSED, &processed);
+	for (; processed > 0; processed--) {
+		ALuint played = 0;
+		alSourceUnqueueBuffers(src, 1, &played);
+		s.slots[s.playNext] = SLOT_EMPTY;
+		s.playNext = (s.playNext + 1) % STREAM_BUFFERS;
+		s.queued--;
+		g_decoderWake.notify_one();
+	}
+	while (s.slots[s.queueNext] == SLOT_FILLED) {
+		int slot = s.queueNext;
+		alBufferData(s.buffers[slot], s.format, s.pcm[slot].data(), (ALsizei)s.pcmBytes[slot], (ALsizei)s.fmt.sampleRate);
+		alSourceQueueBuffers(src, 1, &s.buffers[slot]);
+		s.slots[slot] = SLOT_QUEUED;
+		s.queueNext = (slot + 1) % STREAM_BUFFERS;
+		s.queued++;
+	}
+
+	ALint state = 0;
+	alGetSourcei(src, AL_SOURCE_STATE, &state);
+	if (state == AL_PLAYING || state == AL_PAUSED) return;
+	if (s.queued) alSourcePlay(src); // Starting, or the decoder fell behind
+	else if (s.ended) release_stream(s);
+}
+
+static void update_streams() {
+	std::lock_guard<std::mutex> lock(g_streamLock);
+	for (Stream& s : g_streams) {
+		if (s.state == STREAM_PLAYING) {
+			update_stream(s);
+		} else if (s.state == STREAM_STOPPING) {
+			bool filling = false;
+			for (SlotState slot : s.slots) filling |= slot == SLOT_FILLING;
+			if (!filling) release_stream(s);
+		}
+	}
+}
+
+static void stop_stream_locked(Stream& s) {
+	if (s.state != STREAM_PLAYING) return;
+	alSourceStop(g_voices[s.voice].source);
+	s.state = STREAM_STOPPING; // Freed by update() once the decoder lets go
+}
+
+// play_stream() once audio is up, 'id' its handle
+static bool start_stream(const char* soundPath, float gain, bool loop, int id) {
+	std::lock_guard<std::mutex> lock(g_streamLock);
+	Stream* idle = nullptr;
+	for (Stream& s : g_streams) {
+		if (s.state == STREAM_FREE) {
+			idle = &s;
+			break;
+		}
+	}
+	if (!idle) return false;
+	Stream& s = *idle;
+
+	s.file.open(soundPath, std::ios::binary);
+	s.fmt = WavFormat();
+	if (!s.file || !read_wav_header(s.file, s.fmt)) {
+		std::cerr << "[audio] Failed to open WAV stream: " << soundPath << "\n";
+		s.file.close();
+		metrics::asset_loaded(metrics::ASSET_SOUND, false);
+		return false;
+	}
+	metrics::asset_loaded(metrics::ASSET_SOUND, true);
+	int v = acquire_voice(STREAM_PRIORITY);
+	if (v < 0) {
+		s.file.close();
+		return false;
+	}
+
+	// Made the first time the slot is used, big enough for any WAV after
+	if (!s.buffers[0]) {
+		alGenBuffers(STREAM_BUFFERS, s.buffers);
+		s.raw.resize(STREAM_FRAMES * 2 * 4); // Stereo, 32-bit
+		for (std::vector<std::uint8_t>& pcm : s.pcm) pcm.resize(STREAM_FRAMES * 2 * 2);
+	}
+	s.format = to_al_format(s.fmt.channels, needs_conversion(s.fmt) ? 16 : s.fmt.bitsPerSample);
+	s.id = id;
+	s.loop = loop;
+	s.ended = false;
+	std::fill(s.slots, s.slots + STREAM_BUFFERS, SLOT_EMPTY);
+	s.fillNext = s.queueNext = s.playNext = s.queued = 0;
+	s.dataRead = 0;
+	s.voice = v;
+	s.state = STREAM_PLAYING;
+	g_voices[v].stream = (int)(&s - g_streams);
+
+	// Not positional, as play_ui()
+	ALuint src = g_voices[v].source;
+	alSourcei(src, AL_BUFFER, 0);
+	alSourcef(src, AL_GAIN, gain);
+	alSourcef(src, AL_PITCH, 1.0f);
+	alSourcei(src, AL_LOOPING, AL_FALSE); // The decoder loops
+	alSourcei(src, AL_SOURCE_RELATIVE, AL_TRUE);
+	alSource3f(src, AL_POSITION, 0.0f, 0.0f, 0.0f);
+	alSource3f(src, AL_VELOCITY, 0.0f, 0.0f, 0.0f);
+
+	if (!g_decoder.joinable()) g_decoder = std::thread(decode_streams);
+	g_decoderWake.notify_one();
+	return true;
+}
+
+// Sounds asked for while init_async() is still at work, played by update()
+// once it is done. What would be wrong late is dropped instead: steps at
+// once, other one-shots if they have waited over MAX_PENDING_AGE by then,
+// and anything past MAX_PENDING. Streams (ambience, narration) wait however
+// long it takes. Touched only by the thread that plays sounds.
+const int MAX_PENDING = 8;
+const float MAX_PENDING_AGE = 0.5f; // Seconds
+
+enum PendingKind { PENDING_3D, PENDING_UI, PENDING_STREAM };
+
+struct PendingPlay {
+	PendingKind kind;
+	std::string path;
+	std::chrono::steady_clock::time_point asked;
+	Vec3 position;
+	float gain;
+	Channel channel;
+	bool loop;
+	int stream; // play_stream()'s handle
+};
+static PendingPlay g_pending[MAX_PENDING];
+static int g_pendingCount = 0;
+static std::thread g_initThread;
+static std::atomic<bool> g_initFailed(false);
+
+static PendingPlay* add_pending(PendingKind kind, const char* soundPath) {
+	if (g_pendingCount == MAX_PENDING) return nullptr;
+	PendingPlay& p = g_pending[g_pendingCount++];
+	p.kind = kind;
+	p.path = soundPath;
+	p.asked = std::chrono::steady_clock::now();
+	p.channel = Channel::UI;
+	p.stream = -1;
+	return &p;
+}
+
+// Forgets the pending plays on 'channel' (PENDING_STREAM: of 'stream')
+static void drop_pending(PendingKind kind, Channel channel, int stream) {
+	int kept = 0;
+	for (int i = 0; i < g_pendingCount; i++) {
+		const PendingPlay& p = g_pending[i];
+		bool match = kind == PENDING_STREAM ? p.stream == stream : p.kind != PENDING_STREAM && p.channel == channel;
+		if (!match) std::swap(g_pending[kept++], g_pending[i]);
+	}
+	g_pendingCount = kept;
+}
+
+static void play_pending() {
+	const int count = g_pendingCount;
+	g_pendingCount = 0;
+	std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+	for (int i = 0; i < count; i++) {
+		const PendingPlay& p = g_pending[i];
+		float waited = std::chrono::duration<float>(now - p.asked).count();
+		if (p.kind == PENDING_STREAM) start_stream(p.path.c_str(), p.gain, p.loop, p.stream);
+		else if (waited > MAX_PENDING_AGE) continue;
+		else if (p.kind == PENDING_UI) play_ui(p.path.c_str(), p.gain);
+		else play3d(p.path.c_str(), p.position, p.gain, p.channel);
 	}
 }
 #endif
 
 } // namespace
 
-bool init() {
+namespace {
+
+// What init() and init_async() share: opens the device and makes the voice
+// pool. The API stays off (g_ready) until the caller is done with the rest.
+static bool open_device() {
 #ifdef USE_OPENAL
 	if (g_inited) return true;
 
@@ -310,13 +673,16 @@ bool init() {
 	alDistanceModel(AL_INVERSE_DISTANCE_CLAMPED);
 	alListenerf(AL_GAIN, 1.0f);
 
-	// Dedicated channels so common sounds don't overlap.
-	alGenSources(1, &g_uiSource);
-	alGenSources(1, &g_stepSource);
-	alGenSources(1, &g_actionSource);
-	g_sources.push_back(g_uiSource);
-	g_sources.push_back(g_stepSource);
-	g_sources.push_back(g_actionSource);
+	// The voice pool
+	for (g_voiceCount = 0; g_voiceCount < MAX_VOICES; g_voiceCount++) {
+		ALuint src = 0;
+		alGenSources(1, &src);
+		if (alGetError() != AL_NO_ERROR || !src) break;
+		g_voices[g_voiceCount] = {src, 0, 0, false, -1};
+		g_free[g_voiceCount] = g_voiceCount;
+	}
+	g_freeCount = g_voiceCount;
+	if (!g_voiceCount) std::cerr << "[audio] No sources available\n";
 
 	g_inited = true;
 	return true;
@@ -325,25 +691,65 @@ bool init() {
 #endif
 }
 
+} // namespace
+
+bool init() {
+	if (!open_device()) return false;
+	g_ready = true;
+	return true;
+}
+
+void init_async() {
+#ifdef USE_OPENAL
+	if (g_inited || g_initThread.joinable()) return;
+	g_initThread = std::thread([] {
+		trace::name_thread("audio init");
+		trace::Scope timing("audio init", "audio");
+		if (!open_device()) {
+			g_initFailed = true;
+			return;
+		}
+		preload_defaults();
+		g_ready = true;
+	});
+#endif
+}
+
 void shutdown() {
 #ifdef USE_OPENAL
+	if (g_initThread.joinable()) g_initThread.join(); // A device may still be opening
+	g_ready = false;
+	g_pendingCount = 0;
 	if (!g_inited) return;
 
-	for (ALuint src : g_sources) {
-		alSourceStop(src);
-		alDeleteSources(1, &src);
+	if (g_decoder.joinable()) {
+		{
+			std::lock_guard<std::mutex> lock(g_streamLock);
+			g_decoderQuit = true;
+		}
+		g_decoderWake.notify_one();
+		g_decoder.join();
+		g_decoderQuit = false;
+	}
+	for (Stream& s : g_streams) {
+		if (s.state != STREAM_FREE) release_stream(s);
+		alDeleteBuffers(STREAM_BUFFERS, s.buffers);
+		std::fill(s.buffers, s.buffers + STREAM_BUFFERS, 0u);
+	}
+
+	for (int v = 0; v < g_voiceCount; v++) {
+		alSourceStop(g_voices[v].source);
+		alDeleteSources(1, &g_voices[v].source);
 	}
-	g_sources.clear();
-	g_uiSource = 0;
-	g_stepSource = 0;
-	g_actionSource = 0;
+	g_voiceCount = 0;
+	g_freeCount = 0;
+	for (int& playing : g_channelVoice) playing = -1;
+	g_busy = 0;
 
-	for (auto& kv : g_bufferCache) {
-		ALuint buf = kv.second;
-		if (buf) alDeleteBuffers(1, &buf);
+	for (CachedSound& cached : g_sounds) {
+		if (cached.buffer) alDeleteBuffers(1, &cached.buffer);
 	}
-	g_bufferCache.clear();
-	g_missingSounds.clear();
+	g_sounds.clear();
 
 	alcMakeContextCurrent(nullptr);
 	if (g_context) alcDestroyContext(g_context);
@@ -367,7 +773,7 @@ void preload_defaults() {
 
 void update_listener(Vec3 position, Vec3 forward, Vec3 up) {
 #ifdef USE_OPENAL
-	if (!g_inited) return;
+	if (!g_ready) return;
 
 	g_listenerPos = position;
 	Vec3 f = normalize(forward);
@@ -379,18 +785,41 @@ void update_listener(Vec3 position, Vec3 forward, Vec3 up) {
 #endif
 }
 
-void play3d(const std::string& soundPath, Vec3 position, float gain, Channel channel) {
+void update() {
 #ifdef USE_OPENAL
-	if (!g_inited) return;
+	if (!g_ready) {
+		if (g_initFailed) g_pendingCount = 0; // No device: never will be
+		return;
+	}
+	if (g_pendingCount) play_pending();
+	update_streams();
+	for (int v = 0; v < g_voiceCount; v++) {
+		if (!g_voices[v].busy || g_voices[v].stream >= 0) continue;
+		ALint state = 0;
+		alGetSourcei(g_voices[v].source, AL_SOURCE_STATE, &state);
+		if (state != AL_PLAYING && state != AL_PAUSED) release_voice(v);
+	}
+#endif
+}
+
+void play3d(const char* soundPath, Vec3 position, float gain, Channel channel) {
+#ifdef USE_OPENAL
+	if (!g_ready) {
+		PendingPlay* p = channel == Channel::STEP ? nullptr : add_pending(PENDING_3D, soundPath);
+		if (!p) return;
+		p->position = position;
+		p->gain = gain;
+		p->channel = channel;
+		return;
+	}
 
+	trace::instant("play", "audio", soundPath);
 	ALuint buffer = get_buffer(soundPath);
 	if (!buffer) return;
 
-	ALuint src = channel_source(channel);
+	ALuint src = start_channel(channel, buffer);
 	if (!src) return;
 
-	alSourceStop(src);
-	alSourcei(src, AL_BUFFER, (ALint)buffer);
 	alSource3f(src, AL_POSITION, position.x, position.y, position.z);
 	alSource3f(src, AL_VELOCITY, 0.0f, 0.0f, 0.0f);
 	alSourcef(src, AL_GAIN, gain);
@@ -407,16 +836,19 @@ void play3d(const std::string& soundPath, Vec3 position, float gain, Channel cha
 #endif
 }
 
-void play_ui(const std::string& soundPath, float gain) {
+void play_ui(const char* soundPath, float gain) {
 #ifdef USE_OPENAL
-	if (!g_inited) return;
+	if (!g_ready) {
+		PendingPlay* p = add_pending(PENDING_UI, soundPath);
+		if (p) p->gain = gain;
+		return;
+	}
+	trace::instant("play", "audio", soundPath);
 	ALuint buffer = get_buffer(soundPath);
 	if (!buffer) return;
-	ALuint src = channel_source(Channel::UI);
+	ALuint src = start_channel(Channel::UI, buffer);
 	if (!src) return;
 
-	alSourceStop(src);
-	alSourcei(src, AL_BUFFER, (ALint)buffer);
 	alSourcef(src, AL_GAIN, gain);
 	alSourcef(src, AL_PITCH, 1.0f);
 	alSourcei(src, AL_LOOPING, AL_FALSE);
@@ -430,27 +862,82 @@ void play_ui(const std::string& soundPath, float gain) {
 #endif
 }
 
-void play_step(const std::string& soundPath, float gain) {
+void play_step(const char* soundPath, float gain) {
 #ifdef USE_OPENAL
 	play3d(soundPath, g_listenerPos, gain, Channel::STEP);
 #endif
 }
 
+int play_stream(const char* soundPath, float gain, bool loop) {
+#ifdef USE_OPENAL
+	int id = ++g_streamIds;
+	if (!g_ready) {
+		PendingPlay* p = add_pending(PENDING_STREAM, soundPath);
+		if (!p) return -1;
+		p->gain = gain;
+		p->loop = loop;
+		p->stream = id;
+		return id;
+	}
+	trace::instant("stream", "audio", soundPath);
+	return start_stream(soundPath, gain, loop, id) ? id : -1;
+#else
+	(void)soundPath;
+	(void)gain;
+	(void)loop;
+	return -1;
+#endif
+}
+
+void stop_stream(int stream) {
+#ifdef USE_OPENAL
+	if (!g_ready) {
+		drop_pending(PENDING_STREAM, Channel::UI, stream);
+		return;
+	}
+	std::lock_guard<std::mutex> lock(g_streamLock);
+	for (Stream& s : g_streams) {
+		if (s.id == stream) stop_stream_locked(s);
+	}
+#else
+	(void)stream;
+#endif
+}
+
 void stop(Channel channel) {
 #ifdef USE_OPENAL
-	if (!g_inited) return;
-	ALuint src = channel_source(channel);
-	if (src) alSourceStop(src);
+	if (!g_ready) {
+		drop_pending(PENDING_3D, channel, -1);
+		return;
+	}
+	int v = g_channelVoice[(int)channel];
+	if (v >= 0) stop_voice(v);
 #endif
 }
 
 void stop_all() {
 #ifdef USE_OPENAL
-	if (!g_inited) return;
-	for (ALuint src : g_sources) {
-		if (src) alSourceStop(src);
+	if (!g_ready) {
+		g_pendingCount = 0;
+		return;
+	}
+	{
+		std::lock_guard<std::mutex> lock(g_streamLock);
+		for (Stream& s : g_streams) stop_stream_locked(s);
+	}
+	for (int v = 0; v < g_voiceCount; v++) {
+		if (g_voices[v].busy && g_voices[v].stream < 0) stop_voice(v);
 	}
 #endif
 }
 
+int active_voices() {
+#ifdef USE_OPENAL
+	if (!g_ready) return 0;
+	return g_busy;
+#else
+	return 0;
+#endif
+}
+
 } // namespace audio
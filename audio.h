@@ -1,6 +1,8 @@
 #pragma once
 
+#include <cstdint>
 #include <string>
+#include <vector>
 
 namespace audio {
 
@@ -10,6 +12,14 @@ struct Vec3 {
 	float z;
 };
 
+// A decoded sound: 8-bit unsigned or 16-bit signed little-endian PCM.
+struct WavData {
+	std::vector<std::uint8_t> pcm;
+	int channels = 0;
+	int sampleRate = 0;
+	int bitsPerSample = 0;
+};
+
 enum class Channel {
 	UI,
 	STEP,
@@ -22,23 +32,57 @@ enum class Channel {
 bool init();
 void shutdown();
 
-// Preload commonly used sfx (safe to call even if init() failed).
+// init() and preload_defaults() on a thread of their own, so a slow audio
+// stack (opening the device can take hundreds of ms) never holds up the
+// first frame. Until they are done the API is safe to use but plays
+// nothing: update() plays what was asked for meanwhile once they are, bar
+// what would be wrong late (steps, and clicks or actions asked for over
+// 0.5 s before). shutdown() waits for them.
+void init_async();
+
+// Preload commonly used sfx (safe to call even if init() failed). On the
+// thread that called init(); init_async() does it itself.
 void preload_defaults();
 
 // Update 3D listener (camera) each frame.
 void update_listener(Vec3 position, Vec3 forward, Vec3 up);
 
-// Play a one-shot sound at a world position.
-void play3d(const std::string& soundPath, Vec3 position, float gain = 1.0f, Channel channel = Channel::ACTION);
+// Once a step: frees the voices whose sound has ended for new sounds, and
+// keeps streams fed.
+void update();
+
+// Play a one-shot sound at a world position. A channel plays one sound at
+// a time: this cuts short what 'channel' was playing. If every voice is
+// busy the lowest priority one is taken (STEP < UI < ACTION), the oldest
+// of equals, or the sound is dropped when all outrank it.
+void play3d(const char* soundPath, Vec3 position, float gain = 1.0f, Channel channel = Channel::ACTION);
 
 // Convenience: play at listener position (non-spatial UI click).
-void play_ui(const std::string& soundPath, float gain = 1.0f);
+void play_ui(const char* soundPath, float gain = 1.0f);
 
 // Convenience: step/movement sound (throttled by caller).
-void play_step(const std::string& soundPath, float gain = 1.0f);
+void play_step(const char* soundPath, float gain = 1.0f);
+
+// Streams a long WAV (ambience, narration) from disk as it plays, instead
+// of loading it whole: a stream takes the same memory however long the
+// track. Not positional. 'loop' plays it until stop_stream(). Returns a
+// handle for stop_stream(), or -1 if the file can't be read or two streams
+// are playing already. Before init_async() is done the stream waits, and
+// only then are those checked.
+int play_stream(const char* soundPath, float gain = 1.0f, bool loop = false);
+void stop_stream(int stream);
 
 // Stop playback on a channel.
 void stop(Channel channel);
 void stop_all();
 
+// Voices playing as of the last update(), plus those started since (0
+// without USE_OPENAL). Safe to call from any thread.
+int active_voices();
+
+// Reads a mono or stereo WAV: 8 / 16 / 24 / 32-bit PCM or 32-bit float,
+// the last three converted to 16-bit. False if it can't be read or is
+// another format. Works without USE_OPENAL too.
+bool load_wav_file(const std::string& path, WavData& wav);
+
 } // namespace audio
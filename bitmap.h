@@ -1,6 +1,7 @@
 #ifndef BITMAP
 #define BITMAP
 
+#include "gfx.h"
 #include "gl_includes.h"
 #include <cmath>
 
@@ -11,46 +12,40 @@ void *helv12 = GLUT_BITMAP_HELVETICA_12;
 float prog;
 
 void renderBitmapString(float x, float y, float z, void *font, char *string) {
-
-  char *c;
-  glRasterPos3f(x, y, z);
-  for (c = string; *c != '\0'; c++) {
-    glutBitmapCharacter(font, *c);
-  }
+  gfx::raster_pos3f(x, y, z);
+  gfx::bitmap_string(font, string);
 }
 
-void front_page() {
+void front_page(int w, int h) {
   // Save current matrices
-  glMatrixMode(GL_PROJECTION);
-  glPushMatrix();
-  glLoadIdentity();
+  gfx::matrix_mode(GL_PROJECTION);
+  gfx::push_matrix();
+  gfx::load_identity();
 
   // Set up 2D orthographic projection
-  int w = glutGet(GLUT_WINDOW_WIDTH);
-  int h = glutGet(GLUT_WINDOW_HEIGHT);
-  gluOrtho2D(0, w, 0, h);
+  gfx::ortho2d(0, w, 0, h);
 
-  glMatrixMode(GL_MODELVIEW);
-  glPushMatrix();
-  glLoadIdentity();
+  gfx::matrix_mode(GL_MODELVIEW);
+  gfx::push_matrix();
+  gfx::load_identity();
 
-  glDisable(GL_DEPTH_TEST);
-  glDisable(GL_LIGHTING);
+  gfx::disable(GL_DEPTH_TEST);
+  gfx::disable(GL_LIGHTING);
 
   // Draw dark background
-  glColor3f(0.05f, 0.05f, 0.1f);
-  glBegin(GL_QUADS);
-  glVertex2f(0, 0);
-  glVertex2f(w, 0);
-  glVertex2f(w, h);
-  glVertex2f(0, h);
-  glEnd();
+  gfx::color3f(0.05f, 0.05f, 0.1f);
+  gfx::begin(GL_QUADS);
+  gfx::vertex2f(0, 0);
+  gfx::vertex2f(w, 0);
+  gfx::vertex2f(w, h);
+  gfx::vertex2f(0, h);
+  gfx::end();
 
   // Center text rendering
   float centerX = w / 2.0f;
   float centerY = h / 2.0f;
 
-  glColor3f(1.0f, 1.0f, 1.0f);
+  gfx::color3f(1.0f, 1.0f, 1.0f);
 
   // Title - RV College
   renderBitmapString(centerX - 120, centerY + 180, 0, (void *)helv18,
@@ -59,21 +54,21 @@ void front_page() {
                      (char *)"Computer Science Department");
 
   // Subtitle
-  glColor3f(0.8f, 0.8f, 0.8f);
+  gfx::color3f(0.8f, 0.8f, 0.8f);
   renderBitmapString(centerX - 70, centerY + 100, 0, (void *)helv12,
                      (char *)"A MINI PROJECT ON");
 
-  glColor3f(0.0f, 1.0f, 0.5f); // Green for main title
+  gfx::color3f(0.0f, 1.0f, 0.5f); // Green for main title
   renderBitmapString(
       centerX - 250, centerY + 60, 0, (void *)helv18,
       (char *)"GRAPHICAL SIMULATION OF DESKTOP AND ITS COMPONENTS");
 
   // Team members
-  glColor3f(1.0f, 1.0f, 1.0f);
+  gfx::color3f(1.0f, 1.0f, 1.0f);
   renderBitmapString(centerX - 20, centerY - 20, 0, (void *)helv12,
                      (char *)"BY:");
 
-  glColor3f(0.9f, 0.9f, 0.9f);
+  gfx::color3f(0.9f, 0.9f, 0.9f);
   renderBitmapString(centerX - 55, centerY - 50, 0, (void *)helv12,
                      (char *)"VIBHAV SIMHA");
   renderBitmapString(centerX - 40, centerY - 75, 0, (void *)helv12,
@@ -81,66 +76,66 @@ void front_page() {
   renderBitmapString(centerX - 90, centerY - 100, 0, (void *)helv12,
                      (char *)"SAMVIT SANAT GERSAPPA");
 
-  glEnable(GL_DEPTH_TEST);
+  gfx::enable(GL_DEPTH_TEST);
 
   // Restore matrices
-  glPopMatrix();
-  glMatrixMode(GL_PROJECTION);
-  glPopMatrix();
-  glMatrixMode(GL_MODELVIEW);
+  gfx::pop_matrix();
+  gfx::matrix_mode(GL_PROJECTION);
+  gfx::pop_matrix();
+  gfx::matrix_mode(GL_MODELVIEW);
 }
 
-void progress_wheel(void) {
+/// Progress wheel animation, one SIM_DT step (~3 rad / sec).
+void advance_progress_wheel(float dt) {
+  prog += 3.0f * dt;
+  if (prog > 6.284f)
+    prog = 0.0f;
+}
+
+void progress_wheel(int w, int h, float progress) {
   double i;
 
   // Save current matrices
-  glMatrixMode(GL_PROJECTION);
-  glPushMatrix();
-  glLoadIdentity();
+  gfx::matrix_mode(GL_PROJECTION);
+  gfx::push_matrix();
+  gfx::load_identity();
 
-  int w = glutGet(GLUT_WINDOW_WIDTH);
-  int h = glutGet(GLUT_WINDOW_HEIGHT);
-  gluOrtho2D(0, w, 0, h);
+  gfx::ortho2d(0, w, 0, h);
 
-  glMatrixMode(GL_MODELVIEW);
-  glPushMatrix();
-  glLoadIdentity();
+  gfx::matrix_mode(GL_MODELVIEW);
+  gfx::push_matrix();
+  gfx::load_identity();
 
-  glDisable(GL_DEPTH_TEST);
+  gfx::disable(GL_DEPTH_TEST);
 
   float centerX = w / 2.0f;
   float centerY = h / 2.0f;
 
-  // Progress wheel animation
-  if (prog > 6.284f)
-    prog = 0.0f;
-  prog += 0.05f;
-
-  glPointSize(6.0);
-  glBegin(GL_POINTS);
-  for (i = 0; i < prog; i = i + 0.15f) {
+  gfx::point_size(6.0);
+  gfx::begin(GL_POINTS);
+  for (i = 0; i < progress; i = i + 0.15f) {
     float colorVal = (float)(i / 6.284f);
-    glColor3f(colorVal, 0.3f * colorVal, 0.0f);
-    glVertex2f(centerX + (float)(sin(i) * 30.0f),
+    gfx::color3f(colorVal, 0.3f * colorVal, 0.0f);
+    gfx::vertex2f(centerX + (float)(sin(i) * 30.0f),
                centerY - 180 + (float)(cos(i) * 30.0f));
   }
-  glEnd();
+  gfx::end();
 
-  glColor3f(0.7f, 0.7f, 0.7f);
+  gfx::color3f(0.7f, 0.7f, 0.7f);
   renderBitmapString(centerX - 30, centerY - 230, 0, (void *)helv12,
                      (char *)"Loading...");
 
-  glColor3f(1.0f, 1.0f, 1.0f);
+  gfx::color3f(1.0f, 1.0f, 1.0f);
   renderBitmapString(centerX - 95, centerY - 260, 0, (void *)helv12,
                      (char *)"Press ENTER to continue...");
 
-  glEnable(GL_DEPTH_TEST);
+  gfx::enable(GL_DEPTH_TEST);
 
   // Restore matrices
-  glPopMatrix();
-  glMatrixMode(GL_PROJECTION);
-  glPopMatrix();
-  glMatrixMode(GL_MODELVIEW);
+  gfx::pop_matrix();
+  gfx::matrix_mode(GL_PROJECTION);
+  gfx::pop_matrix();
+  gfx::matrix_mode(GL_MODELVIEW);
 }
 
 #endif BITMAP
\ No newline at end of file
@@ -0,0 +1,395 @@
+#include "bvh.h"
+#include "gfx_replay.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+namespace bvh {
+
+namespace {
+
+struct Box {
+	float min[3], max[3];
+};
+
+const int BINS = 12;         // Candidate split planes per axis, plus one
+const uint32_t MAX_LEAF = 8; // Split bigger leaves even where the SAH would not
+const int MAX_DEPTH = 60;    // Keeps traversal within its fixed stack
+const int STACK_SIZE = 64;
+
+static Box empty_box() {
+	Box b = {{FLT_MAX, FLT_MAX, FLT_MAX}, {-FLT_MAX, -FLT_MAX, -FLT_MAX}};
+	return b;
+}
+
+static void grow(Box& b, const float min[3], const float max[3]) {
+	for (int a = 0; a < 3; a++) {
+		b.min[a] = std::min(b.min[a], min[a]);
+		b.max[a] = std::max(b.max[a], max[a]);
+	}
+}
+
+static float area(const Box& b) {
+	if (b.min[0] > b.max[0]) return 0.0f;
+	float dx = b.max[0] - b.min[0], dy = b.max[1] - b.min[1], dz = b.max[2] - b.min[2];
+	return 2.0f * (dx * dy + dy * dz + dz * dx);
+}
+
+// Builds 'nodes' over primitives with bounds 'boxes' by binned SAH, top
+// down. 'order' gets the primitive indices in leaf order.
+static void build_tree(const std::vector<Box>& boxes, std::vector<Node>& nodes, std::vector<uint32_t>& order) {
+	size_t n = boxes.size();
+	nodes.clear();
+	order.resize(n);
+	if (n == 0) return;
+	std::vector<float> centers(n * 3);
+	for (size_t i = 0; i < n; i++) {
+		order[i] = (uint32_t)i;
+		for (int a = 0; a < 3; a++) centers[i * 3 + a] = 0.5f * (boxes[i].min[a] + boxes[i].max[a]);
+	}
+
+	Node root = {};
+	root.count = (uint32_t)n;
+	nodes.push_back(root);
+	struct Todo {
+		uint32_t node;
+		int depth;
+	};
+	std::vector<Todo> todo(1, Todo{0, 0});
+	while (!todo.empty()) {
+		Todo job = todo.back();
+		todo.pop_back();
+		uint32_t first = nodes[job.node].first, count = nodes[job.node].count;
+
+		Box bounds = empty_box(), centerBounds = empty_box();
+		for (uint32_t k = first; k < first + count; k++) {
+			grow(bounds, boxes[order[k]].min, boxes[order[k]].max);
+			grow(centerBounds, &centers[order[k] * 3], &centers[order[k] * 3]);
+		}
+		std::copy(bounds.min, bounds.min + 3, nodes[job.node].min);
+		std::copy(bounds.max, bounds.max + 3, nodes[job.node].max);
+		if (count <= 1 || job.depth >= MAX_DEPTH) continue;
+
+		// Cost of a split: one box test plus, per side, its primitives
+		// weighted by the chance a ray through the parent crosses that side
+		// (area ratio). Scaled by the parent's area throughout.
+		float leafCost = count * area(bounds);
+		float bestCost = FLT_MAX;
+		int bestAxis = -1, bestBin = 0;
+		for (int a = 0; a < 3; a++) {
+			float extent = centerBounds.max[a] - centerBounds.min[a];
+			if (extent <= 0.0f) continue;
+			float scale = BINS / extent;
+			Box binBox[BINS];
+			uint32_t binCount[BINS] = {};
+			for (int b = 0; b < BINS; b++) binBox[b] = empty_box();
+			for (uint32_t k = first; k < first + count; k++) {
+				int b = std::min(BINS - 1, (int)((centers[order[k] * 3 + a] - centerBounds.min[a]) * scale));
+				binCount[b]++;
+				grow(binBox[b], boxes[order[k]].min, boxes[order[k]].max);
+			}
+			// Sweep from the right for the right-hand sides, then from the left.
+			float rightArea[BINS];
+			uint32_t rightCount[BINS];
+			Box side = empty_box();
+			uint32_t sideCount = 0;
+			for (int b = BINS - 1; b > 0; b--) {
+				grow(side, binBox[b].min, binBox[b].max);
+				sideCount += binCount[b];
+				rightArea[b] = area(side);
+				rightCount[b] = sideCount;
+			}
+			side = empty_box();
+			sideCount = 0;
+			for (int b = 1; b < BINS; b++) { // Plane between bins b - 1 and b
+				grow(side, binBox[b - 1].min, binBox[b - 1].max);
+				sideCount += binCount[b - 1];
+				if (sideCount == 0 || rightCount[b] == 0) continue;
+				float cost = area(bounds) + sideCount * area(side) + rightCount[b] * rightArea[b];
+				if (cost < bestCost) {
+					bestCost = cost;
+					bestAxis = a;
+					bestBin = b;
+				}
+			}
+		}
+		if (bestAxis < 0 || (bestCost >= leafCost && count <= MAX_LEAF)) continue;
+
+		float scale = BINS / (centerBounds.max[bestAxis] - centerBounds.min[bestAxis]);
+		uint32_t* mid = std::partition(&order[first], &order[first] + count, [&](uint32_t p) {
+			return std::min(BINS - 1, (int)((centers[p * 3 + bestAxis] - centerBounds.min[bestAxis]) * scale)) < bestBin;
+		});
+		uint32_t leftCount = (uint32_t)(mid - &order[first]);
+
+		Node left = {}, right = {};
+		left.first = first;
+		left.count = leftCount;
+		right.first = first + leftCount;
+		right.count = count - leftCount;
+		uint32_t child = (uint32_t)nodes.size();
+		nodes.push_back(left);
+		nodes.push_back(right);
+		nodes[job.node].first = child;
+		nodes[job.node].count = 0;
+		todo.push_back(Todo{child, job.depth + 1});
+		todo.push_back(Todo{child + 1, job.depth + 1});
+	}
+}
+
+// Distance at which 'ray' enters the box of 'node', if that is before 't';
+// FLT_MAX if it misses. 'inv' is 1 / ray direction.
+static inline float enter(const Node& node, const float origin[3], const float inv[3], float t) {
+	if (node.min[0] > node.max[0]) return FLT_MAX; // Empty
+	float t0 = 0.0f, t1 = t;
+	for (int a = 0; a < 3; a++) {
+		float n = (node.min[a] - origin[a]) * inv[a];
+		float f = (node.max[a] - origin[a]) * inv[a];
+		if (n > f) std::swap(n, f);
+		t0 = n > t0 ? n : t0;
+		t1 = f < t1 ? f : t1;
+	}
+	return t0 <= t1 ? t0 : FLT_MAX;
+}
+
+// Walks the boxes 'ray' enters before 't', nearer child first, calling
+// leaf(first, count, t) for each leaf it reaches. The leaf may shorten 't',
+// and returns true to stop the walk there. Nodes wait on the stack with the
+// distance their box is entered at, so one a nearer hit has since put out
+// of reach is dropped when popped rather than walked.
+template <typename Leaf>
+static void traverse(const std::vector<Node>& nodes, const gfx::Ray& ray, float& t, const Leaf& leaf) {
+	if (nodes.empty()) return;
+	float inv[3];
+	for (int a = 0; a < 3; a++) inv[a] = 1.0f / ray.dir[a];
+	float tRoot = enter(nodes[0], ray.origin, inv, t);
+	if (tRoot == FLT_MAX) return;
+	uint32_t stack[STACK_SIZE];
+	float stackT[STACK_SIZE]; // Where the ray enters each one's box
+	int top = 0;
+	stack[top] = 0;
+	stackT[top++] = tRoot;
+	while (top > 0) {
+		--top;
+		if (stackT[top] >= t) continue; // Behind the nearest hit so far
+		const Node& node = nodes[stack[top]];
+		if (node.count > 0) {
+			if (leaf(node.first, node.count, t)) return;
+			continue;
+		}
+		uint32_t closer = node.first, further = node.first + 1;
+		float tCloser = enter(nodes[closer], ray.origin, inv, t);
+		float tFurther = enter(nodes[further], ray.origin, inv, t);
+		if (tFurther < tCloser) {
+			std::swap(closer, further);
+			std::swap(tCloser, tFurther);
+		}
+		if (tFurther != FLT_MAX) {
+			stack[top] = further;
+			stackT[top++] = tFurther;
+		}
+		if (tCloser != FLT_MAX) {
+			stack[top] = closer;
+			stackT[top++] = tCloser;
+		}
+	}
+}
+
+} // namespace
+
+void collect_triangles(const gfx::CommandList& list, std::vector<float>& out) {
+	gfx::Replay replay;
+	replay.replay(list);
+	for (size_t b = 0; b < replay.batches.size(); b++) {
+		const gfx::Batch& batch = replay.batches[b];
+		if (batch.state.mode != GL_TRIANGLES || batch.state.blend || batch.state.shading == gfx::SHADE_TEXT) continue;
+		for (GLsizei i = 0; i < batch.count; i++) {
+			const float* p = replay.vertices[batch.first + i].position;
+			out.insert(out.end(), p, p + 3);
+		}
+	}
+}
+
+void Mesh::build(const std::vector<float>& triangles) {
+	size_t n = triangles.size() / 9;
+	std::vector<Box> boxes(n);
+	for (size_t i = 0; i < n; i++) {
+		boxes[i] = empty_box();
+		for (int c = 0; c < 3; c++) grow(boxes[i], &triangles[i * 9 + c * 3], &triangles[i * 9 + c * 3]);
+	}
+	std::vector<uint32_t> order;
+	build_tree(boxes, nodes, order);
+
+	tris.resize(n);
+	for (size_t i = 0; i < n; i++) {
+		const float* c = &triangles[order[i] * 9];
+		for (int a = 0; a < 3; a++) {
+			tris[i].v0[a] = c[a];
+			tris[i].e1[a] = c[3 + a] - c[a];
+			tris[i].e2[a] = c[6 + a] - c[a];
+		}
+	}
+}
+
+bool Mesh::intersect(const gfx::Ray& ray, float& t, bool any) const {
+	bool hit = false;
+	traverse(nodes, ray, t, [&](uint32_t first, uint32_t count, float& best) -> bool {
+		const float* o = ray.origin;
+		const float* d = ray.dir;
+		for (uint32_t k = first; k < first + count; k++) {
+			// Moller-Trumbore
+			const Triangle& tri = tris[k];
+			float p[3] = {d[1] * tri.e2[2] - d[2] * tri.e2[1], d[2] * tri.e2[0] - d[0] * tri.e2[2],
+			              d[0] * tri.e2[1] - d[1] * tri.e2[0]};
+			float det = tri.e1[0] * p[0] + tri.e1[1] * p[1] + tri.e1[2] * p[2];
+			if (std::fabs(det) < 1e-12f) continue; // Parallel
+			float invDet = 1.0f / det;
+			float s[3] = {o[0] - tri.v0[0], o[1] - tri.v0[1], o[2] - tri.v0[2]};
+			float u = (s[0] * p[0] + s[1] * p[1] + s[2] * p[2]) * invDet;
+			if (u < 0.0f || u > 1.0f) continue;
+			float q[3] = {s[1] * tri.e1[2] - s[2] * tri.e1[1], s[2] * tri.e1[0] - s[0] * tri.e1[2],
+			              s[0] * tri.e1[1] - s[1] * tri.e1[0]};
+			float v = (d[0] * q[0] + d[1] * q[1] + d[2] * q[2]) * invDet;
+			if (v < 0.0f || u + v > 1.0f) continue;
+			float along = (tri.e2[0] * q[0] + tri.e2[1] * q[1] + tri.e2[2] * q[2]) * invDet;
+			if (along > 0.0f && along < best) {
+				best = along;
+				hit = true;
+				if (any) return true;
+			}
+		}
+		return false;
+	});
+	return hit;
+}
+
+void Mesh::bounds(float min[3], float max[3]) const {
+	Box b = empty_box();
+	if (!nodes.empty()) grow(b, nodes[0].min, nodes[0].max);
+	std::copy(b.min, b.min + 3, min);
+	std::copy(b.max, b.max + 3, max);
+}
+
+int Scene::add(const Mesh* mesh, int id) {
+	Instance instance = {mesh, id, {0.0f, 0.0f, 0.0f}, true};
+	instances.push_back(instance);
+	built = false;
+	return (int)instances.size() - 1;
+}
+
+void Scene::move(int instance, float x, float y, float z) {
+	instances[instance].offset[0] = x;
+	instances[instance].offset[1] = y;
+	instances[instance].offset[2] = z;
+}
+
+void Scene::set_visible(int instance, bool visible) { instances[instance].visible = visible; }
+
+void Scene::instance_bounds(const Instance& instance, float min[3], float max[3]) const {
+	instance.mesh->bounds(min, max);
+	if (min[0] > max[0]) return;
+	for (int a = 0; a < 3; a++) {
+		min[a] += instance.offset[a];
+		max[a] += instance.offset[a];
+	}
+}
+
+void Scene::update() {
+	if (!built) {
+		// Split by where the instances are now, hidden or not: the tree's
+		// shape only decides how fast it is, refitting keeps it correct.
+		std::vector<Box> boxes(instances.size());
+		for (size_t i = 0; i < instances.size(); i++) instance_bounds(instances[i], boxes[i].min, boxes[i].max);
+		build_tree(boxes, nodes, order);
+		built = true;
+	}
+	// Children come after their parent, so walking back up refits
+	// every child before the parent reads it.
+	for (size_t i = nodes.size(); i-- > 0;) {
+		Node& node = nodes[i];
+		Box b = empty_box();
+		if (node.count > 0) {
+			for (uint32_t k = node.first; k < node.first + node.count; k++) {
+				const Instance& instance = instances[order[k]];
+				if (!instance.visible) continue;
+				float min[3], max[3];
+				instance_bounds(instance, min, max);
+				grow(b, min, max);
+			}
+		} else {
+			grow(b, nodes[node.first].min, nodes[node.first].max);
+			grow(b, nodes[node.first + 1].min, nodes[node.first + 1].max);
+		}
+		std::copy(b.min, b.min + 3, node.min);
+		std::copy(b.max, b.max + 3, node.max);
+	}
+}
+
+Hit Scene::intersect(const gfx::Ray& ray) const {
+	Hit hit = {-1, 0, FLT_MAX};
+	traverse(nodes, ray, hit.t, [&](uint32_t first, uint32_t count, float& best) -> bool {
+		for (uint32_t k = first; k < first + count; k++) {
+			const Instance& instance = instances[order[k]];
+			if (!instance.visible) continue;
+			// Instances only translate: move the ray instead of the mesh.
+			gfx::Ray local = ray;
+			for (int a = 0; a < 3; a++) local.origin[a] -= instance.offset[a];
+			if (instance.mesh->intersect(local, best)) {
+				hit.instance = (int)order[k];
+				hit.id = instance.id;
+			}
+		}
+		return false;
+	});
+	return hit;
+}
+
+bool Scene::visible(int i, const float eye[3]) const {
+	const Instance& instance = instances[i];
+	if (!instance.visible) return false;
+	float min[3], max[3];
+	instance_bounds(instance, min, max);
+	if (min[0] > max[0]) return false;
+	// The centre, then the corners of the box shrunk to half its size: the
+	// real corners are often empty space beside the object.
+	for (int s = 8; s >= 0; s--) {
+		gfx::Ray ray;
+		float dist = 0.0f;
+		for (int a = 0; a < 3; a++) {
+			float half = s == 8 ? 0.0f : ((s >> a) & 1 ? 0.25f : -0.25f) * (max[a] - min[a]);
+			ray.origin[a] = eye[a];
+			ray.dir[a] = 0.5f * (min[a] + max[a]) + half - eye[a];
+			dist += ray.dir[a] * ray.dir[a];
+		}
+		dist = std::sqrt(dist);
+		if (dist < 1e-6f) return true;
+		for (int a = 0; a < 3; a++) ray.dir[a] /= dist;
+		// Seen if no other instance is hit before the point, or before the
+		// instance itself where the ray meets it first
+		gfx::Ray local = ray;
+		for (int a = 0; a < 3; a++) local.origin[a] -= instance.offset[a];
+		instance.mesh->intersect(local, dist);
+		if (!blocked(ray, dist, i)) return true;
+	}
+	return false;
+}
+
+bool Scene::blocked(const gfx::Ray& ray, float t, int skip) const {
+	bool hit = false;
+	traverse(nodes, ray, t, [&](uint32_t first, uint32_t count, float& best) -> bool {
+		for (uint32_t k = first; k < first + count; k++) {
+			const Instance& instance = instances[order[k]];
+			if (!instance.visible || (int)order[k] == skip) continue;
+			gfx::Ray local = ray;
+			for (int a = 0; a < 3; a++) local.origin[a] -= instance.offset[a];
+			if (instance.mesh->intersect(local, best, true)) {
+				hit = true;
+				return true;
+			}
+		}
+		return false;
+	});
+	return hit;
+}
+
+} // namespace bvh
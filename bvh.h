@@ -0,0 +1,102 @@
+#pragma once
+
+#include "camera.h"
+#include "gfx.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace bvh {
+
+// Bounding volume hierarchies for picking exactly what is under the mouse.
+// A Mesh is built once over one object's triangles, split wherever the
+// surface area heuristic (SAH) expects the cheapest ray test. A Scene holds
+// instances of meshes that only ever move by a translation, which is how the
+// CPU parts come apart, so it builds its own tree once and then just refits
+// the bounds. Both keep their tree flattened in one node array, children
+// after their parent.
+
+struct Node {
+	float min[3];
+	uint32_t first; // Leaf: first primitive. Otherwise the left child; the right one follows it
+	float max[3];
+	uint32_t count; // Primitives in a leaf, 0 otherwise
+};
+
+// Opaque triangles 'list' draws, in the space it starts in, 9 floats (three
+// corners) each. Blended triangles (glass), text, lines and points are left
+// out: none of them hide what is behind.
+void collect_triangles(const gfx::CommandList& list, std::vector<float>& out);
+
+class Mesh {
+public:
+	// 'triangles' as from collect_triangles().
+	void build(const std::vector<float>& triangles);
+
+	// Nearest hit along 'ray' closer than 't', which it then replaces.
+	// Triangles count from both sides. With 'any' it stops at the first hit
+	// closer than 't' instead, which is all an occlusion test needs.
+	bool intersect(const gfx::Ray& ray, float& t, bool any = false) const;
+
+	// Empty (min > max) for a mesh without triangles.
+	void bounds(float min[3], float max[3]) const;
+	size_t triangle_count() const { return tris.size(); }
+	size_t node_count() const { return nodes.size(); }
+
+private:
+	struct Triangle {
+		float v0[3], e1[3], e2[3]; // A corner and the edges to the other two
+	};
+
+	std::vector<Node> nodes;
+	std::vector<Triangle> tris; // In leaf order
+};
+
+struct Hit {
+	int instance; // -1 if nothing was hit
+	int id;       // As given to Scene::add()
+	float t;      // Distance along the ray
+};
+
+class Scene {
+public:
+	// Adds an instance of 'mesh', which must outlive the scene, at offset
+	// zero and visible. Returns its index.
+	int add(const Mesh* mesh, int id);
+	void move(int instance, float x, float y, float z);
+	void set_visible(int instance, bool visible);
+
+	// Brings the tree up to date after add() / move() / set_visible():
+	// the first call builds it, later ones refit its bounds.
+	void update();
+
+	// First visible instance along 'ray'.
+	Hit intersect(const gfx::Ray& ray) const;
+
+	// Whether any of a few points across 'instance's bounds can be seen from
+	// 'eye' past the other instances: an occlusion query on its box, answered
+	// on the CPU. False for a hidden instance.
+	bool visible(int instance, const float eye[3]) const;
+
+	size_t size() const { return instances.size(); }
+
+private:
+	struct Instance {
+		const Mesh* mesh;
+		int id;
+		float offset[3];
+		bool visible;
+	};
+
+	std::vector<Instance> instances;
+	std::vector<Node> nodes;
+	std::vector<uint32_t> order; // Instance indices in leaf order
+	bool built = false;
+
+	void instance_bounds(const Instance& instance, float min[3], float max[3]) const;
+	// Whether 'ray' hits any visible instance but 'skip' before 't'.
+	bool blocked(const gfx::Ray& ray, float t, int skip) const;
+};
+
+} // namespace bvh
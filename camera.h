@@ -0,0 +1,85 @@
+#pragma once
+
+#include "matrix.h"
+
+#include <cmath>
+
+namespace gfx {
+
+// A ray in world space; 'dir' has unit length.
+struct Ray {
+	float origin[3];
+	float dir[3];
+};
+
+// The scene camera's matrices and viewport, kept on the CPU next to the
+// look_at() / resize() calls that hand the same parameters to the renderer.
+// Picking reads these instead of asking GL (glGetDoublev / glGetIntegerv
+// stall the pipeline on many drivers) or the renderer for the state it was
+// last left in.
+struct Camera {
+	mat4 view = mat4_identity();
+	mat4 projection = mat4_identity();
+	int viewport[4] = {0, 0, 1, 1};
+
+	// As gfx::resize().
+	void resize(int w, int h, float fovY, float zNear, float zFar) {
+		viewport[0] = 0;
+		viewport[1] = 0;
+		viewport[2] = w > 0 ? w : 1;
+		viewport[3] = h > 0 ? h : 1;
+		projection = mat4_perspective(fovY, (float)viewport[2] / (float)viewport[3], zNear, zFar);
+	}
+
+	// As gfx::look_at() on an identity modelview.
+	void look_at(float eyeX, float eyeY, float eyeZ, float centerX, float centerY, float centerZ) {
+		view = mat4_look_at(eyeX, eyeY, eyeZ, centerX, centerY, centerZ);
+	}
+
+	// The eye in world space: -R^T * t for the view's rotation R and
+	// translation t.
+	void position(float out[3]) const {
+		for (int i = 0; i < 3; i++)
+			out[i] = -(view(0, i) * view(0, 3) + view(1, i) * view(1, 3) + view(2, i) * view(2, 3));
+	}
+
+	// Window position of world point 'p', origin bottom left as GL's (so
+	// not as the mouse's). False if it is behind the camera.
+	bool project(const float p[3], float out[2]) const {
+		const float world[4] = {p[0], p[1], p[2], 1.0f};
+		float eye[4], clip[4];
+		mat4_transform(view, world, eye);
+		mat4_transform(projection, eye, clip);
+		if (clip[3] <= 0.0f) return false;
+		out[0] = viewport[0] + (clip[0] / clip[3] + 1.0f) * 0.5f * viewport[2];
+		out[1] = viewport[1] + (clip[1] / clip[3] + 1.0f) * 0.5f * viewport[3];
+		return true;
+	}
+
+	// Ray through window position (x, y), y down as GLUT reports the mouse.
+	// It starts on the near plane, so it is what gluUnProject gives at
+	// depth 0 and 1, without inverting a matrix: the projection is a
+	// perspective and the view a rotation plus a translation.
+	Ray ray(float x, float y) const {
+		float ndcX = 2.0f * (x - viewport[0]) / viewport[2] - 1.0f;
+		float ndcY = 2.0f * (viewport[3] - y - viewport[1]) / viewport[3] - 1.0f;
+		// Eye space point on the near plane (z = -zNear) under the pointer
+		float zNear = projection(2, 3) / (projection(2, 2) - 1.0f);
+		float eye[3] = {ndcX * zNear / projection(0, 0), ndcY * zNear / projection(1, 1), -zNear};
+
+		// Back to world space with the transposed rotation
+		Ray r;
+		position(r.origin);
+		float len = 0.0f;
+		for (int i = 0; i < 3; i++) {
+			r.dir[i] = view(0, i) * eye[0] + view(1, i) * eye[1] + view(2, i) * eye[2];
+			r.origin[i] += r.dir[i];
+			len += r.dir[i] * r.dir[i];
+		}
+		len = std::sqrt(len);
+		for (int i = 0; i < 3; i++) r.dir[i] /= len;
+		return r;
+	}
+};
+
+} // namespace gfx
@@ -0,0 +1,514 @@
+#include "capture.h"
+
+#include "gfx_soft.h"
+#include "trace.h"
+
+#ifndef __APPLE__
+#include <GL/glext.h>
+#endif
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace capture {
+
+namespace {
+
+// Buffer-object entry points (GL 1.5 / 2.1), resolved in start().
+#ifndef __APPLE__
+#define CAPTURE_FUNCTIONS(X) \
+	X(PFNGLBINDBUFFERPROC, glBindBuffer) \
+	X(PFNGLBUFFERDATAPROC, glBufferData) \
+	X(PFNGLDELETEBUFFERSPROC, glDeleteBuffers) \
+	X(PFNGLGENBUFFERSPROC, glGenBuffers) \
+	X(PFNGLMAPBUFFERPROC, glMapBuffer) \
+	X(PFNGLUNMAPBUFFERPROC, glUnmapBuffer)
+
+#define CAPTURE_DECLARE(type, name) static type name = nullptr;
+CAPTURE_FUNCTIONS(CAPTURE_DECLARE)
+#undef CAPTURE_DECLARE
+#endif
+
+enum Format { FORMAT_PNG, FORMAT_QOI, FORMAT_Y4M };
+
+const int RING_SIZE = 3;   // Pixel buffers in flight
+const int READ_LAG = 2;    // Frames between a readback and its map
+const size_t MAX_QUEUED = 8; // Frames waiting for the encoder before the GL thread waits
+
+struct Frame {
+	unsigned long index;
+	int w, h;
+	std::vector<unsigned char> rgba; // Bottom row first, as glReadPixels
+};
+
+struct Slot {
+	GLuint pbo = 0;
+	int w = 0, h = 0;
+	size_t capacity = 0;
+	bool pending = false;
+	unsigned long index = 0;
+};
+
+static bool g_active = false;
+static Format g_format = FORMAT_QOI;
+static std::string g_path;
+static std::string g_prefix, g_suffix; // Per-frame paths: around the number
+static int g_digits = 5;               // Zero padded to this many
+static int g_fps = 60;
+static bool g_readback = true; // False: software renderer, copy its framebuffer
+static Slot g_ring[RING_SIZE];
+static int g_width = 0, g_height = 0; // Of the window, from resize()
+static unsigned long g_frames = 0;
+
+// Encoder hand-over
+static std::thread g_encoder;
+static std::mutex g_lock;
+static std::condition_variable g_wakeEncoder, g_wakeGL;
+static std::deque<Frame*> g_queue; // To encode, in order
+static std::vector<Frame*> g_free; // Buffers to reuse
+static bool g_quit = false;
+
+// Stats
+static unsigned long g_written = 0, g_stalls = 0, g_skipped = 0;
+static double g_encodeMs = 0.0;
+
+// ENCODERS (encoder thread)
+
+static void put_be32(std::vector<unsigned char>& out, unsigned int v) {
+	out.push_back(v >> 24 & 0xff);
+	out.push_back(v >> 16 & 0xff);
+	out.push_back(v >> 8 & 0xff);
+	out.push_back(v & 0xff);
+}
+
+static unsigned int crc32(const unsigned char* data, size_t n, unsigned int crc = 0) {
+	static unsigned int table[256];
+	static bool ready = false; // Only ever touched by the encoder thread
+	if (!ready) {
+		for (unsigned int i = 0; i < 256; i++) {
+			unsigned int c = i;
+			for (int k = 0; k < 8; k++) c = c & 1 ? 0xedb88320u ^ (c >> 1) : c >> 1;
+			table[i] = c;
+		}
+		ready = true;
+	}
+	crc = ~crc;
+	for (size_t i = 0; i < n; i++) crc = table[(crc ^ data[i]) & 0xff] ^ (crc >> 8);
+	return ~crc;
+}
+
+static void png_chunk(std::vector<unsigned char>& out, const char* type, const unsigned char* data, size_t n) {
+	put_be32(out, (unsigned int)n);
+	size_t start = out.size();
+	out.insert(out.end(), type, type + 4);
+	out.insert(out.end(), data, data + n);
+	put_be32(out, crc32(&out[start], n + 4));
+}
+
+// RGB PNG with stored (uncompressed) deflate blocks: no zlib needed and
+// nearly as fast as a memcpy.
+static void encode_png(const Frame& f, std::vector<unsigned char>& out) {
+	static const unsigned char signature[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n'};
+	out.insert(out.end(), signature, signature + 8);
+	std::vector<unsigned char> ihdr;
+	put_be32(ihdr, (unsigned int)f.w);
+	put_be32(ihdr, (unsigned int)f.h);
+	const unsigned char rest[5] = {8, 2, 0, 0, 0}; // 8 bit RGB, no interlace
+	ihdr.insert(ihdr.end(), rest, rest + 5);
+	png_chunk(out, "IHDR", ihdr.data(), ihdr.size());
+
+	// Scanlines top first, each behind filter byte 0.
+	std::vector<unsigned char> raw;
+	raw.reserve((size_t)f.h * (f.w * 3 + 1));
+	for (int y = f.h - 1; y >= 0; y--) {
+		raw.push_back(0);
+		const unsigned char* row = &f.rgba[(size_t)y * f.w * 4];
+		for (int x = 0; x < f.w; x++) raw.insert(raw.end(), row + x * 4, row + x * 4 + 3);
+	}
+	std::vector<unsigned char> z;
+	z.reserve(raw.size() + raw.size() / 65535 * 5 + 16);
+	z.push_back(0x78);
+	z.push_back(0x01);
+	unsigned int a = 1, b = 0;
+	for (size_t pos = 0; pos < raw.size() || pos == 0;) {
+		size_t n = std::min(raw.size() - pos, (size_t)65535);
+		bool last = pos + n == raw.size();
+		z.push_back(last ? 1 : 0);
+		z.push_back(n & 0xff);
+		z.push_back(n >> 8 & 0xff);
+		z.push_back(~n & 0xff);
+		z.push_back(~n >> 8 & 0xff);
+		z.insert(z.end(), raw.begin() + pos, raw.begin() + pos + n);
+		// Adler-32, reduced every 5552 bytes (the most that can't overflow)
+		for (size_t i = pos; i < pos + n;) {
+			size_t end = std::min(pos + n, i + 5552);
+			for (; i < end; i++) {
+				a += raw[i];
+				b += a;
+			}
+			a %= 65521;
+			b %= 65521;
+		}
+		pos += n;
+		if (last) break;
+	}
+	put_be32(z, b << 16 | a);
+	png_chunk(out, "IDAT", z.data(), z.size());
+	png_chunk(out, "IEND", nullptr, 0);
+}
+
+// "Quite OK Image" format, RGB (qoiformat.org).
+static void encode_qoi(const Frame& f, std::vector<unsigned char>& out) {
+	const unsigned char header[4] = {'q', 'o', 'i', 'f'};
+	out.insert(out.end(), header, header + 4);
+	put_be32(out, (unsigned int)f.w);
+	put_be32(out, (unsigned int)f.h);
+	out.push_back(3); // RGB
+	out.push_back(0); // sRGB
+
+	unsigned char index[64][4];
+	std::memset(index, 0, sizeof(index));
+	unsigned char prev[4] = {0, 0, 0, 255};
+	int run = 0;
+	for (int y = f.h - 1; y >= 0; y--) {
+		const unsigned char* row = &f.rgba[(size_t)y * f.w * 4];
+		for (int x = 0; x < f.w; x++) {
+			const unsigned char px[4] = {row[x * 4], row[x * 4 + 1], row[x * 4 + 2], 255};
+			if (std::memcmp(px, prev, 4) == 0) {
+				if (++run == 62) {
+					out.push_back(0xc0 | (run - 1));
+					run = 0;
+				}
+				continue;
+			}
+			if (run > 0) {
+				out.push_back(0xc0 | (run - 1));
+				run = 0;
+			}
+			int hash = (px[0] * 3 + px[1] * 5 + px[2] * 7 + px[3] * 11) % 64;
+			if (std::memcmp(index[hash], px, 4) == 0) {
+				out.push_back((unsigned char)hash);
+			} else {
+				std::memcpy(index[hash], px, 4);
+				signed char dr = (signed char)(px[0] - prev[0]);
+				signed char dg = (signed char)(px[1] - prev[1]);
+				signed char db = (signed char)(px[2] - prev[2]);
+				signed char drg = (signed char)(dr - dg), dbg = (signed char)(db - dg);
+				if (dr >= -2 && dr <= 1 && dg >= -2 && dg <= 1 && db >= -2 && db <= 1) {
+					out.push_back(0x40 | (dr + 2) << 4 | (dg + 2) << 2 | (db + 2));
+				} else if (dg >= -32 && dg <= 31 && drg >= -8 && drg <= 7 && dbg >= -8 && dbg <= 7) {
+					out.push_back(0x80 | (dg + 32));
+					out.push_back((drg + 8) << 4 | (dbg + 8));
+				} else {
+					out.push_back(0xfe);
+					out.insert(out.end(), px, px + 3);
+				}
+			}
+			std::memcpy(prev, px, 4);
+		}
+	}
+	if (run > 0) out.push_back(0xc0 | (run - 1));
+	const unsigned char end[8] = {0, 0, 0, 0, 0, 0, 0, 1};
+	out.insert(out.end(), end, end + 8);
+}
+
+// One YUV 4:2:0 frame, BT.601 full range (Y4M "C420jpeg").
+static void encode_y4m_frame(const Frame& f, std::vector<unsigned char>& out) {
+	const char tag[] = "FRAME\n";
+	out.insert(out.end(), tag, tag + 6);
+	int cw = (f.w + 1) / 2, ch = (f.h + 1) / 2;
+	size_t ySize = (size_t)f.w * f.h;
+	size_t base = out.size();
+	out.resize(base + ySize + 2 * (size_t)cw * ch);
+	unsigned char* yPlane = &out[base];
+	unsigned char* uPlane = yPlane + ySize;
+	unsigned char* vPlane = uPlane + (size_t)cw * ch;
+
+	for (int y = 0; y < f.h; y++) {
+		const unsigned char* row = &f.rgba[(size_t)(f.h - 1 - y) * f.w * 4];
+		for (int x = 0; x < f.w; x++) {
+			const unsigned char* p = row + x * 4;
+			yPlane[(size_t)y * f.w + x] = (unsigned char)((77 * p[0] + 150 * p[1] + 29 * p[2] + 128) >> 8);
+		}
+	}
+	for (int cy = 0; cy < ch; cy++) {
+		for (int cx = 0; cx < cw; cx++) {
+			int r = 0, g = 0, b = 0, n = 0;
+			for (int dy = 0; dy < 2; dy++) {
+				int y = std::min(cy * 2 + dy, f.h - 1);
+				const unsigned char* row = &f.rgba[(size_t)(f.h - 1 - y) * f.w * 4];
+				for (int dx = 0; dx < 2; dx++) {
+					const unsigned char* p = row + std::min(cx * 2 + dx, f.w - 1) * 4;
+					r += p[0];
+					g += p[1];
+					b += p[2];
+					n++;
+				}
+			}
+			r /= n;
+			g /= n;
+			b /= n;
+			uPlane[(size_t)cy * cw + cx] = (unsigned char)std::min(255, (-43 * r - 85 * g + 128 * b + 32768 + 128) >> 8);
+			vPlane[(size_t)cy * cw + cx] = (unsigned char)std::min(255, (128 * r - 107 * g - 21 * b + 32768 + 128) >> 8);
+		}
+	}
+}
+
+// Splits g_path around where the frame number goes: its one %d / %0Nd, or
+// before the extension. The path never reaches printf as a format, so a
+// stray conversion (%s, %n) is an error, not undefined behaviour.
+static bool split_path() {
+	size_t at = g_path.find('%');
+	if (at == std::string::npos) {
+		size_t dot = g_path.rfind('.');
+		g_prefix = g_path.substr(0, dot);
+		g_suffix = g_path.substr(dot);
+		g_digits = 5;
+		return true;
+	}
+	size_t end = at + 1;
+	g_digits = 0;
+	if (end < g_path.size() && g_path[end] == '0') {
+		end++;
+		while (end < g_path.size() && g_path[end] >= '0' && g_path[end] <= '9' && g_digits < 20) {
+			g_digits = g_digits * 10 + (g_path[end++] - '0');
+		}
+		if (g_digits == 0) return false;
+	}
+	if (end >= g_path.size() || g_path[end] != 'd') return false;
+	g_prefix = g_path.substr(0, at);
+	g_suffix = g_path.substr(end + 1);
+	return g_prefix.find('%') == std::string::npos && g_suffix.find('%') == std::string::npos;
+}
+
+static std::string frame_path(unsigned long index) {
+	char name[1024];
+	std::snprintf(name, sizeof(name), "%s%0*lu%s", g_prefix.c_str(), g_digits, index, g_suffix.c_str());
+	return name;
+}
+
+static void encoder_main() {
+	trace::name_thread("capture encoder");
+	std::vector<unsigned char> out;
+	FILE* stream = nullptr;
+	int streamW = 0, streamH = 0;
+	while (true) {
+		Frame* f;
+		{
+			std::unique_lock<std::mutex> guard(g_lock);
+			g_wakeEncoder.wait(guard, [] { return g_quit || !g_queue.empty(); });
+			if (g_queue.empty()) break; // Quit, and everything written
+			f = g_queue.front();
+			g_queue.pop_front();
+		}
+
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		out.clear();
+		bool written = false;
+		if (g_format == FORMAT_Y4M) {
+			if (!stream) {
+				stream = std::fopen(g_path.c_str(), "wb");
+				streamW = f->w;
+				streamH = f->h;
+				if (stream) std::fprintf(stream, "YUV4MPEG2 W%d H%d F%d:1 Ip A1:1 C420jpeg\n", streamW, streamH, g_fps);
+			}
+			if (stream && f->w == streamW && f->h == streamH) {
+				encode_y4m_frame(*f, out);
+				written = std::fwrite(out.data(), 1, out.size(), stream) == out.size();
+			}
+		} else {
+			if (g_format == FORMAT_PNG) encode_png(*f, out);
+			else encode_qoi(*f, out);
+			FILE* file = std::fopen(frame_path(f->index).c_str(), "wb");
+			if (file) {
+				written = std::fwrite(out.data(), 1, out.size(), file) == out.size();
+				std::fclose(file);
+			}
+		}
+		double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+		{
+			std::lock_guard<std::mutex> guard(g_lock);
+			g_encodeMs += ms;
+			if (written) g_written++;
+			else g_skipped++;
+			g_free.push_back(f);
+		}
+		g_wakeGL.notify_one();
+	}
+	if (stream) std::fclose(stream);
+}
+
+// GL THREAD
+
+// A buffer for 'w' x 'h' pixels, waiting while the encoder is too far
+// behind: dropping frames would leave holes in the sequence.
+static Frame* acquire_frame(int w, int h) {
+	std::unique_lock<std::mutex> guard(g_lock);
+	if (g_queue.size() >= MAX_QUEUED) {
+		g_stalls++;
+		g_wakeGL.wait(guard, [] { return g_queue.size() < MAX_QUEUED; });
+	}
+	Frame* f;
+	if (g_free.empty()) {
+		f = new Frame();
+	} else {
+		f = g_free.back();
+		g_free.pop_back();
+	}
+	f->w = w;
+	f->h = h;
+	f->rgba.resize((size_t)w * h * 4);
+	return f;
+}
+
+static void enqueue(Frame* f) {
+	{
+		std::lock_guard<std::mutex> guard(g_lock);
+		g_queue.push_back(f);
+	}
+	g_wakeEncoder.notify_one();
+}
+
+// Hands the frame read into 'slot' to the encoder.
+static void collect(Slot& slot) {
+	if (!slot.pending) return;
+	slot.pending = false;
+	Frame* f = acquire_frame(slot.w, slot.h);
+	f->index = slot.index;
+	glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.pbo);
+	const void* pixels = glMapBuffer(GL_PIXEL_PACK_BUFFER, GL_READ_ONLY);
+	if (pixels) {
+		std::memcpy(f->rgba.data(), pixels, f->rgba.size());
+		glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+	}
+	glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+	enqueue(f);
+}
+
+static bool load_functions(gfx::ProcLoader loader) {
+#ifdef __APPLE__
+	(void)loader;
+	return true;
+#else
+	bool ok = loader != nullptr;
+#define CAPTURE_LOAD(type, name) \
+	name = ok ? (type)loader(#name) : nullptr; \
+	ok = ok && name;
+	CAPTURE_FUNCTIONS(CAPTURE_LOAD)
+#undef CAPTURE_LOAD
+	return ok;
+#endif
+}
+
+static bool ends_with(const std::string& s, const char* suffix) {
+	size_t n = std::strlen(suffix);
+	return s.size() >= n && s.compare(s.size() - n, n, suffix) == 0;
+}
+
+} // namespace
+
+bool start(const char* path, int fps, gfx::ProcLoader loader) {
+	g_path = path;
+	if (ends_with(g_path, ".png")) g_format = FORMAT_PNG;
+	else if (ends_with(g_path, ".qoi")) g_format = FORMAT_QOI;
+	else if (ends_with(g_path, ".y4m")) g_format = FORMAT_Y4M;
+	else {
+		std::fprintf(stderr, "capture: '%s' should end in .png, .qoi or .y4m\n", path);
+		return false;
+	}
+	if (g_format != FORMAT_Y4M && !split_path()) {
+		std::fprintf(stderr, "capture: '%s' should hold one %%d or %%0Nd for the frame number, and no other %%\n", path);
+		return false;
+	}
+	g_fps = fps > 0 ? fps : 60;
+	g_readback = gfx::renderer() != gfx::RENDERER_SOFTWARE;
+	if (g_readback) {
+		if (!load_functions(loader)) {
+			std::fprintf(stderr, "capture: no pixel buffer objects on this context\n");
+			return false;
+		}
+		for (int i = 0; i < RING_SIZE; i++) glGenBuffers(1, &g_ring[i].pbo);
+	}
+	g_frames = g_written = g_stalls = g_skipped = 0;
+	g_encodeMs = 0.0;
+	g_quit = false;
+	g_encoder = std::thread(encoder_main);
+	g_active = true;
+	return true;
+}
+
+void resize(int w, int h) {
+	g_width = w;
+	g_height = h;
+}
+
+void frame() {
+	if (!g_active) return;
+	unsigned long index = g_frames++;
+
+	if (!g_readback) {
+		const gfx::soft::Framebuffer& fb = gfx::soft::framebuffer();
+		Frame* f = acquire_frame(fb.width, fb.height);
+		f->index = index;
+		std::memcpy(f->rgba.data(), fb.color.data(), f->rgba.size());
+		enqueue(f);
+		return;
+	}
+
+	Slot& slot = g_ring[index % RING_SIZE];
+	collect(slot); // Only if the ring is shallower than the lag
+	slot.w = g_width;
+	slot.h = g_height;
+	slot.index = index;
+	size_t bytes = (size_t)slot.w * slot.h * 4;
+	glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.pbo);
+	if (bytes > slot.capacity) {
+		glBufferData(GL_PIXEL_PACK_BUFFER, bytes, nullptr, GL_STREAM_READ);
+		slot.capacity = bytes;
+	}
+	glPixelStorei(GL_PACK_ALIGNMENT, 4);
+	glReadPixels(0, 0, slot.w, slot.h, GL_RGBA, GL_UNSIGNED_BYTE, nullptr); // Queued, returns at once
+	glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+	slot.pending = true;
+
+	if (index >= (unsigned long)READ_LAG) collect(g_ring[(index - READ_LAG) % RING_SIZE]);
+}
+
+void stop() {
+	if (!g_active) return;
+	if (g_readback) {
+		// The last READ_LAG frames are still in their buffers, oldest first.
+		for (unsigned long i = g_frames > (unsigned long)READ_LAG ? g_frames - READ_LAG : 0; i < g_frames; i++) {
+			collect(g_ring[i % RING_SIZE]);
+		}
+		for (int i = 0; i < RING_SIZE; i++) {
+			glDeleteBuffers(1, &g_ring[i].pbo);
+			g_ring[i] = Slot();
+		}
+	}
+	{
+		std::lock_guard<std::mutex> guard(g_lock);
+		g_quit = true;
+	}
+	g_wakeEncoder.notify_one();
+	g_encoder.join();
+	for (size_t i = 0; i < g_free.size(); i++) delete g_free[i];
+	g_free.clear();
+	g_active = false;
+
+	std::printf("capture: %lu frames to %s, %lu not written, GL thread waited %lu times, %.2f ms encode/frame\n",
+	            g_written, g_path.c_str(), g_skipped, g_stalls, g_frames ? g_encodeMs / g_frames : 0.0);
+}
+
+bool active() { return g_active; }
+
+} // namespace capture
@@ -0,0 +1,38 @@
+#pragma once
+
+#include "gfx.h"
+
+namespace capture {
+
+// Frame capture to disk without stalling the GL thread. Each frame is read
+// back into one of a ring of pixel buffer objects and only mapped two
+// frames later, when the copy is long done; a background thread then
+// encodes and writes it. The software renderer's frames are already in
+// memory and skip the readback.
+//
+// The output format follows the extension of 'path':
+//   .png  uncompressed PNG per frame   (fast to write, big)
+//   .qoi  QOI per frame                (about PNG sized, far faster)
+//   .y4m  one raw YUV 4:2:0 stream     (ffmpeg / video players)
+// Per-frame paths take the frame number where the path has a %d or %0Nd
+// (its only %): "shots/frame%05d.qoi". Without one it goes before the
+// extension, five digits wide.
+
+// Call on the GL thread with the context current. 'fps' is written into
+// Y4M headers. False (with a message) for an unknown format.
+bool start(const char* path, int fps, gfx::ProcLoader loader);
+
+// The window's size, with gfx::resize(): what frame() reads back, without
+// asking GL for the viewport every frame. Any time, started or not.
+void resize(int w, int h);
+
+// After a frame is drawn, before the swap. No-op unless started.
+void frame();
+
+// Writes out the frames still in flight, stops the encoder thread and
+// prints what was captured. Call on the GL thread.
+void stop();
+
+bool active();
+
+} // namespace capture
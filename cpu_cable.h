@@ -1,6 +1,8 @@
 #ifndef CPU_CABLE
 #define CPU_CABLE
 
+#include "frame_snapshot.h"
+#include "gfx.h"
 #include "gl_includes.h"
 #include "parameter.h"
 
@@ -11,142 +13,153 @@ class cable {
   void desktop_power_cable();
 
 public:
-  void render();
+  PartPose pose() const;
+  void update();
+  void render(const PartPose &);
 };
 
 void cable::desktop_power_cable() {
 
-  glPushMatrix();
-  glTranslatef(3.45, 2.8, -8.8);
-  glColor3f(0.05, 0.05, 0.05);
-  glLineWidth(8.0);
-  glBegin(GL_LINES);
-  glVertex3f(0., 1., 0.);
-  glVertex3f(0., 0., 0.);
-  glEnd();
-  glPopMatrix();
+  gfx::push_matrix();
+  gfx::translatef(3.45, 2.8, -8.8);
+  gfx::color3f(0.05, 0.05, 0.05);
+  gfx::line_width(8.0);
+  gfx::begin(GL_LINES);
+  gfx::vertex3f(0., 1., 0.);
+  gfx::vertex3f(0., 0., 0.);
+  gfx::end();
+  gfx::pop_matrix();
 }
 
 void cable::draw_cpu_power() {
-  glPushMatrix();
-  glTranslatef(7.35, 2.6, -5.2);
-  glRotatef(90., 0., 1., 0.);
-  glScalef(.3, 0.5, .6);
-  glColor3f(0.05, 0.05, 0.05);
-  glLineWidth(8.0);
-  glBegin(GL_LINE_STRIP);
+  gfx::push_matrix();
+  gfx::translatef(7.35, 2.6, -5.2);
+  gfx::rotatef(90., 0., 1., 0.);
+  gfx::scalef(.3, 0.5, .6);
+  gfx::color3f(0.05, 0.05, 0.05);
+  gfx::line_width(8.0);
+  gfx::begin(GL_LINE_STRIP);
   for (int i = 0; i <= 90; i = i + 5) {
-    glVertex3f((GLfloat)i / 180. * 3., cos(rad(i)) * 2., -0.01);
+    gfx::vertex3f((GLfloat)i / 180. * 3., cos(rad(i)) * 2., -0.01);
   }
-  glEnd();
-  glPopMatrix();
+  gfx::end();
+  gfx::pop_matrix();
 }
 
-void cable::render() {
+PartPose cable::pose() const {
+  PartPose p = {point3D(), point3D(), 0.0f, 0.0f, visible};
+  return p;
+}
+
+void cable::update() {
+  // SATA cable goes and comes with the hard disk
   if (enterPressed && objIndex == REMOVE_HDD)
     visible = assemble ? true : false;
-  if (!visible)
+}
+
+void cable::render(const PartPose &pose) {
+  if (!pose.visible)
     return;
-  glPushMatrix();
+  gfx::push_matrix();
   draw_sata();
   draw_cpu_power();
   desktop_power_cable();
-  glPopMatrix();
+  gfx::pop_matrix();
 }
 
 void cable::draw_sata() {
 
-  glPushMatrix();
-  glTranslatef(7.95, 4.2, -4.015);
-  glRotatef(-90., 0., 1., 0.);
-  glScalef(.2, 0.34, .6);
+  gfx::push_matrix();
+  gfx::translatef(7.95, 4.2, -4.015);
+  gfx::rotatef(-90., 0., 1., 0.);
+  gfx::scalef(.2, 0.34, .6);
   // SATA Cable
   /// Middle Part
-  glColor3f(.56, 0.2, 0.2);
-  glBegin(GL_QUAD_STRIP);
+  gfx::color3f(.56, 0.2, 0.2);
+  gfx::begin(GL_QUAD_STRIP);
   for (int i = 0; i <= 180; i = i + 5) {
-    glVertex3f((GLfloat)i / 180. * 2., cos(rad(i)), -0.01);
-    glVertex3f((GLfloat)i / 180. * 2 + 0.05, cos(rad(i)) + .05, -0.);
+    gfx::vertex3f((GLfloat)i / 180. * 2., cos(rad(i)), -0.01);
+    gfx::vertex3f((GLfloat)i / 180. * 2 + 0.05, cos(rad(i)) + .05, -0.);
   }
-  glEnd();
+  gfx::end();
 
   /// TOP LEFT Ends
-  glColor3f(0., 0., 0.);
-  glBegin(GL_POLYGON);
-  glVertex3f(-0.01, 0.99, 0.);
-  glVertex3f(0.06, 0.99, 0.);
-  glVertex3f(0.06, 1.06, 0.);
-  glVertex3f(-0.01, 1.06, 0.);
-  glEnd();
-  glBegin(GL_POLYGON);
-  glVertex3f(-0.01, 0.99, -0.03);
-  glVertex3f(0.06, 0.99, -0.03);
-  glVertex3f(0.06, 1.06, -0.03);
-  glVertex3f(-0.01, 1.06, -0.03);
-  glEnd();
-  glBegin(GL_POLYGON);
-  glVertex3f(-0.01, 0.99, 0.);
-  glVertex3f(-0.01, 0.99, -0.03);
-  glVertex3f(-0.01, 1.06, -0.03);
-  glVertex3f(-0.01, 1.06, 0.);
-  glEnd();
-  glBegin(GL_POLYGON);
-  glVertex3f(-0.01, 0.99, 0.);
-  glVertex3f(-0.01, 0.99, -0.03);
-  glVertex3f(-0.01, 1.06, -0.03);
-  glVertex3f(-0.01, 1.06, 0.);
-  glEnd();
-  glBegin(GL_POLYGON);
-  glVertex3f(-0.01, 0.99, 0.);
-  glVertex3f(0.06, 0.99, 0.);
-  glVertex3f(0.06, 0.99, -0.03);
-  glVertex3f(-0.01, 0.99, -0.03);
-  glEnd();
-  glBegin(GL_POLYGON);
-  glVertex3f(-0.01, 1.06, 0.);
-  glVertex3f(0.06, 1.06, 0.);
-  glVertex3f(0.06, 1.06, -0.03);
-  glVertex3f(-0.01, 1.06, -0.03);
-  glEnd();
+  gfx::color3f(0., 0., 0.);
+  gfx::begin(GL_POLYGON);
+  gfx::vertex3f(-0.01, 0.99, 0.);
+  gfx::vertex3f(0.06, 0.99, 0.);
+  gfx::vertex3f(0.06, 1.06, 0.);
+  gfx::vertex3f(-0.01, 1.06, 0.);
+  gfx::end();
+  gfx::begin(GL_POLYGON);
+  gfx::vertex3f(-0.01, 0.99, -0.03);
+  gfx::vertex3f(0.06, 0.99, -0.03);
+  gfx::vertex3f(0.06, 1.06, -0.03);
+  gfx::vertex3f(-0.01, 1.06, -0.03);
+  gfx::end();
+  gfx::begin(GL_POLYGON);
+  gfx::vertex3f(-0.01, 0.99, 0.);
+  gfx::vertex3f(-0.01, 0.99, -0.03);
+  gfx::vertex3f(-0.01, 1.06, -0.03);
+  gfx::vertex3f(-0.01, 1.06, 0.);
+  gfx::end();
+  gfx::begin(GL_POLYGON);
+  gfx::vertex3f(-0.01, 0.99, 0.);
+  gfx::vertex3f(-0.01, 0.99, -0.03);
+  gfx::vertex3f(-0.01, 1.06, -0.03);
+  gfx::vertex3f(-0.01, 1.06, 0.);
+  gfx::end();
+  gfx::begin(GL_POLYGON);
+  gfx::vertex3f(-0.01, 0.99, 0.);
+  gfx::vertex3f(0.06, 0.99, 0.);
+  gfx::vertex3f(0.06, 0.99, -0.03);
+  gfx::vertex3f(-0.01, 0.99, -0.03);
+  gfx::end();
+  gfx::begin(GL_POLYGON);
+  gfx::vertex3f(-0.01, 1.06, 0.);
+  gfx::vertex3f(0.06, 1.06, 0.);
+  gfx::vertex3f(0.06, 1.06, -0.03);
+  gfx::vertex3f(-0.01, 1.06, -0.03);
+  gfx::end();
 
   /// TOP RIGHT End R
-  glColor3f(0., 0., 0.);
-  glBegin(GL_POLYGON);
-  glVertex3f(1.99, -1.01, 0.);
-  glVertex3f(2.06, -1.01, 0.);
-  glVertex3f(2.06, -0.94, 0.);
-  glVertex3f(1.99, -0.94, 0.);
-  glEnd();
-  glBegin(GL_POLYGON);
-  glVertex3f(1.99, -1.01, -0.03);
-  glVertex3f(2.06, -1.01, -0.03);
-  glVertex3f(2.06, -0.94, -0.03);
-  glVertex3f(1.99, -0.94, -0.03);
-  glEnd();
-  glBegin(GL_POLYGON);
-  glVertex3f(1.99, -1.01, 0.);
-  glVertex3f(1.99, -1.01, -0.03);
-  glVertex3f(1.99, -0.94, -0.03);
-  glVertex3f(1.99, -0.94, 0.);
-  glEnd();
-  glBegin(GL_POLYGON);
-  glVertex3f(1.99, -1.01, 0.);
-  glVertex3f(1.99, -1.01, -0.03);
-  glVertex3f(1.99, -0.94, -0.03);
-  glVertex3f(1.99, -0.94, 0.);
-  glEnd();
-  glBegin(GL_POLYGON);
-  glVertex3f(1.99, -1.01, 0.);
-  glVertex3f(2.06, -1.01, 0.);
-  glVertex3f(2.06, -1.01, -0.03);
-  glVertex3f(1.99, -1.01, -0.03);
-  glEnd();
-  glBegin(GL_POLYGON);
-  glVertex3f(1.99, -0.94, 0.);
-  glVertex3f(2.06, -0.94, 0.);
-  glVertex3f(2.06, -0.94, -0.03);
-  glVertex3f(1.99, -0.94, -0.03);
-  glEnd();
-  glPopMatrix();
+  gfx::color3f(0., 0., 0.);
+  gfx::begin(GL_POLYGON);
+  gfx::vertex3f(1.99, -1.01, 0.);
+  gfx::vertex3f(2.06, -1.01, 0.);
+  gfx::vertex3f(2.06, -0.94, 0.);
+  gfx::vertex3f(1.99, -0.94, 0.);
+  gfx::end();
+  gfx::begin(GL_POLYGON);
+  gfx::vertex3f(1.99, -1.01, -0.03);
+  gfx::vertex3f(2.06, -1.01, -0.03);
+  gfx::vertex3f(2.06, -0.94, -0.03);
+  gfx::vertex3f(1.99, -0.94, -0.03);
+  gfx::end();
+  gfx::begin(GL_POLYGON);
+  gfx::vertex3f(1.99, -1.01, 0.);
+  gfx::vertex3f(1.99, -1.01, -0.03);
+  gfx::vertex3f(1.99, -0.94, -0.03);
+  gfx::vertex3f(1.99, -0.94, 0.);
+  gfx::end();
+  gfx::begin(GL_POLYGON);
+  gfx::vertex3f(1.99, -1.01, 0.);
+  gfx::vertex3f(1.99, -1.01, -0.03);
+  gfx::vertex3f(1.99, -0.94, -0.03);
+  gfx::vertex3f(1.99, -0.94, 0.);
+  gfx::end();
+  gfx::begin(GL_POLYGON);
+  gfx::vertex3f(1.99, -1.01, 0.);
+  gfx::vertex3f(2.06, -1.01, 0.);
+  gfx::vertex3f(2.06, -1.01, -0.03);
+  gfx::vertex3f(1.99, -1.01, -0.03);
+  gfx::end();
+  gfx::begin(GL_POLYGON);
+  gfx::vertex3f(1.99, -0.94, 0.);
+  gfx::vertex3f(2.06, -0.94, 0.);
+  gfx::vertex3f(2.06, -0.94, -0.03);
+  gfx::vertex3f(1.99, -0.94, -0.03);
+  gfx::end();
+  gfx::pop_matrix();
 }
 #endif CPU_CABLE
\ No newline at end of file
@@ -2,6 +2,8 @@
 #define CPU_CASE
 
 #include "cpu_fan.h"
+#include "frame_snapshot.h"
+#include "gfx.h"
 #include "gl_includes.h"
 
 class cpu_case {
@@ -12,7 +14,7 @@ private:
   double regionRadius = 2.;
   bool visible = true;
   bool objMove = false;
-  point3D move;
+  point3D move, prevMove; /// Offset now and one sim step ago
   // point3D move;
   // dragHandler handler;
   /// Methods
@@ -25,19 +27,24 @@ private:
   void draw_sidebar();
   void draw_rim();
   void draw_legs();
-  void draw_side_panel();
+  void draw_side_panel(const PartPose &, float);
   void motionHandle();
 
 public:
-  void render();
+  // Snapshot of the side panel's sim state for the frame builder
+  PartPose pose() const;
+  void update();
+  void render(const PartPose &, float);
+  /// Only the side panel, placed as render() places it (for picking)
+  void render_side_panel(const PartPose &, float);
 };
 
-void cpu_case::render() {
+void cpu_case::render(const PartPose &panel, float t) {
 
-  glPushMatrix();
+  gfx::push_matrix();
 
-  glTranslatef(cpuWidth / 2 + 6.6, 3.5, -2.7);
-  glRotatef(0., 0., 1., 0);
+  gfx::translatef(cpuWidth / 2 + 6.6, 3.5, -2.7);
+  gfx::rotatef(0., 0., 1., 0);
   draw_front();
   draw_rightSide();
   draw_back();
@@ -46,9 +53,16 @@ void cpu_case::render() {
   draw_sidebar();
   draw_rim();
   draw_legs();
-  draw_side_panel();
+  draw_side_panel(panel, t);
 
-  glPopMatrix();
+  gfx::pop_matrix();
+}
+
+void cpu_case::render_side_panel(const PartPose &panel, float t) {
+  gfx::push_matrix();
+  gfx::translatef(cpuWidth / 2 + 6.6, 3.5, -2.7);
+  draw_side_panel(panel, t);
+  gfx::pop_matrix();
 }
 
 void cpu_case::motionHandle() {
@@ -57,7 +71,7 @@ void cpu_case::motionHandle() {
       !assemble) {
     objMove = true;
     /// Disassembly of The panel
-    move.x -= 0.007;
+    move.x -= disassembleSpeed * SIM_DT;
     if (move.x < disapphereLimit) {
       /// Last reached
       enterPressed = false;
@@ -71,7 +85,7 @@ void cpu_case::motionHandle() {
     objMove = true;
     visible = true;
     /// Disassembly of The panel
-    move.x += 0.007;
+    move.x += disassembleSpeed * SIM_DT;
 
     if (move.x >= 0) {
       /// Last reached
@@ -81,12 +95,22 @@ void cpu_case::motionHandle() {
   }
 }
 
-void cpu_case::draw_side_panel() {
+PartPose cpu_case::pose() const {
+  PartPose p = {prevMove, move, 0.0f, 0.0f, visible};
+  return p;
+}
+
+void cpu_case::update() {
+  prevMove = move;
   motionHandle();
-  if (!visible)
+}
+
+void cpu_case::draw_side_panel(const PartPose &pose, float t) {
+  if (!pose.visible)
     return;
-  glPushMatrix();
-  glTranslatef(move.x, move.y, move.z);
+  gfx::push_matrix();
+  point3D m = pose.at(t);
+  gfx::translatef(m.x, m.y, m.z);
 
   GLfloat ymin = -0.35 * 0.37, ymax = cpuHight;
   GLfloat xmin = -cpuLength, xmax = 0.;
@@ -95,246 +119,246 @@ void cpu_case::draw_side_panel() {
   GLfloat frameThickness = .1;
 
   /// Bottom
-  glBegin(GL_POLYGON);
-  glVertex3f(xPos, ymin, xmin);           /// 0,0
-  glVertex3f(xPos, frameThickness, xmin); /// 0,1
-  glVertex3f(xPos, frameThickness, xmax);
-  glVertex3f(xPos, ymin, xmax);
-  glEnd();
+  gfx::begin(GL_POLYGON);
+  gfx::vertex3f(xPos, ymin, xmin);           /// 0,0
+  gfx::vertex3f(xPos, frameThickness, xmin); /// 0,1
+  gfx::vertex3f(xPos, frameThickness, xmax);
+  gfx::vertex3f(xPos, ymin, xmax);
+  gfx::end();
 
   /// Left Side
-  glBegin(GL_POLYGON);
-  glVertex3f(xPos, ymin, xmin);                  /// 0,0
-  glVertex3f(xPos, ymax, xmin);                  /// 0,0
-  glVertex3f(xPos, ymax, xmin + frameThickness); /// 0,1
-  glVertex3f(xPos, ymin, xmin + frameThickness);
-  glEnd();
+  gfx::begin(GL_POLYGON);
+  gfx::vertex3f(xPos, ymin, xmin);                  /// 0,0
+  gfx::vertex3f(xPos, ymax, xmin);                  /// 0,0
+  gfx::vertex3f(xPos, ymax, xmin + frameThickness); /// 0,1
+  gfx::vertex3f(xPos, ymin, xmin + frameThickness);
+  gfx::end();
 
   /// Top Side
-  glBegin(GL_POLYGON);
-  glVertex3f(xPos, ymax - frameThickness, xmin); /// 0,0
-  glVertex3f(xPos, ymax, xmin);                  /// 0,0
-  glVertex3f(xPos, ymax, xmax);                  /// 0,1
-  glVertex3f(xPos, ymax - frameThickness, xmax);
-  glEnd();
+  gfx::begin(GL_POLYGON);
+  gfx::vertex3f(xPos, ymax - frameThickness, xmin); /// 0,0
+  gfx::vertex3f(xPos, ymax, xmin);                  /// 0,0
+  gfx::vertex3f(xPos, ymax, xmax);                  /// 0,1
+  gfx::vertex3f(xPos, ymax - frameThickness, xmax);
+  gfx::end();
 
   /// Right side
-  glBegin(GL_POLYGON);
-  glVertex3f(xPos, ymin, xmax - cpuLength * .35); /// 0,0
-  glVertex3f(xPos, ymax, xmax - cpuLength * .35); /// 0,0
-  glVertex3f(xPos, ymax, xmax);                   /// 0,1
-  glVertex3f(xPos, ymin, xmax);
-  glEnd();
+  gfx::begin(GL_POLYGON);
+  gfx::vertex3f(xPos, ymin, xmax - cpuLength * .35); /// 0,0
+  gfx::vertex3f(xPos, ymax, xmax - cpuLength * .35); /// 0,0
+  gfx::vertex3f(xPos, ymax, xmax);                   /// 0,1
+  gfx::vertex3f(xPos, ymin, xmax);
+  gfx::end();
 
   /// Glass side
-  glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-  glEnable(GL_BLEND);
-  glColor4f(0., 0.5, 0., .32);
-  glBegin(GL_POLYGON);
-  glVertex3f(xPos + 0.001, ymin + frameThickness,
+  gfx::blend_func(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+  gfx::enable(GL_BLEND);
+  gfx::color4f(0., 0.5, 0., .32);
+  gfx::begin(GL_POLYGON);
+  gfx::vertex3f(xPos + 0.001, ymin + frameThickness,
              xmax - cpuLength * .35); /// 0,0
-  glVertex3f(xPos + 0.001, ymax - frameThickness,
+  gfx::vertex3f(xPos + 0.001, ymax - frameThickness,
              xmax - cpuLength * .35); /// 0,0
-  glVertex3f(xPos + 0.001, ymax - frameThickness,
+  gfx::vertex3f(xPos + 0.001, ymax - frameThickness,
              xmin + frameThickness); /// 0,1
-  glVertex3f(xPos + 0.001, ymin + frameThickness, xmin + frameThickness);
-  glEnd();
-  glDisable(GL_BLEND);
+  gfx::vertex3f(xPos + 0.001, ymin + frameThickness, xmin + frameThickness);
+  gfx::end();
+  gfx::disable(GL_BLEND);
 
-  glPopMatrix();
+  gfx::pop_matrix();
 }
 
 void cpu_case::draw_rim() {
   GLfloat thickness = 0.08;
   GLfloat frontSpace = 0.07;
 
-  glPushMatrix();
-  glEnable(GL_TEXTURE_2D);
+  gfx::push_matrix();
+  gfx::enable(GL_TEXTURE_2D);
 
   // Back rim
-  glBindTexture(GL_TEXTURE_2D, textures[CASE_RIM_LEFT]);
-  glColor3f(1., 1., 1.);
-  glBegin(GL_POLYGON);
-  glTexCoord2f(0., 1.);
-  glVertex3f(-0.0012, 0., -cpuLength + thickness);
-  glTexCoord2f(1., 1.);
-  glVertex3f(-0.0012, cpuHight, -cpuLength + thickness);
-  glTexCoord2f(1., 0.);
-  glVertex3f(-0.0012, cpuHight, -cpuLength);
-  glTexCoord2f(1., 0.);
-  glVertex3f(-0.0012, 0., -cpuLength);
-  glEnd();
+  gfx::bind_texture(textures[CASE_RIM_LEFT]);
+  gfx::color3f(1., 1., 1.);
+  gfx::begin(GL_POLYGON);
+  gfx::tex_coord2f(0., 1.);
+  gfx::vertex3f(-0.0012, 0., -cpuLength + thickness);
+  gfx::tex_coord2f(1., 1.);
+  gfx::vertex3f(-0.0012, cpuHight, -cpuLength + thickness);
+  gfx::tex_coord2f(1., 0.);
+  gfx::vertex3f(-0.0012, cpuHight, -cpuLength);
+  gfx::tex_coord2f(1., 0.);
+  gfx::vertex3f(-0.0012, 0., -cpuLength);
+  gfx::end();
 
   // Front rim
-  glBindTexture(GL_TEXTURE_2D, textures[CASE_RIM_RIGHT]);
-  glBegin(GL_POLYGON);
-  glTexCoord2f(0., 1.);
-  glVertex3f(-0.0012, 0., -thickness - frontSpace);
-  glTexCoord2f(1., 1.);
-  glVertex3f(-0.0012, cpuHight, -thickness - frontSpace);
-  glTexCoord2f(1., 0.);
-  glVertex3f(-0.0012, cpuHight, -frontSpace);
-  glTexCoord2f(1., 0.);
-  glVertex3f(-0.0012, 0., -frontSpace);
-  glEnd();
+  gfx::bind_texture(textures[CASE_RIM_RIGHT]);
+  gfx::begin(GL_POLYGON);
+  gfx::tex_coord2f(0., 1.);
+  gfx::vertex3f(-0.0012, 0., -thickness - frontSpace);
+  gfx::tex_coord2f(1., 1.);
+  gfx::vertex3f(-0.0012, cpuHight, -thickness - frontSpace);
+  gfx::tex_coord2f(1., 0.);
+  gfx::vertex3f(-0.0012, cpuHight, -frontSpace);
+  gfx::tex_coord2f(1., 0.);
+  gfx::vertex3f(-0.0012, 0., -frontSpace);
+  gfx::end();
 
   // Top Rim
-  glBegin(GL_POLYGON);
-  glBindTexture(GL_TEXTURE_2D, textures[CASE_RIM_TOP]);
-  glTexCoord2f(0., 1.);
-  glVertex3f(-0.0012, cpuHight, -cpuLength);
-  glTexCoord2f(0., 0.);
-  glVertex3f(-0.0012, cpuHight - thickness, -cpuLength);
-  glTexCoord2f(1., 0.);
-  glVertex3f(-0.0012, cpuHight - thickness, -frontSpace);
-  glTexCoord2f(1., 1.);
-  glVertex3f(-0.0012, cpuHight, -frontSpace);
-  glEnd();
+  gfx::begin(GL_POLYGON);
+  gfx::bind_texture(textures[CASE_RIM_TOP]);
+  gfx::tex_coord2f(0., 1.);
+  gfx::vertex3f(-0.0012, cpuHight, -cpuLength);
+  gfx::tex_coord2f(0., 0.);
+  gfx::vertex3f(-0.0012, cpuHight - thickness, -cpuLength);
+  gfx::tex_coord2f(1., 0.);
+  gfx::vertex3f(-0.0012, cpuHight - thickness, -frontSpace);
+  gfx::tex_coord2f(1., 1.);
+  gfx::vertex3f(-0.0012, cpuHight, -frontSpace);
+  gfx::end();
 
   // Bottom Rim
-  glBegin(GL_POLYGON);
-  glBindTexture(GL_TEXTURE_2D, textures[CASE_RIM_BOTTOM]);
-  glTexCoord2f(0., 0.);
-  glVertex3f(-0.0012, 0., -cpuLength);
-  glTexCoord2f(1., 0.);
-  glVertex3f(-0.0012, 0., -frontSpace);
-  glTexCoord2f(1., 1.);
-  glVertex3f(-0.0012, -thickness, -frontSpace);
-  glTexCoord2f(0., 1.);
-  glVertex3f(-0.0012, -thickness, -cpuLength);
-  glEnd();
-
-  glDisable(GL_TEXTURE_2D);
-  glPopMatrix();
+  gfx::begin(GL_POLYGON);
+  gfx::bind_texture(textures[CASE_RIM_BOTTOM]);
+  gfx::tex_coord2f(0., 0.);
+  gfx::vertex3f(-0.0012, 0., -cpuLength);
+  gfx::tex_coord2f(1., 0.);
+  gfx::vertex3f(-0.0012, 0., -frontSpace);
+  gfx::tex_coord2f(1., 1.);
+  gfx::vertex3f(-0.0012, -thickness, -frontSpace);
+  gfx::tex_coord2f(0., 1.);
+  gfx::vertex3f(-0.0012, -thickness, -cpuLength);
+  gfx::end();
+
+  gfx::disable(GL_TEXTURE_2D);
+  gfx::pop_matrix();
 }
 
 void cpu_case::draw_back() {
 
   // Mesh
-  glPushMatrix();
-  glLineWidth(5.0);
-  glColor3fv(cabinetColor);
-  glTranslatef(0.1, 1.1, -cpuLength);
-  glScalef(0.2, 0.2, 1.);
+  gfx::push_matrix();
+  gfx::line_width(5.0);
+  gfx::color3fv(cabinetColor);
+  gfx::translatef(0.1, 1.1, -cpuLength);
+  gfx::scalef(0.2, 0.2, 1.);
   for (GLfloat i = 0; i <= 8; i = i + 0.3) {
     if (i <= 4) {
-      glPushMatrix();
-      glBegin(GL_LINES);
-      glVertex3f(i, 0., -0.02);
-      glVertex3f(0., i, -0.02);
-      glEnd();
-      glPopMatrix();
-      glPushMatrix();
-      glBegin(GL_LINES);
-      glVertex3f(0., 4. - i, -0.02);
-      glVertex3f(i, 4, -0.02);
-      glEnd();
-      glPopMatrix();
+      gfx::push_matrix();
+      gfx::begin(GL_LINES);
+      gfx::vertex3f(i, 0., -0.02);
+      gfx::vertex3f(0., i, -0.02);
+      gfx::end();
+      gfx::pop_matrix();
+      gfx::push_matrix();
+      gfx::begin(GL_LINES);
+      gfx::vertex3f(0., 4. - i, -0.02);
+      gfx::vertex3f(i, 4, -0.02);
+      gfx::end();
+      gfx::pop_matrix();
     } else {
-      glPushMatrix();
-      glBegin(GL_LINES);
-      glVertex3f(4, i - 4., -0.02);
-      glVertex3f(i - 4., 4., -0.02);
-      glEnd();
-      glPopMatrix();
-      glPushMatrix();
-      glBegin(GL_LINES);
-      glVertex3f(i - 4., 0., -0.02);
-      glVertex3f(4., 4. - abs(i - 4.), -0.02);
-      glEnd();
-      glPopMatrix();
+      gfx::push_matrix();
+      gfx::begin(GL_LINES);
+      gfx::vertex3f(4, i - 4., -0.02);
+      gfx::vertex3f(i - 4., 4., -0.02);
+      gfx::end();
+      gfx::pop_matrix();
+      gfx::push_matrix();
+      gfx::begin(GL_LINES);
+      gfx::vertex3f(i - 4., 0., -0.02);
+      gfx::vertex3f(4., 4. - abs(i - 4.), -0.02);
+      gfx::end();
+      gfx::pop_matrix();
     }
   }
-  glPopMatrix();
-  glPushMatrix();
-  glTranslatef(0., 0., -cpuLength);
+  gfx::pop_matrix();
+  gfx::push_matrix();
+  gfx::translatef(0., 0., -cpuLength);
 
   // Cover
-  glColor3fv(cabinetColor);
-  glBegin(GL_POLYGON);
-  glVertex3f(0., 2., 0.);
-  glVertex3f(.15, 2., 0.);
-  glVertex3f(.15, 1.2, 0.);
-  glVertex3f(0., 1.2, 0.);
-  glEnd();
-
-  glBegin(GL_POLYGON);
-  glVertex3f(1., 2., 0.);
-  glVertex3f(1 - .15, 2., 0.);
-  glVertex3f(1 - .15, 1.2, 0.);
-  glVertex3f(1., 1.2, 0.);
-  glEnd();
-
-  glBegin(GL_POLYGON);
-  glVertex3f(0., 2., 0.);
-  glVertex3f(1., 2., 0.);
-  glVertex3f(1., 1.85, 0.);
-  glVertex3f(0., 1.85, 0.);
-  glEnd();
-
-  glBegin(GL_POLYGON);
-  glVertex3f(0., 1.2, 0.);
-  glVertex3f(1., 1.2, 0.);
-  glVertex3f(1., .4, 0.);
-  glVertex3f(0., .4, 0.);
-  glEnd();
+  gfx::color3fv(cabinetColor);
+  gfx::begin(GL_POLYGON);
+  gfx::vertex3f(0., 2., 0.);
+  gfx::vertex3f(.15, 2., 0.);
+  gfx::vertex3f(.15, 1.2, 0.);
+  gfx::vertex3f(0., 1.2, 0.);
+  gfx::end();
+
+  gfx::begin(GL_POLYGON);
+  gfx::vertex3f(1., 2., 0.);
+  gfx::vertex3f(1 - .15, 2., 0.);
+  gfx::vertex3f(1 - .15, 1.2, 0.);
+  gfx::vertex3f(1., 1.2, 0.);
+  gfx::end();
+
+  gfx::begin(GL_POLYGON);
+  gfx::vertex3f(0., 2., 0.);
+  gfx::vertex3f(1., 2., 0.);
+  gfx::vertex3f(1., 1.85, 0.);
+  gfx::vertex3f(0., 1.85, 0.);
+  gfx::end();
+
+  gfx::begin(GL_POLYGON);
+  gfx::vertex3f(0., 1.2, 0.);
+  gfx::vertex3f(1., 1.2, 0.);
+  gfx::vertex3f(1., .4, 0.);
+  gfx::vertex3f(0., .4, 0.);
+  gfx::end();
 
   // Thickness
   GLfloat thickness = .04;
-  glBegin(GL_POLYGON);
-
-  glColor3fv(cabinetColor);
-
-  glVertex3f(0., 2., -thickness);
-  glVertex3f(.15, 2., -thickness);
-  glVertex3f(.15, 0., -thickness);
-  glVertex3f(0., 0., -thickness);
-  glEnd();
-
-  glBegin(GL_POLYGON);
-  glVertex3f(1., 2., -thickness);
-  glVertex3f(1 - .15, 2., -thickness);
-  glVertex3f(1 - .15, 0., -thickness);
-  glVertex3f(1., 0., -thickness);
-  glEnd();
-
-  glBegin(GL_POLYGON);
-  glVertex3f(0., 2., -thickness);
-  glVertex3f(1., 2., -thickness);
-  glVertex3f(1., 1.85, -thickness);
-  glVertex3f(0., 1.85, -thickness);
-  glEnd();
-
-  glEnable(GL_TEXTURE_2D);
-  glColor3f(1., 1., 1.);
-  glBindTexture(GL_TEXTURE_2D, textures[CASE_BEHIND]);
-  glBegin(GL_POLYGON); /// Bottom Square
-  glTexCoord2f(0., 1.);
-  glVertex3f(.15, 1.2, -thickness);
-  glTexCoord2f(1., 1.);
-  glVertex3f(1. - .15, 1.2, -thickness);
-  glTexCoord2f(1., 0.);
-  glVertex3f(1. - .15, .27, -thickness);
-  glTexCoord2f(0., 0.);
-  glVertex3f(.15, .27, -thickness);
-  glEnd();
-  glDisable(GL_TEXTURE_2D);
-
-  glColor3fv(cabinetColor);
-  glBegin(GL_QUAD_STRIP);
-  glVertex3f(0., 0., 0.);
-  glVertex3f(0., 0., -thickness);
-  glVertex3f(cpuWidth, 0., 0.);
-  glVertex3f(cpuWidth, 0., -thickness);
-  glVertex3f(cpuWidth, cpuHight, 0.);
-  glVertex3f(cpuWidth, cpuHight, -thickness);
-  glVertex3f(0., cpuHight, 0.);
-  glVertex3f(0., cpuHight, -thickness);
-  glVertex3f(0., 0., 0.);
-  glVertex3f(0., 0., -thickness);
-  glEnd();
-
-  glPopMatrix();
+  gfx::begin(GL_POLYGON);
+
+  gfx::color3fv(cabinetColor);
+
+  gfx::vertex3f(0., 2., -thickness);
+  gfx::vertex3f(.15, 2., -thickness);
+  gfx::vertex3f(.15, 0., -thickness);
+  gfx::vertex3f(0., 0., -thickness);
+  gfx::end();
+
+  gfx::begin(GL_POLYGON);
+  gfx::vertex3f(1., 2., -thickness);
+  gfx::vertex3f(1 - .15, 2., -thickness);
+  gfx::vertex3f(1 - .15, 0., -thickness);
+  gfx::vertex3f(1., 0., -thickness);
+  gfx::end();
+
+  gfx::begin(GL_POLYGON);
+  gfx::vertex3f(0., 2., -thickness);
+  gfx::vertex3f(1., 2., -thickness);
+  gfx::vertex3f(1., 1.85, -thickness);
+  gfx::vertex3f(0., 1.85, -thickness);
+  gfx::end();
+
+  gfx::enable(GL_TEXTURE_2D);
+  gfx::color3f(1., 1., 1.);
+  gfx::bind_texture(textures[CASE_BEHIND]);
+  gfx::begin(GL_POLYGON); /// Bottom Square
+  gfx::tex_coord2f(0., 1.);
+  gfx::vertex3f(.15, 1.2, -thickness);
+  gfx::tex_coord2f(1., 1.);
+  gfx::vertex3f(1. - .15, 1.2, -thickness);
+  gfx::tex_coord2f(1., 0.);
+  gfx::vertex3f(1. - .15, .27, -thickness);
+  gfx::tex_coord2f(0., 0.);
+  gfx::vertex3f(.15, .27, -thickness);
+  gfx::end();
+  gfx::disable(GL_TEXTURE_2D);
+
+  gfx::color3fv(cabinetColor);
+  gfx::begin(GL_QUAD_STRIP);
+  gfx::vertex3f(0., 0., 0.);
+  gfx::vertex3f(0., 0., -thickness);
+  gfx::vertex3f(cpuWidth, 0., 0.);
+  gfx::vertex3f(cpuWidth, 0., -thickness);
+  gfx::vertex3f(cpuWidth, cpuHight, 0.);
+  gfx::vertex3f(cpuWidth, cpuHight, -thickness);
+  gfx::vertex3f(0., cpuHight, 0.);
+  gfx::vertex3f(0., cpuHight, -thickness);
+  gfx::vertex3f(0., 0., 0.);
+  gfx::vertex3f(0., 0., -thickness);
+  gfx::end();
+
+  gfx::pop_matrix();
 }
 
 void cpu_case::draw_rightSide() {
@@ -343,251 +367,252 @@ void cpu_case::draw_rightSide() {
                          {1., cpuHight, -cpuLength},
                          {1., 0, -cpuLength}};
 
-  glPushMatrix();
+  gfx::push_matrix();
   // Side Face
-  glColor3fv(cabinetColor);
-  glBegin(GL_POLYGON);
+  gfx::color3fv(cabinetColor);
+  gfx::begin(GL_POLYGON);
   for (int i = 0; i < 4; i++)
-    glVertex3fv(rightV[i]);
-  glEnd();
+    gfx::vertex3fv(rightV[i]);
+  gfx::end();
 
   // Side Face thickness
-  glColor3fv(cabinetColor);
-  glBegin(GL_POLYGON);
+  gfx::color3fv(cabinetColor);
+  gfx::begin(GL_POLYGON);
   GLfloat thickness = 0.04;
   for (int i = 0; i < 4; i++)
-    glVertex3f(rightV[i][0] - thickness, rightV[i][1], rightV[i][2]);
-  glEnd();
+    gfx::vertex3f(rightV[i][0] - thickness, rightV[i][1], rightV[i][2]);
+  gfx::end();
 
   // Thickness filler
-  glColor3fv(cabinetColor);
-  glBegin(GL_QUAD_STRIP);
+  gfx::color3fv(cabinetColor);
+  gfx::begin(GL_QUAD_STRIP);
   for (int i = 0; i < 4; i++) {
-    glVertex3fv(rightV[i]);
-    glVertex3f(rightV[i][0] - thickness, rightV[i][1], rightV[i][2]);
+    gfx::vertex3fv(rightV[i]);
+    gfx::vertex3f(rightV[i][0] - thickness, rightV[i][1], rightV[i][2]);
   }
-  glEnd();
+  gfx::end();
 
   // Inside wall texture
   GLfloat nearZ = cpuLength * 0.28;
   GLfloat lowBound = 0.35;
 
-  glEnable(GL_TEXTURE_2D);
-  glColor3f(1., 1., 1.);
-  glBindTexture(GL_TEXTURE_2D, textures[CPU_INSIDE_WALL]);
-  glBegin(GL_POLYGON);
-  glTexCoord2i(0, 0);
-  glVertex3f(cpuWidth - thickness - 0.01, lowBound, -cpuLength + 0.08);
-  glTexCoord2i(1, 0);
-  glVertex3f(cpuWidth - thickness - 0.01, lowBound, -nearZ);
-  glTexCoord2i(1, 1);
-  glVertex3f(cpuWidth - thickness - 0.01, cpuHight - 0.04, -nearZ);
-  glTexCoord2i(0, 1);
-  glVertex3f(cpuWidth - thickness - 0.01, cpuHight - 0.04, -cpuLength + 0.08);
-  glEnd();
-  glDisable(GL_TEXTURE_2D);
-  glPopMatrix();
+  gfx::enable(GL_TEXTURE_2D);
+  gfx::color3f(1., 1., 1.);
+  gfx::bind_texture(textures[CPU_INSIDE_WALL]);
+  gfx::begin(GL_POLYGON);
+  gfx::tex_coord2i(0, 0);
+  gfx::vertex3f(cpuWidth - thickness - 0.01, lowBound, -cpuLength + 0.08);
+  gfx::tex_coord2i(1, 0);
+  gfx::vertex3f(cpuWidth - thickness - 0.01, lowBound, -nearZ);
+  gfx::tex_coord2i(1, 1);
+  gfx::vertex3f(cpuWidth - thickness - 0.01, cpuHight - 0.04, -nearZ);
+  gfx::tex_coord2i(0, 1);
+  gfx::vertex3f(cpuWidth - thickness - 0.01, cpuHight - 0.04,
+                -cpuLength + 0.08);
+  gfx::end();
+  gfx::disable(GL_TEXTURE_2D);
+  gfx::pop_matrix();
 }
 
 void cpu_case::draw_front() {
 
-  glColor3f(0., 0., 0.);
+  gfx::color3f(0., 0., 0.);
 
   GLfloat v[6][3] = {{0., 0., 0},  {0., 1.9, 0}, {0.5, 1.9, 0},
                      {0.7, 2., 0}, {1., 2., 0},  {1., 0., 0}};
 
-  glPushMatrix();
+  gfx::push_matrix();
   /* FRONT BASE */
-  glBegin(GL_POLYGON);
+  gfx::begin(GL_POLYGON);
   for (int i = 0; i < 6; i++)
-    glVertex3fv(v[i]);
-  glEnd();
+    gfx::vertex3fv(v[i]);
+  gfx::end();
 
   /* Thickness */
   GLfloat thickness = 0.04;
-  glBegin(GL_POLYGON);
+  gfx::begin(GL_POLYGON);
   for (int i = 0; i < 6; i++)
-    glVertex3f(v[i][0], v[i][1], v[i][2] - thickness);
-  glEnd();
+    gfx::vertex3f(v[i][0], v[i][1], v[i][2] - thickness);
+  gfx::end();
 
-  glBegin(GL_QUAD_STRIP);
+  gfx::begin(GL_QUAD_STRIP);
   for (int i = 0; i < 6; i++) {
-    glVertex3fv(v[i]);
-    glVertex3f(v[i][0], v[i][1], v[i][2] - thickness);
+    gfx::vertex3fv(v[i]);
+    gfx::vertex3f(v[i][0], v[i][1], v[i][2] - thickness);
   }
-  glEnd();
+  gfx::end();
 
   /* RAZOR LOGO */
-  glEnable(GL_TEXTURE_2D);
-  glBindTexture(GL_TEXTURE_2D, textures[RAZOR_LOGO]);
-  glColor3f(0., 1., 0.);
-  glBegin(GL_POLYGON);
-  glTexCoord2f(0., 0.);
-  glVertex3f(0. + .25, 0. + .75, 0.001);
-  glTexCoord2f(0., 1.);
-  glVertex3f(0. + .25, .5 + .75, 0.001);
-  glTexCoord2f(1., 1.);
-  glVertex3f(.5 + .25, .5 + .75, 0.001);
-  glTexCoord2f(1., 0.);
-  glVertex3f(.5 + .25, 0. + .75, 0.001);
-  glEnd();
-  glDisable(GL_TEXTURE_2D);
-
-  glPushMatrix();
-  glColor3f(0., 0., 0.);
-  glBegin(GL_POLYGON);
-  glVertex3f(0., 0., -thickness - 0.01);
-  glVertex3f(cpuWidth, 0., -thickness - 0.01);
-  glVertex3f(cpuWidth, cpuHight, -thickness - 0.01);
-  glVertex3f(0., cpuHight, -thickness - 0.01);
-  glEnd();
-  glPopMatrix();
-
-  glPopMatrix();
+  gfx::enable(GL_TEXTURE_2D);
+  gfx::bind_texture(textures[RAZOR_LOGO]);
+  gfx::color3f(0., 1., 0.);
+  gfx::begin(GL_POLYGON);
+  gfx::tex_coord2f(0., 0.);
+  gfx::vertex3f(0. + .25, 0. + .75, 0.001);
+  gfx::tex_coord2f(0., 1.);
+  gfx::vertex3f(0. + .25, .5 + .75, 0.001);
+  gfx::tex_coord2f(1., 1.);
+  gfx::vertex3f(.5 + .25, .5 + .75, 0.001);
+  gfx::tex_coord2f(1., 0.);
+  gfx::vertex3f(.5 + .25, 0. + .75, 0.001);
+  gfx::end();
+  gfx::disable(GL_TEXTURE_2D);
+
+  gfx::push_matrix();
+  gfx::color3f(0., 0., 0.);
+  gfx::begin(GL_POLYGON);
+  gfx::vertex3f(0., 0., -thickness - 0.01);
+  gfx::vertex3f(cpuWidth, 0., -thickness - 0.01);
+  gfx::vertex3f(cpuWidth, cpuHight, -thickness - 0.01);
+  gfx::vertex3f(0., cpuHight, -thickness - 0.01);
+  gfx::end();
+  gfx::pop_matrix();
+
+  gfx::pop_matrix();
 }
 
 void cpu_case::draw_bottom() {
   GLfloat thickness = 0.35;
   GLfloat ymin = -thickness * 0.37;
 
-  glPushMatrix();
+  gfx::push_matrix();
   // PSU Holding container
   // Bottom Metal
-  glColor3f(0., 0., 0.);
-  glBegin(GL_POLYGON);
-  glVertex3f(0.001, ymin, 0.);
-  glVertex3f(0.001, ymin, -cpuLength - 0.04);
-  glVertex3f(cpuWidth - 0.001, ymin, -cpuLength - 0.04);
-  glVertex3f(cpuWidth - 0.001, ymin, 0.);
-  glEnd();
+  gfx::color3f(0., 0., 0.);
+  gfx::begin(GL_POLYGON);
+  gfx::vertex3f(0.001, ymin, 0.);
+  gfx::vertex3f(0.001, ymin, -cpuLength - 0.04);
+  gfx::vertex3f(cpuWidth - 0.001, ymin, -cpuLength - 0.04);
+  gfx::vertex3f(cpuWidth - 0.001, ymin, 0.);
+  gfx::end();
 
   // Top Metal
-  glBegin(GL_POLYGON);
-  glVertex3f(0.001, thickness, 0.);
-  glVertex3f(0.001, thickness, -cpuLength - 0.04);
-  glVertex3f(cpuWidth, thickness, -cpuLength - 0.04);
-  glVertex3f(cpuWidth, thickness, 0.);
-  glEnd();
+  gfx::begin(GL_POLYGON);
+  gfx::vertex3f(0.001, thickness, 0.);
+  gfx::vertex3f(0.001, thickness, -cpuLength - 0.04);
+  gfx::vertex3f(cpuWidth, thickness, -cpuLength - 0.04);
+  gfx::vertex3f(cpuWidth, thickness, 0.);
+  gfx::end();
 
   // Left Metal
-  glBegin(GL_POLYGON);
-  glVertex3f(0.001, ymin, 0.);
-  glVertex3f(0.001, thickness, 0.);
-  glVertex3f(0.001, thickness, -cpuLength - 0.04);
-  glVertex3f(0.001, ymin, -cpuLength - 0.04);
-  glEnd();
+  gfx::begin(GL_POLYGON);
+  gfx::vertex3f(0.001, ymin, 0.);
+  gfx::vertex3f(0.001, thickness, 0.);
+  gfx::vertex3f(0.001, thickness, -cpuLength - 0.04);
+  gfx::vertex3f(0.001, ymin, -cpuLength - 0.04);
+  gfx::end();
 
   // Right Metal
-  glBegin(GL_POLYGON);
-  glVertex3f(cpuWidth - 0.001, ymin, 0.);
-  glVertex3f(cpuWidth - 0.001, thickness, 0.);
-  glVertex3f(cpuWidth - 0.001, thickness, -cpuLength - 0.04);
-  glVertex3f(cpuWidth - 0.001, ymin, -cpuLength - 0.04);
-  glEnd();
+  gfx::begin(GL_POLYGON);
+  gfx::vertex3f(cpuWidth - 0.001, ymin, 0.);
+  gfx::vertex3f(cpuWidth - 0.001, thickness, 0.);
+  gfx::vertex3f(cpuWidth - 0.001, thickness, -cpuLength - 0.04);
+  gfx::vertex3f(cpuWidth - 0.001, ymin, -cpuLength - 0.04);
+  gfx::end();
 
   // Front Metal
-  glBegin(GL_POLYGON);
-  glVertex3f(0.001, 0., 0.);
-  glVertex3f(cpuWidth, 0., 0.);
-  glVertex3f(cpuWidth, ymin, 0.);
-  glVertex3f(0.001, ymin, 0.);
-  glEnd();
+  gfx::begin(GL_POLYGON);
+  gfx::vertex3f(0.001, 0., 0.);
+  gfx::vertex3f(cpuWidth, 0., 0.);
+  gfx::vertex3f(cpuWidth, ymin, 0.);
+  gfx::vertex3f(0.001, ymin, 0.);
+  gfx::end();
 
   // Back Metal
-  glBegin(GL_POLYGON);
-  glVertex3f(0.001, 0., -cpuLength);
-  glVertex3f(cpuWidth, 0., -cpuLength);
-  glVertex3f(cpuWidth, ymin, -cpuLength);
-  glVertex3f(0.001, ymin, -cpuLength);
-  glEnd();
+  gfx::begin(GL_POLYGON);
+  gfx::vertex3f(0.001, 0., -cpuLength);
+  gfx::vertex3f(cpuWidth, 0., -cpuLength);
+  gfx::vertex3f(cpuWidth, ymin, -cpuLength);
+  gfx::vertex3f(0.001, ymin, -cpuLength);
+  gfx::end();
 
   // NZXT Logo
-  glEnable(GL_TEXTURE_2D);
-  glColor3f(0., 1., 0.);
-  glBindTexture(GL_TEXTURE_2D, textures[RAZOR_LOGO]);
-  glBegin(GL_POLYGON);
-  glTexCoord2f(1., 1.);
-  glVertex3f(-0.001, 0., -cpuLength * 0.15 - cpuLength / 2 - thickness / 2);
-  glTexCoord2f(1., 0.);
-  glVertex3f(-0.001, 0., -cpuLength * 0.15 - cpuLength / 2 + thickness / 2);
-  glTexCoord2f(0., 0.);
-  glVertex3f(-0.001, thickness,
+  gfx::enable(GL_TEXTURE_2D);
+  gfx::color3f(0., 1., 0.);
+  gfx::bind_texture(textures[RAZOR_LOGO]);
+  gfx::begin(GL_POLYGON);
+  gfx::tex_coord2f(1., 1.);
+  gfx::vertex3f(-0.001, 0., -cpuLength * 0.15 - cpuLength / 2 - thickness / 2);
+  gfx::tex_coord2f(1., 0.);
+  gfx::vertex3f(-0.001, 0., -cpuLength * 0.15 - cpuLength / 2 + thickness / 2);
+  gfx::tex_coord2f(0., 0.);
+  gfx::vertex3f(-0.001, thickness,
              -cpuLength * 0.15 - cpuLength / 2 + thickness / 2);
-  glTexCoord2f(0., 1.);
-  glVertex3f(-0.001, thickness,
+  gfx::tex_coord2f(0., 1.);
+  gfx::vertex3f(-0.001, thickness,
              -cpuLength * 0.15 - cpuLength / 2 - thickness / 2);
-  glEnd();
+  gfx::end();
 
-  glDisable(GL_TEXTURE_2D);
+  gfx::disable(GL_TEXTURE_2D);
 
-  glPopMatrix();
+  gfx::pop_matrix();
 }
 
 void cpu_case::draw_top() {
 
   GLfloat thickness = 0.05;
-  glPushMatrix();
-  glColor3fv(cabinetColor);
+  gfx::push_matrix();
+  gfx::color3fv(cabinetColor);
 
   // Bottom
-  glBegin(GL_POLYGON);
-  glVertex3f(0.7, cpuHight, -.04);
-  glVertex3f(0.5, cpuHight, 0.);
-  glVertex3f(0., cpuHight, 0.);
-  glVertex3f(0., cpuHight, -cpuLength - 0.04);
-  glVertex3f(cpuWidth, cpuHight, -cpuLength - 0.04);
-  glVertex3f(cpuWidth, cpuHight, -.04);
-  glEnd();
+  gfx::begin(GL_POLYGON);
+  gfx::vertex3f(0.7, cpuHight, -.04);
+  gfx::vertex3f(0.5, cpuHight, 0.);
+  gfx::vertex3f(0., cpuHight, 0.);
+  gfx::vertex3f(0., cpuHight, -cpuLength - 0.04);
+  gfx::vertex3f(cpuWidth, cpuHight, -cpuLength - 0.04);
+  gfx::vertex3f(cpuWidth, cpuHight, -.04);
+  gfx::end();
 
   // Top
-  glBegin(GL_POLYGON);
-  glVertex3f(0.7, thickness + cpuHight, -.04);
-  glVertex3f(0.5, thickness + cpuHight, 0.);
-  glVertex3f(0., thickness + cpuHight, 0.);
-  glVertex3f(0., thickness + cpuHight, -cpuLength - 0.04);
-  glVertex3f(cpuWidth, thickness + cpuHight, -cpuLength - 0.04);
-  glVertex3f(cpuWidth, thickness + cpuHight, -.04);
-  glEnd();
-
-  glColor3fv(cabinetColor);
+  gfx::begin(GL_POLYGON);
+  gfx::vertex3f(0.7, thickness + cpuHight, -.04);
+  gfx::vertex3f(0.5, thickness + cpuHight, 0.);
+  gfx::vertex3f(0., thickness + cpuHight, 0.);
+  gfx::vertex3f(0., thickness + cpuHight, -cpuLength - 0.04);
+  gfx::vertex3f(cpuWidth, thickness + cpuHight, -cpuLength - 0.04);
+  gfx::vertex3f(cpuWidth, thickness + cpuHight, -.04);
+  gfx::end();
+
+  gfx::color3fv(cabinetColor);
   // Lside
-  glBegin(GL_POLYGON);
-  glVertex3f(0., cpuHight, 0.);
-  glVertex3f(0., thickness + cpuHight, 0.);
-  glVertex3f(0., thickness + cpuHight, -cpuLength - 0.04);
-  glVertex3f(0., cpuHight, -cpuLength - 0.04);
-  glEnd();
-
-  glColor3fv(cabinetColor);
+  gfx::begin(GL_POLYGON);
+  gfx::vertex3f(0., cpuHight, 0.);
+  gfx::vertex3f(0., thickness + cpuHight, 0.);
+  gfx::vertex3f(0., thickness + cpuHight, -cpuLength - 0.04);
+  gfx::vertex3f(0., cpuHight, -cpuLength - 0.04);
+  gfx::end();
+
+  gfx::color3fv(cabinetColor);
   // Right Side
-  glBegin(GL_POLYGON);
-  glVertex3f(cpuWidth, cpuHight, -.1);
-  glVertex3f(cpuWidth, thickness + cpuHight, -.1);
-  glVertex3f(cpuWidth, thickness + cpuHight, -cpuLength - 0.04);
-  glVertex3f(cpuWidth, cpuHight, -cpuLength - 0.04);
-  glEnd();
+  gfx::begin(GL_POLYGON);
+  gfx::vertex3f(cpuWidth, cpuHight, -.1);
+  gfx::vertex3f(cpuWidth, thickness + cpuHight, -.1);
+  gfx::vertex3f(cpuWidth, thickness + cpuHight, -cpuLength - 0.04);
+  gfx::vertex3f(cpuWidth, cpuHight, -cpuLength - 0.04);
+  gfx::end();
 
   // Front Side
-  glBegin(GL_QUAD_STRIP);
-  glVertex3f(0., cpuHight, 0.);
-  glVertex3f(0., cpuHight + thickness, 0.);
-  glVertex3f(0.5, cpuHight, 0.);
-  glVertex3f(0.5, cpuHight + thickness, 0.);
-  glVertex3f(0.7, cpuHight, -.04);
-  glVertex3f(0.7, cpuHight + thickness, -.04);
-  glVertex3f(cpuWidth, cpuHight, -.04);
-  glVertex3f(cpuWidth, cpuHight + thickness, -.04);
-  glEnd();
+  gfx::begin(GL_QUAD_STRIP);
+  gfx::vertex3f(0., cpuHight, 0.);
+  gfx::vertex3f(0., cpuHight + thickness, 0.);
+  gfx::vertex3f(0.5, cpuHight, 0.);
+  gfx::vertex3f(0.5, cpuHight + thickness, 0.);
+  gfx::vertex3f(0.7, cpuHight, -.04);
+  gfx::vertex3f(0.7, cpuHight + thickness, -.04);
+  gfx::vertex3f(cpuWidth, cpuHight, -.04);
+  gfx::vertex3f(cpuWidth, cpuHight + thickness, -.04);
+  gfx::end();
 
   // Back Side
-  glBegin(GL_QUAD_STRIP);
-  glVertex3f(0., cpuHight, -cpuLength - 0.04);
-  glVertex3f(0., cpuHight + thickness, -cpuLength - 0.04);
-  glVertex3f(cpuWidth, cpuHight, -cpuLength - 0.04);
-  glVertex3f(cpuWidth, cpuHight + thickness, -cpuLength - 0.04);
-  glEnd();
-
-  glPopMatrix();
+  gfx::begin(GL_QUAD_STRIP);
+  gfx::vertex3f(0., cpuHight, -cpuLength - 0.04);
+  gfx::vertex3f(0., cpuHight + thickness, -cpuLength - 0.04);
+  gfx::vertex3f(cpuWidth, cpuHight, -cpuLength - 0.04);
+  gfx::vertex3f(cpuWidth, cpuHight + thickness, -cpuLength - 0.04);
+  gfx::end();
+
+  gfx::pop_matrix();
 }
 
 void cpu_case::draw_sidebar() {
@@ -596,124 +621,124 @@ void cpu_case::draw_sidebar() {
   GLfloat frontSpace = 0.07;
 
   // Side plate
-  glPushMatrix();
-  glEnable(GL_TEXTURE_2D);
-  glBindTexture(GL_TEXTURE_2D, textures[CPU_CASE_SIDEBAR]);
-  glColor3f(1., 1., 1.);
-  glBegin(GL_POLYGON);
-  glTexCoord2f(1., 0.);
-  glVertex3f(0., lowerBound, -frontSpace);
-  glTexCoord2f(0., 0.);
-  glVertex3f(0., lowerBound, -cpuLength * 0.3 - frontSpace);
-  glTexCoord2f(0., 1.);
-  glVertex3f(0., cpuHight - 0.01, -cpuLength * 0.3 - frontSpace);
-  glTexCoord2f(1., 1.);
-  glVertex3f(0., cpuHight - 0.01, -frontSpace);
-  glEnd();
-  glDisable(GL_TEXTURE_2D);
+  gfx::push_matrix();
+  gfx::enable(GL_TEXTURE_2D);
+  gfx::bind_texture(textures[CPU_CASE_SIDEBAR]);
+  gfx::color3f(1., 1., 1.);
+  gfx::begin(GL_POLYGON);
+  gfx::tex_coord2f(1., 0.);
+  gfx::vertex3f(0., lowerBound, -frontSpace);
+  gfx::tex_coord2f(0., 0.);
+  gfx::vertex3f(0., lowerBound, -cpuLength * 0.3 - frontSpace);
+  gfx::tex_coord2f(0., 1.);
+  gfx::vertex3f(0., cpuHight - 0.01, -cpuLength * 0.3 - frontSpace);
+  gfx::tex_coord2f(1., 1.);
+  gfx::vertex3f(0., cpuHight - 0.01, -frontSpace);
+  gfx::end();
+  gfx::disable(GL_TEXTURE_2D);
 
   // Thickness layer
-  glBegin(GL_POLYGON);
-  glColor3fv(cabinetColor);
-  glVertex3f(0., cpuHight - 0.01, -cpuLength * 0.3);
-  glVertex3f(thickness, cpuHight - 0.01, -cpuLength * 0.3);
-  glVertex3f(0., lowerBound, -cpuLength * 0.3);
-  glVertex3f(thickness, lowerBound, -cpuLength * 0.3);
-  // glVertex3f(thickness, lowerBound, 0.);
-  // glVertex3f(thickness, cpuHight - 0.01, -cpuLength * 0.3);
-  // glVertex3f(thickness, cpuHight - 0.01, 0.);
-  glEnd();
+  gfx::begin(GL_POLYGON);
+  gfx::color3fv(cabinetColor);
+  gfx::vertex3f(0., cpuHight - 0.01, -cpuLength * 0.3);
+  gfx::vertex3f(thickness, cpuHight - 0.01, -cpuLength * 0.3);
+  gfx::vertex3f(0., lowerBound, -cpuLength * 0.3);
+  gfx::vertex3f(thickness, lowerBound, -cpuLength * 0.3);
+  // gfx::vertex3f(thickness, lowerBound, 0.);
+  // gfx::vertex3f(thickness, cpuHight - 0.01, -cpuLength * 0.3);
+  // gfx::vertex3f(thickness, cpuHight - 0.01, 0.);
+  gfx::end();
 
   // Gap filler to front
-  glBegin(GL_POLYGON);
-  glColor3b(0, 1, 0);
-  glVertex3f(0., lowerBound, 0.);
-  glVertex3f(0., lowerBound, -frontSpace);
-  glVertex3f(0., cpuHight - 0.01, -frontSpace);
-  glVertex3f(0., cpuHight - 0.01, 0.);
-  glEnd();
-
-  glPopMatrix();
+  gfx::begin(GL_POLYGON);
+  gfx::color3b(0, 1, 0);
+  gfx::vertex3f(0., lowerBound, 0.);
+  gfx::vertex3f(0., lowerBound, -frontSpace);
+  gfx::vertex3f(0., cpuHight - 0.01, -frontSpace);
+  gfx::vertex3f(0., cpuHight - 0.01, 0.);
+  gfx::end();
+
+  gfx::pop_matrix();
 }
 
 void cpu_case::draw_legs() {
   GLfloat padding = 0.2;
 
-  glPushMatrix();
+  gfx::push_matrix();
   // Left Front
-  glColor3f(0., 0., 0.);
-  glTranslatef(0.05, -.215, -0.15);
-  glScalef(0.1, 0.1, 0.1);
-  glBegin(GL_QUAD_STRIP);
-  glVertex3f(padding, 0., 0.);
-  glVertex3f(0., 1., 0.);
-  glVertex3f(1. - padding, 0., 0.);
-  glVertex3f(1., 1., 0.);
-  glVertex3f(1. - padding, 0., -1.);
-  glVertex3f(1, 1., -1.);
-  glVertex3f(padding, 0., -1.);
-  glVertex3f(0., 1., -1.);
-  glVertex3f(padding, 0., 0.);
-  glVertex3f(0., 1., 0.);
-  glEnd();
-  glPopMatrix();
+  gfx::color3f(0., 0., 0.);
+  gfx::translatef(0.05, -.215, -0.15);
+  gfx::scalef(0.1, 0.1, 0.1);
+  gfx::begin(GL_QUAD_STRIP);
+  gfx::vertex3f(padding, 0., 0.);
+  gfx::vertex3f(0., 1., 0.);
+  gfx::vertex3f(1. - padding, 0., 0.);
+  gfx::vertex3f(1., 1., 0.);
+  gfx::vertex3f(1. - padding, 0., -1.);
+  gfx::vertex3f(1, 1., -1.);
+  gfx::vertex3f(padding, 0., -1.);
+  gfx::vertex3f(0., 1., -1.);
+  gfx::vertex3f(padding, 0., 0.);
+  gfx::vertex3f(0., 1., 0.);
+  gfx::end();
+  gfx::pop_matrix();
 
   // Right Front
-  glPushMatrix();
-  glColor3f(0., 0., 0.);
-  glTranslatef(cpuWidth - .1, -.215, -0.1);
-  glScalef(0.1, 0.1, 0.1);
-  glBegin(GL_QUAD_STRIP);
-  glVertex3f(padding, 0., 0.);
-  glVertex3f(0., 1., 0.);
-  glVertex3f(1. - padding, 0., 0.);
-  glVertex3f(1., 1., 0.);
-  glVertex3f(1. - padding, 0., -1.);
-  glVertex3f(1, 1., -1.);
-  glVertex3f(padding, 0., -1.);
-  glVertex3f(0., 1., -1.);
-  glVertex3f(padding, 0., 0.);
-  glVertex3f(0., 1., 0.);
-  glEnd();
-  glPopMatrix();
+  gfx::push_matrix();
+  gfx::color3f(0., 0., 0.);
+  gfx::translatef(cpuWidth - .1, -.215, -0.1);
+  gfx::scalef(0.1, 0.1, 0.1);
+  gfx::begin(GL_QUAD_STRIP);
+  gfx::vertex3f(padding, 0., 0.);
+  gfx::vertex3f(0., 1., 0.);
+  gfx::vertex3f(1. - padding, 0., 0.);
+  gfx::vertex3f(1., 1., 0.);
+  gfx::vertex3f(1. - padding, 0., -1.);
+  gfx::vertex3f(1, 1., -1.);
+  gfx::vertex3f(padding, 0., -1.);
+  gfx::vertex3f(0., 1., -1.);
+  gfx::vertex3f(padding, 0., 0.);
+  gfx::vertex3f(0., 1., 0.);
+  gfx::end();
+  gfx::pop_matrix();
 
   // Right Back
-  glPushMatrix();
-  glColor3f(0., 0., 0.);
-  glTranslatef(cpuWidth - .1, -.215, -cpuLength + 0.1);
-  glScalef(0.1, 0.1, 0.1);
-  glBegin(GL_QUAD_STRIP);
-  glVertex3f(padding, 0., 0.);
-  glVertex3f(0., 1., 0.);
-  glVertex3f(1. - padding, 0., 0.);
-  glVertex3f(1., 1., 0.);
-  glVertex3f(1. - padding, 0., -1.);
-  glVertex3f(1, 1., -1.);
-  glVertex3f(padding, 0., -1.);
-  glVertex3f(0., 1., -1.);
-  glVertex3f(padding, 0., 0.);
-  glVertex3f(0., 1., 0.);
-  glEnd();
-  glPopMatrix();
+  gfx::push_matrix();
+  gfx::color3f(0., 0., 0.);
+  gfx::translatef(cpuWidth - .1, -.215, -cpuLength + 0.1);
+  gfx::scalef(0.1, 0.1, 0.1);
+  gfx::begin(GL_QUAD_STRIP);
+  gfx::vertex3f(padding, 0., 0.);
+  gfx::vertex3f(0., 1., 0.);
+  gfx::vertex3f(1. - padding, 0., 0.);
+  gfx::vertex3f(1., 1., 0.);
+  gfx::vertex3f(1. - padding, 0., -1.);
+  gfx::vertex3f(1, 1., -1.);
+  gfx::vertex3f(padding, 0., -1.);
+  gfx::vertex3f(0., 1., -1.);
+  gfx::vertex3f(padding, 0., 0.);
+  gfx::vertex3f(0., 1., 0.);
+  gfx::end();
+  gfx::pop_matrix();
 
   // Left Back
-  glPushMatrix();
-  glColor3f(0., 0., 0.);
-  glTranslatef(.05, -.215, -cpuLength + 0.1);
-  glScalef(0.1, 0.1, 0.1);
-  glBegin(GL_QUAD_STRIP);
-  glVertex3f(padding, 0., 0.);
-  glVertex3f(0., 1., 0.);
-  glVertex3f(1. - padding, 0., 0.);
-  glVertex3f(1., 1., 0.);
-  glVertex3f(1. - padding, 0., -1.);
-  glVertex3f(1, 1., -1.);
-  glVertex3f(padding, 0., -1.);
-  glVertex3f(0., 1., -1.);
-  glVertex3f(padding, 0., 0.);
-  glVertex3f(0., 1., 0.);
-  glEnd();
-  glPopMatrix();
+  gfx::push_matrix();
+  gfx::color3f(0., 0., 0.);
+  gfx::translatef(.05, -.215, -cpuLength + 0.1);
+  gfx::scalef(0.1, 0.1, 0.1);
+  gfx::begin(GL_QUAD_STRIP);
+  gfx::vertex3f(padding, 0., 0.);
+  gfx::vertex3f(0., 1., 0.);
+  gfx::vertex3f(1. - padding, 0., 0.);
+  gfx::vertex3f(1., 1., 0.);
+  gfx::vertex3f(1. - padding, 0., -1.);
+  gfx::vertex3f(1, 1., -1.);
+  gfx::vertex3f(padding, 0., -1.);
+  gfx::vertex3f(0., 1., -1.);
+  gfx::vertex3f(padding, 0., 0.);
+  gfx::vertex3f(0., 1., 0.);
+  gfx::end();
+  gfx::pop_matrix();
 }
 
 #endif
\ No newline at end of file
@@ -1,25 +1,28 @@
 #ifndef CPU_CHIPSET
 #define CPU_CHIPSET
 
+#include "frame_snapshot.h"
+#include "gfx.h"
 #include "parameter.h"
 
 class cpu_chipset {
-  point3D move;
+  point3D move, prevMove; /// Offset now and one sim step ago
   bool visible = true;
   bool objMove = false;
   void motionHandle();
 
 public:
-  // Accessor for dynamic tooltip
-  point3D getOffset() { return move; }
-  void render();
+  // Snapshot of the sim state for the frame builder / tooltips
+  PartPose pose() const;
+  void update();
+  void render(const PartPose &, float);
 };
 
 void cpu_chipset::motionHandle() {
   if (((enterPressed && objIndex == REMOVE_PROCESSOR) || objMove == true) &&
       !assemble) {
     objMove = true;
-    move.x -= 0.007;
+    move.x -= disassembleSpeed * SIM_DT;
     if (move.x < disapphereLimit) {
       objMove = false;
       enterPressed = false;
@@ -30,7 +33,7 @@ void cpu_chipset::motionHandle() {
              assemble) {
     objMove = true;
     visible = true;
-    move.x += 0.007;
+    move.x += disassembleSpeed * SIM_DT;
     if (move.x >= 0.) {
       objMove = false;
       enterPressed = false;
@@ -38,81 +41,90 @@ void cpu_chipset::motionHandle() {
   }
 }
 
-void cpu_chipset::render() {
+PartPose cpu_chipset::pose() const {
+  PartPose p = {prevMove, move, 0.0f, 0.0f, visible};
+  return p;
+}
 
+void cpu_chipset::update() {
+  prevMove = move;
   motionHandle();
-  if (!visible)
+}
+
+void cpu_chipset::render(const PartPose &pose, float t) {
+  if (!pose.visible)
     return;
-  glPushMatrix();
-  glTranslatef(move.x, move.y, move.z);
-  glColor3f(1, 1, 1);
-  glTranslatef(8., 4.77, -4.7);
-  glRotatef(-90., 0., 1., 0.);
-  glScalef(0.2, 0.2, 0.2);
-  glEnable(GL_TEXTURE_2D);
-  glBindTexture(GL_TEXTURE_2D, textures[CHIPSET]);
-  glColor3f(1, 1, 1);
-  glBegin(GL_POLYGON);
-  glTexCoord2f(0., 0.);
-  glVertex3f(0, 0, 0.05);
-  glTexCoord2f(1., 0);
-  glVertex3f(1, 0, 0.05);
-  glTexCoord2f(1, 1);
-  glVertex3f(1, 1, 0.05);
-  glTexCoord2f(0., 1);
-  glVertex3f(0, 1, 0.05);
-  glEnd();
-
-  glDisable(GL_TEXTURE_2D);
-
-  glEnable(GL_TEXTURE_2D);
-  glColor3f(1, 1, 1);
-  glBindTexture(GL_TEXTURE_2D, textures[CHIPSET_BACK]);
-
-  glBegin(GL_POLYGON);
-  glTexCoord2f(0., 0.);
-  glVertex3f(0, 0, 0);
-  glTexCoord2f(1., 0);
-  glVertex3f(1, 0, 0);
-  glTexCoord2f(1, 1);
-  glVertex3f(1, 1, 0.0);
-  glTexCoord2f(0., 1);
-  glVertex3f(0, 1, 0.0);
-  glEnd();
-
-  glDisable(GL_TEXTURE_2D);
-
-  glColor3f(0, .1, 0);
-
-  glBegin(GL_POLYGON);
-  glVertex3f(0, 1, 0.0);
-  glVertex3f(1, 1, 0.0);
-  glVertex3f(1, 1, 0.05);
-  glVertex3f(0, 1, 0.05);
-  glEnd();
-
-  glBegin(GL_POLYGON);
-  glVertex3f(0, 0, 0.0);
-  glVertex3f(1, 0, 0.0);
-  glVertex3f(1, 0, 0.05);
-  glVertex3f(0, 0, 0.05);
-  glEnd();
-
-  glBegin(GL_POLYGON);
-  glVertex3f(0, 0, 0.0);
-  glVertex3f(0, 1, 0.0);
-  glVertex3f(0, 1, 0.05);
-  glVertex3f(0, 0, 0.05);
-  glEnd();
-
-  glBegin(GL_POLYGON);
-  glVertex3f(1, 0, 0.0);
-  glVertex3f(1, 1, 0.0);
-  glVertex3f(1, 1, 0.05);
-  glVertex3f(1, 0, 0.05);
-  glEnd();
-
-  glPopMatrix();
+  gfx::push_matrix();
+  point3D m = pose.at(t);
+  gfx::translatef(m.x, m.y, m.z);
+  gfx::color3f(1, 1, 1);
+  gfx::translatef(8., 4.77, -4.7);
+  gfx::rotatef(-90., 0., 1., 0.);
+  gfx::scalef(0.2, 0.2, 0.2);
+  gfx::enable(GL_TEXTURE_2D);
+  gfx::bind_texture(textures[CHIPSET]);
+  gfx::color3f(1, 1, 1);
+  gfx::begin(GL_POLYGON);
+  gfx::tex_coord2f(0., 0.);
+  gfx::vertex3f(0, 0, 0.05);
+  gfx::tex_coord2f(1., 0);
+  gfx::vertex3f(1, 0, 0.05);
+  gfx::tex_coord2f(1, 1);
+  gfx::vertex3f(1, 1, 0.05);
+  gfx::tex_coord2f(0., 1);
+  gfx::vertex3f(0, 1, 0.05);
+  gfx::end();
+
+  gfx::disable(GL_TEXTURE_2D);
+
+  gfx::enable(GL_TEXTURE_2D);
+  gfx::color3f(1, 1, 1);
+  gfx::bind_texture(textures[CHIPSET_BACK]);
+
+  gfx::begin(GL_POLYGON);
+  gfx::tex_coord2f(0., 0.);
+  gfx::vertex3f(0, 0, 0);
+  gfx::tex_coord2f(1., 0);
+  gfx::vertex3f(1, 0, 0);
+  gfx::tex_coord2f(1, 1);
+  gfx::vertex3f(1, 1, 0.0);
+  gfx::tex_coord2f(0., 1);
+  gfx::vertex3f(0, 1, 0.0);
+  gfx::end();
+
+  gfx::disable(GL_TEXTURE_2D);
+
+  gfx::color3f(0, .1, 0);
+
+  gfx::begin(GL_POLYGON);
+  gfx::vertex3f(0, 1, 0.0);
+  gfx::vertex3f(1, 1, 0.0);
+  gfx::vertex3f(1, 1, 0.05);
+  gfx::vertex3f(0, 1, 0.05);
+  gfx::end();
+
+  gfx::begin(GL_POLYGON);
+  gfx::vertex3f(0, 0, 0.0);
+  gfx::vertex3f(1, 0, 0.0);
+  gfx::vertex3f(1, 0, 0.05);
+  gfx::vertex3f(0, 0, 0.05);
+  gfx::end();
+
+  gfx::begin(GL_POLYGON);
+  gfx::vertex3f(0, 0, 0.0);
+  gfx::vertex3f(0, 1, 0.0);
+  gfx::vertex3f(0, 1, 0.05);
+  gfx::vertex3f(0, 0, 0.05);
+  gfx::end();
+
+  gfx::begin(GL_POLYGON);
+  gfx::vertex3f(1, 0, 0.0);
+  gfx::vertex3f(1, 1, 0.0);
+  gfx::vertex3f(1, 1, 0.05);
+  gfx::vertex3f(1, 0, 0.05);
+  gfx::end();
+
+  gfx::pop_matrix();
 }
 
 #endif CPU_CHIPSET
@@ -1,6 +1,8 @@
 #ifndef CPU_FAN
 #define CPU_FAN
 #include "dragHandler.h"
+#include "frame_snapshot.h"
+#include "gfx.h"
 #include "parameter.h"
 
 class cpu_fan {
@@ -11,6 +13,7 @@ private:
   GLfloat c_rim[3] = {0., 0., 0.};
   GLfloat c_blade[3] = {.0, .0, .0};
   GLfloat fan_spin_theta = 0, y_spin = 0;
+  GLfloat prev_spin_theta = 0;
   GLuint fan_no_blades = 6;
   int sides = 30;
   float rim_start = 0., rim_end = -0.9;
@@ -27,41 +30,42 @@ private:
       {4., 17.57, -0.55}, {3., 17.4, -0.6},   {2., 16.46, -0.65},
       {1.3, 16., -0.7},   {1., 15.46, -0.75}, {0.5, 15., -0.8},
       {0.15, 14., -0.85}, {0.123, 13., -0.9}, {0.12, 12., -0.95}};
-  point3D move;
+  point3D move, prevMove; /// Offset now and one sim step ago
   GLfloat viewTheta = 0.;
 
   bool visible = true;
   bool objMove = false;
 
-  void draw_fan_blades();
-  void draw_fan_center();
+  void draw_fan_blades(GLfloat);
+  void draw_fan_center(GLfloat);
   void draw_fan_rim();
   void draw_cooler_grills();
   void showDescrpiton();
   void motionHandle();
 
 public:
-  // Accessor for dynamic tooltip
-  point3D getOffset() { return move; }
-  void render();
+  // Snapshot of the sim state for the frame builder / tooltips
+  PartPose pose() const;
+  void update();
+  void render(const PartPose &, float);
 };
 
 void cpu_fan::showDescrpiton() {
   GLfloat diff = 1.5;
 
-  glPushMatrix();
-  glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-  glEnable(GL_BLEND);
+  gfx::push_matrix();
+  gfx::blend_func(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+  gfx::enable(GL_BLEND);
 
   //	Transperent Glass Frame
-  glColor4f(0., 0., 0., .7);
-  glBegin(GL_POLYGON);
-  glVertex3f(-10., -10., objLoc.z - diff);
-  glVertex3f(-10., 10., objLoc.z - diff);
-  glVertex3f(10., 10., objLoc.z - diff);
-  glVertex3f(10., -10., objLoc.z - diff);
-  glEnd();
-  glPopMatrix();
+  gfx::color4f(0., 0., 0., .7);
+  gfx::begin(GL_POLYGON);
+  gfx::vertex3f(-10., -10., objLoc.z - diff);
+  gfx::vertex3f(-10., 10., objLoc.z - diff);
+  gfx::vertex3f(10., 10., objLoc.z - diff);
+  gfx::vertex3f(10., -10., objLoc.z - diff);
+  gfx::end();
+  gfx::pop_matrix();
 }
 
 void cpu_fan::motionHandle() {
@@ -69,7 +73,7 @@ void cpu_fan::motionHandle() {
   if (((enterPressed && objIndex == REMOVE_FAN) || objMove == true) &&
       !assemble) {
     objMove = true;
-    move.x -= 0.007;
+    move.x -= disassembleSpeed * SIM_DT;
     if (move.x < disapphereLimit) {
       enterPressed = false;
       visible = false;
@@ -80,7 +84,7 @@ void cpu_fan::motionHandle() {
              assemble) {
     objMove = true;
     visible = true;
-    move.x += 0.007;
+    move.x += disassembleSpeed * SIM_DT;
     if (move.x >= 0.) {
       enterPressed = false;
       objMove = false;
@@ -88,272 +92,288 @@ void cpu_fan::motionHandle() {
   }
 }
 
-void cpu_fan::render() {
+PartPose cpu_fan::pose() const {
+  PartPose p = {prevMove, move, prev_spin_theta, fan_spin_theta, visible};
+  return p;
+}
+
+void cpu_fan::update() {
+  prevMove = move;
   motionHandle();
-  if (!visible)
+
+  prev_spin_theta = fan_spin_theta;
+  fan_spin_theta += fanSpinSpeed * SIM_DT;
+  if (fan_spin_theta >= 360) {
+    fan_spin_theta -= 360;
+    prev_spin_theta -= 360;
+  }
+}
+
+void cpu_fan::render(const PartPose &pose, float t) {
+  if (!pose.visible)
     return;
-  glPushMatrix();
-  glTranslatef(move.x, move.y, move.z);
-  glRotatef(viewTheta, 0., 1., 0.);
-  glColor3f(.001, 0.001, .001);
-  glTranslatef(-0.974, .52, -0.745);
-  glTranslatef(8.72, 4.321, -3.821);
+  gfx::push_matrix();
+  point3D m = pose.at(t);
+  gfx::translatef(m.x, m.y, m.z);
+  gfx::rotatef(viewTheta, 0., 1., 0.);
+  gfx::color3f(.001, 0.001, .001);
+  gfx::translatef(-0.974, .52, -0.745);
+  gfx::translatef(8.72, 4.321, -3.821);
   /// Remove this to stop rotate
-  // glRotatef(y_spin * 0.5, 0., 1., 0.); //Rotate whole on Y axis
+  // gfx::rotatef(y_spin * 0.5, 0., 1., 0.); //Rotate whole on Y axis
   // y_spin += 2.;
   // if (y_spin >= 720.) y_spin = 0;
-  glRotatef(-90., 0., 1., 0.);
-  glScalef(0.009375, 0.009375, 0.046875);
-  draw_fan_blades();
-  draw_fan_center();
+  gfx::rotatef(-90., 0., 1., 0.);
+  gfx::scalef(0.009375, 0.009375, 0.046875);
+  draw_fan_blades(pose.spinAt(t));
+  draw_fan_center(pose.spinAt(t));
   draw_fan_rim();
   draw_cooler_grills();
-  glPopMatrix();
+  gfx::pop_matrix();
 }
 
-void cpu_fan::draw_fan_blades() {
+void cpu_fan::draw_fan_blades(GLfloat spin) {
   /*	This produces blades.
           Number of blades = 'fan_no_blades'
           Co-ordinates are given in class 'v_blade'
-          'fan_spin_theta' - incremented for rotation for blades.
+          'spin' - blade angle, advanced in update() & blended per frame.
   */
-  glPushMatrix();
-  glRotatef(fan_spin_theta, 0, 0, 1);
+  gfx::push_matrix();
+  gfx::rotatef(spin, 0, 0, 1);
   for (int i = 0; i < fan_no_blades; i++) {
-    glPushMatrix();
-    glColor3fv(c_blade);
-    glRotatef(i * 360.0 / (float)fan_no_blades, 0.0, 0.0, 1.);
-    glBegin(GL_POLYGON);
+    gfx::push_matrix();
+    gfx::color3fv(c_blade);
+    gfx::rotatef(i * 360.0 / (float)fan_no_blades, 0.0, 0.0, 1.);
+    gfx::begin(GL_POLYGON);
     for (int j = 0; j < 30; j++)
-      glVertex3fv(v_blade[j]);
-    glEnd();
-    glPopMatrix();
+      gfx::vertex3fv(v_blade[j]);
+    gfx::end();
+    gfx::pop_matrix();
   }
-  fan_spin_theta += deltaTime * 0.1;
-  if (fan_spin_theta >= 360)
-    fan_spin_theta = 0;
-  glPopMatrix();
+  gfx::pop_matrix();
 }
 
-void cpu_fan::draw_fan_center() {
+void cpu_fan::draw_fan_center(GLfloat spin) {
   /*	Draws the center cylinder of fan
           Draws circle using 'GL_TRIANGLE_FAN' using sin() & cos() function
           Draws multiple circles one behind another
   */
-  glPushMatrix();
+  gfx::push_matrix();
   // For the width of cylinder
   float centerScale = 4;
-  glPushMatrix();
-  glRotatef(fan_spin_theta, 0, 0, 1);
+  gfx::push_matrix();
+  gfx::rotatef(spin, 0, 0, 1);
   // Center Front Circle
-  glColor3fv(c_center);
-  glBegin(GL_TRIANGLE_FAN);
-  glVertex3f(0., 0., rim_start);
+  gfx::color3fv(c_center);
+  gfx::begin(GL_TRIANGLE_FAN);
+  gfx::vertex3f(0., 0., rim_start);
   for (int i = 0; i <= sides; i++)
-    glVertex3f(sin(rad(i * 360 / sides)) * centerScale,
+    gfx::vertex3f(sin(rad(i * 360 / sides)) * centerScale,
                cos(rad(i * 360 / sides)) * centerScale, rim_start);
-  glEnd();
+  gfx::end();
 
   float diff = 1.2;
-  glEnable(GL_TEXTURE_2D);
-  glBindTexture(GL_TEXTURE_2D, textures[FAN_LOGO]);
-  glColor3f(1., 1., 1.);
-  glBegin(GL_POLYGON);
-  glTexCoord2i(1, 1);
-  glVertex3f(centerScale - diff, centerScale - diff, 0.01);
-  glTexCoord2i(1, 0);
-  glVertex3f(centerScale - diff, -centerScale + diff, 0.01);
-  glTexCoord2i(0, 0);
-  glVertex3f(-centerScale + diff, -centerScale + diff, 0.01);
-  glTexCoord2i(0, 1);
-  glVertex3f(-centerScale + diff, centerScale - diff, 0.01);
-  glEnd();
-  glDisable(GL_TEXTURE_2D);
+  gfx::enable(GL_TEXTURE_2D);
+  gfx::bind_texture(textures[FAN_LOGO]);
+  gfx::color3f(1., 1., 1.);
+  gfx::begin(GL_POLYGON);
+  gfx::tex_coord2i(1, 1);
+  gfx::vertex3f(centerScale - diff, centerScale - diff, 0.01);
+  gfx::tex_coord2i(1, 0);
+  gfx::vertex3f(centerScale - diff, -centerScale + diff, 0.01);
+  gfx::tex_coord2i(0, 0);
+  gfx::vertex3f(-centerScale + diff, -centerScale + diff, 0.01);
+  gfx::tex_coord2i(0, 1);
+  gfx::vertex3f(-centerScale + diff, centerScale - diff, 0.01);
+  gfx::end();
+  gfx::disable(GL_TEXTURE_2D);
 
   // Center Rear Circle
-  glColor3fv(c_center);
-  glBegin(GL_TRIANGLE_FAN);
-  glVertex3f(0., 0., rim_end);
+  gfx::color3fv(c_center);
+  gfx::begin(GL_TRIANGLE_FAN);
+  gfx::vertex3f(0., 0., rim_end);
   for (int i = 0; i <= sides; i++)
-    glVertex3f(sin(rad(i * 360 / sides)) * centerScale,
+    gfx::vertex3f(sin(rad(i * 360 / sides)) * centerScale,
                cos(rad(i * 360 / sides)) * centerScale, rim_end);
-  glEnd();
+  gfx::end();
 
   // Center Cover
-  glBegin(GL_QUAD_STRIP);
+  gfx::begin(GL_QUAD_STRIP);
   for (int i = 0; i <= sides; i++) {
-    glVertex3f(sin(rad(i * 360 / sides)) * centerScale,
+    gfx::vertex3f(sin(rad(i * 360 / sides)) * centerScale,
                cos(rad(i * 360 / sides)) * centerScale, rim_start);
-    glVertex3f(sin(rad(i * 360 / sides)) * centerScale,
+    gfx::vertex3f(sin(rad(i * 360 / sides)) * centerScale,
                cos(rad(i * 360 / sides)) * centerScale, rim_end);
   }
-  glEnd();
-  glPopMatrix();
+  gfx::end();
+  gfx::pop_matrix();
 
   // Center Rear Props
-  glPushMatrix();
-  glColor3f(0.1, 0.1, 0.1);
+  gfx::push_matrix();
+  gfx::color3f(0.1, 0.1, 0.1);
   float prop_thickness = 0.8;
   for (int i = 0; i < 4; i++) {
-    glRotatef(i * 90, 0., 0., 1.);
-    glBegin(GL_POLYGON);
-    glVertex3f(-prop_thickness, 0., rim_end + 0.1);
-    glVertex3f(prop_thickness, 0., rim_end + 0.1);
-    glVertex3f(prop_thickness, 19., rim_end + 0.1);
-    glVertex3f(-prop_thickness, 19., rim_end + 0.1);
-    glEnd();
+    gfx::rotatef(i * 90, 0., 0., 1.);
+    gfx::begin(GL_POLYGON);
+    gfx::vertex3f(-prop_thickness, 0., rim_end + 0.1);
+    gfx::vertex3f(prop_thickness, 0., rim_end + 0.1);
+    gfx::vertex3f(prop_thickness, 19., rim_end + 0.1);
+    gfx::vertex3f(-prop_thickness, 19., rim_end + 0.1);
+    gfx::end();
   }
-  glPopMatrix();
+  gfx::pop_matrix();
+  gfx::pop_matrix();
 }
 
 void cpu_fan::draw_fan_rim() {
   /*	Draws fan rim to hold and fit the fan
           Also the cylinder to fit the 'Screws'
   */
-  glPushMatrix();
-  glLineWidth(4.0);
+  gfx::push_matrix();
+  gfx::line_width(4.0);
 
   /*Inner circle*/
-  glColor3fv(c_rim);
+  gfx::color3fv(c_rim);
   float rimScale = 19.;
-  glBegin(GL_QUAD_STRIP);
+  gfx::begin(GL_QUAD_STRIP);
   for (int i = 0; i < sides; i++) {
-    glVertex3f(sin(rad(i * 360 / sides)) * rimScale,
+    gfx::vertex3f(sin(rad(i * 360 / sides)) * rimScale,
                cos(rad(i * 360 / sides)) * rimScale, rim_start);
-    glVertex3f(sin(rad(i * 360 / sides)) * rimScale,
+    gfx::vertex3f(sin(rad(i * 360 / sides)) * rimScale,
                cos(rad(i * 360 / sides)) * rimScale, rim_end);
   }
-  glEnd();
+  gfx::end();
 
   /*Outer circle*/
   rimScale = 19.8; /// This is more for outer one
-  glBegin(GL_QUAD_STRIP);
+  gfx::begin(GL_QUAD_STRIP);
   for (int i = 0; i <= sides; i++) {
-    glVertex3f(sin(rad(i * 360 / sides)) * rimScale,
+    gfx::vertex3f(sin(rad(i * 360 / sides)) * rimScale,
                cos(rad(i * 360 / sides)) * rimScale, rim_start);
-    glVertex3f(sin(rad(i * 360 / sides)) * rimScale,
+    gfx::vertex3f(sin(rad(i * 360 / sides)) * rimScale,
                cos(rad(i * 360 / sides)) * rimScale, rim_end);
   }
-  glEnd();
+  gfx::end();
 
   /*Front and Back Plates*/
   float rimScale_out = 19.8, rimScale_in = 19.; /// This is more for outer one
-  glBegin(GL_QUAD_STRIP);
+  gfx::begin(GL_QUAD_STRIP);
   for (int i = 0; i <= sides; i++) {
-    glVertex3f(sin(rad(i * 360 / sides)) * rimScale_out,
+    gfx::vertex3f(sin(rad(i * 360 / sides)) * rimScale_out,
                cos(rad(i * 360 / sides)) * rimScale_out, rim_start);
-    glVertex3f(sin(rad(i * 360 / sides)) * rimScale_in,
+    gfx::vertex3f(sin(rad(i * 360 / sides)) * rimScale_in,
                cos(rad(i * 360 / sides)) * rimScale_in, rim_start);
   }
-  glEnd();
+  gfx::end();
 
-  glBegin(GL_QUAD_STRIP);
+  gfx::begin(GL_QUAD_STRIP);
   for (int i = 0; i <= sides; i++) {
-    glVertex3f(sin(rad(i * 360 / sides)) * rimScale_out,
+    gfx::vertex3f(sin(rad(i * 360 / sides)) * rimScale_out,
                cos(rad(i * 360 / sides)) * rimScale_out, rim_end);
-    glVertex3f(sin(rad(i * 360 / sides)) * rimScale_in,
+    gfx::vertex3f(sin(rad(i * 360 / sides)) * rimScale_in,
                cos(rad(i * 360 / sides)) * rimScale_in, rim_end);
   }
-  glEnd();
+  gfx::end();
 
   /*Screw Holder*/
-  glPushMatrix();
-  glColor3f(0., 0., 0.);
+  gfx::push_matrix();
+  gfx::color3f(0., 0., 0.);
   float screw_x = 0.03, screw_y = 2.;
   for (int k = 0; k < 4; k++) {
-    glRotatef(90 * k, 0., 0., 1.);
+    gfx::rotatef(90 * k, 0., 0., 1.);
     // Front Face of screw holder
-    glBegin(GL_TRIANGLE_FAN);
+    gfx::begin(GL_TRIANGLE_FAN);
     for (int i = 0; i <= 180; i = i + 10) {
-      glVertex3f(i * screw_x - 90. * screw_x,
+      gfx::vertex3f(i * screw_x - 90. * screw_x,
                  screw_y * sin(rad(i)) + rimScale_in + 0.05, rim_start - 0.2);
     }
-    glEnd();
+    gfx::end();
     // Back Face of screw holder
-    glBegin(GL_TRIANGLE_FAN);
+    gfx::begin(GL_TRIANGLE_FAN);
     for (int i = 0; i <= 180; i = i + 10) {
-      glVertex3f(i * screw_x - 90. * screw_x,
+      gfx::vertex3f(i * screw_x - 90. * screw_x,
                  screw_y * sin(rad(i)) + rimScale_in + 0.05, rim_end);
     }
-    glEnd();
+    gfx::end();
     // Outer Cover of screw holder
-    glBegin(GL_QUAD_STRIP);
+    gfx::begin(GL_QUAD_STRIP);
     for (int i = 0; i <= 180; i = i + 10) {
-      glVertex3f(i * screw_x - 90. * screw_x,
+      gfx::vertex3f(i * screw_x - 90. * screw_x,
                  sin(rad(i)) * screw_y + rimScale_in + 0.05, rim_start - 0.2);
-      glVertex3f(i * screw_x - 90. * screw_x,
+      gfx::vertex3f(i * screw_x - 90. * screw_x,
                  sin(rad(i)) * screw_y + rimScale_in + 0.05, rim_end + 0.01);
     }
-    glEnd();
+    gfx::end();
   }
 
   /* 4. SCREW */
   for (int k = 0; k < 4; k++) {
-    glRotatef(90 * k, 0., 0., 1.);
+    gfx::rotatef(90 * k, 0., 0., 1.);
     // Front Face of screw
-    glBegin(GL_TRIANGLE_FAN);
+    gfx::begin(GL_TRIANGLE_FAN);
     for (int i = 0; i <= 270; i = i + 10) {
       /// Sine function ie. y = cos(x) is used.
-      glVertex3f(i * screw_x * cos(rad(i)) + 2,
+      gfx::vertex3f(i * screw_x * cos(rad(i)) + 2,
                  screw_y * sin(rad(i)) + rimScale_in + 0.05, mesh_start);
     }
-    glEnd();
+    gfx::end();
     // Back Face of Screw
-    glBegin(GL_TRIANGLE_FAN);
+    gfx::begin(GL_TRIANGLE_FAN);
     for (int i = 0; i <= 270; i = i + 10) {
-      glVertex3f(i * screw_x * cos(rad(i)) + 2,
+      gfx::vertex3f(i * screw_x * cos(rad(i)) + 2,
                  screw_y * sin(rad(i)) + rimScale_in + 0.05, mesh_end);
     }
-    glEnd();
+    gfx::end();
     // Outer Cover of Screw
-    glBegin(GL_QUAD_STRIP);
+    gfx::begin(GL_QUAD_STRIP);
     for (int i = 0; i <= 270; i = i + 10) {
-      glVertex3f(i * screw_x * cos(rad(i)) + 2,
+      gfx::vertex3f(i * screw_x * cos(rad(i)) + 2,
                  sin(rad(i)) * screw_y + rimScale_in + 0.05, mesh_start);
-      glVertex3f(i * screw_x * cos(rad(i)) + 2,
+      gfx::vertex3f(i * screw_x * cos(rad(i)) + 2,
                  sin(rad(i)) * screw_y + rimScale_in + 0.05, mesh_end);
     }
-    glEnd();
+    gfx::end();
   }
 
-  glPopMatrix();
+  gfx::pop_matrix();
+  gfx::pop_matrix();
 }
 
 void cpu_fan::draw_cooler_grills() {
   // Mesh that cooles the cpu
 
   /* 1. MESH CYLINDER */
-  glPushMatrix();
+  gfx::push_matrix();
 
   float meshCylinderScale = 10.;
 
   // Mesh Cylinder Front Circle
-  glColor3fv(c_meshCylinder);
-  glBegin(GL_TRIANGLE_FAN);
-  glVertex3f(0., 0., mesh_start + 0.1);
+  gfx::color3fv(c_meshCylinder);
+  gfx::begin(GL_TRIANGLE_FAN);
+  gfx::vertex3f(0., 0., mesh_start + 0.1);
   for (int i = 0; i <= sides; i++)
-    glVertex3f(sin(rad(i * 360 / sides)) * meshCylinderScale,
+    gfx::vertex3f(sin(rad(i * 360 / sides)) * meshCylinderScale,
                cos(rad(i * 360 / sides)) * meshCylinderScale, mesh_start + 0.1);
-  glEnd();
+  gfx::end();
 
   // Mesh Cylinder Rear Circle
-  glColor3fv(c_meshCylinder);
-  glBegin(GL_TRIANGLE_FAN);
-  glVertex3f(0., 0., mesh_end - 0.1);
+  gfx::color3fv(c_meshCylinder);
+  gfx::begin(GL_TRIANGLE_FAN);
+  gfx::vertex3f(0., 0., mesh_end - 0.1);
   for (int i = 0; i <= sides; i++)
-    glVertex3f(sin(rad(i * 360 / sides)) * meshCylinderScale,
+    gfx::vertex3f(sin(rad(i * 360 / sides)) * meshCylinderScale,
                cos(rad(i * 360 / sides)) * meshCylinderScale, mesh_end - 0.1);
-  glEnd();
+  gfx::end();
 
   // Mesh Cylinder Cover
-  glBegin(GL_QUAD_STRIP);
+  gfx::begin(GL_QUAD_STRIP);
   for (int i = 0; i <= sides; i++) {
-    glVertex3f(sin(rad(i * 360 / sides)) * meshCylinderScale,
+    gfx::vertex3f(sin(rad(i * 360 / sides)) * meshCylinderScale,
                cos(rad(i * 360 / sides)) * meshCylinderScale, mesh_start + 0.1);
-    glVertex3f(sin(rad(i * 360 / sides)) * meshCylinderScale,
+    gfx::vertex3f(sin(rad(i * 360 / sides)) * meshCylinderScale,
                cos(rad(i * 360 / sides)) * meshCylinderScale, mesh_end - 0.1);
   }
-  glEnd();
+  gfx::end();
 
   /*-------------------------------------------------------*/
   /* 2. MESH WINGS */
@@ -361,23 +381,24 @@ void cpu_fan::draw_cooler_grills() {
   float meshWingScale_y = 19.;
 
   float val = 15;
-  glPushMatrix();
-  glColor3fv(c_meshBlade);
+  gfx::push_matrix();
+  gfx::color3fv(c_meshBlade);
   for (int i = 0; i < meshCount; i++) {
-    glPushMatrix();
-    glRotatef(i * 360 / meshCount, 0., 0., 1.);
-    glBegin(GL_QUAD_STRIP);
+    gfx::push_matrix();
+    gfx::rotatef(i * 360 / meshCount, 0., 0., 1.);
+    gfx::begin(GL_QUAD_STRIP);
     for (float y = 0; y <= 180; y = y + 10) {
       /// Here the x = A. sin(y) function is used
-      glVertex3f(sin(rad(y)) * meshWingScale_x, y / 180 * meshWingScale_y,
+      gfx::vertex3f(sin(rad(y)) * meshWingScale_x, y / 180 * meshWingScale_y,
                  mesh_start);
-      glVertex3f(sin(rad(y)) * meshWingScale_x, y / 180 * meshWingScale_y,
+      gfx::vertex3f(sin(rad(y)) * meshWingScale_x, y / 180 * meshWingScale_y,
                  mesh_end);
     }
-    glEnd();
-    glPopMatrix();
+    gfx::end();
+    gfx::pop_matrix();
   }
-  glPopMatrix();
+  gfx::pop_matrix();
+  gfx::pop_matrix();
 }
 
 #endif CPU_FAN
\ No newline at end of file
@@ -1,26 +1,29 @@
 #ifndef CPU_GPU
 #define CPU_GPU
 
+#include "frame_snapshot.h"
+#include "gfx.h"
 #include "parameter.h"
 
 class cpu_gpu {
-  point3D move;
+  point3D move, prevMove; /// Offset now and one sim step ago
   bool visible = true;
   bool objMove = false;
   void lower_render();
   void motionHandle();
 
 public:
-  // Accessor for dynamic tooltip
-  point3D getOffset() { return move; }
-  void render();
+  // Snapshot of the sim state for the frame builder / tooltips
+  PartPose pose() const;
+  void update();
+  void render(const PartPose &, float);
 };
 
 void cpu_gpu::motionHandle() {
   if (((enterPressed && objIndex == REMOVE_GPU) || objMove == true) &&
       !assemble) {
     objMove = true;
-    move.x -= 0.007;
+    move.x -= disassembleSpeed * SIM_DT;
     if (move.x < disapphereLimit) {
       enterPressed = false;
       visible = false;
@@ -31,7 +34,7 @@ void cpu_gpu::motionHandle() {
     objMove = true;
     visible = true;
 
-    move.x += 0.007;
+    move.x += disassembleSpeed * SIM_DT;
     if (move.x >= 0.) {
       enterPressed = false;
       objMove = false;
@@ -39,191 +42,200 @@ void cpu_gpu::motionHandle() {
   }
 }
 
-void cpu_gpu::render() {
+PartPose cpu_gpu::pose() const {
+  PartPose p = {prevMove, move, 0.0f, 0.0f, visible};
+  return p;
+}
 
+void cpu_gpu::update() {
+  prevMove = move;
   motionHandle();
-  if (!visible)
+}
+
+void cpu_gpu::render(const PartPose &pose, float t) {
+  if (!pose.visible)
     return;
-  glPushMatrix();
-  glTranslatef(move.x, move.y, move.z);
-
-  glTranslatef(7.55, 4.2, -4.65);
-  glRotatef(-90., 0., 1., 0.);
-  glRotatef(-90., 1., 0., 0.);
-
-  glScalef(0.3, 0.3, 0.3);
-  glEnable(GL_TEXTURE_2D);
-  glColor3f(1., 1., 1.);
-  glBindTexture(GL_TEXTURE_2D, textures[GPU_FRONT]);
-
-  glBegin(GL_POLYGON);
-  glTexCoord2f(0., 0.);
-  glVertex3f(-1.75, 0, 0.2);
-  glTexCoord2f(1., 0);
-  glVertex3f(1.5, 0, 0.2);
-  glTexCoord2f(1, 1);
-  glVertex3f(1.5, 1.5, 0.2);
-  glTexCoord2f(0., 1);
-  glVertex3f(-1.75, 1.5, 0.2);
-  glEnd();
-
-  glDisable(GL_TEXTURE_2D);
+  gfx::push_matrix();
+  point3D m = pose.at(t);
+  gfx::translatef(m.x, m.y, m.z);
+
+  gfx::translatef(7.55, 4.2, -4.65);
+  gfx::rotatef(-90., 0., 1., 0.);
+  gfx::rotatef(-90., 1., 0., 0.);
+
+  gfx::scalef(0.3, 0.3, 0.3);
+  gfx::enable(GL_TEXTURE_2D);
+  gfx::color3f(1., 1., 1.);
+  gfx::bind_texture(textures[GPU_FRONT]);
+
+  gfx::begin(GL_POLYGON);
+  gfx::tex_coord2f(0., 0.);
+  gfx::vertex3f(-1.75, 0, 0.2);
+  gfx::tex_coord2f(1., 0);
+  gfx::vertex3f(1.5, 0, 0.2);
+  gfx::tex_coord2f(1, 1);
+  gfx::vertex3f(1.5, 1.5, 0.2);
+  gfx::tex_coord2f(0., 1);
+  gfx::vertex3f(-1.75, 1.5, 0.2);
+  gfx::end();
+
+  gfx::disable(GL_TEXTURE_2D);
 
   // back
-  glEnable(GL_TEXTURE_2D);
-  glColor3f(1., 1., 1.);
-  glBindTexture(GL_TEXTURE_2D, textures[GPU_LEFT]);
-
-  glBegin(GL_POLYGON);
-  glTexCoord2f(0., 0.);
-  glVertex3f(-1.75, 1.5, 0);
-  glTexCoord2f(1., 0.);
-  glVertex3f(1.5, 1.5, 0);
-  glTexCoord2f(1., 1.);
-  glVertex3f(1.5, 0, 0);
-  glTexCoord2f(0., 1.);
-  glVertex3f(-1.75, 0, 0);
-  glEnd();
-  glDisable(GL_TEXTURE_2D);
+  gfx::enable(GL_TEXTURE_2D);
+  gfx::color3f(1., 1., 1.);
+  gfx::bind_texture(textures[GPU_LEFT]);
+
+  gfx::begin(GL_POLYGON);
+  gfx::tex_coord2f(0., 0.);
+  gfx::vertex3f(-1.75, 1.5, 0);
+  gfx::tex_coord2f(1., 0.);
+  gfx::vertex3f(1.5, 1.5, 0);
+  gfx::tex_coord2f(1., 1.);
+  gfx::vertex3f(1.5, 0, 0);
+  gfx::tex_coord2f(0., 1.);
+  gfx::vertex3f(-1.75, 0, 0);
+  gfx::end();
+  gfx::disable(GL_TEXTURE_2D);
 
   // side
 
-  glEnable(GL_TEXTURE_2D);
-  glColor3f(1., 1., 1.);
-  glBindTexture(GL_TEXTURE_2D, textures[GPU_BACK]);
-  glBegin(GL_POLYGON);
+  gfx::enable(GL_TEXTURE_2D);
+  gfx::color3f(1., 1., 1.);
+  gfx::bind_texture(textures[GPU_BACK]);
+  gfx::begin(GL_POLYGON);
 
-  glTexCoord2f(0., 0.);
-  glVertex3f(-1.75, 0, 0.0);
-  glTexCoord2f(1., 0.);
-  glVertex3f(-1.75, 1.5, 0.0);
-  glTexCoord2f(1., 1.);
-  glVertex3f(-1.75, 1.5, 0.3);
-  glTexCoord2f(0., 1.);
-  glVertex3f(-1.75, 0, 0.3);
-  glEnd();
+  gfx::tex_coord2f(0., 0.);
+  gfx::vertex3f(-1.75, 0, 0.0);
+  gfx::tex_coord2f(1., 0.);
+  gfx::vertex3f(-1.75, 1.5, 0.0);
+  gfx::tex_coord2f(1., 1.);
+  gfx::vertex3f(-1.75, 1.5, 0.3);
+  gfx::tex_coord2f(0., 1.);
+  gfx::vertex3f(-1.75, 0, 0.3);
+  gfx::end();
 
-  glDisable(GL_TEXTURE_2D);
+  gfx::disable(GL_TEXTURE_2D);
 
   // side
-  glColor3f(0.2, 0.2, 0.2);
+  gfx::color3f(0.2, 0.2, 0.2);
 
-  glBegin(GL_POLYGON);
-  glVertex3f(1.5, 0, 0.0);
-  glVertex3f(1.5, 1.5, 0.0);
-  glVertex3f(1.5, 1.5, 0.2);
-  glVertex3f(1.5, 0, 0.2);
-  glEnd();
+  gfx::begin(GL_POLYGON);
+  gfx::vertex3f(1.5, 0, 0.0);
+  gfx::vertex3f(1.5, 1.5, 0.0);
+  gfx::vertex3f(1.5, 1.5, 0.2);
+  gfx::vertex3f(1.5, 0, 0.2);
+  gfx::end();
 
   // bottom
-  glEnable(GL_TEXTURE_2D);
-  glColor3f(1., 1., 1.);
-  glBindTexture(GL_TEXTURE_2D, textures[GPU_SIDE]);
-  glBegin(GL_POLYGON);
-  glTexCoord2i(1, 0);
-  glVertex3f(1.5, 0, 0.0);
-  glTexCoord2i(1, 1);
-  glVertex3f(1.5, 0, 0.2);
-  glTexCoord2i(0, 1);
-  glVertex3f(-1.5, 0, 0.2);
-  glTexCoord2i(0, 0);
-  glVertex3f(-1.5, 0, 0.0);
-  glEnd();
+  gfx::enable(GL_TEXTURE_2D);
+  gfx::color3f(1., 1., 1.);
+  gfx::bind_texture(textures[GPU_SIDE]);
+  gfx::begin(GL_POLYGON);
+  gfx::tex_coord2i(1, 0);
+  gfx::vertex3f(1.5, 0, 0.0);
+  gfx::tex_coord2i(1, 1);
+  gfx::vertex3f(1.5, 0, 0.2);
+  gfx::tex_coord2i(0, 1);
+  gfx::vertex3f(-1.5, 0, 0.2);
+  gfx::tex_coord2i(0, 0);
+  gfx::vertex3f(-1.5, 0, 0.0);
+  gfx::end();
 
   // top
 
-  glEnable(GL_TEXTURE_2D);
-  glColor3f(1., 1., 1.);
-  glBindTexture(GL_TEXTURE_2D, textures[GPU_SIDE]);
-  glBegin(GL_POLYGON);
-  glTexCoord2f(1., 0.);
-  glVertex3f(-1.75, 1.5, 0.0);
-  glTexCoord2f(1., 1.);
-  glVertex3f(-1.75, 1.5, 0.2);
-  glTexCoord2f(0., 1.);
-  glVertex3f(1.5, 1.5, 0.2);
-  glTexCoord2f(0., 0.);
-  glVertex3f(1.5, 1.5, 0.0);
-  glEnd();
-  glDisable(GL_TEXTURE_2D);
-
-  // glPushMatrix();
+  gfx::enable(GL_TEXTURE_2D);
+  gfx::color3f(1., 1., 1.);
+  gfx::bind_texture(textures[GPU_SIDE]);
+  gfx::begin(GL_POLYGON);
+  gfx::tex_coord2f(1., 0.);
+  gfx::vertex3f(-1.75, 1.5, 0.0);
+  gfx::tex_coord2f(1., 1.);
+  gfx::vertex3f(-1.75, 1.5, 0.2);
+  gfx::tex_coord2f(0., 1.);
+  gfx::vertex3f(1.5, 1.5, 0.2);
+  gfx::tex_coord2f(0., 0.);
+  gfx::vertex3f(1.5, 1.5, 0.0);
+  gfx::end();
+  gfx::disable(GL_TEXTURE_2D);
+
+  // gfx::push_matrix();
   // lower_render();
-  // glPopMatrix();
-  glPopMatrix();
+  // gfx::pop_matrix();
+  gfx::pop_matrix();
 }
 
 void cpu_gpu::lower_render() {
 
-  glPushMatrix();
-  glEnable(GL_TEXTURE_2D);
-  glColor3f(0.5, 0.5, 0.5);
-  glBindTexture(GL_TEXTURE_2D, textures[GPU_LOWER]);
-
-  glBegin(GL_POLYGON);
-  glTexCoord2f(0., 0.);
-  glVertex3f(-1.2, 0, 0.1);
-  glTexCoord2f(1, 0);
-  glVertex3f(0.4, 0, 0.1);
-  glTexCoord2f(1, -1);
-  glVertex3f(0.4, -0.15, 0.1);
-  glTexCoord2f(0, -1);
-  glVertex3f(-1.2, -0.15, 0.1);
-  glEnd();
-
-  glDisable(GL_TEXTURE_2D);
-
-  glEnable(GL_TEXTURE_2D);
-  glColor3f(0.5, 0.5, 0.5);
-  glBindTexture(GL_TEXTURE_2D, textures[GPU_LOWER]);
-
-  glBegin(GL_POLYGON);
-  glTexCoord2f(0., 0.);
-  glVertex3f(-1.2, 0, 0);
-  glTexCoord2f(1, 0);
-  glVertex3f(0.4, 0, 0);
-  glTexCoord2f(1, -1);
-  glVertex3f(0.4, -0.15, 0);
-  glTexCoord2f(0, -1);
-  glVertex3f(-1.2, -0.15, 0);
-  glEnd();
-
-  glDisable(GL_TEXTURE_2D);
-
-  glColor3f(0.5, 0.5, 0.5);
+  gfx::push_matrix();
+  gfx::enable(GL_TEXTURE_2D);
+  gfx::color3f(0.5, 0.5, 0.5);
+  gfx::bind_texture(textures[GPU_LOWER]);
+
+  gfx::begin(GL_POLYGON);
+  gfx::tex_coord2f(0., 0.);
+  gfx::vertex3f(-1.2, 0, 0.1);
+  gfx::tex_coord2f(1, 0);
+  gfx::vertex3f(0.4, 0, 0.1);
+  gfx::tex_coord2f(1, -1);
+  gfx::vertex3f(0.4, -0.15, 0.1);
+  gfx::tex_coord2f(0, -1);
+  gfx::vertex3f(-1.2, -0.15, 0.1);
+  gfx::end();
+
+  gfx::disable(GL_TEXTURE_2D);
+
+  gfx::enable(GL_TEXTURE_2D);
+  gfx::color3f(0.5, 0.5, 0.5);
+  gfx::bind_texture(textures[GPU_LOWER]);
+
+  gfx::begin(GL_POLYGON);
+  gfx::tex_coord2f(0., 0.);
+  gfx::vertex3f(-1.2, 0, 0);
+  gfx::tex_coord2f(1, 0);
+  gfx::vertex3f(0.4, 0, 0);
+  gfx::tex_coord2f(1, -1);
+  gfx::vertex3f(0.4, -0.15, 0);
+  gfx::tex_coord2f(0, -1);
+  gfx::vertex3f(-1.2, -0.15, 0);
+  gfx::end();
+
+  gfx::disable(GL_TEXTURE_2D);
+
+  gfx::color3f(0.5, 0.5, 0.5);
   // side
-  glBegin(GL_POLYGON);
-  glVertex3f(-1.2, 0, 0.1);
-  glVertex3f(-1.2, -0.15, 0.1);
-  glVertex3f(-1.2, -0.15, 0);
-  glVertex3f(-1.2, 0, 0);
-  glEnd();
+  gfx::begin(GL_POLYGON);
+  gfx::vertex3f(-1.2, 0, 0.1);
+  gfx::vertex3f(-1.2, -0.15, 0.1);
+  gfx::vertex3f(-1.2, -0.15, 0);
+  gfx::vertex3f(-1.2, 0, 0);
+  gfx::end();
 
   // side
 
-  glBegin(GL_POLYGON);
-  glVertex3f(0.4, 0, 0.1);
-  glVertex3f(0.4, -0.15, 0.1);
-  glVertex3f(0.4, -0.15, 0);
-  glVertex3f(0.4, 0, 0);
-  glEnd();
+  gfx::begin(GL_POLYGON);
+  gfx::vertex3f(0.4, 0, 0.1);
+  gfx::vertex3f(0.4, -0.15, 0.1);
+  gfx::vertex3f(0.4, -0.15, 0);
+  gfx::vertex3f(0.4, 0, 0);
+  gfx::end();
 
   // bottom
-  glBegin(GL_POLYGON);
-  glVertex3f(0.4, 0, 0.1);
-  glVertex3f(0.4, 0, 0);
-  glVertex3f(-1.2, 0, 0);
-  glVertex3f(-1.2, 0, 0.1);
-  glEnd();
+  gfx::begin(GL_POLYGON);
+  gfx::vertex3f(0.4, 0, 0.1);
+  gfx::vertex3f(0.4, 0, 0);
+  gfx::vertex3f(-1.2, 0, 0);
+  gfx::vertex3f(-1.2, 0, 0.1);
+  gfx::end();
   // top
-  glBegin(GL_POLYGON);
-  glVertex3f(0.4, -0.15, 0.1);
-  glVertex3f(0.4, -0.15, 0);
-  glVertex3f(-1.2, -0.15, 0);
-  glVertex3f(-1.2, -0.15, 0.1);
-  glEnd();
-
-  glPopMatrix();
+  gfx::begin(GL_POLYGON);
+  gfx::vertex3f(0.4, -0.15, 0.1);
+  gfx::vertex3f(0.4, -0.15, 0);
+  gfx::vertex3f(-1.2, -0.15, 0);
+  gfx::vertex3f(-1.2, -0.15, 0.1);
+  gfx::end();
+
+  gfx::pop_matrix();
 }
 
 #endif CPU_GPU
@@ -1,19 +1,22 @@
 #ifndef HARDDISK
 #define HARDDISK
 
+#include "frame_snapshot.h"
+#include "gfx.h"
 #include "parameter.h"
 
 class cpu_harddisk {
-  point3D move;
+  point3D move, prevMove; /// Offset now and one sim step ago
   bool visible = true;
   bool objMove = false;
 
   void motionHandle();
 
 public:
-  // Accessor for dynamic tooltip
-  point3D getOffset() { return move; }
-  void render();
+  // Snapshot of the sim state for the frame builder / tooltips
+  PartPose pose() const;
+  void update();
+  void render(const PartPose &, float);
 };
 
 void cpu_harddisk::motionHandle() {
@@ -22,9 +25,9 @@ void cpu_harddisk::motionHandle() {
       !assemble) {
     objMove = true;
     if (move.z < -1.)
-      move.x -= 0.007;
+      move.x -= disassembleSpeed * SIM_DT;
     else
-      move.z -= 0.007;
+      move.z -= disassembleSpeed * SIM_DT;
 
     if (move.x < disapphereLimit) {
       enterPressed = false;
@@ -37,9 +40,9 @@ void cpu_harddisk::motionHandle() {
     objMove = true;
     visible = true;
     if (move.x < 0.)
-      move.x += 0.007;
+      move.x += disassembleSpeed * SIM_DT;
     else
-      move.z += 0.007;
+      move.z += disassembleSpeed * SIM_DT;
 
     if (move.x >= 0. && move.z >= 0.) {
       enterPressed = false;
@@ -48,80 +51,90 @@ void cpu_harddisk::motionHandle() {
   }
 }
 
-void cpu_harddisk::render() {
-  GLfloat scaleFactor = 0.4;
+PartPose cpu_harddisk::pose() const {
+  PartPose p = {prevMove, move, 0.0f, 0.0f, visible};
+  return p;
+}
 
+void cpu_harddisk::update() {
+  prevMove = move;
   motionHandle();
-  if (!visible)
-    return;
-  glPushMatrix();
-  glTranslatef(move.x, move.y, move.z);
-  glScalef(scaleFactor, scaleFactor, scaleFactor);
-  glTranslatef(8. / scaleFactor, 3.86 / scaleFactor, -3.2 / scaleFactor);
-  glRotatef(-90., 0., 1., 0);
+}
 
-  glColor3f(0.05, 0.05, 0.05);
+void cpu_harddisk::render(const PartPose &pose, float t) {
+  GLfloat scaleFactor = 0.4;
+
+  if (!pose.visible)
+    return;
+  gfx::push_matrix();
+  point3D m = pose.at(t);
+  gfx::translatef(m.x, m.y, m.z);
+  gfx::scalef(scaleFactor, scaleFactor, scaleFactor);
+  gfx::translatef(8. / scaleFactor, 3.86 / scaleFactor, -3.2 / scaleFactor);
+  gfx::rotatef(-90., 0., 1., 0);
+
+  gfx::color3f(0.05, 0.05, 0.05);
   // back face
-  glBegin(GL_POLYGON);
-  glVertex3f(-1, 0.2, 0);
-  glVertex3f(-1, 0, 0);
-  glVertex3f(1, 0, 0);
-  glVertex3f(1, 0.2, 0);
-  glEnd();
+  gfx::begin(GL_POLYGON);
+  gfx::vertex3f(-1, 0.2, 0);
+  gfx::vertex3f(-1, 0, 0);
+  gfx::vertex3f(1, 0, 0);
+  gfx::vertex3f(1, 0.2, 0);
+  gfx::end();
 
   // side face right
 
-  glBegin(GL_POLYGON);
-  glVertex3f(1, 0.2, 0);
-  glVertex3f(1, 0, 0);
-  glVertex3f(1, 0, 0.8);
-  glVertex3f(1, 0.2, 0.8);
-  glEnd();
+  gfx::begin(GL_POLYGON);
+  gfx::vertex3f(1, 0.2, 0);
+  gfx::vertex3f(1, 0, 0);
+  gfx::vertex3f(1, 0, 0.8);
+  gfx::vertex3f(1, 0.2, 0.8);
+  gfx::end();
 
   // back
-  glBegin(GL_POLYGON);
-  glVertex3f(1, 0.2, 0.8);
-  glVertex3f(1, 0, 0.8);
-  glVertex3f(-1, 0, 0.8);
-  glVertex3f(-1, 0.2, 0.8);
-  glEnd();
+  gfx::begin(GL_POLYGON);
+  gfx::vertex3f(1, 0.2, 0.8);
+  gfx::vertex3f(1, 0, 0.8);
+  gfx::vertex3f(-1, 0, 0.8);
+  gfx::vertex3f(-1, 0.2, 0.8);
+  gfx::end();
 
   // side left face
-  glBegin(GL_POLYGON);
-  glVertex3f(-1, 0.2, .8);
-  glVertex3f(-1, 0, 0.8);
-  glVertex3f(-1, 0, 0);
-  glVertex3f(-1, 0.2, 0);
-  glEnd();
+  gfx::begin(GL_POLYGON);
+  gfx::vertex3f(-1, 0.2, .8);
+  gfx::vertex3f(-1, 0, 0.8);
+  gfx::vertex3f(-1, 0, 0);
+  gfx::vertex3f(-1, 0.2, 0);
+  gfx::end();
 
-  glEnable(GL_TEXTURE_2D);
-  glColor3f(1., 1., 1.);
-  glBindTexture(GL_TEXTURE_2D, textures[HDD_TOP]);
+  gfx::enable(GL_TEXTURE_2D);
+  gfx::color3f(1., 1., 1.);
+  gfx::bind_texture(textures[HDD_TOP]);
 
   // top
-  glBegin(GL_POLYGON);
-  glTexCoord2f(0., 0.);
-  glVertex3f(-1, 0.2, 0);
-  glTexCoord2f(0., 1);
-  glVertex3f(1, 0.2, 0);
-  glTexCoord2f(1, 1);
-  glVertex3f(1, 0.2, 0.8);
-  glTexCoord2f(1., 0);
-  glVertex3f(-1, 0.2, 0.8);
-  glEnd();
-
-  glDisable(GL_TEXTURE_2D);
+  gfx::begin(GL_POLYGON);
+  gfx::tex_coord2f(0., 0.);
+  gfx::vertex3f(-1, 0.2, 0);
+  gfx::tex_coord2f(0., 1);
+  gfx::vertex3f(1, 0.2, 0);
+  gfx::tex_coord2f(1, 1);
+  gfx::vertex3f(1, 0.2, 0.8);
+  gfx::tex_coord2f(1., 0);
+  gfx::vertex3f(-1, 0.2, 0.8);
+  gfx::end();
+
+  gfx::disable(GL_TEXTURE_2D);
 
   // bottom
-  glColor3f(0, 0, 0);
-  glBegin(GL_POLYGON);
-  glVertex3f(-1, 0, 0);
-  glVertex3f(1, 0, 0);
-  glVertex3f(1, 0, 0.8);
-  glVertex3f(-1, 0, 0.8);
-  glEnd();
-
-  glPopMatrix();
+  gfx::color3f(0, 0, 0);
+  gfx::begin(GL_POLYGON);
+  gfx::vertex3f(-1, 0, 0);
+  gfx::vertex3f(1, 0, 0);
+  gfx::vertex3f(1, 0, 0.8);
+  gfx::vertex3f(-1, 0, 0.8);
+  gfx::end();
+
+  gfx::pop_matrix();
 }
 
 #endif HARDDISK
\ No newline at end of file
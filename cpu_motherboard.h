@@ -2,13 +2,15 @@
 #define CPU_MOTHERBOARD
 
 #include "dragHandler.h"
+#include "frame_snapshot.h"
+#include "gfx.h"
 #include "gl_includes.h"
 #include "parameter.h"
 
 class cpu_motherboard {
 private:
   GLfloat boardThickness = 0.025;
-  point3D move;
+  point3D move, prevMove; /// Offset now and one sim step ago
   bool visible = true;
   bool objMove = false;
   void draw_surface();
@@ -16,14 +18,17 @@ private:
   void draw_components(GLfloat, GLfloat, GLfloat, GLfloat, int);
 
 public:
-  void render();
+  // Snapshot of the sim state for the frame builder / tooltips
+  PartPose pose() const;
+  void update();
+  void render(const PartPose &, float);
 };
 
 void cpu_motherboard::motionHandle() {
   if (((enterPressed && objIndex == REMOVE_MOTHERBOARD) || objMove == true) &&
       !assemble) {
     objMove = true;
-    move.x -= 0.007;
+    move.x -= disassembleSpeed * SIM_DT;
     if (move.x < disapphereLimit) {
       objMove = false;
       enterPressed = false;
@@ -34,7 +39,7 @@ void cpu_motherboard::motionHandle() {
              assemble) {
     objMove = true;
     visible = true;
-    move.x += 0.007;
+    move.x += disassembleSpeed * SIM_DT;
     if (move.x >= 0.) {
       objMove = false;
       enterPressed = false;
@@ -42,140 +47,149 @@ void cpu_motherboard::motionHandle() {
   }
 }
 
-void cpu_motherboard::render() {
+PartPose cpu_motherboard::pose() const {
+  PartPose p = {prevMove, move, 0.0f, 0.0f, visible};
+  return p;
+}
 
+void cpu_motherboard::update() {
+  prevMove = move;
   motionHandle();
-  if (!visible)
+}
+
+void cpu_motherboard::render(const PartPose &pose, float t) {
+  if (!pose.visible)
     return;
-  glPushMatrix();
-  glTranslatef(move.x, move.y, move.z);
-  glTranslatef(9., 3.55, -3.7);
-  glTranslatef(move.x - 1., 1.1 + move.y, move.z - .9);
-  glRotatef(-90., 0., 1., 0.);
-  glScalef(.6, .6, .7);
+  gfx::push_matrix();
+  point3D m = pose.at(t);
+  gfx::translatef(m.x, m.y, m.z);
+  gfx::translatef(9., 3.55, -3.7);
+  gfx::translatef(m.x - 1., 1.1 + m.y, m.z - .9);
+  gfx::rotatef(-90., 0., 1., 0.);
+  gfx::scalef(.6, .6, .7);
   draw_surface();
   draw_components(0., 0.7, 0.3, 0.4, MOTHERBOARD_USB);
   draw_components(-.2, 0.7, 0.3, 0.2, MOTHERBOARD_USB);
   draw_components(-.65, 1.1, 0.15, 0.25, MOTHERBOARD_VGA);
-  glPopMatrix();
+  gfx::pop_matrix();
 }
 
 void cpu_motherboard::draw_surface() {
-  glPushMatrix();
-  glEnable(GL_TEXTURE_2D);
-  glColor3f(1., 1., 1.);
+  gfx::push_matrix();
+  gfx::enable(GL_TEXTURE_2D);
+  gfx::color3f(1., 1., 1.);
   // Motherboard front
-  glBindTexture(GL_TEXTURE_2D, textures[MOTHERBOARD_FRONT]);
-  glBegin(GL_QUADS);
-  glTexCoord2f(0., 0.);
-  glVertex3f(-1., -1., 0.);
-  glTexCoord2f(0., 1.);
-  glVertex3f(-1., 1., 0.);
-  glTexCoord2f(1., 1.);
-  glVertex3f(1., 1., 0.);
-  glTexCoord2f(1., 0.);
-  glVertex3f(1., -1., 0.);
-  glEnd();
+  gfx::bind_texture(textures[MOTHERBOARD_FRONT]);
+  gfx::begin(GL_QUADS);
+  gfx::tex_coord2f(0., 0.);
+  gfx::vertex3f(-1., -1., 0.);
+  gfx::tex_coord2f(0., 1.);
+  gfx::vertex3f(-1., 1., 0.);
+  gfx::tex_coord2f(1., 1.);
+  gfx::vertex3f(1., 1., 0.);
+  gfx::tex_coord2f(1., 0.);
+  gfx::vertex3f(1., -1., 0.);
+  gfx::end();
 
   // Motherboard back
-  glBindTexture(GL_TEXTURE_2D, textures[MOTHERBOARD_BACK]);
-  glBegin(GL_QUADS);
-  glTexCoord2f(0., 0.);
-  glVertex3f(-1., -1., -boardThickness);
-  glTexCoord2f(0., 1.);
-  glVertex3f(-1., 1., -boardThickness);
-  glTexCoord2f(1., 1.);
-  glVertex3f(1., 1., -boardThickness);
-  glTexCoord2f(1., 0.);
-  glVertex3f(1., -1., -boardThickness);
-  glEnd();
-  glDisable(GL_TEXTURE_2D);
+  gfx::bind_texture(textures[MOTHERBOARD_BACK]);
+  gfx::begin(GL_QUADS);
+  gfx::tex_coord2f(0., 0.);
+  gfx::vertex3f(-1., -1., -boardThickness);
+  gfx::tex_coord2f(0., 1.);
+  gfx::vertex3f(-1., 1., -boardThickness);
+  gfx::tex_coord2f(1., 1.);
+  gfx::vertex3f(1., 1., -boardThickness);
+  gfx::tex_coord2f(1., 0.);
+  gfx::vertex3f(1., -1., -boardThickness);
+  gfx::end();
+  gfx::disable(GL_TEXTURE_2D);
 
   // Thicknes Sides (fillings)
-  glColor3f(0., 0.06, 0.05);
-  glBegin(GL_QUAD_STRIP);
-  glVertex3f(-1., -1., 0.);
-  glVertex3f(-1., -1., -boardThickness);
-  glVertex3f(-1., 1., 0.);
-  glVertex3f(-1., 1., -boardThickness);
-  glVertex3f(1., 1., 0.);
-  glVertex3f(1., 1., -boardThickness);
-  glVertex3f(1., -1., 0.);
-  glVertex3f(1., -1., -boardThickness);
-  glVertex3f(-1., -1., 0.);
-  glVertex3f(-1., -1., -boardThickness);
-  glEnd();
-
-  glPopMatrix();
+  gfx::color3f(0., 0.06, 0.05);
+  gfx::begin(GL_QUAD_STRIP);
+  gfx::vertex3f(-1., -1., 0.);
+  gfx::vertex3f(-1., -1., -boardThickness);
+  gfx::vertex3f(-1., 1., 0.);
+  gfx::vertex3f(-1., 1., -boardThickness);
+  gfx::vertex3f(1., 1., 0.);
+  gfx::vertex3f(1., 1., -boardThickness);
+  gfx::vertex3f(1., -1., 0.);
+  gfx::vertex3f(1., -1., -boardThickness);
+  gfx::vertex3f(-1., -1., 0.);
+  gfx::vertex3f(-1., -1., -boardThickness);
+  gfx::end();
+
+  gfx::pop_matrix();
 }
 
 void cpu_motherboard::draw_components(GLfloat xCord, GLfloat scaleX,
                                       GLfloat scaleY, GLfloat scaleZ, int id) {
-  glPushMatrix();
-  glRotatef(-90., 0., 1., 0.);
-  glRotatef(-90., 0., 0., 1.);
-  glTranslatef(xCord, 0., 1.);
-  glScalef(scaleX, scaleY, scaleZ);
-  glColor3f(1., 1., 1.);
-  glEnable(GL_TEXTURE_2D);
-  glBindTexture(GL_TEXTURE_2D, textures[id]);
-  glBegin(GL_POLYGON);
-  glTexCoord2f(0., 0.);
-  glVertex3f(0., 0., .001);
-  glTexCoord2f(0., 1.);
-  glVertex3f(0., .4, .001);
-  glTexCoord2f(1., 1.);
-  glVertex3f(.2, .4, .001);
-  glTexCoord2f(1., 0.);
-  glVertex3f(.2, 0., .001);
-  glEnd();
-
-  glBindTexture(GL_TEXTURE_2D, textures[STEEL_FINISH]);
-  glColor3f(1., 1., 1.);
-  glRotatef(90., 0., 1., 0.);
-  glTranslatef(0., 0., .2);
-  glBegin(GL_QUAD_STRIP);
-  glTexCoord2f(0., 0.);
-  glVertex3f(0., 0., 0.);
-  glTexCoord2f(0., 1.);
-  glVertex3f(0., .4, 0.);
-  glTexCoord2f(1., 0.);
-  glVertex3f(.6, 0., 0.);
-  glTexCoord2f(1., 1.);
-  glVertex3f(.6, .4, 0.);
-
-  glTexCoord2f(1., 0.);
-  glVertex3f(.6, 0., -.2);
-  glTexCoord2f(1., 1.);
-  glVertex3f(.6, .4, -.2);
-
-  glTexCoord2f(0., 0.);
-  glVertex3f(.0, .0, -.2);
-  glTexCoord2f(0., 1.);
-  glVertex3f(.0, .4, -.2);
-
-  glTexCoord2f(0., 0.);
-  glVertex3f(.0, .0, 0.);
-  glTexCoord2f(0., 1.);
-  glVertex3f(.0, .4, 0.);
-  glEnd();
-
-  glBegin(GL_POLYGON);
-  glVertex3f(0., 0., 0.);
-  glVertex3f(.6, .0, 0.);
-  glVertex3f(.6, .0, -.2);
-  glVertex3f(.0, 0., -.2);
-  glEnd();
-
-  glBegin(GL_POLYGON);
-  glVertex3f(0., .4, 0.);
-  glVertex3f(.6, .4, 0.);
-  glVertex3f(.6, .4, -.2);
-  glVertex3f(.0, .4, -.2);
-  glEnd();
-
-  glDisable(GL_TEXTURE_2D);
-  glPopMatrix();
+  gfx::push_matrix();
+  gfx::rotatef(-90., 0., 1., 0.);
+  gfx::rotatef(-90., 0., 0., 1.);
+  gfx::translatef(xCord, 0., 1.);
+  gfx::scalef(scaleX, scaleY, scaleZ);
+  gfx::color3f(1., 1., 1.);
+  gfx::enable(GL_TEXTURE_2D);
+  gfx::bind_texture(textures[id]);
+  gfx::begin(GL_POLYGON);
+  gfx::tex_coord2f(0., 0.);
+  gfx::vertex3f(0., 0., .001);
+  gfx::tex_coord2f(0., 1.);
+  gfx::vertex3f(0., .4, .001);
+  gfx::tex_coord2f(1., 1.);
+  gfx::vertex3f(.2, .4, .001);
+  gfx::tex_coord2f(1., 0.);
+  gfx::vertex3f(.2, 0., .001);
+  gfx::end();
+
+  gfx::bind_texture(textures[STEEL_FINISH]);
+  gfx::color3f(1., 1., 1.);
+  gfx::rotatef(90., 0., 1., 0.);
+  gfx::translatef(0., 0., .2);
+  gfx::begin(GL_QUAD_STRIP);
+  gfx::tex_coord2f(0., 0.);
+  gfx::vertex3f(0., 0., 0.);
+  gfx::tex_coord2f(0., 1.);
+  gfx::vertex3f(0., .4, 0.);
+  gfx::tex_coord2f(1., 0.);
+  gfx::vertex3f(.6, 0., 0.);
+  gfx::tex_coord2f(1., 1.);
+  gfx::vertex3f(.6, .4, 0.);
+
+  gfx::tex_coord2f(1., 0.);
+  gfx::vertex3f(.6, 0., -.2);
+  gfx::tex_coord2f(1., 1.);
+  gfx::vertex3f(.6, .4, -.2);
+
+  gfx::tex_coord2f(0., 0.);
+  gfx::vertex3f(.0, .0, -.2);
+  gfx::tex_coord2f(0., 1.);
+  gfx::vertex3f(.0, .4, -.2);
+
+  gfx::tex_coord2f(0., 0.);
+  gfx::vertex3f(.0, .0, 0.);
+  gfx::tex_coord2f(0., 1.);
+  gfx::vertex3f(.0, .4, 0.);
+  gfx::end();
+
+  gfx::begin(GL_POLYGON);
+  gfx::vertex3f(0., 0., 0.);
+  gfx::vertex3f(.6, .0, 0.);
+  gfx::vertex3f(.6, .0, -.2);
+  gfx::vertex3f(.0, 0., -.2);
+  gfx::end();
+
+  gfx::begin(GL_POLYGON);
+  gfx::vertex3f(0., .4, 0.);
+  gfx::vertex3f(.6, .4, 0.);
+  gfx::vertex3f(.6, .4, -.2);
+  gfx::vertex3f(.0, .4, -.2);
+  gfx::end();
+
+  gfx::disable(GL_TEXTURE_2D);
+  gfx::pop_matrix();
 }
 
 #endif CPU_MOTHERBOARD
\ No newline at end of file
@@ -2,18 +2,21 @@
 #define CPU_PSU
 
 #include "bitmap.h"
+#include "frame_snapshot.h"
+#include "gfx.h"
 #include "parameter.h"
 
 class cpu_psu {
-  point3D move;
+  point3D move, prevMove; /// Offset now and one sim step ago
   bool visible = true;
   bool objMove = false;
   void motionHandle();
 
 public:
-  // Accessor for dynamic tooltip
-  point3D getOffset() { return move; }
-  void render();
+  // Snapshot of the sim state for the frame builder / tooltips
+  PartPose pose() const;
+  void update();
+  void render(const PartPose &, float);
 };
 
 void cpu_psu::motionHandle() {
@@ -21,7 +24,7 @@ void cpu_psu::motionHandle() {
   if (((enterPressed && objIndex == REMOVE_PSU) || objMove == true) &&
       !assemble) {
     objMove = true;
-    move.x -= 0.007;
+    move.x -= disassembleSpeed * SIM_DT;
     if (move.x < disapphereLimit) {
       objMove = false;
       enterPressed = false;
@@ -32,7 +35,7 @@ void cpu_psu::motionHandle() {
              assemble) {
     objMove = true;
     visible = true;
-    move.x += 0.007;
+    move.x += disassembleSpeed * SIM_DT;
     if (move.x >= 0.) {
       objMove = false;
       enterPressed = false;
@@ -40,100 +43,108 @@ void cpu_psu::motionHandle() {
   }
 }
 
-void cpu_psu::render() {
+PartPose cpu_psu::pose() const {
+  PartPose p = {prevMove, move, 0.0f, 0.0f, visible};
+  return p;
+}
 
+void cpu_psu::update() {
+  prevMove = move;
   motionHandle();
+}
 
-  if (!visible)
+void cpu_psu::render(const PartPose &pose, float t) {
+  if (!pose.visible)
     return;
 
-  glPushMatrix();
+  gfx::push_matrix();
 
-  glTranslatef(move.x, move.y, move.z);
+  point3D m = pose.at(t);
+  gfx::translatef(m.x, m.y, m.z);
 
-  glTranslatef(8., 3.4, -4.79);
-  glRotatef(-90., 0., 1., 0.);
-  glScalef(0.4, 0.4, 0.8);
+  gfx::translatef(8., 3.4, -4.79);
+  gfx::rotatef(-90., 0., 1., 0.);
+  gfx::scalef(0.4, 0.4, 0.8);
 
-  glColor3f(1., 1., 1.);
+  gfx::color3f(1., 1., 1.);
   // front face
-  glBegin(GL_POLYGON);
-  glVertex3f(-1, 0, 0);
-  glVertex3f(1, 0, 0);
-  glVertex3f(1, 1, 0);
-  glVertex3f(-1, 1, 0);
-  glEnd();
+  gfx::begin(GL_POLYGON);
+  gfx::vertex3f(-1, 0, 0);
+  gfx::vertex3f(1, 0, 0);
+  gfx::vertex3f(1, 1, 0);
+  gfx::vertex3f(-1, 1, 0);
+  gfx::end();
 
   // back face
-  glEnable(GL_TEXTURE_2D);
-  glColor3f(1., 1., 1.);
-  glBindTexture(GL_TEXTURE_2D, textures[PSU_FRONT]);
-  glBegin(GL_POLYGON);
-  glTexCoord2f(0., 0.);
-  glVertex3f(-1, 0, 1);
-  glTexCoord2f(1., 0);
-  glVertex3f(1, 0, 1);
-  glTexCoord2f(1, 1);
-  glVertex3f(1, 1, 1);
-  glTexCoord2f(0., 1);
-  glVertex3f(-1, 1, 1);
-  glEnd();
-  glDisable(GL_TEXTURE_2D);
+  gfx::enable(GL_TEXTURE_2D);
+  gfx::color3f(1., 1., 1.);
+  gfx::bind_texture(textures[PSU_FRONT]);
+  gfx::begin(GL_POLYGON);
+  gfx::tex_coord2f(0., 0.);
+  gfx::vertex3f(-1, 0, 1);
+  gfx::tex_coord2f(1., 0);
+  gfx::vertex3f(1, 0, 1);
+  gfx::tex_coord2f(1, 1);
+  gfx::vertex3f(1, 1, 1);
+  gfx::tex_coord2f(0., 1);
+  gfx::vertex3f(-1, 1, 1);
+  gfx::end();
+  gfx::disable(GL_TEXTURE_2D);
 
   // side left
-  glEnable(GL_TEXTURE_2D);
-  glColor3f(1., 1., 1.);
-  glBindTexture(GL_TEXTURE_2D, textures[PSU_LEFT]);
-  glBegin(GL_POLYGON);
-  glTexCoord2f(0., 0.);
-  glVertex3f(-1, 0, 0);
-  glTexCoord2f(1., 0);
-  glVertex3f(-1, 0, 1);
-  glTexCoord2f(1, 1);
-  glVertex3f(-1, 1, 1);
-  glTexCoord2f(0., 1);
-  glVertex3f(-1, 1, 0);
-  glEnd();
-  glDisable(GL_TEXTURE_2D);
+  gfx::enable(GL_TEXTURE_2D);
+  gfx::color3f(1., 1., 1.);
+  gfx::bind_texture(textures[PSU_LEFT]);
+  gfx::begin(GL_POLYGON);
+  gfx::tex_coord2f(0., 0.);
+  gfx::vertex3f(-1, 0, 0);
+  gfx::tex_coord2f(1., 0);
+  gfx::vertex3f(-1, 0, 1);
+  gfx::tex_coord2f(1, 1);
+  gfx::vertex3f(-1, 1, 1);
+  gfx::tex_coord2f(0., 1);
+  gfx::vertex3f(-1, 1, 0);
+  gfx::end();
+  gfx::disable(GL_TEXTURE_2D);
 
   // side face right
-  glColor3f(0.2, 0.2, 0.2);
-  glBegin(GL_POLYGON);
-  glVertex3f(1, 0, 0);
-  glVertex3f(1, 0, 1);
-  glVertex3f(1, 1, 1);
-  glVertex3f(1, 1, 0);
-  glEnd();
-
-  glEnable(GL_TEXTURE_2D);
-  glColor3f(1., 1., 1.);
-  glBindTexture(GL_TEXTURE_2D, textures[PSU_TOP]);
+  gfx::color3f(0.2, 0.2, 0.2);
+  gfx::begin(GL_POLYGON);
+  gfx::vertex3f(1, 0, 0);
+  gfx::vertex3f(1, 0, 1);
+  gfx::vertex3f(1, 1, 1);
+  gfx::vertex3f(1, 1, 0);
+  gfx::end();
+
+  gfx::enable(GL_TEXTURE_2D);
+  gfx::color3f(1., 1., 1.);
+  gfx::bind_texture(textures[PSU_TOP]);
 
   // top face
-  glBegin(GL_POLYGON);
-  glTexCoord2f(0., 0.);
-  glVertex3f(-1, 1, 0);
-  glTexCoord2f(1., 0);
-  glVertex3f(1, 1, 0);
-  glTexCoord2f(1, 1);
-  glVertex3f(1, 1, 1);
-  glTexCoord2f(0., 1);
-  glVertex3f(-1, 1, 1);
+  gfx::begin(GL_POLYGON);
+  gfx::tex_coord2f(0., 0.);
+  gfx::vertex3f(-1, 1, 0);
+  gfx::tex_coord2f(1., 0);
+  gfx::vertex3f(1, 1, 0);
+  gfx::tex_coord2f(1, 1);
+  gfx::vertex3f(1, 1, 1);
+  gfx::tex_coord2f(0., 1);
+  gfx::vertex3f(-1, 1, 1);
 
-  glEnd();
-  glDisable(GL_TEXTURE_2D);
+  gfx::end();
+  gfx::disable(GL_TEXTURE_2D);
 
-  glColor3f(0.2, 0.2, 0.2);
+  gfx::color3f(0.2, 0.2, 0.2);
 
   // bottom face
-  glBegin(GL_POLYGON);
-  glVertex3f(-1, 0, 0);
-  glVertex3f(1, 0, 0);
-  glVertex3f(1, 0, 1);
-  glVertex3f(-1, 0, 1);
-  glEnd();
-
-  glPopMatrix();
+  gfx::begin(GL_POLYGON);
+  gfx::vertex3f(-1, 0, 0);
+  gfx::vertex3f(1, 0, 0);
+  gfx::vertex3f(1, 0, 1);
+  gfx::vertex3f(-1, 0, 1);
+  gfx::end();
+
+  gfx::pop_matrix();
 }
 
 #endif CPU_PSU
\ No newline at end of file
@@ -1,18 +1,21 @@
 #ifndef CPU_RAM
 #define CPU_RAM
 
+#include "frame_snapshot.h"
+#include "gfx.h"
 #include "parameter.h"
 
 class cpu_ramstick {
-  point3D move;
+  point3D move, prevMove; /// Offset now and one sim step ago
   bool visible = true;
   bool objMove = false;
   void motionHandle();
 
 public:
-  // Accessor for dynamic tooltip
-  point3D getOffset() { return move; }
-  void render(GLfloat, GLfloat, GLfloat);
+  // Snapshot of the sim state for the frame builder / tooltips
+  PartPose pose() const;
+  void update();
+  void render(const PartPose &, float, GLfloat, GLfloat, GLfloat);
 };
 
 void cpu_ramstick::motionHandle() {
@@ -21,7 +24,7 @@ void cpu_ramstick::motionHandle() {
       !assemble) {
     objMove = true;
     /// Disassembly of The RAM
-    move.x -= 0.007;
+    move.x -= disassembleSpeed * SIM_DT;
     if (move.x < disapphereLimit) {
       /// Last reached
       objMove = false;
@@ -34,7 +37,7 @@ void cpu_ramstick::motionHandle() {
     objMove = true;
     visible = true;
     /// Assembly of The RAM
-    move.x += 0.007;
+    move.x += disassembleSpeed * SIM_DT;
     if (move.x >= 0.) {
       /// Last reached
       objMove = false;
@@ -43,84 +46,94 @@ void cpu_ramstick::motionHandle() {
   }
 }
 
-void cpu_ramstick::render(GLfloat tx, GLfloat ty, GLfloat tz) {
+PartPose cpu_ramstick::pose() const {
+  PartPose p = {prevMove, move, 0.0f, 0.0f, visible};
+  return p;
+}
 
+void cpu_ramstick::update() {
+  prevMove = move;
   motionHandle();
-  if (!visible)
+}
+
+void cpu_ramstick::render(const PartPose &pose, float t, GLfloat tx, GLfloat ty,
+                          GLfloat tz) {
+  if (!pose.visible)
     return;
-  glPushMatrix();
-  glTranslatef(move.x, move.y, move.z);
-
-  glTranslatef(tx, ty, tz);
-  glRotatef(90., 0., 0., 1.);
-  glScalef(0.35, 0.35, 0.35);
-
-  glColor3f(1., 1., 1.);
-
-  glEnable(GL_TEXTURE_2D);
-  glColor3f(1., 1., 1.);
-  glBindTexture(GL_TEXTURE_2D, textures[RAMSTICK]);
-
-  glBegin(GL_POLYGON);
-  glTexCoord2f(0., 0.);
-  glVertex3f(-1, 0, 0.02);
-  glTexCoord2f(1., 0);
-  glVertex3f(1, 0, 0.02);
-  glTexCoord2f(1, 1);
-  glVertex3f(1, 0.5, 0.02);
-  glTexCoord2f(0., 1);
-  glVertex3f(-1, 0.5, 0.02);
-  glEnd();
-
-  glDisable(GL_TEXTURE_2D);
-
-  glEnable(GL_TEXTURE_2D);
-  glColor3f(1., 1., 1.);
-  glBindTexture(GL_TEXTURE_2D, textures[RAMSTICK]);
-
-  glBegin(GL_POLYGON);
-  glTexCoord2f(0., 0.);
-  glVertex3f(-1, 0, 0);
-  glTexCoord2f(1., 0);
-  glVertex3f(1, 0, 0);
-  glTexCoord2f(1, 1);
-  glVertex3f(1, 0.5, 0);
-  glTexCoord2f(0., 1);
-  glVertex3f(-1, 0.5, 0);
-  glEnd();
-
-  glDisable(GL_TEXTURE_2D);
-
-  glColor3f(0, .2, 0);
-
-  glBegin(GL_POLYGON);
-  glVertex3f(-1, 0, 0.0);
-  glVertex3f(-1, 0.5, 0.0);
-  glVertex3f(-1, 0.5, 0.02);
-  glVertex3f(-1, 0, 0.02);
-  glEnd();
-
-  glBegin(GL_POLYGON);
-  glVertex3f(1, 0, 0.0);
-  glVertex3f(1, 0.5, 0.0);
-  glVertex3f(1, 0.5, 0.02);
-  glVertex3f(1, 0, 0.02);
-  glEnd();
-
-  glBegin(GL_POLYGON);
-  glVertex3f(1, 0, 0.0);
-  glVertex3f(1, 0, 0.02);
-  glVertex3f(-1, 0, 0.02);
-  glVertex3f(-1, 0, 0.0);
-  glEnd();
-  glBegin(GL_POLYGON);
-  glVertex3f(1, 0.5, 0.0);
-  glVertex3f(1, 0.5, 0.02);
-  glVertex3f(-1, 0.5, 0.02);
-  glVertex3f(-1, 0.5, 0.0);
-  glEnd();
-
-  glPopMatrix();
+  gfx::push_matrix();
+  point3D m = pose.at(t);
+  gfx::translatef(m.x, m.y, m.z);
+
+  gfx::translatef(tx, ty, tz);
+  gfx::rotatef(90., 0., 0., 1.);
+  gfx::scalef(0.35, 0.35, 0.35);
+
+  gfx::color3f(1., 1., 1.);
+
+  gfx::enable(GL_TEXTURE_2D);
+  gfx::color3f(1., 1., 1.);
+  gfx::bind_texture(textures[RAMSTICK]);
+
+  gfx::begin(GL_POLYGON);
+  gfx::tex_coord2f(0., 0.);
+  gfx::vertex3f(-1, 0, 0.02);
+  gfx::tex_coord2f(1., 0);
+  gfx::vertex3f(1, 0, 0.02);
+  gfx::tex_coord2f(1, 1);
+  gfx::vertex3f(1, 0.5, 0.02);
+  gfx::tex_coord2f(0., 1);
+  gfx::vertex3f(-1, 0.5, 0.02);
+  gfx::end();
+
+  gfx::disable(GL_TEXTURE_2D);
+
+  gfx::enable(GL_TEXTURE_2D);
+  gfx::color3f(1., 1., 1.);
+  gfx::bind_texture(textures[RAMSTICK]);
+
+  gfx::begin(GL_POLYGON);
+  gfx::tex_coord2f(0., 0.);
+  gfx::vertex3f(-1, 0, 0);
+  gfx::tex_coord2f(1., 0);
+  gfx::vertex3f(1, 0, 0);
+  gfx::tex_coord2f(1, 1);
+  gfx::vertex3f(1, 0.5, 0);
+  gfx::tex_coord2f(0., 1);
+  gfx::vertex3f(-1, 0.5, 0);
+  gfx::end();
+
+  gfx::disable(GL_TEXTURE_2D);
+
+  gfx::color3f(0, .2, 0);
+
+  gfx::begin(GL_POLYGON);
+  gfx::vertex3f(-1, 0, 0.0);
+  gfx::vertex3f(-1, 0.5, 0.0);
+  gfx::vertex3f(-1, 0.5, 0.02);
+  gfx::vertex3f(-1, 0, 0.02);
+  gfx::end();
+
+  gfx::begin(GL_POLYGON);
+  gfx::vertex3f(1, 0, 0.0);
+  gfx::vertex3f(1, 0.5, 0.0);
+  gfx::vertex3f(1, 0.5, 0.02);
+  gfx::vertex3f(1, 0, 0.02);
+  gfx::end();
+
+  gfx::begin(GL_POLYGON);
+  gfx::vertex3f(1, 0, 0.0);
+  gfx::vertex3f(1, 0, 0.02);
+  gfx::vertex3f(-1, 0, 0.02);
+  gfx::vertex3f(-1, 0, 0.0);
+  gfx::end();
+  gfx::begin(GL_POLYGON);
+  gfx::vertex3f(1, 0.5, 0.0);
+  gfx::vertex3f(1, 0.5, 0.02);
+  gfx::vertex3f(-1, 0.5, 0.02);
+  gfx::vertex3f(-1, 0.5, 0.0);
+  gfx::end();
+
+  gfx::pop_matrix();
 }
 
 #endif CPU_RAM
@@ -1,6 +1,7 @@
 #ifndef ENV_TABLE
 #define ENV_TABLE
 
+#include "gfx.h"
 #include "parameter.h"
 
 class env_table {
@@ -9,326 +10,326 @@ public:void render();
 
 void env_table::render() {
 	
-	glPushMatrix();
-	glColor3f(0, 0, 0);
-	glBegin(GL_POLYGON);
-	glVertex3f(0, 3, -9.9);
-	glVertex3f(0, 3, -7);
-	glVertex3f(1, 3, -7);
-	glVertex3f(1, 3, -9.9);
-	glEnd();
-
-	glBegin(GL_POLYGON);
-	glVertex3f(0, 0, -9.9);
-	glVertex3f(0, 0, -7);
-	glVertex3f(1, 0, -7);
-	glVertex3f(1, 0, -9.9);
-	glEnd();
-
-	glBegin(GL_POLYGON);
-	glVertex3f(0, 3, -9.9);
-	glVertex3f(0, 3, -7);
-	glVertex3f(0, 0, -7);
-	glVertex3f(0, 0, -9.9);
-	glEnd();
-
-	glBegin(GL_POLYGON);
-	glVertex3f(1, 3, -9.9);
-	glVertex3f(1, 3, -7);
-	glVertex3f(1, 0, -7);
-	glVertex3f(1, 0, -9.9);
-	glEnd();
-
-	glBegin(GL_POLYGON);
-	glVertex3f(0, 3, -7);
-	glVertex3f(0, 0, -7);
-	glVertex3f(1, 0, -7);
-	glVertex3f(1, 3, -7);
-	glEnd();
-
-
-	glBegin(GL_POLYGON);
-	glVertex3f(0, 3, -9.9);
-	glVertex3f(0, 0, -9.9);
-	glVertex3f(1, 0, -9.9);
-	glVertex3f(1, 3, -9.9);
-	glEnd();
+	gfx::push_matrix();
+	gfx::color3f(0, 0, 0);
+	gfx::begin(GL_POLYGON);
+	gfx::vertex3f(0, 3, -9.9);
+	gfx::vertex3f(0, 3, -7);
+	gfx::vertex3f(1, 3, -7);
+	gfx::vertex3f(1, 3, -9.9);
+	gfx::end();
+
+	gfx::begin(GL_POLYGON);
+	gfx::vertex3f(0, 0, -9.9);
+	gfx::vertex3f(0, 0, -7);
+	gfx::vertex3f(1, 0, -7);
+	gfx::vertex3f(1, 0, -9.9);
+	gfx::end();
+
+	gfx::begin(GL_POLYGON);
+	gfx::vertex3f(0, 3, -9.9);
+	gfx::vertex3f(0, 3, -7);
+	gfx::vertex3f(0, 0, -7);
+	gfx::vertex3f(0, 0, -9.9);
+	gfx::end();
+
+	gfx::begin(GL_POLYGON);
+	gfx::vertex3f(1, 3, -9.9);
+	gfx::vertex3f(1, 3, -7);
+	gfx::vertex3f(1, 0, -7);
+	gfx::vertex3f(1, 0, -9.9);
+	gfx::end();
+
+	gfx::begin(GL_POLYGON);
+	gfx::vertex3f(0, 3, -7);
+	gfx::vertex3f(0, 0, -7);
+	gfx::vertex3f(1, 0, -7);
+	gfx::vertex3f(1, 3, -7);
+	gfx::end();
+
+
+	gfx::begin(GL_POLYGON);
+	gfx::vertex3f(0, 3, -9.9);
+	gfx::vertex3f(0, 0, -9.9);
+	gfx::vertex3f(1, 0, -9.9);
+	gfx::vertex3f(1, 3, -9.9);
+	gfx::end();
 
 
 	//fourth(6,10)
-	glBegin(GL_POLYGON);
-	glVertex3f(5, 3, -9.9);
-	glVertex3f(5, 3, -7);
-	glVertex3f(6, 3, -7);
-	glVertex3f(6, 3, -9.9);
-	glEnd();
-
-	glBegin(GL_POLYGON);
-	glVertex3f(5, 0, -9.9);
-	glVertex3f(5, 0, -7);
-	glVertex3f(6, 0, -7);
-	glVertex3f(6, 0, -9.9);
-	glEnd();
-
-	glBegin(GL_POLYGON);
-	glVertex3f(5, 3, -9.9);
-	glVertex3f(5, 3, -7);
-	glVertex3f(5, 0, -7);
-	glVertex3f(5, 0, -9.9);
-	glEnd();
-
-	glBegin(GL_POLYGON);
-	glVertex3f(6, 3, -9.9);
-	glVertex3f(6, 3, -7);
-	glVertex3f(6, 0, -7);
-	glVertex3f(6, 0, -9.9);
-	glEnd();
-
-	glBegin(GL_POLYGON);
-	glVertex3f(5, 3, -7);
-	glVertex3f(5, 0, -7);
-	glVertex3f(6, 0, -7);
-	glVertex3f(6, 3, -7);
-	glEnd();
-
-
-	glBegin(GL_POLYGON);
-	glVertex3f(5, 3, -9.9);
-	glVertex3f(5, 0, -9.9);
-	glVertex3f(6, 0, -9.9);
-	glVertex3f(6, 3, -9.9);
-	glEnd();
+	gfx::begin(GL_POLYGON);
+	gfx::vertex3f(5, 3, -9.9);
+	gfx::vertex3f(5, 3, -7);
+	gfx::vertex3f(6, 3, -7);
+	gfx::vertex3f(6, 3, -9.9);
+	gfx::end();
+
+	gfx::begin(GL_POLYGON);
+	gfx::vertex3f(5, 0, -9.9);
+	gfx::vertex3f(5, 0, -7);
+	gfx::vertex3f(6, 0, -7);
+	gfx::vertex3f(6, 0, -9.9);
+	gfx::end();
+
+	gfx::begin(GL_POLYGON);
+	gfx::vertex3f(5, 3, -9.9);
+	gfx::vertex3f(5, 3, -7);
+	gfx::vertex3f(5, 0, -7);
+	gfx::vertex3f(5, 0, -9.9);
+	gfx::end();
+
+	gfx::begin(GL_POLYGON);
+	gfx::vertex3f(6, 3, -9.9);
+	gfx::vertex3f(6, 3, -7);
+	gfx::vertex3f(6, 0, -7);
+	gfx::vertex3f(6, 0, -9.9);
+	gfx::end();
+
+	gfx::begin(GL_POLYGON);
+	gfx::vertex3f(5, 3, -7);
+	gfx::vertex3f(5, 0, -7);
+	gfx::vertex3f(6, 0, -7);
+	gfx::vertex3f(6, 3, -7);
+	gfx::end();
+
+
+	gfx::begin(GL_POLYGON);
+	gfx::vertex3f(5, 3, -9.9);
+	gfx::vertex3f(5, 0, -9.9);
+	gfx::vertex3f(6, 0, -9.9);
+	gfx::vertex3f(6, 3, -9.9);
+	gfx::end();
 
 
 	//fifth
 
 
-	glBegin(GL_POLYGON);
-	glVertex3f(6, 3, -7);
-	glVertex3f(6, 3, -6);
-	glVertex3f(9.9, 3, -6);
-	glVertex3f(9.9, 3, -7);
-	glEnd();
-
-	glBegin(GL_POLYGON);
-	glVertex3f(6, 0, -7);
-	glVertex3f(6, 0, -6);
-	glVertex3f(9.9, 0, -6);
-	glVertex3f(9.9, 0, -7);
-	glEnd();
-
-	glBegin(GL_POLYGON);
-	glVertex3f(6, 3, -7);
-	glVertex3f(6, 3, -6);
-	glVertex3f(6, 0, -6);
-	glVertex3f(6, 0, -7);
-	glEnd();
-
-	glBegin(GL_POLYGON);
-	glVertex3f(9.9, 3, -7);
-	glVertex3f(9.9, 3, -6);
-	glVertex3f(9.9, 0, -6);
-	glVertex3f(9.9, 0, -7);
-	glEnd();
-
-	glBegin(GL_POLYGON);
-	glVertex3f(6, 3, -6);
-	glVertex3f(6, 0, -6);
-	glVertex3f(9.9, 0, -6);
-	glVertex3f(9.9, 3, -6);
-	glEnd();
-
-
-	glBegin(GL_POLYGON);
-	glVertex3f(6, 3, -7);
-	glVertex3f(6, 0, -7);
-	glVertex3f(9.9, 0, -7);
-	glVertex3f(9.9, 3, -7);
-	glEnd();
+	gfx::begin(GL_POLYGON);
+	gfx::vertex3f(6, 3, -7);
+	gfx::vertex3f(6, 3, -6);
+	gfx::vertex3f(9.9, 3, -6);
+	gfx::vertex3f(9.9, 3, -7);
+	gfx::end();
+
+	gfx::begin(GL_POLYGON);
+	gfx::vertex3f(6, 0, -7);
+	gfx::vertex3f(6, 0, -6);
+	gfx::vertex3f(9.9, 0, -6);
+	gfx::vertex3f(9.9, 0, -7);
+	gfx::end();
+
+	gfx::begin(GL_POLYGON);
+	gfx::vertex3f(6, 3, -7);
+	gfx::vertex3f(6, 3, -6);
+	gfx::vertex3f(6, 0, -6);
+	gfx::vertex3f(6, 0, -7);
+	gfx::end();
+
+	gfx::begin(GL_POLYGON);
+	gfx::vertex3f(9.9, 3, -7);
+	gfx::vertex3f(9.9, 3, -6);
+	gfx::vertex3f(9.9, 0, -6);
+	gfx::vertex3f(9.9, 0, -7);
+	gfx::end();
+
+	gfx::begin(GL_POLYGON);
+	gfx::vertex3f(6, 3, -6);
+	gfx::vertex3f(6, 0, -6);
+	gfx::vertex3f(9.9, 0, -6);
+	gfx::vertex3f(9.9, 3, -6);
+	gfx::end();
+
+
+	gfx::begin(GL_POLYGON);
+	gfx::vertex3f(6, 3, -7);
+	gfx::vertex3f(6, 0, -7);
+	gfx::vertex3f(9.9, 0, -7);
+	gfx::vertex3f(9.9, 3, -7);
+	gfx::end();
 
 	//seventh
-	glBegin(GL_POLYGON);
-	glVertex3f(6, 3, -2);
-	glVertex3f(6, 3, -1);
-	glVertex3f(9.9, 3, -1);
-	glVertex3f(9.9, 3, -2);
-	glEnd();
-
-	glBegin(GL_POLYGON);
-	glVertex3f(6, 0, -2);
-	glVertex3f(6, 0, -1);
-	glVertex3f(9.9, 0, -1);
-	glVertex3f(9.9, 0, -2);
-	glEnd();
-
-	glBegin(GL_POLYGON);
-	glVertex3f(6, 3, -2);
-	glVertex3f(6, 3, -1);
-	glVertex3f(6, 0, -1);
-	glVertex3f(6, 0, -2);
-	glEnd();
-
-	glBegin(GL_POLYGON);
-	glVertex3f(9.9, 3, -2);
-	glVertex3f(9.9, 3, -1);
-	glVertex3f(9.9, 0, -1);
-	glVertex3f(9.9, 0, -2);
-	glEnd();
-
-	glBegin(GL_POLYGON);
-	glVertex3f(6, 3, -2);
-	glVertex3f(6, 0, -1);
-	glVertex3f(9.9, 0, -1);
-	glVertex3f(9.9, 3, -2);
-	glEnd();
-
-
-	glBegin(GL_POLYGON);
-	glVertex3f(6, 3, -2);
-	glVertex3f(6, 0, -2);
-	glVertex3f(9.9, 0, -2);
-	glVertex3f(9.9, 3, -2);
-	glEnd();
-
-	glEnable(GL_TEXTURE_2D);
-	glColor3f(1., 1., 1.);
-	glBindTexture(GL_TEXTURE_2D, textures[TABLE]);
+	gfx::begin(GL_POLYGON);
+	gfx::vertex3f(6, 3, -2);
+	gfx::vertex3f(6, 3, -1);
+	gfx::vertex3f(9.9, 3, -1);
+	gfx::vertex3f(9.9, 3, -2);
+	gfx::end();
+
+	gfx::begin(GL_POLYGON);
+	gfx::vertex3f(6, 0, -2);
+	gfx::vertex3f(6, 0, -1);
+	gfx::vertex3f(9.9, 0, -1);
+	gfx::vertex3f(9.9, 0, -2);
+	gfx::end();
+
+	gfx::begin(GL_POLYGON);
+	gfx::vertex3f(6, 3, -2);
+	gfx::vertex3f(6, 3, -1);
+	gfx::vertex3f(6, 0, -1);
+	gfx::vertex3f(6, 0, -2);
+	gfx::end();
+
+	gfx::begin(GL_POLYGON);
+	gfx::vertex3f(9.9, 3, -2);
+	gfx::vertex3f(9.9, 3, -1);
+	gfx::vertex3f(9.9, 0, -1);
+	gfx::vertex3f(9.9, 0, -2);
+	gfx::end();
+
+	gfx::begin(GL_POLYGON);
+	gfx::vertex3f(6, 3, -2);
+	gfx::vertex3f(6, 0, -1);
+	gfx::vertex3f(9.9, 0, -1);
+	gfx::vertex3f(9.9, 3, -2);
+	gfx::end();
+
+
+	gfx::begin(GL_POLYGON);
+	gfx::vertex3f(6, 3, -2);
+	gfx::vertex3f(6, 0, -2);
+	gfx::vertex3f(9.9, 0, -2);
+	gfx::vertex3f(9.9, 3, -2);
+	gfx::end();
+
+	gfx::enable(GL_TEXTURE_2D);
+	gfx::color3f(1., 1., 1.);
+	gfx::bind_texture(textures[TABLE]);
 	//first
-	glBegin(GL_POLYGON);
-	glTexCoord2f(1., 0.);	glVertex3f(1, 3, -9.9);
-	glTexCoord2f(0., 0.);	glVertex3f(1, 3, -7);
-	glTexCoord2f(0., 1.);	glVertex3f(5, 3, -7);
-	glTexCoord2f(1., 1.);	glVertex3f(5, 3, -9.9);
-	glEnd();
-	glBegin(GL_POLYGON);
-	glTexCoord2f(1., 0.);	glVertex3f(1, 0, -9.9);
-	glTexCoord2f(0., 0.);	glVertex3f(1, 0, -7);
-	glTexCoord2f(0., 1.);	glVertex3f(5, 0, -7);
-	glTexCoord2f(1., 1.);	glVertex3f(5, 0, -9.9);
-	glEnd();
-	glBegin(GL_POLYGON);
-	glTexCoord2f(1., 0.);	glVertex3f(1, 3, -9.9);
-	glTexCoord2f(0., 0.);	glVertex3f(1, 3, -7);
-	glTexCoord2f(0., 1.);	glVertex3f(1, 0, -7);
-	glTexCoord2f(1., 1.);	glVertex3f(1, 0, -9.9);
-	glEnd();
-	glBegin(GL_POLYGON);
-	glTexCoord2f(1., 0.);	glVertex3f(5, 3, -9.9);
-	glTexCoord2f(0., 0.);	glVertex3f(5, 3, -7);
-	glTexCoord2f(0., 1.);	glVertex3f(5, 0, -7);
-	glTexCoord2f(1., 1.);	glVertex3f(5, 0, -9.9);
-	glEnd();
-	glBegin(GL_POLYGON);
-	glTexCoord2f(1., 0.);	glVertex3f(1, 3, -9.9);
-	glTexCoord2f(0., 0.);	glVertex3f(1, 0, -9.9);
-	glTexCoord2f(0., 1.);	glVertex3f(5, 0, -9.9);
-	glTexCoord2f(1., 1.);	glVertex3f(5, 3, -9.9);
-	glEnd();
+	gfx::begin(GL_POLYGON);
+	gfx::tex_coord2f(1., 0.);	gfx::vertex3f(1, 3, -9.9);
+	gfx::tex_coord2f(0., 0.);	gfx::vertex3f(1, 3, -7);
+	gfx::tex_coord2f(0., 1.);	gfx::vertex3f(5, 3, -7);
+	gfx::tex_coord2f(1., 1.);	gfx::vertex3f(5, 3, -9.9);
+	gfx::end();
+	gfx::begin(GL_POLYGON);
+	gfx::tex_coord2f(1., 0.);	gfx::vertex3f(1, 0, -9.9);
+	gfx::tex_coord2f(0., 0.);	gfx::vertex3f(1, 0, -7);
+	gfx::tex_coord2f(0., 1.);	gfx::vertex3f(5, 0, -7);
+	gfx::tex_coord2f(1., 1.);	gfx::vertex3f(5, 0, -9.9);
+	gfx::end();
+	gfx::begin(GL_POLYGON);
+	gfx::tex_coord2f(1., 0.);	gfx::vertex3f(1, 3, -9.9);
+	gfx::tex_coord2f(0., 0.);	gfx::vertex3f(1, 3, -7);
+	gfx::tex_coord2f(0., 1.);	gfx::vertex3f(1, 0, -7);
+	gfx::tex_coord2f(1., 1.);	gfx::vertex3f(1, 0, -9.9);
+	gfx::end();
+	gfx::begin(GL_POLYGON);
+	gfx::tex_coord2f(1., 0.);	gfx::vertex3f(5, 3, -9.9);
+	gfx::tex_coord2f(0., 0.);	gfx::vertex3f(5, 3, -7);
+	gfx::tex_coord2f(0., 1.);	gfx::vertex3f(5, 0, -7);
+	gfx::tex_coord2f(1., 1.);	gfx::vertex3f(5, 0, -9.9);
+	gfx::end();
+	gfx::begin(GL_POLYGON);
+	gfx::tex_coord2f(1., 0.);	gfx::vertex3f(1, 3, -9.9);
+	gfx::tex_coord2f(0., 0.);	gfx::vertex3f(1, 0, -9.9);
+	gfx::tex_coord2f(0., 1.);	gfx::vertex3f(5, 0, -9.9);
+	gfx::tex_coord2f(1., 1.);	gfx::vertex3f(5, 3, -9.9);
+	gfx::end();
 	//second(6,10)
-	glBegin(GL_POLYGON);
-	glTexCoord2f(1., 0.);	glVertex3f(6, 3, -9.9);
-	glTexCoord2f(0., 0.);	glVertex3f(6, 3, -7);
-	glTexCoord2f(0., 1.);	glVertex3f(9.9, 3, -7);
-	glTexCoord2f(1., 1.);	glVertex3f(9.9, 3, -9.9);
-	glEnd();
-	glBegin(GL_POLYGON);
-	glTexCoord2f(1., 0.);	glVertex3f(6, 3, -9.9);
-	glTexCoord2f(0., 0.);	glVertex3f(6, 3, -7);
-	glTexCoord2f(0., 1.);	glVertex3f(9.9, 3, -7);
-	glTexCoord2f(1., 1.);	glVertex3f(9.9, 3, -9.9);
-	glEnd();
-
-	glBegin(GL_POLYGON);
-	glTexCoord2f(1., 0.);	glVertex3f(6, 0, -9.9);
-	glTexCoord2f(0., 0.);	glVertex3f(6, 0, -7);
-	glTexCoord2f(0., 1.);	glVertex3f(9.9, 0, -7);
-	glTexCoord2f(1., 1.);	glVertex3f(9.9, 0, -9.9);
-	glEnd();
-	glBegin(GL_POLYGON);
-	glTexCoord2f(1., 0.);	glVertex3f(6, 3, -9.9);
-	glTexCoord2f(0., 0.);	glVertex3f(6, 3, -7);
-	glTexCoord2f(0., 1.);	glVertex3f(6, 0, -7);
-	glTexCoord2f(1., 1.);	glVertex3f(6, 0, -9.9);
-	glEnd();  glBegin(GL_POLYGON);
-	glTexCoord2f(1., 0.);	glVertex3f(9.9, 3, -9.9);
-	glTexCoord2f(0., 0.);	glVertex3f(9.9, 3, -7);
-	glTexCoord2f(0., 1.);	glVertex3f(9.9, 0, -7);
-	glTexCoord2f(1., 1.);	glVertex3f(9.9, 0, -9.9);
-	glEnd();
-	glBegin(GL_POLYGON);
-	glTexCoord2f(1., 0.);	glVertex3f(6, 3, -7);
-	glTexCoord2f(0., 0.);	glVertex3f(6, 0, -7);
-	glTexCoord2f(0., 1.);	glVertex3f(9.9, 0, -7);
-	glTexCoord2f(1., 1.);	glVertex3f(9.9, 3, -7);
-	glEnd();
-
-	glBegin(GL_POLYGON);
-	glTexCoord2f(1., 0.);	glVertex3f(6, 3, -6);
-	glTexCoord2f(0., 0.);	glVertex3f(6, 3, -2);
-	glTexCoord2f(0., 1.);	glVertex3f(9.9, 3, -2);
-	glTexCoord2f(1., 1.);	glVertex3f(9.9, 3, -6);
-	glEnd();
-
-	glBegin(GL_POLYGON);
-	glTexCoord2f(1., 0.);	glVertex3f(6, 0, -6);
-	glTexCoord2f(0., 0.);	glVertex3f(6, 0, -2);
-	glTexCoord2f(0., 1.);	glVertex3f(9.9, 0, -2);
-	glTexCoord2f(1., 1.);	glVertex3f(9.9, 0, -6);
-	glEnd();
-
-
-	glBegin(GL_POLYGON);
-	glTexCoord2f(1., 0.);	glVertex3f(9.9, 3, -6);
-	glTexCoord2f(0., 0.);	glVertex3f(9.9, 3, -2);
-	glTexCoord2f(0., 1.);	glVertex3f(9.9, 0, -2);
-	glTexCoord2f(1., 1.);	glVertex3f(9.9, 0, -6);
-	glEnd();
-
-	glBegin(GL_POLYGON);
-	glTexCoord2f(1., 0.);	glVertex3f(6, 3, -2);
-	glTexCoord2f(0., 0.);	glVertex3f(6, 0, -2);
-	glTexCoord2f(0., 1.);	glVertex3f(9.9, 0, -2);
-	glTexCoord2f(1., 1.);	glVertex3f(9.9, 3, -2);
-	glEnd();
-
-
-	glBegin(GL_POLYGON);
-	glTexCoord2f(1., 0.);	glVertex3f(6, 3, -6);
-	glTexCoord2f(0., 0.);	glVertex3f(6, 0, -6);
-	glTexCoord2f(0., 1.);	glVertex3f(9.9, 0, -6);
-	glTexCoord2f(1., 1.);	glVertex3f(9.9, 3, -6);
-	glEnd();
-
-
-
-	glDisable(GL_TEXTURE_2D);
-
-
-	glEnable(GL_TEXTURE_2D);
-	glColor3f(1, 1, 1);
-	glBindTexture(GL_TEXTURE_2D, textures[DRAWERS]);
+	gfx::begin(GL_POLYGON);
+	gfx::tex_coord2f(1., 0.);	gfx::vertex3f(6, 3, -9.9);
+	gfx::tex_coord2f(0., 0.);	gfx::vertex3f(6, 3, -7);
+	gfx::tex_coord2f(0., 1.);	gfx::vertex3f(9.9, 3, -7);
+	gfx::tex_coord2f(1., 1.);	gfx::vertex3f(9.9, 3, -9.9);
+	gfx::end();
+	gfx::begin(GL_POLYGON);
+	gfx::tex_coord2f(1., 0.);	gfx::vertex3f(6, 3, -9.9);
+	gfx::tex_coord2f(0., 0.);	gfx::vertex3f(6, 3, -7);
+	gfx::tex_coord2f(0., 1.);	gfx::vertex3f(9.9, 3, -7);
+	gfx::tex_coord2f(1., 1.);	gfx::vertex3f(9.9, 3, -9.9);
+	gfx::end();
+
+	gfx::begin(GL_POLYGON);
+	gfx::tex_coord2f(1., 0.);	gfx::vertex3f(6, 0, -9.9);
+	gfx::tex_coord2f(0., 0.);	gfx::vertex3f(6, 0, -7);
+	gfx::tex_coord2f(0., 1.);	gfx::vertex3f(9.9, 0, -7);
+	gfx::tex_coord2f(1., 1.);	gfx::vertex3f(9.9, 0, -9.9);
+	gfx::end();
+	gfx::begin(GL_POLYGON);
+	gfx::tex_coord2f(1., 0.);	gfx::vertex3f(6, 3, -9.9);
+	gfx::tex_coord2f(0., 0.);	gfx::vertex3f(6, 3, -7);
+	gfx::tex_coord2f(0., 1.);	gfx::vertex3f(6, 0, -7);
+	gfx::tex_coord2f(1., 1.);	gfx::vertex3f(6, 0, -9.9);
+	gfx::end();  gfx::begin(GL_POLYGON);
+	gfx::tex_coord2f(1., 0.);	gfx::vertex3f(9.9, 3, -9.9);
+	gfx::tex_coord2f(0., 0.);	gfx::vertex3f(9.9, 3, -7);
+	gfx::tex_coord2f(0., 1.);	gfx::vertex3f(9.9, 0, -7);
+	gfx::tex_coord2f(1., 1.);	gfx::vertex3f(9.9, 0, -9.9);
+	gfx::end();
+	gfx::begin(GL_POLYGON);
+	gfx::tex_coord2f(1., 0.);	gfx::vertex3f(6, 3, -7);
+	gfx::tex_coord2f(0., 0.);	gfx::vertex3f(6, 0, -7);
+	gfx::tex_coord2f(0., 1.);	gfx::vertex3f(9.9, 0, -7);
+	gfx::tex_coord2f(1., 1.);	gfx::vertex3f(9.9, 3, -7);
+	gfx::end();
+
+	gfx::begin(GL_POLYGON);
+	gfx::tex_coord2f(1., 0.);	gfx::vertex3f(6, 3, -6);
+	gfx::tex_coord2f(0., 0.);	gfx::vertex3f(6, 3, -2);
+	gfx::tex_coord2f(0., 1.);	gfx::vertex3f(9.9, 3, -2);
+	gfx::tex_coord2f(1., 1.);	gfx::vertex3f(9.9, 3, -6);
+	gfx::end();
+
+	gfx::begin(GL_POLYGON);
+	gfx::tex_coord2f(1., 0.);	gfx::vertex3f(6, 0, -6);
+	gfx::tex_coord2f(0., 0.);	gfx::vertex3f(6, 0, -2);
+	gfx::tex_coord2f(0., 1.);	gfx::vertex3f(9.9, 0, -2);
+	gfx::tex_coord2f(1., 1.);	gfx::vertex3f(9.9, 0, -6);
+	gfx::end();
+
+
+	gfx::begin(GL_POLYGON);
+	gfx::tex_coord2f(1., 0.);	gfx::vertex3f(9.9, 3, -6);
+	gfx::tex_coord2f(0., 0.);	gfx::vertex3f(9.9, 3, -2);
+	gfx::tex_coord2f(0., 1.);	gfx::vertex3f(9.9, 0, -2);
+	gfx::tex_coord2f(1., 1.);	gfx::vertex3f(9.9, 0, -6);
+	gfx::end();
+
+	gfx::begin(GL_POLYGON);
+	gfx::tex_coord2f(1., 0.);	gfx::vertex3f(6, 3, -2);
+	gfx::tex_coord2f(0., 0.);	gfx::vertex3f(6, 0, -2);
+	gfx::tex_coord2f(0., 1.);	gfx::vertex3f(9.9, 0, -2);
+	gfx::tex_coord2f(1., 1.);	gfx::vertex3f(9.9, 3, -2);
+	gfx::end();
+
+
+	gfx::begin(GL_POLYGON);
+	gfx::tex_coord2f(1., 0.);	gfx::vertex3f(6, 3, -6);
+	gfx::tex_coord2f(0., 0.);	gfx::vertex3f(6, 0, -6);
+	gfx::tex_coord2f(0., 1.);	gfx::vertex3f(9.9, 0, -6);
+	gfx::tex_coord2f(1., 1.);	gfx::vertex3f(9.9, 3, -6);
+	gfx::end();
+
+
+
+	gfx::disable(GL_TEXTURE_2D);
+
+
+	gfx::enable(GL_TEXTURE_2D);
+	gfx::color3f(1, 1, 1);
+	gfx::bind_texture(textures[DRAWERS]);
 	//first(1,5)
 
-	glBegin(GL_POLYGON);
-	glTexCoord2f(0., 1.);	glVertex3f(1, 3, -7);
-	glTexCoord2f(0., 0.);	glVertex3f(1, 0, -7);
-	glTexCoord2f(1., 0.);	glVertex3f(5, 0, -7);
-	glTexCoord2f(1., 1.);	glVertex3f(5, 3, -7);
-	glEnd();
+	gfx::begin(GL_POLYGON);
+	gfx::tex_coord2f(0., 1.);	gfx::vertex3f(1, 3, -7);
+	gfx::tex_coord2f(0., 0.);	gfx::vertex3f(1, 0, -7);
+	gfx::tex_coord2f(1., 0.);	gfx::vertex3f(5, 0, -7);
+	gfx::tex_coord2f(1., 1.);	gfx::vertex3f(5, 3, -7);
+	gfx::end();
 
 	//third
-	glBegin(GL_POLYGON);
-	glTexCoord2f(1., 0.);	glVertex3f(6, 3, -6);
-	glTexCoord2f(0., 0.);	glVertex3f(6, 3, -2);
-	glTexCoord2f(0., 1.);	glVertex3f(6, 0, -2);
-	glTexCoord2f(1., 1.);	glVertex3f(6, 0, -6);
-	glEnd();
+	gfx::begin(GL_POLYGON);
+	gfx::tex_coord2f(1., 0.);	gfx::vertex3f(6, 3, -6);
+	gfx::tex_coord2f(0., 0.);	gfx::vertex3f(6, 3, -2);
+	gfx::tex_coord2f(0., 1.);	gfx::vertex3f(6, 0, -2);
+	gfx::tex_coord2f(1., 1.);	gfx::vertex3f(6, 0, -6);
+	gfx::end();
 
 
 
-	glDisable(GL_TEXTURE_2D);
+	gfx::disable(GL_TEXTURE_2D);
 
-	glPopMatrix();
+	gfx::pop_matrix();
 
 }
 
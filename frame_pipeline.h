@@ -0,0 +1,284 @@
+#ifndef FRAME_PIPELINE_H
+#define FRAME_PIPELINE_H
+
+#include "frame_snapshot.h"
+#include "gfx.h"
+#include "sim_clock.h"
+#include "trace.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/*
+  FRAME PIPELINE
+  Three stages, each on its own thread, overlapping across frames:
+
+    simulation  : input + fixed SIM_DT steps -> FrameSnapshot
+    build       : latest snapshot            -> gfx::CommandList
+    submit (GL) : latest command list        -> GL, swap
+
+  Stages hand over through triple buffers, so nobody waits on a slower
+  neighbour: the builder records frame N+1 while the GL thread is still
+  submitting / swapping frame N, and a late GL thread just skips to the
+  newest list. Serial mode runs all three back to back on the GL thread.
+*/
+
+// INPUT EVENTS
+/// GLUT callbacks run on the GL thread; they only queue what happened and
+/// the simulation applies it before its next step.
+enum {
+  INPUT_KEY,
+  INPUT_KEY_UP,
+  INPUT_SPECIAL,
+  INPUT_SPECIAL_UP,
+  INPUT_MOUSE,
+  INPUT_RESIZE,
+  INPUT_SET /// Scripted: global 'key' (a ScriptVar) = 'value'
+};
+
+struct InputEvent {
+  int type;
+  int key;
+  int x, y;
+  float value;
+};
+
+class InputQueue {
+private:
+  std::mutex lock;
+  std::vector<InputEvent> pending;
+
+public:
+  void push(const InputEvent &e) {
+    std::lock_guard<std::mutex> guard(lock);
+    pending.push_back(e);
+  }
+
+  /// Hands every queued event over in 'out' (which is cleared first). The
+  /// two vectors trade buffers, so this doesn't allocate once warmed up.
+  void drain(std::vector<InputEvent> &out) {
+    out.clear();
+    std::lock_guard<std::mutex> guard(lock);
+    out.swap(pending);
+  }
+};
+
+// TRIPLE BUFFER
+/// Single producer / single consumer hand-over without locks. The writer
+/// fills writeSlot() and publish()es it; the reader acquire()s the most
+/// recent published slot. Neither side ever waits for the other.
+template <typename T> class TripleBuffer {
+private:
+  enum { FRESH = 4, INDEX = 3 };
+  T slots[3];
+  std::atomic<int> middle;
+  int back, front;
+
+public:
+  TripleBuffer() : middle(2), back(0), front(1) {}
+
+  T &writeSlot() { return slots[back]; }
+  void publish() {
+    back = middle.exchange(back | FRESH, std::memory_order_acq_rel) & INDEX;
+  }
+
+  /// True (and readSlot() updated) when something new was published.
+  bool acquire() {
+    if (!(middle.load(std::memory_order_acquire) & FRESH))
+      return false;
+    front = middle.exchange(front, std::memory_order_acq_rel) & INDEX;
+    return true;
+  }
+  const T &readSlot() const { return slots[front]; }
+  T &readSlot() { return slots[front]; }
+};
+
+// FRAME DATA
+/// What the GL thread gets: the recorded scene plus the snapshot it was
+/// built from (tooltips and overlays still read it on the GL thread).
+struct FrameData {
+  FrameSnapshot snapshot;
+  float t; /// Blend factor between snapshot's previous and current state
+  gfx::CommandList scene;
+};
+
+class FramePipeline {
+public:
+  typedef void (*ApplyInputFn)(const InputEvent &);
+  typedef void (*StepFn)();
+  typedef void (*SnapshotFn)(FrameSnapshot &);
+  typedef void (*BuildFn)(const FrameSnapshot &, float, gfx::CommandList &);
+
+  InputQueue input;
+
+  FramePipeline(SimClock &clock, ApplyInputFn applyInput, StepFn step,
+                SnapshotFn snapshot, BuildFn build)
+      : clock(clock), applyInput(applyInput), step(step), snapshot(snapshot),
+        build(build) {}
+
+  ~FramePipeline() { stop(); }
+
+  void start(bool threadedMode) {
+    threaded = threadedMode;
+    if (!threaded)
+      return;
+    running = true;
+    simThread = std::thread(&FramePipeline::simLoop, this);
+    buildThread = std::thread(&FramePipeline::buildLoop, this);
+  }
+
+  void stop() {
+    if (!running)
+      return;
+    {
+      std::lock_guard<std::mutex> guard(lock);
+      running = false;
+    }
+    wakeBuilder.notify_all();
+    wakeGL.notify_all();
+    if (simThread.joinable())
+      simThread.join();
+    if (buildThread.joinable())
+      buildThread.join();
+  }
+
+  bool isThreaded() const { return threaded; }
+
+  /// GL thread: the next frame to submit, or nullptr if none arrived within
+  /// 'waitMs'. Taking a frame immediately lets the builder start the next.
+  /// The frame stays valid until the following acquire().
+  const FrameData *acquire(int waitMs) {
+    if (!threaded) {
+      tick();
+      FrameData &f = frames.writeSlot();
+      buildFrame(f);
+      frames.publish();
+    } else {
+      std::unique_lock<std::mutex> guard(lock);
+      wakeGL.wait_for(guard, std::chrono::milliseconds(waitMs),
+                      [this] { return frameReady || !running; });
+      if (!frameReady)
+        return nullptr;
+      frameReady = false;
+      frameTaken = true;
+      guard.unlock();
+      wakeBuilder.notify_one();
+    }
+    if (!frames.acquire())
+      return nullptr;
+    hasFrame = true;
+    return &frames.readSlot();
+  }
+
+  /// GL thread: the frame returned by the last successful acquire().
+  const FrameData *last() const {
+    return hasFrame ? &frames.readSlot() : nullptr;
+  }
+
+private:
+  SimClock &clock;
+  ApplyInputFn applyInput;
+  StepFn step;
+  SnapshotFn snapshot;
+  BuildFn build;
+
+  bool threaded = false;
+  bool running = false;
+  bool hasFrame = false;
+  std::thread simThread, buildThread;
+
+  TripleBuffer<FrameSnapshot> snapshots;
+  TripleBuffer<FrameData> frames;
+  std::vector<InputEvent> events; /// Sim side scratch
+  unsigned long steps = 0;
+
+  std::mutex lock;
+  std::condition_variable wakeBuilder, wakeGL;
+  bool published = false;  /// Sim has produced a first snapshot
+  bool frameTaken = true;  /// GL took the last built frame
+  bool frameReady = false; /// Built frame waiting for GL
+
+  static double seconds() {
+    return std::chrono::duration<double>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+  }
+
+  /// Simulation stage: apply queued input, run due steps, publish.
+  void tick() {
+    int due = clock.advance();
+    input.drain(events);
+    for (size_t i = 0; i < events.size(); i++)
+      applyInput(events[i]);
+    for (int i = 0; i < due; i++)
+      step();
+    steps += due;
+
+    FrameSnapshot &s = snapshots.writeSlot();
+    snapshot(s);
+    s.step = steps;
+    s.alpha = clock.alpha();
+    s.publishTime = seconds();
+    snapshots.publish();
+  }
+
+  /// Build stage: record the newest snapshot, blended to the current time.
+  void buildFrame(FrameData &f) {
+    snapshots.acquire();
+    f.snapshot = snapshots.readSlot();
+    float late = (float)((seconds() - f.snapshot.publishTime) / SIM_DT);
+    f.t = std::min(1.0f, f.snapshot.alpha + (threaded ? late : 0.0f));
+    build(f.snapshot, f.t, f.scene);
+  }
+
+  void simLoop() {
+    trace::name_thread("simulation");
+    while (true) {
+      {
+        std::lock_guard<std::mutex> guard(lock);
+        if (!running)
+          break;
+      }
+      tick();
+      if (!published) {
+        {
+          std::lock_guard<std::mutex> guard(lock);
+          published = true;
+        }
+        wakeBuilder.notify_one();
+      }
+      // Sleep until the next step is due.
+      std::this_thread::sleep_for(
+          std::chrono::duration<float>(SIM_DT * (1.0f - clock.alpha())));
+    }
+  }
+
+  void buildLoop() {
+    trace::name_thread("build");
+    while (true) {
+      {
+        std::unique_lock<std::mutex> guard(lock);
+        wakeBuilder.wait(guard, [this] {
+          return !running || (published && frameTaken);
+        });
+        if (!running)
+          break;
+        frameTaken = false;
+      }
+      buildFrame(frames.writeSlot());
+      frames.publish();
+      {
+        std::lock_guard<std::mutex> guard(lock);
+        frameReady = true;
+      }
+      wakeGL.notify_one();
+    }
+  }
+};
+
+#endif
@@ -0,0 +1,68 @@
+#ifndef FRAME_SNAPSHOT_H
+#define FRAME_SNAPSHOT_H
+
+#include "parameter.h"
+
+// CAMERA STATE
+/// Everything the frame needs to place the camera.
+struct CameraState {
+  double x, y, z;
+  float lx, lz;
+};
+
+CameraState lerp(const CameraState &a, const CameraState &b, float t) {
+  CameraState c;
+  c.x = a.x + (b.x - a.x) * t;
+  c.y = a.y + (b.y - a.y) * t;
+  c.z = a.z + (b.z - a.z) * t;
+  c.lx = a.lx + (b.lx - a.lx) * t;
+  c.lz = a.lz + (b.lz - a.lz) * t;
+  return c;
+}
+
+// PART POSES
+/// Where a removable part is drawn: its offset one sim step ago and now, so
+/// the frame can blend between them. 'spin' is only used by the fan.
+struct PartPose {
+  point3D prev, curr;
+  float spinPrev, spin;
+  bool visible;
+
+  point3D at(float t) const { return lerp(prev, curr, t); }
+  float spinAt(float t) const { return spinPrev + (spin - spinPrev) * t; }
+};
+
+enum {
+  PART_FAN,
+  PART_MOTHERBOARD,
+  PART_RAM,
+  PART_CHIPSET,
+  PART_GPU,
+  PART_PSU,
+  PART_HDD,
+  PART_SIDE_PANEL,
+  PART_CABLE,
+  PART_COUNT
+};
+
+/// Text shown near the case while in CPU view (see cpuView()).
+enum { PROMPT_NONE, PROMPT_ASK_DISASSEMBLE, PROMPT_CONTROLS };
+
+// FRAME SNAPSHOT
+/// Immutable copy of the simulation taken after a step. The frame builder
+/// only ever reads one of these, never the live globals the simulation owns.
+struct FrameSnapshot {
+  unsigned long step;  /// Sim steps run so far
+  double publishTime;  /// steady_clock seconds when taken
+  float alpha;         /// SimClock::alpha() when taken
+  CameraState cameraPrev, camera;
+  PartPose parts[PART_COUNT];
+  int page;
+  int objIndex;
+  int prompt;
+  float progress;      /// Loading wheel
+  int width, height;   /// Window size, for 2D overlays
+  int mouseX, mouseY;
+};
+
+#endif
@@ -0,0 +1,481 @@
+#include "gfx.h"
+#include "alloc_track.h"
+#include "font_atlas.h"
+#include "gfx_gl3.h"
+#include "gfx_soft.h"
+#include "trace.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace gfx {
+
+namespace {
+
+static thread_local CommandList* t_list = nullptr;
+
+#ifndef NO_GFX_COUNTERS
+static thread_local Counters t_counts = {};
+static thread_local size_t t_begin = 0;             // Open begin() in t_list->cmds
+static thread_local unsigned long t_begin_verts = 0; // t_counts vertices then
+static Counters g_frame_counts = {}, g_last_frame_counts = {};
+
+static void count(Counter kind, unsigned long n = 1) {
+	t_list->counts.n[kind] += n;
+	t_counts.n[kind] += n;
+}
+
+static unsigned long primitives(GLenum mode, unsigned long v) {
+	switch (mode) {
+	case GL_POINTS: return v;
+	case GL_LINES: return v / 2;
+	case GL_LINE_STRIP: return v > 1 ? v - 1 : 0;
+	case GL_LINE_LOOP: return v > 1 ? v : 0;
+	case GL_TRIANGLES: return v / 3;
+	case GL_QUADS: return v / 4 * 2;
+	default: return v > 2 ? v - 2 : 0; // Strips, fans, quad strips, polygons
+	}
+}
+
+static void count_op(Op op) {
+	switch (op) {
+	case OP_BEGIN:
+		count(COUNT_DRAWS);
+		t_begin = t_list->cmds.size() - 1;
+		t_begin_verts = t_counts.n[COUNT_VERTICES];
+		break;
+	case OP_END:
+		if (t_begin < t_list->cmds.size() && t_list->cmds[t_begin].op == OP_BEGIN)
+			count(COUNT_PRIMITIVES, primitives(t_list->cmds[t_begin].u, t_counts.n[COUNT_VERTICES] - t_begin_verts));
+		break;
+	case OP_VERTEX: count(COUNT_VERTICES); break;
+	case OP_BIND_TEXTURE: count(COUNT_BINDS); break;
+	case OP_ENABLE:
+	case OP_DISABLE:
+	case OP_BLEND_FUNC:
+	case OP_LINE_WIDTH:
+	case OP_POINT_SIZE: count(COUNT_STATES); break;
+	case OP_PUSH_MATRIX:
+	case OP_POP_MATRIX: count(COUNT_MATRICES); break;
+	case OP_TEXT: count(COUNT_DRAWS); break;
+	default: break;
+	}
+}
+#endif
+
+static Command& push(Op op) {
+	alloc::push_kept(t_list->cmds, Command());
+	Command& c = t_list->cmds.back();
+	c.op = op;
+	c.u = 0;
+	c.n = 0;
+#ifndef NO_GFX_COUNTERS
+	count_op(op);
+#endif
+	return c;
+}
+
+static void push_f(Op op, float a, float b = 0.0f, float c = 0.0f, float d = 0.0f) {
+	if (!t_list) return;
+	Command& cmd = push(op);
+	cmd.f[0] = a;
+	cmd.f[1] = b;
+	cmd.f[2] = c;
+	cmd.f[3] = d;
+}
+
+static void push_u(Op op, unsigned int u) {
+	if (!t_list) return;
+	push(op).u = u;
+}
+
+static Renderer g_renderer = RENDERER_LEGACY;
+static bool g_windowed = true;
+static GLuint g_soft_textures = 0; // Software: texture names handed out
+static std::vector<size_t> g_texture_bytes; // By texture name
+static size_t g_texture_total = 0;
+static GLuint g_overlay_font = 0; // Legacy: font atlas as GL_ALPHA
+static int g_width = 1, g_height = 1; // Window, from resize()
+
+} // namespace
+
+const char* counter_name(int counter) {
+	static const char* const names[COUNTER_KINDS] = {"draws", "vertices", "primitives", "binds",
+	                                                 "states", "matrices", "glyphs"};
+	return counter >= 0 && counter < COUNTER_KINDS ? names[counter] : "";
+}
+
+void CommandList::append(const CommandList& other) {
+#ifndef NO_GFX_COUNTERS
+	counts.add(other.counts);
+#endif
+	size_t first = cmds.size();
+	unsigned int textBase = (unsigned int)text.size();
+	alloc::reserve_kept(cmds, first + other.cmds.size());
+	alloc::reserve_kept(text, textBase + other.text.size());
+	cmds.insert(cmds.end(), other.cmds.begin(), other.cmds.end());
+	text.insert(text.end(), other.text.begin(), other.text.end());
+	if (textBase == 0) return;
+	for (size_t i = first; i < cmds.size(); i++) {
+		if (cmds[i].op == OP_TEXT) cmds[i].n += textBase;
+	}
+}
+
+void merge(const SortedList* lists, size_t count, CommandList& out) {
+	static thread_local std::vector<size_t> order;
+	order.resize(count);
+	size_t cmds = out.cmds.size(), text = out.text.size();
+	for (size_t i = 0; i < count; i++) {
+		order[i] = i;
+		cmds += lists[i].list.cmds.size();
+		text += lists[i].list.text.size();
+	}
+	// Stable insertion sort: a few dozen lists, and std::stable_sort would
+	// allocate a scratch buffer every frame.
+	for (size_t i = 1; i < count; i++) {
+		size_t moving = order[i], j = i;
+		for (; j > 0 && lists[moving].key < lists[order[j - 1]].key; j--) order[j] = order[j - 1];
+		order[j] = moving;
+	}
+	alloc::reserve_kept(out.cmds, cmds);
+	alloc::reserve_kept(out.text, text);
+	for (size_t i = 0; i < count; i++) out.append(lists[order[i]].list);
+}
+
+void record_into(CommandList* list) { t_list = list; }
+
+CommandList* recording() { return t_list; }
+
+#ifndef NO_GFX_COUNTERS
+Counters thread_counters() { return t_counts; }
+Counters frame_counters() { return g_last_frame_counts; }
+#else
+Counters thread_counters() { return Counters(); }
+Counters frame_counters() { return Counters(); }
+#endif
+
+Font font_id(void* glutFont) {
+	if (glutFont == GLUT_BITMAP_HELVETICA_12) return FONT_HELVETICA_12;
+	if (glutFont == GLUT_BITMAP_TIMES_ROMAN_10) return FONT_TIMES_ROMAN_10;
+	return FONT_HELVETICA_18;
+}
+
+void* glut_font(unsigned int font) {
+	switch (font) {
+	case FONT_HELVETICA_12: return GLUT_BITMAP_HELVETICA_12;
+	case FONT_TIMES_ROMAN_10: return GLUT_BITMAP_TIMES_ROMAN_10;
+	default: return GLUT_BITMAP_HELVETICA_18;
+	}
+}
+
+void begin(GLenum mode) { push_u(OP_BEGIN, mode); }
+void end() { push_u(OP_END, 0); }
+void vertex2f(float x, float y) { push_f(OP_VERTEX, x, y, 0.0f, 1.0f); }
+void vertex3f(float x, float y, float z) { push_f(OP_VERTEX, x, y, z, 1.0f); }
+void vertex3fv(const float* v) { push_f(OP_VERTEX, v[0], v[1], v[2], 1.0f); }
+void tex_coord2f(float s, float t) { push_f(OP_TEX_COORD, s, t); }
+void tex_coord2i(int s, int t) { push_f(OP_TEX_COORD, (float)s, (float)t); }
+void color3f(float r, float g, float b) { push_f(OP_COLOR, r, g, b, 1.0f); }
+void color3fv(const float* c) { push_f(OP_COLOR, c[0], c[1], c[2], 1.0f); }
+void color4f(float r, float g, float b, float a) { push_f(OP_COLOR, r, g, b, a); }
+
+void color3b(signed char r, signed char g, signed char b) {
+	// Same mapping as glColor3b: [-128, 127] -> [-1, 1].
+	push_f(OP_COLOR, (2.0f * r + 1.0f) / 255.0f, (2.0f * g + 1.0f) / 255.0f, (2.0f * b + 1.0f) / 255.0f, 1.0f);
+}
+
+void push_matrix() { push_u(OP_PUSH_MATRIX, 0); }
+void pop_matrix() { push_u(OP_POP_MATRIX, 0); }
+void translatef(float x, float y, float z) { push_f(OP_TRANSLATE, x, y, z); }
+void rotatef(float angle, float x, float y, float z) { push_f(OP_ROTATE, angle, x, y, z); }
+void scalef(float x, float y, float z) { push_f(OP_SCALE, x, y, z); }
+void matrix_mode(GLenum mode) { push_u(OP_MATRIX_MODE, mode); }
+void load_identity() { push_u(OP_LOAD_IDENTITY, 0); }
+void ortho2d(float left, float right, float bottom, float top) { push_f(OP_ORTHO_2D, left, right, bottom, top); }
+
+void look_at(float eyeX, float eyeY, float eyeZ, float centerX, float centerY, float centerZ) {
+	if (!t_list) return;
+	Command& c = push(OP_LOOK_AT);
+	c.f[0] = eyeX;
+	c.f[1] = eyeY;
+	c.f[2] = eyeZ;
+	c.f[3] = centerX;
+	c.f[4] = centerY;
+	c.f[5] = centerZ;
+}
+
+void enable(GLenum cap) { push_u(OP_ENABLE, cap); }
+void disable(GLenum cap) { push_u(OP_DISABLE, cap); }
+void bind_texture(GLuint texture) { push_u(OP_BIND_TEXTURE, texture); }
+void line_width(float width) { push_f(OP_LINE_WIDTH, width); }
+void point_size(float size) { push_f(OP_POINT_SIZE, size); }
+
+void blend_func(GLenum src, GLenum dst) {
+	if (!t_list) return;
+	Command& c = push(OP_BLEND_FUNC);
+	c.u = src;
+	c.n = dst;
+}
+
+void raster_pos2f(float x, float y) { push_f(OP_RASTER_POS, x, y, 0.0f, 1.0f); }
+void raster_pos3f(float x, float y, float z) { push_f(OP_RASTER_POS, x, y, z, 1.0f); }
+
+void bitmap_string(void* glutFont, const char* text) { bitmap_string(glutFont, text, std::strlen(text)); }
+
+void bitmap_string(void* glutFont, const char* text, size_t length) {
+	if (!t_list) return;
+	Command& c = push(OP_TEXT);
+	c.u = font_id(glutFont);
+	c.n = (unsigned int)t_list->text.size();
+	alloc::reserve_kept(t_list->text, t_list->text.size() + length + 1);
+	t_list->text.insert(t_list->text.end(), text, text + length);
+	t_list->text.push_back('\0');
+#ifndef NO_GFX_COUNTERS
+	count(COUNT_GLYPHS, length);
+#endif
+}
+
+static void submit_legacy(const CommandList& list) {
+	const Command* cmds = list.cmds.data();
+	const char* text = list.text.data();
+	for (size_t i = 0, n = list.cmds.size(); i < n; i++) {
+		const Command& c = cmds[i];
+		switch (c.op) {
+		case OP_BEGIN: glBegin(c.u); break;
+		case OP_END: glEnd(); break;
+		case OP_VERTEX: glVertex3f(c.f[0], c.f[1], c.f[2]); break;
+		case OP_TEX_COORD: glTexCoord2f(c.f[0], c.f[1]); break;
+		case OP_COLOR: glColor4f(c.f[0], c.f[1], c.f[2], c.f[3]); break;
+		case OP_PUSH_MATRIX: glPushMatrix(); break;
+		case OP_POP_MATRIX: glPopMatrix(); break;
+		case OP_TRANSLATE: glTranslatef(c.f[0], c.f[1], c.f[2]); break;
+		case OP_ROTATE: glRotatef(c.f[0], c.f[1], c.f[2], c.f[3]); break;
+		case OP_SCALE: glScalef(c.f[0], c.f[1], c.f[2]); break;
+		case OP_MATRIX_MODE: glMatrixMode(c.u); break;
+		case OP_LOAD_IDENTITY: glLoadIdentity(); break;
+		case OP_ORTHO_2D: gluOrtho2D(c.f[0], c.f[1], c.f[2], c.f[3]); break;
+		case OP_LOOK_AT: gluLookAt(c.f[0], c.f[1], c.f[2], c.f[3], c.f[4], c.f[5], 0.0, 1.0, 0.0); break;
+		case OP_ENABLE: glEnable(c.u); break;
+		case OP_DISABLE: glDisable(c.u); break;
+		case OP_BIND_TEXTURE: glBindTexture(GL_TEXTURE_2D, c.u); break;
+		case OP_BLEND_FUNC: glBlendFunc(c.u, c.n); break;
+		case OP_LINE_WIDTH: glLineWidth(c.f[0]); break;
+		case OP_POINT_SIZE: glPointSize(c.f[0]); break;
+		case OP_RASTER_POS: glRasterPos3f(c.f[0], c.f[1], c.f[2]); break;
+		case OP_TEXT: {
+			void* font = glut_font(c.u);
+			for (const char* ch = text + c.n; *ch; ch++) glutBitmapCharacter(font, *ch);
+			break;
+		}
+		}
+	}
+}
+
+// Client arrays rather than a buffer object keep this GL 1.1, like the rest
+// of the legacy path; it is still a single glDrawArrays.
+static void draw_overlay_legacy(const OverlayVertex* vertices, size_t count) {
+	if (!g_overlay_font) {
+		std::vector<unsigned char> atlas(FONT_ATLAS_WIDTH * FONT_ATLAS_HEIGHT);
+		build_font_atlas(atlas.data());
+		glGenTextures(1, &g_overlay_font);
+		glBindTexture(GL_TEXTURE_2D, g_overlay_font);
+		glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+		glTexImage2D(GL_TEXTURE_2D, 0, GL_ALPHA, FONT_ATLAS_WIDTH, FONT_ATLAS_HEIGHT, 0, GL_ALPHA, GL_UNSIGNED_BYTE,
+		             atlas.data());
+		glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+	}
+	glPushAttrib(GL_ENABLE_BIT | GL_COLOR_BUFFER_BIT | GL_TEXTURE_BIT);
+	glPushClientAttrib(GL_CLIENT_VERTEX_ARRAY_BIT);
+	glMatrixMode(GL_PROJECTION);
+	glPushMatrix();
+	glLoadIdentity();
+	glOrtho(0.0, g_width, 0.0, g_height, -1.0, 1.0); // As resize() set the viewport
+	glMatrixMode(GL_MODELVIEW);
+	glPushMatrix();
+	glLoadIdentity();
+
+	glDisable(GL_LIGHTING);
+	glDisable(GL_DEPTH_TEST);
+	glEnable(GL_BLEND);
+	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+	glEnable(GL_TEXTURE_2D);
+	glBindTexture(GL_TEXTURE_2D, g_overlay_font);
+	glTexEnvi(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_MODULATE); // Alpha: vertex x coverage
+
+	glEnableClientState(GL_VERTEX_ARRAY);
+	glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+	glEnableClientState(GL_COLOR_ARRAY);
+	glDisableClientState(GL_NORMAL_ARRAY);
+	glVertexPointer(2, GL_FLOAT, sizeof(OverlayVertex), &vertices[0].x);
+	glTexCoordPointer(2, GL_FLOAT, sizeof(OverlayVertex), &vertices[0].u);
+	glColorPointer(4, GL_UNSIGNED_BYTE, sizeof(OverlayVertex), vertices[0].rgba);
+	glDrawArrays(GL_TRIANGLES, 0, (GLsizei)count);
+
+	glPopMatrix();
+	glMatrixMode(GL_PROJECTION);
+	glPopMatrix();
+	glMatrixMode(GL_MODELVIEW);
+	glPopClientAttrib();
+	glPopAttrib();
+}
+
+bool parse_renderer(const char* name, Renderer& out) {
+	for (int r = RENDERER_LEGACY; r <= RENDERER_SOFTWARE; r++) {
+		if (std::strcmp(name, renderer_name((Renderer)r)) == 0) {
+			out = (Renderer)r;
+			return true;
+		}
+	}
+	return false;
+}
+
+const char* renderer_name(Renderer renderer) {
+	switch (renderer) {
+	case RENDERER_GL3: return "gl3";
+	case RENDERER_SOFTWARE: return "software";
+	default: return "legacy";
+	}
+}
+
+void set_renderer(Renderer renderer) { g_renderer = renderer; }
+
+Renderer renderer() { return g_renderer; }
+
+void set_windowed(bool windowed) { g_windowed = windowed; }
+
+bool windowed() { return g_windowed; }
+
+bool init_renderer(ProcLoader loader, unsigned int workers) {
+	if (g_renderer == RENDERER_SOFTWARE) return soft::init(workers);
+	glEnable(GL_DEPTH_TEST);
+	if (g_renderer == RENDERER_GL3) return gl3::init(loader);
+	return true;
+}
+
+void resize(int w, int h, float fovY, float zNear, float zFar) {
+	g_width = w;
+	g_height = h;
+	if (g_renderer == RENDERER_GL3) {
+		gl3::resize(w, h, fovY, zNear, zFar);
+		return;
+	}
+	if (g_renderer == RENDERER_SOFTWARE) {
+		if (g_windowed) glViewport(0, 0, w, h); // For present()
+		soft::resize(w, h, fovY, zNear, zFar);
+		return;
+	}
+	glViewport(0, 0, w, h);
+	glMatrixMode(GL_PROJECTION);
+	glLoadIdentity();
+	gluPerspective(fovY, (float)w / (float)(h == 0 ? 1 : h), zNear, zFar);
+	glMatrixMode(GL_MODELVIEW);
+}
+
+void set_light(const float position[4], const float diffuse[4]) {
+	if (g_renderer == RENDERER_GL3) {
+		gl3::set_light(position, diffuse);
+		return;
+	}
+	if (g_renderer == RENDERER_SOFTWARE) {
+		soft::set_light(position, diffuse);
+		return;
+	}
+	const GLfloat black[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+	glEnable(GL_LIGHTING);
+	glEnable(GL_LIGHT0);
+	glLightfv(GL_LIGHT0, GL_POSITION, position);
+	glLightfv(GL_LIGHT0, GL_DIFFUSE, diffuse);
+	glLightfv(GL_LIGHT0, GL_SPECULAR, black);
+
+	glEnable(GL_COLOR_MATERIAL);
+	glColorMaterial(GL_FRONT, GL_AMBIENT_AND_DIFFUSE);
+	glMaterialfv(GL_FRONT, GL_SPECULAR, black);
+}
+
+void upload_texture(unsigned int texture, int w, int h, const unsigned char* rgb) {
+	trace::Scope timing("upload texture", "load");
+	size_t bytes = 0;
+	for (int lw = w, lh = h; lw > 0 && lh > 0; lw = std::max(1, lw / 2), lh = std::max(1, lh / 2)) {
+		bytes += (size_t)lw * lh * 4;
+		if (lw == 1 && lh == 1) break;
+	}
+	if (texture >= g_texture_bytes.size()) g_texture_bytes.resize(texture + 1, 0);
+	g_texture_total += bytes - g_texture_bytes[texture];
+	g_texture_bytes[texture] = bytes;
+
+	if (g_renderer == RENDERER_GL3) {
+		gl3::upload_texture(texture, w, h, rgb);
+		return;
+	}
+	if (g_renderer == RENDERER_SOFTWARE) {
+		soft::upload_texture(texture, w, h, rgb);
+		return;
+	}
+	glBindTexture(GL_TEXTURE_2D, texture);
+	glTexEnvf(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_MODULATE);
+	glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_NEAREST);
+	glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+	glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+	gluBuild2DMipmaps(GL_TEXTURE_2D, GL_RGB, w, h, GL_RGB, GL_UNSIGNED_BYTE, rgb);
+}
+
+size_t texture_bytes() { return g_texture_total; }
+
+bool has_render_targets() { return g_renderer == RENDERER_GL3 || g_renderer == RENDERER_SOFTWARE; }
+
+GLuint create_texture() {
+	// The software renderer keeps its textures itself, so it needs no GL
+	// context (headless, it has none).
+	if (g_renderer == RENDERER_SOFTWARE) return ++g_soft_textures;
+	GLuint texture = 0;
+	glGenTextures(1, &texture);
+	return texture;
+}
+
+void render_to_texture(GLuint texture, int w, int h, const CommandList& list) {
+	if (!has_render_targets()) return;
+	trace::Scope timing("render to texture", "gfx");
+	size_t bytes = (size_t)w * h * 4;
+	if (texture >= g_texture_bytes.size()) g_texture_bytes.resize(texture + 1, 0);
+	g_texture_total += bytes - g_texture_bytes[texture];
+	g_texture_bytes[texture] = bytes;
+#ifndef NO_GFX_COUNTERS
+	g_frame_counts.add(list.counts);
+#endif
+	if (g_renderer == RENDERER_GL3) gl3::render_to_texture(texture, w, h, list);
+	else soft::render_to_texture(texture, w, h, list);
+}
+
+void clear() {
+	if (g_renderer == RENDERER_SOFTWARE) soft::clear();
+	else glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+}
+
+void submit(const CommandList& list) {
+#ifndef NO_GFX_COUNTERS
+	g_frame_counts.add(list.counts);
+#endif
+	if (g_renderer == RENDERER_GL3) gl3::submit(list);
+	else if (g_renderer == RENDERER_SOFTWARE) soft::submit(list);
+	else submit_legacy(list);
+}
+
+void present() {
+	if (g_renderer == RENDERER_SOFTWARE && g_windowed) soft::present();
+#ifndef NO_GFX_COUNTERS
+	g_last_frame_counts = g_frame_counts;
+	g_frame_counts = Counters();
+#endif
+}
+
+void draw_overlay(const OverlayVertex* vertices, size_t count) {
+	if (count == 0) return;
+	if (g_renderer == RENDERER_GL3) gl3::draw_overlay(vertices, count);
+	else if (g_renderer == RENDERER_SOFTWARE) soft::draw_overlay(vertices, count);
+	else draw_overlay_legacy(vertices, count);
+}
+
+} // namespace gfx
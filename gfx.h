@@ -0,0 +1,259 @@
+#pragma once
+
+#include "gl_includes.h"
+
+#include <cstddef>
+#include <vector>
+
+namespace gfx {
+
+// Scene drawing is recorded into a CommandList instead of going straight to
+// GL, so a frame can be built on a worker thread and replayed later on the
+// thread that owns the GL context. The recording calls mirror the GL 1.x
+// entry points the simulator uses, one-to-one.
+
+enum Op : unsigned char {
+	OP_BEGIN,
+	OP_END,
+	OP_VERTEX,
+	OP_TEX_COORD,
+	OP_COLOR,
+	OP_PUSH_MATRIX,
+	OP_POP_MATRIX,
+	OP_TRANSLATE,
+	OP_ROTATE,
+	OP_SCALE,
+	OP_MATRIX_MODE,
+	OP_LOAD_IDENTITY,
+	OP_ORTHO_2D,
+	OP_LOOK_AT,
+	OP_ENABLE,
+	OP_DISABLE,
+	OP_BIND_TEXTURE,
+	OP_BLEND_FUNC,
+	OP_LINE_WIDTH,
+	OP_POINT_SIZE,
+	OP_RASTER_POS,
+	OP_TEXT,
+};
+
+// Bitmap fonts, recorded by id so non-GLUT backends can map them.
+enum Font : unsigned int {
+	FONT_HELVETICA_18,
+	FONT_HELVETICA_12,
+	FONT_TIMES_ROMAN_10,
+};
+
+struct Command {
+	Op op;
+	unsigned int u; // GL enum, texture name, font
+	unsigned int n; // OP_TEXT: offset of the NUL terminated string in 'text'
+	float f[6];
+};
+
+// SUBMISSION COUNTERS
+// What the simulator asks of the renderer, counted as it is recorded, so
+// the numbers are the same whichever renderer replays it. Built with
+// -DNO_GFX_COUNTERS (the Release target is) the counting compiles away and
+// the functions below return zeros.
+enum Counter {
+	COUNT_DRAWS,      // begin / end pairs and text runs
+	COUNT_VERTICES,
+	COUNT_PRIMITIVES, // Points, lines, triangles (a quad is 2, a polygon n - 2)
+	COUNT_BINDS,      // Texture binds
+	COUNT_STATES,     // enable / disable / blend_func / line_width / point_size
+	COUNT_MATRICES,   // push / pop
+	COUNT_GLYPHS,     // Bitmap characters
+	COUNTER_KINDS,
+};
+
+struct Counters {
+	unsigned long n[COUNTER_KINDS];
+
+	void add(const Counters& other) {
+		for (int i = 0; i < COUNTER_KINDS; i++) n[i] += other.n[i];
+	}
+};
+
+#ifndef NO_GFX_COUNTERS
+const bool COUNTERS_ENABLED = true;
+#else
+const bool COUNTERS_ENABLED = false;
+#endif
+
+const char* counter_name(int counter);
+
+struct CommandList {
+	std::vector<Command> cmds;
+	std::vector<char> text; // OP_TEXT payloads
+#ifndef NO_GFX_COUNTERS
+	Counters counts = {}; // What was recorded into it
+#endif
+
+	// Keeps capacity, so steady-state frames don't allocate. Lists are
+	// meant to be kept and cleared: recording grows them through
+	// alloc::push_kept(), which --assert-no-alloc lets through.
+	void clear() {
+		cmds.clear();
+		text.clear();
+#ifndef NO_GFX_COUNTERS
+		counts = Counters();
+#endif
+	}
+	size_t size() const { return cmds.size(); }
+	void append(const CommandList& other);
+};
+
+// A list recorded on its own (e.g. by a worker thread), tagged with where
+// it belongs in the frame.
+struct SortedList {
+	unsigned int key;
+	CommandList list;
+};
+
+// Appends 'count' lists to 'out' in ascending key order; equal keys keep
+// their order in 'lists'.
+void merge(const SortedList* lists, size_t count, CommandList& out);
+
+// Makes 'list' the recording target of the calling thread (nullptr stops).
+// Calls made with no target are dropped.
+void record_into(CommandList* list);
+CommandList* recording();
+
+// Everything the calling thread has recorded so far; never reset, so
+// callers take differences (see prof::CpuScope).
+Counters thread_counters();
+
+// Totals of the lists submit()ted between the last two present() calls.
+Counters frame_counters();
+
+// RENDERERS
+// What turns command lists into pixels, picked once at startup. The GL 3.3
+// renderer needs a core profile context (see main()); everything else in
+// the simulator only talks to the functions below, never to GL directly.
+enum Renderer {
+	RENDERER_LEGACY,   // GL 1.x fixed function, immediate mode
+	RENDERER_GL3,      // GL 3.3 core: batched VBOs, GLSL, uniform buffers
+	RENDERER_SOFTWARE, // CPU tile rasterizer, GL only to show the result
+};
+
+bool parse_renderer(const char* name, Renderer& out);
+const char* renderer_name(Renderer renderer);
+void set_renderer(Renderer renderer);
+Renderer renderer();
+
+// Resolves GL entry points above 1.1 (e.g. glutGetProcAddress).
+typedef void* (*ProcLoader)(const char* name);
+
+// Call with the context current, before any of the calls below (the
+// software renderer, not windowed, needs none). False if the selected
+// renderer can't run on this context. 'workers' sizes the
+// software renderer's tile pool (0: core count).
+bool init_renderer(ProcLoader loader, unsigned int workers = 0);
+
+// Viewport and 3D projection (as gluPerspective) for a w x h window.
+void resize(int w, int h, float fovY, float zNear, float zFar);
+
+// The scene's single light, fixed to the camera (eye space position) and
+// colouring surfaces by their vertex colour (GL_COLOR_MATERIAL).
+void set_light(const float position[4], const float diffuse[4]);
+
+// Fills texture name 'texture' with a mipmapped RGB image.
+void upload_texture(unsigned int texture, int w, int h, const unsigned char* rgb);
+
+// Bytes the uploaded textures take, mip chains included, at 4 bytes a
+// texel (what drivers store RGB8 as). An estimate of resident memory.
+size_t texture_bytes();
+
+// Clears colour and depth for a new frame.
+void clear();
+
+// Replays a list on the current GL context.
+void submit(const CommandList& list);
+
+// Puts the finished frame on the window, before the buffer swap.
+void present();
+
+// Whether there is a window to present to (the default). Without one, as
+// with --headless, the software renderer makes no GL calls at all: its
+// frames end in its CPU framebuffer (soft::framebuffer()), and it runs
+// without a GL context.
+void set_windowed(bool windowed);
+bool windowed();
+
+// RENDER TARGETS
+// Drawing into a texture instead of the window, for content that changes
+// far less often than it is shown: draw it once, then bind the texture.
+// The GL 3.3 and software renderers have them; the legacy GL 1.x one
+// doesn't, so callers draw directly there.
+bool has_render_targets();
+
+// A texture name nothing else uses, as glGenTextures. Texture names come
+// from here, not from GL, so the software renderer can do without one.
+GLuint create_texture();
+
+// Replays 'list' into 'texture', sized w x h and cleared to transparent
+// first. The list starts from a fresh context's state (identity matrices,
+// nothing enabled) with a w x h viewport, and binds no textures of its own.
+// Alpha accumulates coverage, as glBlendFuncSeparate(..., GL_ONE,
+// GL_ONE_MINUS_SRC_ALPHA) would, so the texels end up premultiplied: draw
+// them with blend_func(GL_ONE, GL_ONE_MINUS_SRC_ALPHA). GL thread.
+void render_to_texture(GLuint texture, int w, int h, const CommandList& list);
+
+// OVERLAY DRAWING
+// 2D geometry built on the CPU and drawn in one call, bypassing command
+// lists (and the submission counters): for overlays that would otherwise
+// cost a draw per glyph. Positions are window pixels, origin bottom left;
+// texture coordinates index the font atlas (font_atlas.h), whose
+// FONT_SOLID_CELL gives plain fills.
+struct OverlayVertex {
+	float x, y;
+	float u, v;
+	unsigned char rgba[4];
+};
+
+// Draws 'count' vertices as triangles, alpha blended over the frame with
+// no depth test. GL thread, between clear() and present().
+void draw_overlay(const OverlayVertex* vertices, size_t count);
+
+// Maps a GLUT bitmap font handle to its Font id and back.
+Font font_id(void* glutFont);
+void* glut_font(unsigned int font);
+
+// Recording calls
+void begin(GLenum mode);
+void end();
+void vertex2f(float x, float y);
+void vertex3f(float x, float y, float z);
+void vertex3fv(const float* v);
+void tex_coord2f(float s, float t);
+void tex_coord2i(int s, int t);
+void color3f(float r, float g, float b);
+void color3fv(const float* c);
+void color3b(signed char r, signed char g, signed char b);
+void color4f(float r, float g, float b, float a);
+
+void push_matrix();
+void pop_matrix();
+void translatef(float x, float y, float z);
+void rotatef(float angle, float x, float y, float z);
+void scalef(float x, float y, float z);
+void matrix_mode(GLenum mode);
+void load_identity();
+void ortho2d(float left, float right, float bottom, float top);
+// Camera with +Y up, as gluLookAt(eye, center, 0, 1, 0).
+void look_at(float eyeX, float eyeY, float eyeZ, float centerX, float centerY, float centerZ);
+
+void enable(GLenum cap);
+void disable(GLenum cap);
+void bind_texture(GLuint texture);
+void blend_func(GLenum src, GLenum dst);
+void line_width(float width);
+void point_size(float size);
+
+void raster_pos2f(float x, float y);
+void raster_pos3f(float x, float y, float z);
+void bitmap_string(void* glutFont, const char* text);
+void bitmap_string(void* glutFont, const char* text, size_t length);
+
+} // namespace gfx
@@ -0,0 +1,370 @@
+#include "gfx_gl3.h"
+
+#include "alloc_track.h"
+#include "font_atlas.h"
+#include "gfx_replay.h"
+
+#ifdef __APPLE__
+#include <OpenGL/gl3.h>
+#else
+#include <GL/glext.h>
+#endif
+
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+namespace gfx {
+namespace gl3 {
+
+namespace {
+
+// Entry points above GL 1.1, resolved in init(). Declared in this namespace
+// they hide the system prototypes, so the code below reads like plain GL.
+#ifndef __APPLE__
+#define GL3_FUNCTIONS(X) \
+	X(PFNGLACTIVETEXTUREPROC, glActiveTexture) \
+	X(PFNGLATTACHSHADERPROC, glAttachShader) \
+	X(PFNGLBINDBUFFERPROC, glBindBuffer) \
+	X(PFNGLBINDBUFFERBASEPROC, glBindBufferBase) \
+	X(PFNGLBINDBUFFERRANGEPROC, glBindBufferRange) \
+	X(PFNGLBINDFRAMEBUFFERPROC, glBindFramebuffer) \
+	X(PFNGLBINDVERTEXARRAYPROC, glBindVertexArray) \
+	X(PFNGLBLENDFUNCSEPARATEPROC, glBlendFuncSeparate) \
+	X(PFNGLBUFFERDATAPROC, glBufferData) \
+	X(PFNGLCHECKFRAMEBUFFERSTATUSPROC, glCheckFramebufferStatus) \
+	X(PFNGLCOMPILESHADERPROC, glCompileShader) \
+	X(PFNGLCREATEPROGRAMPROC, glCreateProgram) \
+	X(PFNGLCREATESHADERPROC, glCreateShader) \
+	X(PFNGLDELETESHADERPROC, glDeleteShader) \
+	X(PFNGLENABLEVERTEXATTRIBARRAYPROC, glEnableVertexAttribArray) \
+	X(PFNGLFRAMEBUFFERTEXTURE2DPROC, glFramebufferTexture2D) \
+	X(PFNGLGENBUFFERSPROC, glGenBuffers) \
+	X(PFNGLGENFRAMEBUFFERSPROC, glGenFramebuffers) \
+	X(PFNGLGENERATEMIPMAPPROC, glGenerateMipmap) \
+	X(PFNGLGENVERTEXARRAYSPROC, glGenVertexArrays) \
+	X(PFNGLGETPROGRAMINFOLOGPROC, glGetProgramInfoLog) \
+	X(PFNGLGETPROGRAMIVPROC, glGetProgramiv) \
+	X(PFNGLGETSHADERINFOLOGPROC, glGetShaderInfoLog) \
+	X(PFNGLGETSHADERIVPROC, glGetShaderiv) \
+	X(PFNGLGETUNIFORMBLOCKINDEXPROC, glGetUniformBlockIndex) \
+	X(PFNGLGETUNIFORMLOCATIONPROC, glGetUniformLocation) \
+	X(PFNGLLINKPROGRAMPROC, glLinkProgram) \
+	X(PFNGLSHADERSOURCEPROC, glShaderSource) \
+	X(PFNGLUNIFORM1IPROC, glUniform1i) \
+	X(PFNGLUNIFORMBLOCKBINDINGPROC, glUniformBlockBinding) \
+	X(PFNGLUSEPROGRAMPROC, glUseProgram) \
+	X(PFNGLVERTEXATTRIBPOINTERPROC, glVertexAttribPointer)
+
+#define GL3_DECLARE(type, name) static type name = nullptr;
+GL3_FUNCTIONS(GL3_DECLARE)
+#undef GL3_DECLARE
+#endif
+
+static bool load_functions(ProcLoader loader) {
+#ifdef __APPLE__
+	(void)loader;
+	return true;
+#else
+	bool ok = true;
+#define GL3_LOAD(type, name) \
+	name = (type)loader(#name); \
+	if (!name) { \
+		std::fprintf(stderr, "gl3: missing %s\n", #name); \
+		ok = false; \
+	}
+	GL3_FUNCTIONS(GL3_LOAD)
+#undef GL3_LOAD
+	return ok;
+#endif
+}
+
+// SHADERS
+// One source, compiled per program with LIGHTING / TEXTURE / TEXT defined.
+// Lighting reproduces the fixed-function setup of show_light_effect(): one
+// point light, GL_COLOR_MATERIAL (ambient & diffuse from the vertex colour),
+// the default 0.2 scene ambient, no specular, no GL_NORMALIZE.
+
+static const char* VERTEX_SHADER =
+	"layout(std140) uniform Camera { mat4 projection; };\n"
+	"layout(std140) uniform Light { vec4 lightPosition; vec4 lightDiffuse; vec4 sceneAmbient; };\n"
+	"layout(location = 0) in vec3 position;\n"
+	"layout(location = 1) in vec3 normal;\n"
+	"layout(location = 2) in vec4 color;\n"
+	"layout(location = 3) in vec2 uv;\n"
+	"out vec4 vColor;\n"
+	"out vec2 vUv;\n"
+	"void main() {\n"
+	"#ifdef LIGHTING\n"
+	"	vec3 toLight = normalize(lightPosition.xyz - position * lightPosition.w);\n"
+	"	float diffuse = max(dot(normal, toLight), 0.0);\n"
+	"	vColor = vec4(clamp(color.rgb * (sceneAmbient.rgb + lightDiffuse.rgb * diffuse), 0.0, 1.0), color.a);\n"
+	"#else\n"
+	"	vColor = color;\n"
+	"#endif\n"
+	"	vUv = uv;\n"
+	"	gl_Position = projection * vec4(position, 1.0);\n"
+	"}\n";
+
+static const char* FRAGMENT_SHADER =
+	"uniform sampler2D image;\n"
+	"in vec4 vColor;\n"
+	"in vec2 vUv;\n"
+	"out vec4 fragColor;\n"
+	"void main() {\n"
+	"#if defined(TEXT)\n"
+	"	if (texture(image, vUv).r < 0.5) discard;\n"
+	"	fragColor = vColor;\n"
+	"#elif defined(TEXTURE)\n"
+	"	fragColor = vColor * texture(image, vUv);\n"
+	"#else\n"
+	"	fragColor = vColor;\n"
+	"#endif\n"
+	"}\n";
+
+// By Shading (gfx_replay.h).
+static const char* PROGRAM_DEFINES[SHADE_COUNT] = {
+	"#define LIGHTING\n#define TEXTURE\n",
+	"#define LIGHTING\n",
+	"#define TEXTURE\n",
+	"",
+	"#define TEXT\n",
+};
+
+enum { CAMERA_BINDING = 0, LIGHT_BINDING = 1 };
+
+// GL objects
+static bool g_ready = false;
+static GLuint g_programs[SHADE_COUNT];
+static GLuint g_vao = 0, g_vbo = 0, g_cameraUbo = 0, g_lightUbo = 0, g_fontTexture = 0;
+static GLint g_uboAlign = 256;
+
+static Replay g_replay;
+static std::vector<unsigned char> g_cameraData;
+
+// render_to_texture()
+static Replay g_targetReplay;
+static GLuint g_targetFbo = 0;
+static bool g_offscreen = false; // Alpha accumulates coverage
+
+static GLuint compile(GLenum type, const char* defines, const char* source) {
+	const char* parts[3] = {"#version 330 core\n", defines, source};
+	GLuint shader = glCreateShader(type);
+	glShaderSource(shader, 3, parts, nullptr);
+	glCompileShader(shader);
+	GLint ok = 0;
+	glGetShaderiv(shader, GL_COMPILE_STATUS, &ok);
+	if (!ok) {
+		char log[1024];
+		glGetShaderInfoLog(shader, sizeof(log), nullptr, log);
+		std::fprintf(stderr, "gl3: shader: %s\n", log);
+	}
+	return shader;
+}
+
+static bool build_program(int index) {
+	GLuint vs = compile(GL_VERTEX_SHADER, PROGRAM_DEFINES[index], VERTEX_SHADER);
+	GLuint fs = compile(GL_FRAGMENT_SHADER, PROGRAM_DEFINES[index], FRAGMENT_SHADER);
+	GLuint program = glCreateProgram();
+	glAttachShader(program, vs);
+	glAttachShader(program, fs);
+	glLinkProgram(program);
+	glDeleteShader(vs);
+	glDeleteShader(fs);
+
+	GLint ok = 0;
+	glGetProgramiv(program, GL_LINK_STATUS, &ok);
+	if (!ok) {
+		char log[1024];
+		glGetProgramInfoLog(program, sizeof(log), nullptr, log);
+		std::fprintf(stderr, "gl3: program %d: %s\n", index, log);
+		return false;
+	}
+	GLuint block = glGetUniformBlockIndex(program, "Camera");
+	if (block != GL_INVALID_INDEX) glUniformBlockBinding(program, block, CAMERA_BINDING);
+	block = glGetUniformBlockIndex(program, "Light");
+	if (block != GL_INVALID_INDEX) glUniformBlockBinding(program, block, LIGHT_BINDING);
+	glUseProgram(program);
+	glUniform1i(glGetUniformLocation(program, "image"), 0);
+	g_programs[index] = program;
+	return true;
+}
+
+static void upload_light() {
+	if (!g_ready) return;
+	glBindBuffer(GL_UNIFORM_BUFFER, g_lightUbo);
+	glBufferData(GL_UNIFORM_BUFFER, sizeof(Light), &g_replay.light, GL_STATIC_DRAW);
+}
+
+// Uploads what 'replay' collected (vertices and camera slots), then draws
+// every batch.
+static void flush(Replay& replay) {
+	const std::vector<Batch>& batches = replay.batches;
+	const std::vector<mat4>& cameras = replay.cameras;
+	if (batches.empty()) return;
+
+	size_t slot = (sizeof(mat4) + g_uboAlign - 1) / g_uboAlign * g_uboAlign;
+	alloc::reserve_kept(g_cameraData, slot * cameras.size());
+	g_cameraData.resize(slot * cameras.size());
+	for (size_t i = 0; i < cameras.size(); i++) std::memcpy(&g_cameraData[i * slot], &cameras[i], sizeof(mat4));
+	glBindBuffer(GL_UNIFORM_BUFFER, g_cameraUbo);
+	glBufferData(GL_UNIFORM_BUFFER, g_cameraData.size(), g_cameraData.data(), GL_STREAM_DRAW);
+
+	glBindVertexArray(g_vao);
+	glBindBuffer(GL_ARRAY_BUFFER, g_vbo);
+	glBufferData(GL_ARRAY_BUFFER, replay.vertices.size() * sizeof(Vertex), replay.vertices.data(), GL_STREAM_DRAW);
+	glActiveTexture(GL_TEXTURE0);
+
+	// Drivers compile a variant of the program the first time it meets new
+	// state (llvmpipe does, through LLVM's operator new). Nothing below
+	// allocates otherwise.
+	alloc::AllowScope driver;
+	const DrawState* applied = nullptr;
+	for (size_t i = 0; i < batches.size(); i++) {
+		const DrawState& s = batches[i].state;
+		GLuint texture = s.shading == SHADE_TEXT ? g_fontTexture : s.texture;
+		if (!applied || applied->shading != s.shading) glUseProgram(g_programs[s.shading]);
+		if (!applied || applied->texture != s.texture || applied->shading != s.shading) {
+			glBindTexture(GL_TEXTURE_2D, texture);
+		}
+		if (!applied || applied->blend != s.blend) {
+			if (s.blend) glEnable(GL_BLEND);
+			else glDisable(GL_BLEND);
+		}
+		if (!applied || applied->blendSrc != s.blendSrc || applied->blendDst != s.blendDst) {
+			if (g_offscreen) glBlendFuncSeparate(s.blendSrc, s.blendDst, GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+			else glBlendFunc(s.blendSrc, s.blendDst);
+		}
+		if (!applied || applied->depth != s.depth) {
+			if (s.depth) glEnable(GL_DEPTH_TEST);
+			else glDisable(GL_DEPTH_TEST);
+		}
+		if (!applied || applied->lineWidth != s.lineWidth) glLineWidth(s.lineWidth);
+		if (!applied || applied->pointSize != s.pointSize) glPointSize(s.pointSize);
+		if (!applied || applied->camera != s.camera) {
+			glBindBufferRange(GL_UNIFORM_BUFFER, CAMERA_BINDING, g_cameraUbo, s.camera * slot, sizeof(mat4));
+		}
+		glDrawArrays(s.mode, batches[i].first, batches[i].count);
+		applied = &s;
+	}
+
+	replay.clear_output();
+}
+
+} // namespace
+
+bool init(ProcLoader loader) {
+	if (!load_functions(loader)) return false;
+	const char* version = (const char*)glGetString(GL_VERSION);
+	std::printf("gl3: %s\n", version ? version : "(no context)");
+
+	for (int i = 0; i < SHADE_COUNT; i++) {
+		if (!build_program(i)) return false;
+	}
+	glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &g_uboAlign);
+	if (g_uboAlign <= 0) g_uboAlign = 256;
+
+	glGenVertexArrays(1, &g_vao);
+	glGenBuffers(1, &g_vbo);
+	glGenBuffers(1, &g_cameraUbo);
+	glGenBuffers(1, &g_lightUbo);
+	glBindVertexArray(g_vao);
+	glBindBuffer(GL_ARRAY_BUFFER, g_vbo);
+	glEnableVertexAttribArray(0);
+	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, position));
+	glEnableVertexAttribArray(1);
+	glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, normal));
+	glEnableVertexAttribArray(2);
+	glVertexAttribPointer(2, 4, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, color));
+	glEnableVertexAttribArray(3);
+	glVertexAttribPointer(3, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, uv));
+
+	std::vector<unsigned char> atlas(FONT_ATLAS_WIDTH * FONT_ATLAS_HEIGHT);
+	build_font_atlas(atlas.data());
+	glGenTextures(1, &g_fontTexture);
+	glBindTexture(GL_TEXTURE_2D, g_fontTexture);
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_R8, FONT_ATLAS_WIDTH, FONT_ATLAS_HEIGHT, 0, GL_RED, GL_UNSIGNED_BYTE, atlas.data());
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+	g_replay.set_depth_test(glIsEnabled(GL_DEPTH_TEST) == GL_TRUE);
+	g_ready = true;
+	upload_light();
+	glBindBufferBase(GL_UNIFORM_BUFFER, LIGHT_BINDING, g_lightUbo);
+	return true;
+}
+
+void resize(int w, int h, float fovY, float zNear, float zFar) {
+	glViewport(0, 0, w, h);
+	g_replay.resize(w, h, fovY, zNear, zFar);
+}
+
+void set_light(const float position[4], const float diffuse[4]) {
+	g_replay.set_light(position, diffuse);
+	upload_light();
+}
+
+void upload_texture(unsigned int texture, int w, int h, const unsigned char* rgb) {
+	glBindTexture(GL_TEXTURE_2D, texture);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_NEAREST);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB8, w, h, 0, GL_RGB, GL_UNSIGNED_BYTE, rgb);
+	glGenerateMipmap(GL_TEXTURE_2D);
+	g_replay.set_texture_loaded(texture, w > 0 && h > 0);
+}
+
+void submit(const CommandList& list) {
+	g_replay.replay(list);
+	flush(g_replay);
+}
+
+void draw_overlay(const OverlayVertex* vertices, size_t count) {
+	g_replay.overlay(vertices, count);
+	flush(g_replay);
+}
+
+void render_to_texture(unsigned int texture, int w, int h, const CommandList& list) {
+	glBindTexture(GL_TEXTURE_2D, texture);
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, w, h, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+	g_replay.set_texture_loaded(texture, true);
+
+	// Headless runs draw the window into an FBO of their own: go back to it
+	GLint window = 0;
+	GLfloat clearColor[4];
+	glGetIntegerv(GL_FRAMEBUFFER_BINDING, &window);
+	glGetFloatv(GL_COLOR_CLEAR_VALUE, clearColor);
+	if (!g_targetFbo) glGenFramebuffers(1, &g_targetFbo);
+	glBindFramebuffer(GL_FRAMEBUFFER, g_targetFbo);
+	glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, texture, 0);
+	if (glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE) {
+		glViewport(0, 0, w, h);
+		glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+		glClear(GL_COLOR_BUFFER_BIT);
+		g_targetReplay.reset_state();
+		g_targetReplay.set_viewport(w, h);
+		g_targetReplay.replay(list);
+		g_offscreen = true;
+		flush(g_targetReplay);
+		g_offscreen = false;
+	}
+	glBindFramebuffer(GL_FRAMEBUFFER, (GLuint)window);
+	const int* vp = g_replay.viewport();
+	glViewport(vp[0], vp[1], vp[2], vp[3]);
+	glClearColor(clearColor[0], clearColor[1], clearColor[2], clearColor[3]);
+	// flush() leaves blending and depth as the target's last batch had them;
+	// the next one of the window sets them all again.
+}
+
+} // namespace gl3
+} // namespace gfx
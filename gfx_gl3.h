@@ -0,0 +1,23 @@
+#pragma once
+
+#include "gfx.h"
+
+namespace gfx {
+namespace gl3 {
+
+// GL 3.3 core renderer. Command lists are replayed on the CPU (see
+// gfx_replay.h) and each resulting batch becomes one draw call from a
+// single streamed vertex buffer. Camera and light data live in uniform
+// buffers shared by all programs.
+// Used through the renderer-neutral calls in gfx.h.
+
+bool init(ProcLoader loader);
+void resize(int w, int h, float fovY, float zNear, float zFar);
+void set_light(const float position[4], const float diffuse[4]);
+void upload_texture(unsigned int texture, int w, int h, const unsigned char* rgb);
+void submit(const CommandList& list);
+void draw_overlay(const OverlayVertex* vertices, size_t count);
+void render_to_texture(unsigned int texture, int w, int h, const CommandList& list);
+
+} // namespace gl3
+} // namespace gfx
@@ -0,0 +1,339 @@
+#include "gfx_replay.h"
+
+#include "alloc_track.h"
+#include "font_atlas.h"
+
+#include <cmath>
+#include <cstring>
+
+namespace gfx {
+
+void light_color(const Light& light, const float eye[3], const float normal[3], const float color[4], float out[4]) {
+	float l[3];
+	for (int i = 0; i < 3; i++) l[i] = light.position[i] - eye[i] * light.position[3];
+	float len = std::sqrt(l[0] * l[0] + l[1] * l[1] + l[2] * l[2]);
+	float d = len > 0.0f ? (normal[0] * l[0] + normal[1] * l[1] + normal[2] * l[2]) / len : 0.0f;
+	if (d < 0.0f) d = 0.0f;
+	for (int i = 0; i < 3; i++) {
+		float c = color[i] * (light.ambient[i] + light.diffuse[i] * d);
+		out[i] = c < 0.0f ? 0.0f : (c > 1.0f ? 1.0f : c);
+	}
+	out[3] = color[3];
+}
+
+void Replay::clear_output() {
+	vertices.clear();
+	batches.clear();
+	cameras.clear();
+}
+
+void Replay::resize(int w, int h, float fovY, float zNear, float zFar) {
+	h = h == 0 ? 1 : h;
+	set_viewport(w, h);
+	projection.back() = mat4_perspective(fovY, (float)w / (float)h, zNear, zFar);
+	matrixMode = GL_MODELVIEW;
+}
+
+void Replay::set_viewport(int w, int h) {
+	viewportBox[0] = 0;
+	viewportBox[1] = 0;
+	viewportBox[2] = w;
+	viewportBox[3] = h;
+}
+
+void Replay::reset_state() {
+	modelview.resize(1);
+	modelview[0] = mat4_identity();
+	projection.resize(1);
+	projection[0] = mat4_identity();
+	matrixMode = GL_MODELVIEW;
+	for (int i = 0; i < 4; i++) color[i] = 1.0f;
+	uv[0] = uv[1] = 0.0f;
+	texture2d = lighting = blend = depth = false;
+	texture = 0;
+	blendSrc = GL_ONE;
+	blendDst = GL_ZERO;
+	lineWidth = pointSize = 1.0f;
+	rasterValid = false;
+}
+
+void Replay::set_light(const float position[4], const float diffuse[4]) {
+	lighting = true;
+	// Like glLightfv, the position is taken through the current modelview.
+	mat4_transform(modelview.back(), position, light.position);
+	std::memcpy(light.diffuse, diffuse, sizeof(light.diffuse));
+}
+
+void Replay::set_texture_loaded(GLuint tex, bool isLoaded) {
+	if (tex >= loaded.size()) loaded.resize(tex + 1, false);
+	loaded[tex] = isLoaded;
+}
+
+// Slot of 'm' in this frame's cameras.
+int Replay::camera_slot(const mat4& m) {
+	for (size_t i = cameras.size(); i-- > 0;) {
+		if (std::memcmp(&cameras[i], &m, sizeof(mat4)) == 0) return (int)i;
+	}
+	alloc::push_kept(cameras, m);
+	return (int)cameras.size() - 1;
+}
+
+int Replay::current_shading() const {
+	bool textured = texture2d && texture < loaded.size() && loaded[texture];
+	if (lighting) return textured ? SHADE_LIT_TEXTURED : SHADE_LIT_COLORED;
+	return textured ? SHADE_UNLIT_TEXTURED : SHADE_UNLIT;
+}
+
+DrawState Replay::current_state(GLenum mode, int shading, GLuint tex, int camera) const {
+	DrawState s;
+	s.mode = mode;
+	s.shading = shading;
+	s.texture = tex;
+	s.blend = blend;
+	s.blendSrc = blendSrc;
+	s.blendDst = blendDst;
+	s.depth = depth;
+	s.lineWidth = mode == GL_LINES ? lineWidth : 1.0f;
+	s.pointSize = mode == GL_POINTS ? pointSize : 1.0f;
+	s.camera = camera;
+	return s;
+}
+
+// Appends 'count' vertices (already in 'vertices') to a batch with 'state'.
+void Replay::add_to_batch(const DrawState& state, size_t first, size_t count) {
+	if (count == 0) return;
+	if (!batches.empty()) {
+		Batch& last = batches.back();
+		if (last.state == state && (size_t)(last.first + last.count) == first) {
+			last.count += (GLsizei)count;
+			return;
+		}
+	}
+	Batch b = {state, (GLint)first, (GLsizei)count};
+	batches.push_back(b);
+}
+
+// Splits the primitive collected between begin() and end() into plain
+// triangles, lines or points.
+void Replay::emit_primitive() {
+	const std::vector<Vertex>& v = prim;
+	size_t n = v.size();
+	size_t first = vertices.size();
+	GLenum mode = GL_TRIANGLES;
+
+	switch (primitive) {
+	case GL_POINTS:
+		mode = GL_POINTS;
+		vertices.insert(vertices.end(), v.begin(), v.end());
+		break;
+	case GL_LINES:
+		mode = GL_LINES;
+		vertices.insert(vertices.end(), v.begin(), v.begin() + n / 2 * 2);
+		break;
+	case GL_LINE_STRIP:
+	case GL_LINE_LOOP:
+		mode = GL_LINES;
+		for (size_t i = 1; i < n; i++) {
+			vertices.push_back(v[i - 1]);
+			vertices.push_back(v[i]);
+		}
+		if (primitive == GL_LINE_LOOP && n > 2) {
+			vertices.push_back(v[n - 1]);
+			vertices.push_back(v[0]);
+		}
+		break;
+	case GL_TRIANGLES:
+		vertices.insert(vertices.end(), v.begin(), v.begin() + n / 3 * 3);
+		break;
+	case GL_TRIANGLE_STRIP:
+		for (size_t i = 2; i < n; i++) {
+			vertices.push_back(v[i - 2]);
+			vertices.push_back(v[i - 1]);
+			vertices.push_back(v[i]);
+		}
+		break;
+	case GL_QUADS:
+		for (size_t i = 0; i + 3 < n; i += 4) {
+			const Vertex quad[6] = {v[i], v[i + 1], v[i + 2], v[i], v[i + 2], v[i + 3]};
+			vertices.insert(vertices.end(), quad, quad + 6);
+		}
+		break;
+	case GL_QUAD_STRIP:
+		for (size_t i = 0; i + 3 < n; i += 2) {
+			const Vertex quad[6] = {v[i], v[i + 1], v[i + 3], v[i], v[i + 3], v[i + 2]};
+			vertices.insert(vertices.end(), quad, quad + 6);
+		}
+		break;
+	default: // GL_POLYGON, GL_TRIANGLE_FAN: convex, fan from the first vertex
+		for (size_t i = 2; i < n; i++) {
+			vertices.push_back(v[0]);
+			vertices.push_back(v[i - 1]);
+			vertices.push_back(v[i]);
+		}
+		break;
+	}
+
+	int shading = current_shading();
+	GLuint tex = (shading == SHADE_LIT_TEXTURED || shading == SHADE_UNLIT_TEXTURED) ? texture : 0;
+	add_to_batch(current_state(mode, shading, tex, camera_slot(projection.back())), first, vertices.size() - first);
+}
+
+void Replay::raster_pos(const float p[4]) {
+	float eye[4], clip[4];
+	mat4_transform(modelview.back(), p, eye);
+	mat4_transform(projection.back(), eye, clip);
+	float w = clip[3];
+	rasterValid = w > 0.0f && clip[0] >= -w && clip[0] <= w && clip[1] >= -w && clip[1] <= w && clip[2] >= -w &&
+	              clip[2] <= w;
+	if (!rasterValid) return;
+	raster[0] = viewportBox[0] + (clip[0] / w + 1.0f) * 0.5f * viewportBox[2];
+	raster[1] = viewportBox[1] + (clip[1] / w + 1.0f) * 0.5f * viewportBox[3];
+	raster[2] = (clip[2] / w + 1.0f) * 0.5f;
+	if (lighting) {
+		float normal[3];
+		mat4_default_normal(modelview.back(), normal);
+		light_color(light, eye, normal, color, rasterColor);
+	} else {
+		std::memcpy(rasterColor, color, sizeof(rasterColor));
+	}
+}
+
+// glutBitmapCharacter replacement: one textured quad per character, in
+// window pixels, advancing by the GLUT font's widths so layouts match.
+void Replay::text(unsigned int font, const char* str) {
+	if (!rasterValid) return;
+	float scale = font == FONT_HELVETICA_18 ? 2.0f : (font == FONT_HELVETICA_12 ? 1.5f : 1.25f);
+	float size = FONT_CELL * scale;
+	float z = 1.0f - 2.0f * raster[2]; // Eye z under the pixel ortho below
+	mat4 pixels = mat4_ortho((float)viewportBox[0], (float)(viewportBox[0] + viewportBox[2]), (float)viewportBox[1],
+	                         (float)(viewportBox[1] + viewportBox[3]), -1.0f, 1.0f);
+
+	size_t first = vertices.size();
+	for (const char* ch = str; *ch; ch++) {
+		int cx, cy;
+		font_atlas_cell((unsigned char)*ch, cx, cy);
+		float x0 = raster[0], y0 = raster[1] - scale; // Bottom row is the descender
+		float u0 = (float)cx / FONT_ATLAS_WIDTH, u1 = (float)(cx + FONT_CELL) / FONT_ATLAS_WIDTH;
+		float vTop = (float)cy / FONT_ATLAS_HEIGHT, vBottom = (float)(cy + FONT_CELL) / FONT_ATLAS_HEIGHT;
+		const float corners[4][4] = {
+			{x0, y0, u0, vBottom}, {x0 + size, y0, u1, vBottom}, {x0 + size, y0 + size, u1, vTop}, {x0, y0 + size, u0, vTop}};
+		const int order[6] = {0, 1, 2, 0, 2, 3};
+		for (int i = 0; i < 6; i++) {
+			Vertex vert;
+			const float* c = corners[order[i]];
+			vert.position[0] = c[0];
+			vert.position[1] = c[1];
+			vert.position[2] = z;
+			vert.normal[0] = vert.normal[1] = 0.0f;
+			vert.normal[2] = 1.0f;
+			std::memcpy(vert.color, rasterColor, sizeof(vert.color));
+			vert.uv[0] = c[2];
+			vert.uv[1] = c[3];
+			vertices.push_back(vert);
+		}
+		raster[0] += (float)font_advance(font, (unsigned char)*ch);
+	}
+	add_to_batch(current_state(GL_TRIANGLES, SHADE_TEXT, 0, camera_slot(pixels)), first, vertices.size() - first);
+}
+
+void Replay::overlay(const OverlayVertex* v, size_t count) {
+	mat4 pixels = mat4_ortho((float)viewportBox[0], (float)(viewportBox[0] + viewportBox[2]), (float)viewportBox[1],
+	                         (float)(viewportBox[1] + viewportBox[3]), -1.0f, 1.0f);
+	DrawState state = current_state(GL_TRIANGLES, SHADE_TEXT, 0, camera_slot(pixels));
+	state.blend = true;
+	state.blendSrc = GL_SRC_ALPHA;
+	state.blendDst = GL_ONE_MINUS_SRC_ALPHA;
+	state.depth = false;
+
+	size_t first = vertices.size();
+	vertices.resize(first + count);
+	for (size_t i = 0; i < count; i++) {
+		Vertex& vert = vertices[first + i];
+		vert.position[0] = v[i].x;
+		vert.position[1] = v[i].y;
+		vert.position[2] = 0.0f;
+		vert.normal[0] = vert.normal[1] = 0.0f;
+		vert.normal[2] = 1.0f;
+		for (int c = 0; c < 4; c++) vert.color[c] = v[i].rgba[c] / 255.0f;
+		vert.uv[0] = v[i].u;
+		vert.uv[1] = v[i].v;
+	}
+	add_to_batch(state, first, count);
+}
+
+void Replay::set_cap(GLenum cap, bool on) {
+	switch (cap) {
+	case GL_TEXTURE_2D: texture2d = on; break;
+	case GL_LIGHTING: lighting = on; break;
+	case GL_BLEND: blend = on; break;
+	case GL_DEPTH_TEST: depth = on; break;
+	default: break; // Nothing else the simulator toggles matters here
+	}
+}
+
+void Replay::replay(const CommandList& list) {
+	const Command* cmds = list.cmds.data();
+	const char* strings = list.text.data();
+	for (size_t i = 0, n = list.cmds.size(); i < n; i++) {
+		const Command& c = cmds[i];
+		switch (c.op) {
+		case OP_BEGIN:
+			primitive = c.u;
+			prim.clear();
+			mat4_default_normal(modelview.back(), primNormal);
+			break;
+		case OP_END:
+			emit_primitive();
+			break;
+		case OP_VERTEX: {
+			float eye[4];
+			mat4_transform(modelview.back(), c.f, eye);
+			Vertex v;
+			v.position[0] = eye[0];
+			v.position[1] = eye[1];
+			v.position[2] = eye[2];
+			std::memcpy(v.normal, primNormal, sizeof(v.normal));
+			std::memcpy(v.color, color, sizeof(v.color));
+			std::memcpy(v.uv, uv, sizeof(v.uv));
+			prim.push_back(v);
+			break;
+		}
+		case OP_TEX_COORD:
+			uv[0] = c.f[0];
+			uv[1] = c.f[1];
+			break;
+		case OP_COLOR: std::memcpy(color, c.f, sizeof(color)); break;
+		case OP_PUSH_MATRIX:
+			if (matrixMode == GL_PROJECTION) projection.push_back(projection.back());
+			else modelview.push_back(modelview.back());
+			break;
+		case OP_POP_MATRIX:
+			if (matrixMode == GL_PROJECTION) {
+				if (projection.size() > 1) projection.pop_back();
+			} else if (modelview.size() > 1) {
+				modelview.pop_back();
+			}
+			break;
+		case OP_TRANSLATE: top() = top() * mat4_translate(c.f[0], c.f[1], c.f[2]); break;
+		case OP_ROTATE: top() = top() * mat4_rotate(c.f[0], c.f[1], c.f[2], c.f[3]); break;
+		case OP_SCALE: top() = top() * mat4_scale(c.f[0], c.f[1], c.f[2]); break;
+		case OP_MATRIX_MODE: matrixMode = c.u; break;
+		case OP_LOAD_IDENTITY: top() = mat4_identity(); break;
+		case OP_ORTHO_2D: top() = top() * mat4_ortho(c.f[0], c.f[1], c.f[2], c.f[3], -1.0f, 1.0f); break;
+		case OP_LOOK_AT: top() = top() * mat4_look_at(c.f[0], c.f[1], c.f[2], c.f[3], c.f[4], c.f[5]); break;
+		case OP_ENABLE: set_cap(c.u, true); break;
+		case OP_DISABLE: set_cap(c.u, false); break;
+		case OP_BIND_TEXTURE: texture = c.u; break;
+		case OP_BLEND_FUNC:
+			blendSrc = c.u;
+			blendDst = c.n;
+			break;
+		case OP_LINE_WIDTH: lineWidth = c.f[0]; break;
+		case OP_POINT_SIZE: pointSize = c.f[0]; break;
+		case OP_RASTER_POS: raster_pos(c.f); break;
+		case OP_TEXT: text(c.u, strings + c.n); break;
+		}
+	}
+}
+
+} // namespace gfx
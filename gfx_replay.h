@@ -0,0 +1,131 @@
+#pragma once
+
+#include "gfx.h"
+#include "matrix.h"
+
+#include <vector>
+
+namespace gfx {
+
+// CPU replay shared by the renderers that don't run on fixed-function GL
+// (gl3, software). A command list is walked with GL 1.x semantics: vertices
+// are transformed to eye space as they come in, primitives are turned into
+// triangles / lines / points, and runs with the same state are merged into
+// batches. What a backend does with the batches is up to it.
+
+// How a batch is shaded; the GL 3.3 renderer has one program per value.
+enum Shading {
+	SHADE_LIT_TEXTURED,
+	SHADE_LIT_COLORED,
+	SHADE_UNLIT_TEXTURED,
+	SHADE_UNLIT, // Overlays: HUD, tooltips, front page
+	SHADE_TEXT,  // Glyphs from the font atlas (font_atlas.h), texture 0
+	SHADE_COUNT,
+};
+
+struct Vertex {
+	float position[3]; // Eye space
+	float normal[3];   // Eye space
+	float color[4];
+	float uv[2];
+};
+
+// One point light, GL_COLOR_MATERIAL (ambient & diffuse from the vertex
+// colour), the default 0.2 scene ambient, no specular: the setup of
+// show_light_effect(). Laid out as the GL 3.3 renderer's std140 block.
+struct Light {
+	float position[4]; // Eye space
+	float diffuse[4];
+	float ambient[4];
+};
+
+// Everything drawing a batch depends on. Consecutive primitives with equal
+// state share a batch.
+struct DrawState {
+	GLenum mode; // GL_TRIANGLES, GL_LINES or GL_POINTS
+	int shading;
+	GLuint texture;
+	bool blend;
+	GLenum blendSrc, blendDst;
+	bool depth;
+	float lineWidth, pointSize;
+	int camera; // Projection, index into Replay::cameras
+
+	bool operator==(const DrawState& o) const {
+		return mode == o.mode && shading == o.shading && texture == o.texture && blend == o.blend &&
+		       blendSrc == o.blendSrc && blendDst == o.blendDst && depth == o.depth && lineWidth == o.lineWidth &&
+		       pointSize == o.pointSize && camera == o.camera;
+	}
+};
+
+struct Batch {
+	DrawState state;
+	GLint first; // Into Replay::vertices
+	GLsizei count;
+};
+
+// Colour GL 1.x lighting gives a vertex at eye position 'eye'.
+void light_color(const Light& light, const float eye[3], const float normal[3], const float color[4], float out[4]);
+
+class Replay {
+public:
+	// Output of replay(), collected until clear_output().
+	std::vector<Vertex> vertices;
+	std::vector<Batch> batches;
+	std::vector<mat4> cameras;
+
+	Light light = {{0, 0, 1, 0}, {1, 1, 1, 1}, {0.2f, 0.2f, 0.2f, 1}};
+
+	void replay(const CommandList& list);
+	// gfx::draw_overlay(): one SHADE_TEXT batch in window pixels. Leaves
+	// the replayed GL state alone.
+	void overlay(const OverlayVertex* v, size_t count);
+	void clear_output();
+
+	void resize(int w, int h, float fovY, float zNear, float zFar);
+	void set_viewport(int w, int h);
+	// Back to a fresh context's state: identity matrices, nothing enabled,
+	// white. Keeps the light, viewport and texture flags (and the memory).
+	void reset_state();
+	void set_light(const float position[4], const float diffuse[4]);
+	void set_depth_test(bool on) { depth = on; }
+	// GL 1.x skips texturing when the bound texture has no image (e.g. a
+	// bitmap that failed to load); backends report which ones do.
+	void set_texture_loaded(GLuint texture, bool loaded);
+
+	const int* viewport() const { return viewportBox; }
+
+private:
+	// Like GL's own, this state carries over from one replay to the next.
+	std::vector<mat4> modelview = std::vector<mat4>(1, mat4_identity());
+	std::vector<mat4> projection = std::vector<mat4>(1, mat4_identity());
+	GLenum matrixMode = GL_MODELVIEW;
+	float color[4] = {1.0f, 1.0f, 1.0f, 1.0f};
+	float uv[2] = {0.0f, 0.0f};
+	bool texture2d = false, lighting = false, blend = false, depth = false;
+	GLuint texture = 0;
+	std::vector<bool> loaded; // By texture name
+	GLenum blendSrc = GL_ONE, blendDst = GL_ZERO;
+	float lineWidth = 1.0f, pointSize = 1.0f;
+	int viewportBox[4] = {0, 0, 1, 1};
+
+	bool rasterValid = false;
+	float raster[3]; // Window x, y and depth
+	float rasterColor[4];
+
+	GLenum primitive = 0;
+	float primNormal[3];
+	std::vector<Vertex> prim;
+
+	mat4& top() { return matrixMode == GL_PROJECTION ? projection.back() : modelview.back(); }
+	int camera_slot(const mat4& m);
+	int current_shading() const;
+	DrawState current_state(GLenum mode, int shading, GLuint tex, int camera) const;
+	void add_to_batch(const DrawState& state, size_t first, size_t count);
+	void emit_primitive();
+	void raster_pos(const float p[4]);
+	void text(unsigned int font, const char* str);
+	void set_cap(GLenum cap, bool on);
+};
+
+} // namespace gfx
@@ -0,0 +1,609 @@
+#include "gfx_soft.h"
+
+#include "alloc_track.h"
+#include "font_atlas.h"
+#include "gfx_replay.h"
+#include "jobs.h"
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define SOFT_SSE2 1
+#endif
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <memory>
+
+namespace gfx {
+namespace soft {
+
+namespace {
+
+const int TILE_SIZE = 64;
+const float GUARD_BAND = 8.0f; // Clip x / y at this many viewports wide
+
+// Attributes interpolated across a primitive: colour, then texture uv.
+enum { ATTR_R, ATTR_G, ATTR_B, ATTR_A, ATTR_U, ATTR_V, ATTR_COUNT };
+
+struct MipLevel {
+	int w, h;
+	std::vector<unsigned int> texels; // RGBA8 as Framebuffer::color
+};
+
+struct Texture {
+	std::vector<MipLevel> levels; // Empty: no image, as GL leaves it
+};
+
+// Vertex after lighting and projection, before clipping.
+struct ClipVertex {
+	float pos[4];
+	float attr[ATTR_COUNT];
+};
+
+// Vertex in window coordinates. 'q' is 1/w and the attributes are
+// premultiplied by it, so they interpolate linearly across the screen.
+struct ScreenVertex {
+	float x, y, z, q;
+	float attr[ATTR_COUNT];
+};
+
+// f(x, y) = a * x + b * y + c over the window
+struct Plane {
+	float a, b, c;
+	float at(float x, float y) const { return a * x + b * y + c; }
+};
+
+// A set-up triangle: three edge functions, positive inside, and planes for
+// everything interpolated.
+struct Triangle {
+	Plane edge[3];
+	bool inclusive[3]; // Top-left rule: pixels exactly on the edge belong to it
+	Plane z, q, attr[ATTR_COUNT];
+	int x0, y0, x1, y1; // Pixel bounds, end exclusive
+	int style;          // Index into g_styles
+};
+
+// A batch's state, resolved for the rasterizer.
+struct Style {
+	DrawState state;
+	const Texture* texture; // Null: untextured
+};
+
+static Replay g_replay;
+static std::unique_ptr<jobs::Pool> g_pool;
+static Framebuffer g_fb;
+static std::vector<Texture> g_textures; // By texture name
+static Texture g_font;
+
+// Frame being rasterized
+static std::vector<Style> g_styles;
+static std::vector<Triangle> g_triangles;
+static std::vector<std::vector<unsigned int> > g_bins; // Triangles per tile, in submit order
+static int g_tilesX = 0, g_tilesY = 0;
+
+// render_to_texture(): swapped with g_replay / g_fb while a target draws
+static Replay g_targetReplay;
+static Framebuffer g_target;
+static bool g_offscreen = false; // Alpha accumulates coverage
+
+static unsigned int pack(const float c[4]) {
+	unsigned int out = 0;
+	for (int i = 0; i < 4; i++) {
+		float v = c[i] < 0.0f ? 0.0f : (c[i] > 1.0f ? 1.0f : c[i]);
+		out |= (unsigned int)(v * 255.0f + 0.5f) << (8 * i);
+	}
+	return out;
+}
+
+static void unpack(unsigned int rgba, float out[4]) {
+	for (int i = 0; i < 4; i++) out[i] = (float)(rgba >> (8 * i) & 0xff) * (1.0f / 255.0f);
+}
+
+// Halves 'from' in both directions with a box filter, as gluBuild2DMipmaps.
+static MipLevel downsample(const MipLevel& from) {
+	MipLevel to;
+	to.w = std::max(1, from.w / 2);
+	to.h = std::max(1, from.h / 2);
+	to.texels.resize((size_t)to.w * to.h);
+	for (int y = 0; y < to.h; y++) {
+		for (int x = 0; x < to.w; x++) {
+			int sx = std::min(x * 2 + 1, from.w - 1), sy = std::min(y * 2 + 1, from.h - 1);
+			const unsigned int texels[4] = {from.texels[(size_t)y * 2 * from.w + x * 2],
+			                                from.texels[(size_t)y * 2 * from.w + sx],
+			                                from.texels[(size_t)sy * from.w + x * 2],
+			                                from.texels[(size_t)sy * from.w + sx]};
+			unsigned int out = 0;
+			for (int c = 0; c < 4; c++) {
+				unsigned int sum = 2; // Round to nearest
+				for (int i = 0; i < 4; i++) sum += texels[i] >> (8 * c) & 0xff;
+				out |= (sum / 4) << (8 * c);
+			}
+			to.texels[(size_t)y * to.w + x] = out;
+		}
+	}
+	return to;
+}
+
+static unsigned int texel(const MipLevel& level, int x, int y) {
+	x %= level.w;
+	y %= level.h;
+	if (x < 0) x += level.w;
+	if (y < 0) y += level.h;
+	return level.texels[(size_t)y * level.w + x];
+}
+
+// GL_LINEAR within the level, GL_REPEAT at the borders.
+static void sample_linear(const MipLevel& level, float u, float v, float out[4]) {
+	float fx = u * level.w - 0.5f, fy = v * level.h - 0.5f;
+	float x0 = std::floor(fx), y0 = std::floor(fy);
+	float ax = fx - x0, ay = fy - y0;
+	int ix = (int)x0, iy = (int)y0;
+	float c00[4], c10[4], c01[4], c11[4];
+	unpack(texel(level, ix, iy), c00);
+	unpack(texel(level, ix + 1, iy), c10);
+	unpack(texel(level, ix, iy + 1), c01);
+	unpack(texel(level, ix + 1, iy + 1), c11);
+	for (int i = 0; i < 4; i++) {
+		float top = c00[i] + (c10[i] - c00[i]) * ax;
+		float bottom = c01[i] + (c11[i] - c01[i]) * ax;
+		out[i] = top + (bottom - top) * ay;
+	}
+}
+
+static float blend_factor(GLenum factor, const float src[4], const float dst[4], int channel) {
+	switch (factor) {
+	case GL_ZERO: return 0.0f;
+	case GL_ONE: return 1.0f;
+	case GL_SRC_COLOR: return src[channel];
+	case GL_ONE_MINUS_SRC_COLOR: return 1.0f - src[channel];
+	case GL_DST_COLOR: return dst[channel];
+	case GL_ONE_MINUS_DST_COLOR: return 1.0f - dst[channel];
+	case GL_SRC_ALPHA: return src[3];
+	case GL_ONE_MINUS_SRC_ALPHA: return 1.0f - src[3];
+	case GL_DST_ALPHA: return dst[3];
+	case GL_ONE_MINUS_DST_ALPHA: return 1.0f - dst[3];
+	default: return 1.0f;
+	}
+}
+
+// VERTEX STAGE
+
+static void project(const Vertex& v, const mat4& projection, bool lit, ClipVertex& out) {
+	const float eye[4] = {v.position[0], v.position[1], v.position[2], 1.0f};
+	mat4_transform(projection, eye, out.pos);
+	float color[4];
+	if (lit) light_color(g_replay.light, v.position, v.normal, v.color, color);
+	else std::memcpy(color, v.color, sizeof(color));
+	for (int i = 0; i < 4; i++) out.attr[ATTR_R + i] = color[i];
+	out.attr[ATTR_U] = v.uv[0];
+	out.attr[ATTR_V] = v.uv[1];
+}
+
+// Clip volume planes as (x, y, z, w) weights; inside is >= 0.
+static const float CLIP_PLANES[6][4] = {
+	{0, 0, 1, 1},           // Near
+	{0, 0, -1, 1},          // Far
+	{1, 0, 0, GUARD_BAND},  // Guard band: everything inside is
+	{-1, 0, 0, GUARD_BAND}, // rasterized as is, the scissor is
+	{0, 1, 0, GUARD_BAND},  // the tile.
+	{0, -1, 0, GUARD_BAND},
+};
+
+static float plane_distance(const float plane[4], const ClipVertex& v) {
+	return plane[0] * v.pos[0] + plane[1] * v.pos[1] + plane[2] * v.pos[2] + plane[3] * v.pos[3];
+}
+
+static ClipVertex lerp(const ClipVertex& a, const ClipVertex& b, float t) {
+	ClipVertex r;
+	for (int i = 0; i < 4; i++) r.pos[i] = a.pos[i] + (b.pos[i] - a.pos[i]) * t;
+	for (int i = 0; i < ATTR_COUNT; i++) r.attr[i] = a.attr[i] + (b.attr[i] - a.attr[i]) * t;
+	return r;
+}
+
+// Sutherland-Hodgman against every clip plane. 'poly' is a closed polygon
+// (or, with 'closed' false, a line segment); returns the vertex count left.
+static int clip(ClipVertex* poly, int count, bool closed, ClipVertex* scratch) {
+	for (int p = 0; p < 6 && count > 0; p++) {
+		const float* plane = CLIP_PLANES[p];
+		int out = 0;
+		int edges = closed ? count : count - 1;
+		bool allInside = true;
+		for (int i = 0; i < count; i++) allInside = allInside && plane_distance(plane, poly[i]) >= 0.0f;
+		if (allInside) continue;
+		for (int i = 0; i < edges; i++) {
+			const ClipVertex& a = poly[i];
+			const ClipVertex& b = poly[(i + 1) % count];
+			float da = plane_distance(plane, a), db = plane_distance(plane, b);
+			if (da >= 0.0f) scratch[out++] = a;
+			if ((da >= 0.0f) != (db >= 0.0f)) scratch[out++] = lerp(a, b, da / (da - db));
+			if (!closed && i == edges - 1 && db >= 0.0f) scratch[out++] = b;
+		}
+		std::copy(scratch, scratch + out, poly);
+		count = out;
+	}
+	return count;
+}
+
+static ScreenVertex to_window(const ClipVertex& v) {
+	const int* vp = g_replay.viewport();
+	ScreenVertex s;
+	s.q = 1.0f / v.pos[3];
+	s.x = vp[0] + (v.pos[0] * s.q + 1.0f) * 0.5f * vp[2];
+	s.y = vp[1] + (v.pos[1] * s.q + 1.0f) * 0.5f * vp[3];
+	s.z = (v.pos[2] * s.q + 1.0f) * 0.5f;
+	for (int i = 0; i < ATTR_COUNT; i++) s.attr[i] = v.attr[i] * s.q;
+	return s;
+}
+
+// SETUP & BINNING
+
+static Plane attribute_plane(const Plane edge[3], float area, float f0, float f1, float f2) {
+	// f = (f0 * E0 + f1 * E1 + f2 * E2) / area, Ei being the edge opposite vertex i
+	Plane p;
+	p.a = (f0 * edge[0].a + f1 * edge[1].a + f2 * edge[2].a) / area;
+	p.b = (f0 * edge[0].b + f1 * edge[1].b + f2 * edge[2].b) / area;
+	p.c = (f0 * edge[0].c + f1 * edge[1].c + f2 * edge[2].c) / area;
+	return p;
+}
+
+static void setup_triangle(const ScreenVertex* a, const ScreenVertex* b, const ScreenVertex* c, int style) {
+	float area = (b->x - a->x) * (c->y - a->y) - (c->x - a->x) * (b->y - a->y);
+	if (!(area != 0.0f)) return; // Degenerate (or NaN)
+	if (area < 0.0f) {
+		// No face culling in the simulator: wind everything counter-clockwise.
+		std::swap(b, c);
+		area = -area;
+	}
+
+	const ScreenVertex* v[3] = {a, b, c};
+	Triangle t;
+	for (int i = 0; i < 3; i++) {
+		const ScreenVertex* from = v[(i + 1) % 3];
+		const ScreenVertex* to = v[(i + 2) % 3];
+		Plane& e = t.edge[i];
+		e.a = from->y - to->y;
+		e.b = to->x - from->x;
+		e.c = -(e.a * from->x + e.b * from->y);
+		t.inclusive[i] = e.a > 0.0f || (e.a == 0.0f && e.b < 0.0f);
+	}
+
+	float minX = std::min(a->x, std::min(b->x, c->x)), maxX = std::max(a->x, std::max(b->x, c->x));
+	float minY = std::min(a->y, std::min(b->y, c->y)), maxY = std::max(a->y, std::max(b->y, c->y));
+	// Pixel centres at +0.5 inside the bounds
+	t.x0 = std::max(0, (int)std::ceil(minX - 0.5f));
+	t.y0 = std::max(0, (int)std::ceil(minY - 0.5f));
+	t.x1 = std::min(g_fb.width, (int)std::floor(maxX - 0.5f) + 1);
+	t.y1 = std::min(g_fb.height, (int)std::floor(maxY - 0.5f) + 1);
+	if (t.x0 >= t.x1 || t.y0 >= t.y1) return;
+
+	t.z = attribute_plane(t.edge, area, v[0]->z, v[1]->z, v[2]->z);
+	t.q = attribute_plane(t.edge, area, v[0]->q, v[1]->q, v[2]->q);
+	for (int i = 0; i < ATTR_COUNT; i++) t.attr[i] = attribute_plane(t.edge, area, v[0]->attr[i], v[1]->attr[i], v[2]->attr[i]);
+	t.style = style;
+
+	unsigned int index = (unsigned int)g_triangles.size();
+	alloc::push_kept(g_triangles, t);
+	for (int ty = t.y0 / TILE_SIZE; ty <= (t.y1 - 1) / TILE_SIZE; ty++) {
+		for (int tx = t.x0 / TILE_SIZE; tx <= (t.x1 - 1) / TILE_SIZE; tx++) alloc::push_kept(g_bins[ty * g_tilesX + tx], index);
+	}
+}
+
+// Two triangles covering the window-space rectangle around a..b (a line
+// 'width' wide) or, with a == b, a 'width' sized square (a point).
+static void setup_quad(const ScreenVertex& a, const ScreenVertex& b, float width, int style) {
+	float dx = b.x - a.x, dy = b.y - a.y;
+	float len = std::sqrt(dx * dx + dy * dy);
+	float half = width * 0.5f;
+	float nx, ny, ex, ey;
+	if (len > 0.0f) {
+		nx = -dy / len * half;
+		ny = dx / len * half;
+		ex = ey = 0.0f;
+	} else {
+		nx = 0.0f;
+		ny = half;
+		ex = half;
+		ey = 0.0f;
+	}
+	ScreenVertex corners[4] = {a, a, b, b};
+	corners[0].x += -nx - ex;
+	corners[0].y += -ny - ey;
+	corners[1].x += nx - ex;
+	corners[1].y += ny - ey;
+	corners[2].x += nx + ex;
+	corners[2].y += ny + ey;
+	corners[3].x += -nx + ex;
+	corners[3].y += -ny + ey;
+	setup_triangle(&corners[0], &corners[1], &corners[2], style);
+	setup_triangle(&corners[0], &corners[2], &corners[3], style);
+}
+
+static void setup_batch(const Batch& batch, int style) {
+	const DrawState& s = batch.state;
+	const mat4& projection = g_replay.cameras[s.camera];
+	bool lit = s.shading == SHADE_LIT_TEXTURED || s.shading == SHADE_LIT_COLORED;
+	const Vertex* v = &g_replay.vertices[batch.first];
+	ClipVertex poly[16], scratch[16];
+	ScreenVertex screen[16];
+
+	if (s.mode == GL_TRIANGLES) {
+		for (GLsizei i = 0; i + 2 < batch.count; i += 3) {
+			for (int k = 0; k < 3; k++) project(v[i + k], projection, lit, poly[k]);
+			int n = clip(poly, 3, true, scratch);
+			for (int k = 0; k < n; k++) screen[k] = to_window(poly[k]);
+			for (int k = 2; k < n; k++) setup_triangle(&screen[0], &screen[k - 1], &screen[k], style);
+		}
+	} else if (s.mode == GL_LINES) {
+		for (GLsizei i = 0; i + 1 < batch.count; i += 2) {
+			project(v[i], projection, lit, poly[0]);
+			project(v[i + 1], projection, lit, poly[1]);
+			if (clip(poly, 2, false, scratch) < 2) continue;
+			setup_quad(to_window(poly[0]), to_window(poly[1]), s.lineWidth, style);
+		}
+	} else {
+		for (GLsizei i = 0; i < batch.count; i++) {
+			project(v[i], projection, lit, poly[0]);
+			if (clip(poly, 1, false, scratch) < 1) continue;
+			ScreenVertex p = to_window(poly[0]);
+			setup_quad(p, p, s.pointSize, style);
+		}
+	}
+}
+
+// TILE STAGE
+
+static void shade(const Triangle& t, const Style& style, int x, int y) {
+	size_t index = (size_t)y * g_fb.width + x;
+	float px = x + 0.5f, py = y + 0.5f;
+	const DrawState& s = style.state;
+
+	float z = t.z.at(px, py);
+	if (s.depth && !(z < g_fb.depth[index])) return; // GL_LESS
+
+	float q = t.q.at(px, py);
+	float w = 1.0f / q;
+	float color[4];
+	for (int i = 0; i < 4; i++) color[i] = t.attr[ATTR_R + i].at(px, py) * w;
+
+	if (style.texture) {
+		float u = t.attr[ATTR_U].at(px, py) * w, v = t.attr[ATTR_V].at(px, py) * w;
+		const std::vector<MipLevel>& levels = style.texture->levels;
+		if (s.shading == SHADE_TEXT) {
+			const MipLevel& atlas = levels[0];
+			if ((texel(atlas, (int)std::floor(u * atlas.w), (int)std::floor(v * atlas.h)) & 0xff) < 128) return;
+		} else {
+			// GL_LINEAR_MIPMAP_NEAREST: the footprint of this pixel in
+			// texels picks the level. d(u)/dx of u = U / q is (U' - u q') / q.
+			const MipLevel& base = levels[0];
+			float dudx = (t.attr[ATTR_U].a - u * t.q.a) * w * base.w, dvdx = (t.attr[ATTR_V].a - v * t.q.a) * w * base.h;
+			float dudy = (t.attr[ATTR_U].b - u * t.q.b) * w * base.w, dvdy = (t.attr[ATTR_V].b - v * t.q.b) * w * base.h;
+			float rho2 = std::max(dudx * dudx + dvdx * dvdx, dudy * dudy + dvdy * dvdy);
+			int level = 0;
+			if (rho2 > 1.0f) {
+				level = (int)(0.5f * std::log2(rho2) + 0.5f);
+				level = std::min(level, (int)levels.size() - 1);
+			}
+			float texColor[4];
+			sample_linear(levels[level], u, v, texColor);
+			for (int i = 0; i < 4; i++) color[i] *= texColor[i]; // GL_MODULATE
+		}
+	}
+
+	if (s.blend) {
+		float dst[4], src[4];
+		unpack(g_fb.color[index], dst);
+		std::memcpy(src, color, sizeof(src));
+		for (int i = 0; i < 4; i++) {
+			color[i] = src[i] * blend_factor(s.blendSrc, src, dst, i) + dst[i] * blend_factor(s.blendDst, src, dst, i);
+		}
+		if (g_offscreen) color[3] = src[3] + dst[3] * (1.0f - src[3]);
+	}
+	g_fb.color[index] = pack(color);
+	if (s.depth) g_fb.depth[index] = z;
+}
+
+// Calls shade() for every pixel of rows [y0, y1) x [x0, x1) that 't' covers.
+static void rasterize(const Triangle& t, int x0, int y0, int x1, int y1) {
+	const Style& style = g_styles[t.style];
+#ifdef SOFT_SSE2
+	// Four pixels of a row at once: each edge function is evaluated for the
+	// whole span, the coverage masks ANDed, and only covered pixels shaded.
+	const __m128 offsets = _mm_setr_ps(0.5f, 1.5f, 2.5f, 3.5f);
+	const __m128 zero = _mm_setzero_ps();
+	__m128 ea[3], inclusive[3];
+	for (int i = 0; i < 3; i++) {
+		ea[i] = _mm_set1_ps(t.edge[i].a);
+		inclusive[i] = _mm_castsi128_ps(_mm_set1_epi32(t.inclusive[i] ? -1 : 0));
+	}
+	for (int y = y0; y < y1; y++) {
+		float py = y + 0.5f;
+		__m128 rowBase[3];
+		for (int i = 0; i < 3; i++) rowBase[i] = _mm_set1_ps(t.edge[i].b * py + t.edge[i].c);
+		for (int x = x0; x < x1; x += 4) {
+			__m128 px = _mm_add_ps(_mm_set1_ps((float)x), offsets);
+			__m128 covered = _mm_castsi128_ps(_mm_set1_epi32(-1));
+			for (int i = 0; i < 3; i++) {
+				__m128 e = _mm_add_ps(_mm_mul_ps(ea[i], px), rowBase[i]);
+				__m128 inside = _mm_or_ps(_mm_cmpgt_ps(e, zero), _mm_and_ps(_mm_cmpeq_ps(e, zero), inclusive[i]));
+				covered = _mm_and_ps(covered, inside);
+			}
+			int mask = _mm_movemask_ps(covered);
+			if (x1 - x < 4) mask &= (1 << (x1 - x)) - 1;
+			while (mask) {
+				int lane = 0;
+				while (!(mask >> lane & 1)) lane++;
+				mask &= ~(1 << lane);
+				shade(t, style, x + lane, y);
+			}
+		}
+	}
+#else
+	for (int y = y0; y < y1; y++) {
+		float py = y + 0.5f;
+		for (int x = x0; x < x1; x++) {
+			float px = x + 0.5f;
+			bool covered = true;
+			for (int i = 0; i < 3 && covered; i++) {
+				float e = t.edge[i].at(px, py);
+				covered = e > 0.0f || (e == 0.0f && t.inclusive[i]);
+			}
+			if (covered) shade(t, style, x, y);
+		}
+	}
+#endif
+}
+
+// Draws the tile's triangles in submit order; tiles share no pixels, so
+// any number of them run at once.
+static void rasterize_tile(size_t tile) {
+	const std::vector<unsigned int>& bin = g_bins[tile];
+	if (bin.empty()) return;
+	int tx = (int)(tile % g_tilesX) * TILE_SIZE, ty = (int)(tile / g_tilesX) * TILE_SIZE;
+	for (size_t i = 0; i < bin.size(); i++) {
+		const Triangle& t = g_triangles[bin[i]];
+		rasterize(t, std::max(t.x0, tx), std::max(t.y0, ty), std::min(t.x1, tx + TILE_SIZE),
+		          std::min(t.y1, ty + TILE_SIZE));
+	}
+}
+
+static const Texture* texture_for(const DrawState& s) {
+	if (s.shading == SHADE_TEXT) return &g_font;
+	if (s.shading != SHADE_LIT_TEXTURED && s.shading != SHADE_UNLIT_TEXTURED) return nullptr;
+	if (s.texture >= g_textures.size() || g_textures[s.texture].levels.empty()) return nullptr;
+	return &g_textures[s.texture];
+}
+
+// Tiles covering a w x h g_fb. The bins only ever grow, so switching
+// between the window and a render target reuses them.
+static void size_tiles(int w, int h) {
+	g_tilesX = (w + TILE_SIZE - 1) / TILE_SIZE;
+	g_tilesY = (h + TILE_SIZE - 1) / TILE_SIZE;
+	if (g_bins.size() < (size_t)g_tilesX * g_tilesY) g_bins.resize((size_t)g_tilesX * g_tilesY);
+}
+
+// Draws and clears what g_replay has collected.
+static void rasterize_output() {
+	size_t tiles = (size_t)g_tilesX * g_tilesY;
+	if (g_fb.width > 0 && g_fb.height > 0) {
+		alloc::reserve_kept(g_styles, g_replay.batches.size());
+		g_styles.resize(g_replay.batches.size());
+		for (size_t i = 0; i < g_replay.batches.size(); i++) {
+			g_styles[i].state = g_replay.batches[i].state;
+			g_styles[i].texture = texture_for(g_replay.batches[i].state);
+			setup_batch(g_replay.batches[i], (int)i);
+		}
+		g_pool->parallel_for(tiles, [](size_t tile) { rasterize_tile(tile); });
+	}
+
+	g_triangles.clear();
+	for (size_t i = 0; i < tiles; i++) g_bins[i].clear();
+	g_replay.clear_output();
+}
+
+} // namespace
+
+bool init(unsigned int workers) {
+	g_pool.reset(new jobs::Pool(workers));
+
+	std::vector<unsigned char> atlas(FONT_ATLAS_WIDTH * FONT_ATLAS_HEIGHT);
+	build_font_atlas(atlas.data());
+	MipLevel level;
+	level.w = FONT_ATLAS_WIDTH;
+	level.h = FONT_ATLAS_HEIGHT;
+	level.texels.assign(atlas.begin(), atlas.end()); // Coverage in red
+	g_font.levels.assign(1, level);
+
+	// opengl_init() starts the window context with GL_DEPTH_TEST on.
+	g_replay.set_depth_test(true);
+	return true;
+}
+
+void resize(int w, int h, float fovY, float zNear, float zFar) {
+	h = h == 0 ? 1 : h;
+	g_replay.resize(w, h, fovY, zNear, zFar);
+	g_fb.width = w;
+	g_fb.height = h;
+	g_fb.color.assign((size_t)w * h, 0);
+	g_fb.depth.assign((size_t)w * h, 1.0f);
+	size_tiles(w, h);
+}
+
+void set_light(const float position[4], const float diffuse[4]) { g_replay.set_light(position, diffuse); }
+
+void upload_texture(unsigned int texture, int w, int h, const unsigned char* rgb) {
+	if (texture >= g_textures.size()) g_textures.resize(texture + 1);
+	Texture& tex = g_textures[texture];
+	tex.levels.clear();
+	g_replay.set_texture_loaded(texture, w > 0 && h > 0);
+	if (w <= 0 || h <= 0) return;
+
+	MipLevel base;
+	base.w = w;
+	base.h = h;
+	base.texels.resize((size_t)w * h);
+	for (size_t i = 0; i < base.texels.size(); i++) {
+		const unsigned char* p = rgb + i * 3;
+		base.texels[i] = p[0] | p[1] << 8 | p[2] << 16 | 0xffu << 24;
+	}
+	tex.levels.push_back(base);
+	while (tex.levels.back().w > 1 || tex.levels.back().h > 1) tex.levels.push_back(downsample(tex.levels.back()));
+}
+
+void submit(const CommandList& list) {
+	g_replay.replay(list);
+	rasterize_output();
+}
+
+void draw_overlay(const OverlayVertex* vertices, size_t count) {
+	g_replay.overlay(vertices, count);
+	rasterize_output();
+}
+
+void render_to_texture(unsigned int texture, int w, int h, const CommandList& list) {
+	if (w <= 0 || h <= 0) return;
+	g_target.width = w;
+	g_target.height = h;
+	g_target.color.assign((size_t)w * h, 0);
+	g_target.depth.assign((size_t)w * h, 1.0f);
+	g_targetReplay.reset_state();
+	g_targetReplay.set_viewport(w, h);
+
+	// The rasterizer draws into g_fb through g_replay: lend it the target's
+	std::swap(g_replay, g_targetReplay);
+	std::swap(g_fb, g_target);
+	size_tiles(w, h);
+	g_offscreen = true;
+	g_replay.replay(list);
+	rasterize_output();
+	g_offscreen = false;
+	std::swap(g_replay, g_targetReplay);
+	std::swap(g_fb, g_target);
+	size_tiles(g_fb.width, g_fb.height);
+
+	if (texture >= g_textures.size()) g_textures.resize(texture + 1);
+	std::vector<MipLevel>& levels = g_textures[texture].levels;
+	levels.resize(1);
+	levels[0].w = w;
+	levels[0].h = h;
+	levels[0].texels.assign(g_target.color.begin(), g_target.color.end());
+	g_replay.set_texture_loaded(texture, true);
+}
+
+void clear() {
+	std::fill(g_fb.color.begin(), g_fb.color.end(), 0u);
+	std::fill(g_fb.depth.begin(), g_fb.depth.end(), 1.0f);
+}
+
+void present() {
+	// The window context is left at its defaults (identity matrices), so
+	// (-1, -1) is the bottom-left corner.
+	glDisable(GL_DEPTH_TEST);
+	glRasterPos2f(-1.0f, -1.0f);
+	glDrawPixels(g_fb.width, g_fb.height, GL_RGBA, GL_UNSIGNED_BYTE, g_fb.color.data());
+}
+
+const Framebuffer& framebuffer() { return g_fb; }
+
+} // namespace soft
+} // namespace gfx
@@ -0,0 +1,37 @@
+#pragma once
+
+#include "gfx.h"
+
+#include <vector>
+
+namespace gfx {
+namespace soft {
+
+// Software renderer: no GPU needed, and the same pixels on every machine.
+// Command lists are replayed on the CPU (gfx_replay.h); the triangles,
+// lines and points are set up once, binned into screen tiles and the tiles
+// shaded in parallel on a job pool, into the framebuffer below. present()
+// copies it to the window, if there is one.
+// Used through the renderer-neutral calls in gfx.h.
+
+struct Framebuffer {
+	int width = 0, height = 0;
+	std::vector<unsigned int> color; // RGBA8, red in the low byte; bottom row first, as glReadPixels
+	std::vector<float> depth;
+};
+
+// 'workers' counts the calling thread; 0 picks the core count.
+bool init(unsigned int workers);
+void resize(int w, int h, float fovY, float zNear, float zFar);
+void set_light(const float position[4], const float diffuse[4]);
+void upload_texture(unsigned int texture, int w, int h, const unsigned char* rgb);
+void submit(const CommandList& list);
+void draw_overlay(const OverlayVertex* vertices, size_t count);
+void render_to_texture(unsigned int texture, int w, int h, const CommandList& list);
+void clear();
+void present();
+
+const Framebuffer& framebuffer();
+
+} // namespace soft
+} // namespace gfx
@@ -5,7 +5,7 @@
 #include <GLUT/glut.h>
 #else
 #include <GL/glut.h>
-// #include <GL/freeglut.h> // Common on Windows/Linux setups
+#include <GL/freeglut_ext.h> // Core profile contexts, glutGetProcAddress
 #endif
 
 #endif
@@ -0,0 +1,143 @@
+#include "headless.h"
+
+#include <cstdio>
+
+#ifdef __linux__
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#include <GL/glext.h>
+#endif
+
+namespace headless {
+
+#ifdef __linux__
+
+namespace {
+
+static EGLDisplay g_display = EGL_NO_DISPLAY;
+static EGLContext g_context = EGL_NO_CONTEXT;
+static GLuint g_fbo = 0, g_renderbuffers[2] = {0, 0};
+
+static PFNGLGENFRAMEBUFFERSPROC genFramebuffers;
+static PFNGLBINDFRAMEBUFFERPROC bindFramebuffer;
+static PFNGLDELETEFRAMEBUFFERSPROC deleteFramebuffers;
+static PFNGLCHECKFRAMEBUFFERSTATUSPROC checkFramebufferStatus;
+static PFNGLGENRENDERBUFFERSPROC genRenderbuffers;
+static PFNGLBINDRENDERBUFFERPROC bindRenderbuffer;
+static PFNGLDELETERENDERBUFFERSPROC deleteRenderbuffers;
+static PFNGLRENDERBUFFERSTORAGEPROC renderbufferStorage;
+static PFNGLFRAMEBUFFERRENDERBUFFERPROC framebufferRenderbuffer;
+
+static void* load(const char* name) { return (void*)eglGetProcAddress(name); }
+
+static bool fail(const char* what) {
+	std::fprintf(stderr, "headless: %s (EGL error 0x%x)\n", what, eglGetError());
+	destroy();
+	return false;
+}
+
+static bool create_framebuffer(int w, int h) {
+	genFramebuffers = (PFNGLGENFRAMEBUFFERSPROC)load("glGenFramebuffers");
+	bindFramebuffer = (PFNGLBINDFRAMEBUFFERPROC)load("glBindFramebuffer");
+	deleteFramebuffers = (PFNGLDELETEFRAMEBUFFERSPROC)load("glDeleteFramebuffers");
+	checkFramebufferStatus = (PFNGLCHECKFRAMEBUFFERSTATUSPROC)load("glCheckFramebufferStatus");
+	genRenderbuffers = (PFNGLGENRENDERBUFFERSPROC)load("glGenRenderbuffers");
+	bindRenderbuffer = (PFNGLBINDRENDERBUFFERPROC)load("glBindRenderbuffer");
+	deleteRenderbuffers = (PFNGLDELETERENDERBUFFERSPROC)load("glDeleteRenderbuffers");
+	renderbufferStorage = (PFNGLRENDERBUFFERSTORAGEPROC)load("glRenderbufferStorage");
+	framebufferRenderbuffer = (PFNGLFRAMEBUFFERRENDERBUFFERPROC)load("glFramebufferRenderbuffer");
+	if (!genFramebuffers || !bindFramebuffer || !deleteFramebuffers || !checkFramebufferStatus || !genRenderbuffers ||
+	    !bindRenderbuffer || !deleteRenderbuffers || !renderbufferStorage || !framebufferRenderbuffer) {
+		return false;
+	}
+
+	genFramebuffers(1, &g_fbo);
+	bindFramebuffer(GL_FRAMEBUFFER, g_fbo);
+	genRenderbuffers(2, g_renderbuffers);
+	bindRenderbuffer(GL_RENDERBUFFER, g_renderbuffers[0]);
+	renderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, w, h);
+	framebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, g_renderbuffers[0]);
+	bindRenderbuffer(GL_RENDERBUFFER, g_renderbuffers[1]);
+	renderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, w, h);
+	framebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, g_renderbuffers[1]);
+	return checkFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+}
+
+} // namespace
+
+bool create(int w, int h, gfx::Renderer renderer) {
+	if (renderer == gfx::RENDERER_SOFTWARE) {
+		std::printf("headless: software renderer, no GL, %dx%d\n", w, h);
+		return true;
+	}
+	bool core = renderer == gfx::RENDERER_GL3;
+	PFNEGLGETPLATFORMDISPLAYEXTPROC getPlatformDisplay =
+		(PFNEGLGETPLATFORMDISPLAYEXTPROC)eglGetProcAddress("eglGetPlatformDisplayEXT");
+	if (!getPlatformDisplay) return fail("no eglGetPlatformDisplayEXT");
+	g_display = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr);
+	EGLint major, minor;
+	if (g_display == EGL_NO_DISPLAY || !eglInitialize(g_display, &major, &minor)) {
+		return fail("no surfaceless EGL display");
+	}
+	if (!eglBindAPI(EGL_OPENGL_API)) return fail("no desktop GL");
+
+	const EGLint coreAttribs[] = {EGL_CONTEXT_MAJOR_VERSION, 3, EGL_CONTEXT_MINOR_VERSION, 3,
+	                              EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT, EGL_NONE};
+	// No config: the context never draws to an EGL surface, only to the FBO.
+	g_context = eglCreateContext(g_display, EGL_NO_CONFIG_KHR, EGL_NO_CONTEXT, core ? coreAttribs : nullptr);
+	if (g_context == EGL_NO_CONTEXT) return fail("can't create a GL context");
+	if (!eglMakeCurrent(g_display, EGL_NO_SURFACE, EGL_NO_SURFACE, g_context)) return fail("can't make it current");
+	if (!create_framebuffer(w, h)) return fail("can't create the framebuffer");
+
+	const char* device = (const char*)glGetString(GL_RENDERER);
+	std::printf("headless: EGL %d.%d, %s, %dx%d\n", major, minor, device ? device : "?", w, h);
+	return true;
+}
+
+void destroy() {
+	if (g_context != EGL_NO_CONTEXT) {
+		if (g_fbo) {
+			deleteRenderbuffers(2, g_renderbuffers);
+			deleteFramebuffers(1, &g_fbo);
+			g_fbo = 0;
+		}
+		eglMakeCurrent(g_display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+		eglDestroyContext(g_display, g_context);
+		g_context = EGL_NO_CONTEXT;
+	}
+	if (g_display != EGL_NO_DISPLAY) {
+		eglTerminate(g_display);
+		g_display = EGL_NO_DISPLAY;
+	}
+}
+
+gfx::ProcLoader proc_loader() {
+	return g_context != EGL_NO_CONTEXT ? (gfx::ProcLoader)eglGetProcAddress : nullptr;
+}
+
+void finish_frame() {
+	// Without a context the frame is the software renderer's, complete once
+	// submitted: it stays in the CPU framebuffer.
+	if (g_context != EGL_NO_CONTEXT) glFinish();
+}
+
+#else
+
+bool create(int w, int h, gfx::Renderer renderer) {
+	if (renderer == gfx::RENDERER_SOFTWARE) {
+		std::printf("headless: software renderer, no GL, %dx%d\n", w, h);
+		return true;
+	}
+	std::fprintf(stderr, "headless: needs EGL, only available on Linux\n");
+	return false;
+}
+
+void destroy() {}
+
+gfx::ProcLoader proc_loader() { return nullptr; }
+
+void finish_frame() {}
+
+#endif
+
+} // namespace headless
@@ -0,0 +1,27 @@
+#pragma once
+
+#include "gfx.h"
+
+namespace headless {
+
+// Offscreen GL for running without a window or display server: an EGL
+// context on Mesa's surfaceless platform, rendering into a framebuffer
+// object of the requested size. Linux only (link with -lEGL); elsewhere
+// create() reports that it isn't available. The software renderer needs
+// none of it: it draws into its own CPU framebuffer, with no GL context, on
+// any platform.
+
+// For the GL renderers, makes a context current with a w x h colour + depth
+// FBO bound (the GL 3.3 core profile for RENDERER_GL3). For the software
+// renderer, does nothing. False (with a message) on failure.
+bool create(int w, int h, gfx::Renderer renderer);
+void destroy();
+
+// Entry point lookup for gfx::init_renderer(); null without a context.
+gfx::ProcLoader proc_loader();
+
+// Waits for the frame's GL work, the headless stand-in for a swap. Nothing
+// to wait for without a context.
+void finish_frame();
+
+} // namespace headless
@@ -0,0 +1,164 @@
+#include "hud.h"
+
+#include "alloc_track.h"
+#include "audio.h"
+#include "font_atlas.h"
+#include "gfx.h"
+#include "profiler.h"
+
+#include <algorithm>
+#include <cstdarg>
+#include <cstdio>
+#include <vector>
+
+namespace hud {
+
+namespace {
+
+const float PAD = 6.0f;
+const float LINE = 11.0f;            // Text rows, 8 pixel glyphs
+const float WIDTH = HISTORY + 2 * PAD; // The graph sets the width
+const float GRAPH_H = 60.0f;
+const float GRAPH_MS = 50.0f; // Frame time at the top of the graph
+const int NAME_CHARS = 14;    // Pass names are cut to this
+
+struct Color {
+	unsigned char r, g, b, a;
+};
+
+const Color BACKGROUND = {0, 0, 0, 170};
+const Color GRAPH_BACKGROUND = {40, 40, 40, 200};
+const Color GUIDE = {120, 120, 120, 255};
+const Color TITLE = {150, 230, 255, 255};
+const Color WHITE = {255, 255, 255, 255};
+const Color GPU = {150, 255, 150, 255}; // As the F3 table
+const Color COUNTS = {255, 215, 130, 255};
+const Color FAST = {90, 220, 90, 255};   // Under 60 fps' frame time
+const Color SLOW = {240, 200, 60, 255};  // Under 30 fps'
+const Color STALL = {240, 80, 60, 255};
+
+static float g_frames[HISTORY]; // Ring of frame times, ms
+static int g_count = 0, g_next = 0;
+static std::vector<gfx::OverlayVertex> g_vertices; // Keeps its capacity
+static std::vector<prof::Stats> g_stats;
+static std::vector<const prof::Stats*> g_passes;
+
+static void quad(float x0, float y0, float x1, float y1, float u0, float v0, float u1, float v1, Color c) {
+	const float corners[4][4] = {{x0, y0, u0, v0}, {x1, y0, u1, v0}, {x1, y1, u1, v1}, {x0, y1, u0, v1}};
+	const int order[6] = {0, 1, 2, 0, 2, 3};
+	for (int i = 0; i < 6; i++) {
+		const float* p = corners[order[i]];
+		gfx::OverlayVertex v = {p[0], p[1], p[2], p[3], {c.r, c.g, c.b, c.a}};
+		g_vertices.push_back(v);
+	}
+}
+
+static void fill(float x0, float y0, float x1, float y1, Color c) {
+	// The middle of the solid cell: filtered or not, every sample is inside
+	const float u = ((gfx::FONT_SOLID_CELL % gfx::FONT_ATLAS_COLUMNS) + 0.5f) * gfx::FONT_CELL / gfx::FONT_ATLAS_WIDTH;
+	const float v = ((gfx::FONT_SOLID_CELL / gfx::FONT_ATLAS_COLUMNS) + 0.5f) * gfx::FONT_CELL / gfx::FONT_ATLAS_HEIGHT;
+	quad(x0, y0, x1, y1, u, v, u, v, c);
+}
+
+// Monospaced at one texel a pixel, (x, y) the bottom left of the first cell.
+static void text(float x, float y, Color c, const char* fmt, ...) {
+	char line[64];
+	va_list args;
+	va_start(args, fmt);
+	std::vsnprintf(line, sizeof(line), fmt, args);
+	va_end(args);
+	for (const char* ch = line; *ch; ch++, x += gfx::FONT_CELL) {
+		if (*ch == ' ') continue;
+		int cx, cy;
+		gfx::font_atlas_cell((unsigned char)*ch, cx, cy);
+		float u0 = (float)cx / gfx::FONT_ATLAS_WIDTH, u1 = (float)(cx + gfx::FONT_CELL) / gfx::FONT_ATLAS_WIDTH;
+		float vTop = (float)cy / gfx::FONT_ATLAS_HEIGHT;
+		float vBottom = (float)(cy + gfx::FONT_CELL) / gfx::FONT_ATLAS_HEIGHT;
+		quad(x, y, x + gfx::FONT_CELL, y + gfx::FONT_CELL, u0, vBottom, u1, vTop, c);
+	}
+}
+
+static void graph(float x, float y) {
+	fill(x, y, x + HISTORY, y + GRAPH_H, GRAPH_BACKGROUND);
+	const float guides[2] = {1000.0f / 60.0f, 1000.0f / 30.0f};
+	for (float ms : guides) {
+		float gy = y + GRAPH_H * ms / GRAPH_MS;
+		fill(x, gy, x + HISTORY, gy + 1.0f, GUIDE);
+	}
+	for (int i = 0; i < g_count; i++) {
+		float ms = g_frames[(g_next - g_count + i + HISTORY) % HISTORY];
+		Color c = ms <= guides[0] ? FAST : (ms <= guides[1] ? SLOW : STALL);
+		float bx = x + HISTORY - g_count + i;
+		fill(bx, y, bx + 1.0f, y + GRAPH_H * std::min(ms / GRAPH_MS, 1.0f), c);
+	}
+}
+
+} // namespace
+
+void add_frame(float ms) {
+	g_frames[g_next] = ms;
+	g_next = (g_next + 1) % HISTORY;
+	if (g_count < HISTORY) g_count++;
+}
+
+void draw(int w, int h) {
+	// Passes: what runs every frame, i.e. each thread's top scope and the
+	// GPU-timed ones. One-off scopes (loading textures) would pin the list.
+	prof::stats(g_stats);
+	g_passes.clear();
+	for (const prof::Stats& s : g_stats) {
+		if ((s.depth == 0 || s.gpu.samples) && s.cpu.samples > 1) g_passes.push_back(&s);
+	}
+
+	const int lines = 1 + 1 + std::max((int)g_passes.size(), 1) + 2 + (alloc::TRACKING_ENABLED ? 1 : 0) + 1;
+	const float x = w - WIDTH - PAD, top = h - PAD;
+	const float bottom = top - PAD * 3 - GRAPH_H - LINE * lines;
+	g_vertices.clear();
+	fill(x, bottom, x + WIDTH, top, BACKGROUND);
+
+	float sum = 0.0f, worst = 0.0f;
+	for (int i = 0; i < g_count; i++) {
+		sum += g_frames[i];
+		worst = std::max(worst, g_frames[i]);
+	}
+	float avg = g_count ? sum / g_count : 0.0f;
+	float tx = x + PAD, y = top - PAD - LINE + 2.0f;
+	text(tx, y, TITLE, "%5.1f fps %5.2f ms max %5.2f", avg > 0.0f ? 1000.0f / avg : 0.0f, avg, worst);
+
+	y -= PAD + GRAPH_H;
+	graph(tx, y);
+
+	y -= LINE + 2.0f;
+	text(tx, y, TITLE, "%-*s %6s %6s", NAME_CHARS, "pass ms", "cpu", "gpu");
+	for (const prof::Stats* s : g_passes) {
+		y -= LINE;
+		text(tx, y, WHITE, "%-*.*s %6.2f", NAME_CHARS, NAME_CHARS, s->name, s->cpu.avg);
+		if (s->gpu.samples) text(tx + (NAME_CHARS + 7) * gfx::FONT_CELL, y, GPU, "%7.2f", s->gpu.avg);
+	}
+	if (g_passes.empty()) {
+		y -= LINE;
+		text(tx, y, WHITE, "(built with NO_PROFILER)");
+	}
+
+	gfx::Counters calls = gfx::frame_counters();
+	y -= LINE;
+	if (gfx::COUNTERS_ENABLED) {
+		text(tx, y, COUNTS, "draws %-6lu binds %lu", calls.n[gfx::COUNT_DRAWS], calls.n[gfx::COUNT_BINDS]);
+		y -= LINE;
+		text(tx, y, COUNTS, "prims %-6lu verts %lu", calls.n[gfx::COUNT_PRIMITIVES], calls.n[gfx::COUNT_VERTICES]);
+	} else {
+		text(tx, y, COUNTS, "(built with NO_GFX_COUNTERS)");
+		y -= LINE;
+	}
+	if (alloc::TRACKING_ENABLED) {
+		alloc::Counts made = alloc::frame_counts();
+		y -= LINE;
+		text(tx, y, COUNTS, "allocs %-5lu bytes %lu", made.allocs, made.bytes);
+	}
+	y -= LINE;
+	text(tx, y, WHITE, "textures %.1f MB  voices %d", gfx::texture_bytes() / (1024.0 * 1024.0), audio::active_voices());
+
+	gfx::draw_overlay(g_vertices.data(), g_vertices.size());
+}
+
+} // namespace hud
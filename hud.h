@@ -0,0 +1,20 @@
+#pragma once
+
+namespace hud {
+
+// Heads-up display (F2): FPS and a graph of the last HISTORY frame times,
+// CPU and GPU time per pass (prof::stats), the last frame's gfx submission
+// counters, texture memory and playing audio voices. Everything is built
+// into one vertex array and drawn with a single gfx::draw_overlay(), so
+// showing it costs one draw call whatever it displays, and none of it is
+// counted in the numbers it reports.
+
+const int HISTORY = 240; // Frames in the graph, one pixel column each
+
+// GL thread, once per frame drawn: wall-clock time since the previous one.
+void add_frame(float ms);
+
+// Draws the HUD in the top right corner of a w x h window. GL thread.
+void draw(int w, int h);
+
+} // namespace hud
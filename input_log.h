@@ -0,0 +1,242 @@
+#ifndef INPUT_LOG_H
+#define INPUT_LOG_H
+
+#include "frame_pipeline.h"
+#include "sim_clock.h"
+
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+/*
+  INPUT LOGS
+  A session's input, stamped with the simulation step it was applied
+  before. Everything the world does follows from its input and the fixed
+  SIM_DT steps, so feeding the same events in before the same steps plays
+  the session again exactly, however fast or slowly frames are drawn.
+
+  File: "DSIL", version byte, SIM_HZ (u16 little-endian), then records of
+    <step delta> <type byte> <payload>
+  with the step delta (from the previous record) a LEB128 varint and the
+  payload zigzag varints:
+    keys    key, x, y
+    mouse   x, y as deltas from the previous mouse event
+    resize  width, height
+    set     var, then value as an f32 little-endian
+  The last record is LOG_END, at the step the session stopped.
+*/
+
+const unsigned char LOG_VERSION = 1;
+const int LOG_END = 0xff;
+
+class InputLog {
+private:
+  FILE *out = nullptr;
+  std::vector<unsigned char> in; /// Whole log being replayed
+  size_t pos = 0;
+  std::atomic<bool> replay{false}; /// Read by the GL thread too
+  bool ended = false;
+  unsigned long lastStep = 0;
+  unsigned long endStep = 0;
+  int lastX = 0, lastY = 0; /// Previous mouse event
+  unsigned long events = 0;
+  InputEvent pending; /// Next event to replay, due before 'pendingStep'
+  unsigned long pendingStep = 0;
+  bool havePending = false;
+
+  void put(unsigned long v) {
+    do {
+      unsigned char b = v & 0x7f;
+      v >>= 7;
+      std::fputc(v ? b | 0x80 : b, out);
+    } while (v);
+  }
+  void putSigned(long v) {
+    put(v < 0 ? ((unsigned long)~v << 1) | 1 : (unsigned long)v << 1);
+  }
+
+  bool get(unsigned long &v) {
+    v = 0;
+    for (int shift = 0; pos < in.size() && shift < 64; shift += 7) {
+      unsigned char b = in[pos++];
+      v |= (unsigned long)(b & 0x7f) << shift;
+      if (!(b & 0x80))
+        return true;
+    }
+    return false;
+  }
+  bool getSigned(long &v) {
+    unsigned long u;
+    if (!get(u))
+      return false;
+    v = u & 1 ? ~(long)(u >> 1) : (long)(u >> 1);
+    return true;
+  }
+  bool getInt(int &v) {
+    long l = 0;
+    bool ok = getSigned(l);
+    v = (int)l;
+    return ok;
+  }
+
+  /// Decodes the next record into 'e'; false at LOG_END or a bad byte.
+  bool next(unsigned long &step, InputEvent &e) {
+    unsigned long delta;
+    if (ended || !get(delta) || pos >= in.size()) {
+      endStep = lastStep; // Cut short: play what there is
+      ended = true;
+      return false;
+    }
+    step = lastStep += delta;
+    int type = in[pos++];
+    e = {type, 0, 0, 0, 0.0f};
+    bool ok = true;
+    switch (type) {
+    case INPUT_KEY:
+    case INPUT_KEY_UP:
+    case INPUT_SPECIAL:
+    case INPUT_SPECIAL_UP:
+      ok = getInt(e.key) && getInt(e.x) && getInt(e.y);
+      break;
+    case INPUT_MOUSE:
+      ok = getInt(e.x) && getInt(e.y);
+      e.x = lastX += e.x;
+      e.y = lastY += e.y;
+      break;
+    case INPUT_RESIZE:
+      ok = getInt(e.x) && getInt(e.y);
+      break;
+    case INPUT_SET:
+      ok = getInt(e.key) && pos + 4 <= in.size();
+      if (ok) {
+        std::uint32_t bits = in[pos] | in[pos + 1] << 8 | in[pos + 2] << 16 |
+                             (std::uint32_t)in[pos + 3] << 24;
+        std::memcpy(&e.value, &bits, 4);
+        pos += 4;
+      }
+      break;
+    default: // LOG_END, or a newer version's record
+      ok = false;
+    }
+    if (!ok) {
+      endStep = step;
+      ended = true;
+    }
+    return ok;
+  }
+
+public:
+  /// --record-input: false (with a message) if 'path' can't be written.
+  bool record(const char *path) {
+    out = std::fopen(path, "wb");
+    if (!out) {
+      std::fprintf(stderr, "Can't write input log '%s'\n", path);
+      return false;
+    }
+    const unsigned char header[7] = {'D', 'S', 'I', 'L', LOG_VERSION,
+                                     SIM_HZ & 0xff, SIM_HZ >> 8};
+    std::fwrite(header, 1, sizeof(header), out);
+    return true;
+  }
+
+  /// --replay-input: false (with a message) if 'path' isn't a log this
+  /// build can play.
+  bool load(const char *path) {
+    FILE *f = std::fopen(path, "rb");
+    if (!f) {
+      std::fprintf(stderr, "Can't open input log '%s'\n", path);
+      return false;
+    }
+    in.clear();
+    unsigned char buf[4096];
+    size_t n;
+    while ((n = std::fread(buf, 1, sizeof(buf), f)) > 0)
+      in.insert(in.end(), buf, buf + n);
+    std::fclose(f);
+    if (in.size() < 7 || std::memcmp(in.data(), "DSIL", 4) != 0 ||
+        in[4] != LOG_VERSION) {
+      std::fprintf(stderr, "'%s' is not an input log\n", path);
+      return false;
+    }
+    if ((in[5] | in[6] << 8) != SIM_HZ) {
+      std::fprintf(stderr, "'%s' was recorded at %d Hz, this build steps "
+                           "at %d Hz\n",
+                   path, in[5] | in[6] << 8, SIM_HZ);
+      return false;
+    }
+    pos = 7;
+    replay = true;
+    havePending = next(pendingStep, pending);
+    return true;
+  }
+
+  bool recording() const { return out != nullptr; }
+  /// True from load() until the log's last step has run.
+  bool replaying() const { return replay; }
+
+  /// Logs 'e', applied before simulation step 'step'.
+  void log(unsigned long step, const InputEvent &e) {
+    if (!out)
+      return;
+    put(step - lastStep);
+    lastStep = step;
+    std::fputc(e.type, out);
+    switch (e.type) {
+    case INPUT_MOUSE:
+      putSigned(e.x - lastX);
+      putSigned(e.y - lastY);
+      lastX = e.x;
+      lastY = e.y;
+      break;
+    case INPUT_RESIZE:
+      putSigned(e.x);
+      putSigned(e.y);
+      break;
+    case INPUT_SET: {
+      putSigned(e.key);
+      std::uint32_t bits;
+      std::memcpy(&bits, &e.value, 4);
+      for (int i = 0; i < 4; i++)
+        std::fputc(bits >> (8 * i) & 0xff, out);
+      break;
+    }
+    default:
+      putSigned(e.key);
+      putSigned(e.x);
+      putSigned(e.y);
+    }
+    events++;
+  }
+
+  /// Ends the log at 'step' and closes it.
+  void close(unsigned long step) {
+    if (!out)
+      return;
+    put(step - lastStep);
+    std::fputc(LOG_END, out);
+    std::fclose(out);
+    out = nullptr;
+    std::printf("input log: %lu events over %lu steps\n", events, step);
+  }
+
+  /// Hands every event due before simulation step 'step' to 'apply'. Once
+  /// the log's last step is reached replaying() turns false.
+  template <class Apply> void replayDue(unsigned long step, Apply apply) {
+    if (!replay)
+      return;
+    while (havePending && pendingStep <= step) {
+      apply(pending);
+      events++;
+      havePending = next(pendingStep, pending);
+    }
+    if (!havePending && step >= endStep) {
+      replay = false;
+      std::printf("input log: replayed %lu events over %lu steps\n", events,
+                  endStep);
+    }
+  }
+};
+
+#endif
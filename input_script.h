@@ -0,0 +1,179 @@
+#ifndef INPUT_SCRIPT_H
+#define INPUT_SCRIPT_H
+
+#include "frame_pipeline.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+/*
+  INPUT SCRIPTS
+  Input for runs without a window, one event per line, queued right before
+  the frame it names is drawn:
+
+    <frame> key <code or character>    "0 key 13" is Enter, "40 key y"
+    <frame> special <GLUT_KEY_* code>  "90 special 101" holds Up
+    <frame> special_up <GLUT_KEY_* code>
+    <frame> mouse <x> <y>
+
+  Timelines (see bench/) also drive the world's globals directly:
+
+    <frame> set <var> <value>                 "120 set objIndex 2"
+    <frame> ramp <var> <from> <to> <frames>   a set every frame, linear
+    <frame> ramp mouse <x0> <y0> <x1> <y1> <frames>
+
+  with <var> one of scriptVarNames below. Lines must come in frame order;
+  ramps may overlap later lines. Blank lines and lines starting with '#'
+  are skipped.
+*/
+
+/// Globals a script can set, INPUT_SET's 'key'.
+enum ScriptVar {
+  VAR_X,
+  VAR_Z,
+  VAR_Y,     /// Look height
+  VAR_ANGLE, /// Radians, also turns lx / lz
+  VAR_OBJ_INDEX,
+  VAR_ENTER_PRESSED,
+  VAR_ASSEMBLE,
+  VAR_DISASSEMBLE_SPEED,
+  VAR_COUNT
+};
+
+const char *const scriptVarNames[VAR_COUNT] = {
+    "x",        "z",            "y",        "angle",
+    "objIndex", "enterPressed", "assemble", "disassembleSpeed"};
+
+struct ScriptedInput {
+  unsigned long frame;
+  InputEvent event;
+};
+
+class InputScript {
+private:
+  std::vector<ScriptedInput> events; /// In frame order
+  size_t next = 0;
+
+  static bool parseKey(const char *text, int &key) {
+    if (text[0] && !text[1] && (text[0] < '0' || text[0] > '9')) {
+      key = (unsigned char)text[0];
+      return true;
+    }
+    return std::sscanf(text, "%d", &key) == 1;
+  }
+
+  static bool parseVar(const char *text, int &var) {
+    for (var = 0; var < VAR_COUNT; var++)
+      if (std::strcmp(text, scriptVarNames[var]) == 0)
+        return true;
+    return false;
+  }
+
+  /// "ramp ...": one event per frame from 'frame' on, the last one exact.
+  bool parseRamp(const char *line, unsigned long frame, const char *what) {
+    float from[2], to[2];
+    int frames;
+    InputEvent e = {INPUT_SET, 0, 0, 0, 0.0f};
+    if (std::strcmp(what, "mouse") == 0) {
+      e.type = INPUT_MOUSE;
+      if (std::sscanf(line, "%*s %*s %*s %f %f %f %f %d", &from[0], &from[1],
+                      &to[0], &to[1], &frames) != 5)
+        return false;
+    } else {
+      if (!parseVar(what, e.key) ||
+          std::sscanf(line, "%*s %*s %*s %f %f %d", &from[0], &to[0],
+                      &frames) != 3)
+        return false;
+      from[1] = to[1] = 0.0f;
+    }
+    if (frames < 1)
+      return false;
+    for (int i = 1; i <= frames; i++) {
+      float t = (float)i / frames;
+      float a = from[0] + (to[0] - from[0]) * t;
+      float b = from[1] + (to[1] - from[1]) * t;
+      e.value = a;
+      e.x = (int)(a + 0.5f);
+      e.y = (int)(b + 0.5f);
+      ScriptedInput in = {frame + i - 1, e};
+      events.push_back(in);
+    }
+    return true;
+  }
+
+public:
+  /// False (with a message) if 'path' can't be read or has a bad line.
+  bool load(const char *path) {
+    FILE *f = std::fopen(path, "r");
+    if (!f) {
+      std::fprintf(stderr, "Can't open input script '%s'\n", path);
+      return false;
+    }
+    events.clear();
+    next = 0;
+    char line[256];
+    int lineNo = 0;
+    unsigned long lastLine = 0;
+    bool ok = true;
+    while (ok && std::fgets(line, sizeof(line), f)) {
+      lineNo++;
+      char type[32] = "", a[32] = "";
+      unsigned long frame;
+      int fields = std::sscanf(line, "%lu %31s %31s", &frame, type, a);
+      if (fields <= 0 || line[0] == '#')
+        continue;
+
+      ScriptedInput in = {frame, {INPUT_KEY, 0, 0, 0, 0.0f}};
+      bool single = true;
+      if (fields == 3 && std::strcmp(type, "key") == 0)
+        ok = parseKey(a, in.event.key);
+      else if (fields == 3 && std::strcmp(type, "special") == 0) {
+        in.event.type = INPUT_SPECIAL;
+        ok = std::sscanf(a, "%d", &in.event.key) == 1;
+      } else if (fields == 3 && std::strcmp(type, "special_up") == 0) {
+        in.event.type = INPUT_SPECIAL_UP;
+        ok = std::sscanf(a, "%d", &in.event.key) == 1;
+      } else if (std::strcmp(type, "mouse") == 0) {
+        in.event.type = INPUT_MOUSE;
+        ok = std::sscanf(line, "%*s %*s %d %d", &in.event.x, &in.event.y) == 2;
+      } else if (fields == 3 && std::strcmp(type, "set") == 0) {
+        in.event.type = INPUT_SET;
+        ok = parseVar(a, in.event.key) &&
+             std::sscanf(line, "%*s %*s %*s %f", &in.event.value) == 1;
+      } else if (fields == 3 && std::strcmp(type, "ramp") == 0) {
+        ok = parseRamp(line, frame, a);
+        single = false;
+      } else
+        ok = false;
+      if (ok && frame < lastLine)
+        ok = false; // Keep the file in frame order
+      lastLine = frame;
+      if (ok && single)
+        events.push_back(in);
+      else if (!ok)
+        std::fprintf(stderr, "%s:%d: bad input line: %s", path, lineNo, line);
+    }
+    std::fclose(f);
+    // Ramps run on past the lines that follow them.
+    std::stable_sort(events.begin(), events.end(),
+                     [](const ScriptedInput &l, const ScriptedInput &r) {
+                       return l.frame < r.frame;
+                     });
+    return ok;
+  }
+
+  /// Frame of the last event (0 for an empty script).
+  unsigned long lastFrame() const {
+    return events.empty() ? 0 : events.back().frame;
+  }
+
+  /// Queues every event for frames up to and including 'frame'.
+  void queueDue(unsigned long frame, InputQueue &queue) {
+    for (; next < events.size() && events[next].frame <= frame; next++)
+      queue.push(events[next].event);
+  }
+};
+
+#endif
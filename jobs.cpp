@@ -0,0 +1,123 @@
+#include "jobs.h"
+#include "trace.h"
+
+namespace jobs {
+
+Pool::Pool(unsigned int workers) : pending(0) {
+	if (workers == 0) workers = std::thread::hardware_concurrency();
+	if (workers == 0) workers = 1;
+	for (unsigned int i = 0; i < workers; i++) queues.push_back(new Queue());
+	for (unsigned int i = 1; i < workers; i++) threads.emplace_back(&Pool::worker_main, this, i);
+}
+
+Pool::~Pool() {
+	{
+		std::lock_guard<std::mutex> guard(wakeLock);
+		quit = true;
+	}
+	wake.notify_all();
+	for (size_t i = 0; i < threads.size(); i++) threads[i].join();
+	for (size_t i = 0; i < queues.size(); i++) delete queues[i];
+}
+
+void Pool::parallel_for(size_t count, TaskFn fn, void* ctx) {
+	if (count == 0) return;
+	pending.store(count, std::memory_order_relaxed);
+
+	// Deal the tasks out round-robin; stealing evens out whatever the
+	// uneven task sizes undo.
+	unsigned int n = size();
+	for (unsigned int q = 0; q < n; q++) {
+		Queue& queue = *queues[q];
+		std::lock_guard<std::mutex> guard(queue.lock);
+		queue.tasks.clear(); // Drained by the last batch
+		queue.front = 0;
+		for (size_t i = q; i < count; i += n) queue.tasks.push_back(Task{fn, ctx, i});
+	}
+	if (n > 1) {
+		{
+			std::lock_guard<std::mutex> guard(wakeLock);
+			generation++;
+		}
+		wake.notify_all();
+	}
+
+	drain(0);
+
+	std::unique_lock<std::mutex> guard(wakeLock);
+	done.wait(guard, [this] { return pending.load(std::memory_order_acquire) == 0; });
+}
+
+bool Pool::pop(unsigned int self, Task& out) {
+	{
+		Queue& own = *queues[self];
+		std::lock_guard<std::mutex> guard(own.lock);
+		if (!own.empty()) {
+			out = own.tasks.back();
+			own.tasks.pop_back();
+			own.stats.tasks++;
+			return true;
+		}
+	}
+	unsigned int n = size();
+	for (unsigned int i = 1; i < n; i++) {
+		Queue& victim = *queues[(self + i) % n];
+		{
+			std::lock_guard<std::mutex> guard(victim.lock);
+			if (victim.empty()) continue;
+			out = victim.tasks[victim.front++];
+		}
+		// Never hold two queue locks at once: two thieves robbing each
+		// other would deadlock.
+		Queue& own = *queues[self];
+		std::lock_guard<std::mutex> guard(own.lock);
+		own.stats.tasks++;
+		own.stats.steals++;
+		return true;
+	}
+	return false;
+}
+
+void Pool::drain(unsigned int self) {
+	Task task;
+	while (pop(self, task)) {
+		task.fn(task.ctx, task.index);
+		if (pending.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+			std::lock_guard<std::mutex> guard(wakeLock);
+			done.notify_all();
+		}
+	}
+}
+
+void Pool::worker_main(unsigned int self) {
+	trace::name_thread("jobs worker");
+	unsigned long seen = 0;
+	while (true) {
+		{
+			std::unique_lock<std::mutex> guard(wakeLock);
+			wake.wait(guard, [&] { return quit || generation != seen; });
+			if (quit) return;
+			seen = generation;
+		}
+		drain(self);
+	}
+}
+
+Stats Pool::stats() const {
+	Stats total;
+	for (size_t i = 0; i < queues.size(); i++) {
+		std::lock_guard<std::mutex> guard(queues[i]->lock);
+		total.tasks += queues[i]->stats.tasks;
+		total.steals += queues[i]->stats.steals;
+	}
+	return total;
+}
+
+void Pool::reset_stats() {
+	for (size_t i = 0; i < queues.size(); i++) {
+		std::lock_guard<std::mutex> guard(queues[i]->lock);
+		queues[i]->stats = Stats();
+	}
+}
+
+} // namespace jobs
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace jobs {
+
+// Small work-stealing pool for fanning a batch of independent tasks out
+// over a few threads. Every participant owns a deque: it takes work from
+// the back of its own and, when that runs dry, steals from the front of
+// the others. The thread calling parallel_for() is participant 0 and
+// works too, so a pool of size 1 runs everything inline. The deques are
+// vectors with a front index, so a batch reuses the last one's memory.
+
+typedef void (*TaskFn)(void* ctx, size_t index);
+
+struct Stats {
+	unsigned long tasks = 0;  // Tasks run
+	unsigned long steals = 0; // ...of which were taken from another deque
+};
+
+class Pool {
+public:
+	// 'workers' counts the calling thread; 0 picks the core count.
+	explicit Pool(unsigned int workers = 0);
+	~Pool();
+
+	Pool(const Pool&) = delete;
+	Pool& operator=(const Pool&) = delete;
+
+	unsigned int size() const { return (unsigned int)queues.size(); }
+
+	// Runs fn(ctx, i) for every i in [0, count) and returns once all have
+	// finished. Only one thread may call this at a time.
+	void parallel_for(size_t count, TaskFn fn, void* ctx);
+
+	template <typename F>
+	void parallel_for(size_t count, const F& f) {
+		parallel_for(count, &call<F>, const_cast<F*>(&f));
+	}
+
+	// Totals since construction or the last reset_stats().
+	Stats stats() const;
+	void reset_stats();
+
+private:
+	struct Task {
+		TaskFn fn;
+		void* ctx;
+		size_t index;
+	};
+
+	struct Queue {
+		std::mutex lock;
+		std::vector<Task> tasks;
+		size_t front = 0; // tasks before it were stolen
+		Stats stats;
+
+		bool empty() const { return front == tasks.size(); }
+	};
+
+	std::vector<Queue*> queues;
+	std::vector<std::thread> threads;
+
+	std::mutex wakeLock;
+	std::condition_variable wake, done;
+	unsigned long generation = 0;
+	bool quit = false;
+	std::atomic<size_t> pending;
+
+	template <typename F>
+	static void call(void* ctx, size_t index) {
+		(*static_cast<F*>(ctx))(index);
+	}
+
+	bool pop(unsigned int self, Task& out);
+	void drain(unsigned int self);
+	void worker_main(unsigned int self);
+};
+
+} // namespace jobs
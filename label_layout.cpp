@@ -0,0 +1,120 @@
+#include "label_layout.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace labels {
+
+namespace {
+
+// Where a label may go: a direction from the anchor and a gap between the
+// anchor and the box's nearest edge, nearest spots first. Above the anchor
+// before below it, so a leader line does not cross the part it names.
+const int DIRECTIONS = 8;
+const float DIRECTION[DIRECTIONS][2] = {
+	{0, 1}, {1, 1}, {-1, 1}, {1, 0}, {-1, 0}, {1, -1}, {-1, -1}, {0, -1}};
+const int GAPS = 3;
+const float GAP[GAPS] = {16.0f, 48.0f, 96.0f}; // Pixels
+const int SPOTS = DIRECTIONS * GAPS;
+
+static Box spot_box(const Label& l, int spot) {
+	const float* d = DIRECTION[spot % DIRECTIONS];
+	float gap = GAP[spot / DIRECTIONS];
+	float cx = l.anchor[0] + d[0] * (l.size[0] * 0.5f + gap);
+	float cy = l.anchor[1] + d[1] * (l.size[1] * 0.5f + gap);
+	Box b = {{cx - l.size[0] * 0.5f, cy - l.size[1] * 0.5f}, {cx + l.size[0] * 0.5f, cy + l.size[1] * 0.5f}};
+	return b;
+}
+
+static Box empty_box() {
+	Box b = {{1.0f, 1.0f}, {0.0f, 0.0f}};
+	return b;
+}
+
+static bool overlap(const Box& a, const Box& b) {
+	return a.min[0] < b.max[0] && b.min[0] < a.max[0] && a.min[1] < b.max[1] && b.min[1] < a.max[1];
+}
+
+} // namespace
+
+void Layout::solve(const Label* labels, size_t count, int w, int h) {
+	// Vectors only grow, so a steady label count allocates nothing
+	boxes.resize(count);
+	spot.resize(count, -1);
+	order.clear();
+	overlapTests = 0;
+
+	// Cells as wide as the widest label and as high as the highest: a box
+	// then covers at most 2 x 2, and a cell holds few boxes even when the
+	// labels are long lines of text
+	cellSize[0] = cellSize[1] = 1.0f;
+	for (size_t i = 0; i < count; i++) {
+		if (!labels[i].visible) continue;
+		cellSize[0] = std::max(cellSize[0], labels[i].size[0]);
+		cellSize[1] = std::max(cellSize[1], labels[i].size[1]);
+	}
+	cellsX = std::max(1, (int)std::ceil(w / cellSize[0]));
+	cellsY = std::max(1, (int)std::ceil(h / cellSize[1]));
+	cells.assign((size_t)cellsX * cellsY, -1);
+	entries.clear();
+
+	// Last frame's labels first, so a new one cannot push out an old one
+	for (size_t i = 0; i < count; i++) {
+		boxes[i] = empty_box();
+		if (!labels[i].visible) spot[i] = -1;
+		else if (spot[i] >= 0) order.push_back((int)i);
+	}
+	for (size_t i = 0; i < count; i++)
+		if (labels[i].visible && spot[i] < 0) order.push_back((int)i);
+
+	for (int i : order) {
+		const Label& l = labels[i];
+		int last = spot[i];
+		spot[i] = -1;
+		for (int k = last >= 0 ? -1 : 0; k < SPOTS; k++) {
+			int s = k < 0 ? last : k;
+			if (k == last) continue; // Tried first
+			Box b = spot_box(l, s);
+			if (!fits(b, w, h)) continue;
+			boxes[i] = b;
+			spot[i] = s;
+			insert(i);
+			break;
+		}
+	}
+}
+
+void Layout::cell_range(const Box& b, int& x0, int& y0, int& x1, int& y1) const {
+	x0 = std::min((int)(b.min[0] / cellSize[0]), cellsX - 1);
+	x1 = std::min((int)(b.max[0] / cellSize[0]), cellsX - 1);
+	y0 = std::min((int)(b.min[1] / cellSize[1]), cellsY - 1);
+	y1 = std::min((int)(b.max[1] / cellSize[1]), cellsY - 1);
+}
+
+bool Layout::fits(const Box& b, int w, int h) {
+	if (b.min[0] < 0.0f || b.min[1] < 0.0f || b.max[0] > w || b.max[1] > h) return false;
+	int x0, y0, x1, y1;
+	cell_range(b, x0, y0, x1, y1);
+	for (int y = y0; y <= y1; y++)
+		for (int x = x0; x <= x1; x++)
+			for (int e = cells[y * cellsX + x]; e >= 0; e = entries[e].next) {
+				overlapTests++;
+				if (overlap(b, boxes[entries[e].box])) return false;
+			}
+	return true;
+}
+
+void Layout::insert(int label) {
+	const Box& b = boxes[label];
+	int x0, y0, x1, y1;
+	cell_range(b, x0, y0, x1, y1);
+	for (int y = y0; y <= y1; y++)
+		for (int x = x0; x <= x1; x++) {
+			int& head = cells[y * cellsX + x];
+			Entry e = {label, head};
+			head = (int)entries.size();
+			entries.push_back(e);
+		}
+}
+
+} // namespace labels
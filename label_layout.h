@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+namespace labels {
+
+// Screen-space placement of many labels at once, for views that label every
+// part (F5). A label is a box of known size that wants to sit next to its
+// anchor: the layout tries a fixed ring of spots around the anchor, nearest
+// first, and keeps the first one that stays in the window and overlaps no
+// label placed before it, or leaves the label out. Overlaps are tested
+// through a uniform grid of the boxes placed so far, so a frame costs
+// O(labels) tests rather than O(labels^2). Each frame starts from the last
+// one's solution: labels placed then go first and try their old spot first,
+// so a still scene takes one test per label and labels don't hop around.
+
+struct Label {
+	float anchor[2]; // Window pixels, origin bottom left
+	float size[2];   // Box width and height, pixels
+	bool visible;    // False: left out this frame
+};
+
+struct Box {
+	float min[2], max[2]; // Window pixels; empty (min > max) if left out
+};
+
+class Layout {
+public:
+	// Lays out 'count' labels in a w x h window. Label i must be the same
+	// label from one frame to the next for the previous solution to help.
+	void solve(const Label* labels, size_t count, int w, int h);
+
+	const Box& box(size_t i) const { return boxes[i]; }
+	bool placed(size_t i) const { return boxes[i].min[0] <= boxes[i].max[0]; }
+
+	// Box against box overlap tests the last solve() made.
+	size_t tests() const { return overlapTests; }
+
+private:
+	struct Entry {
+		int box;  // Label index
+		int next; // Next entry in the same cell, -1 at the end
+	};
+
+	std::vector<Box> boxes;
+	std::vector<int> spot;   // By label: ring spot it took last, -1 if none
+	std::vector<int> order;  // Labels in the order they are placed
+	std::vector<int> cells;  // Grid: first entry of each cell, -1 if empty
+	std::vector<Entry> entries;
+	int cellsX = 0, cellsY = 0;
+	float cellSize[2] = {1.0f, 1.0f};
+	size_t overlapTests = 0;
+
+	// Cells box 'b' covers; it must be in the window
+	void cell_range(const Box& b, int& x0, int& y0, int& x1, int& y1) const;
+	bool fits(const Box& b, int w, int h);
+	void insert(int label);
+};
+
+} // namespace labels
@@ -1,3 +1,4 @@
+#include "gfx.h"
 #include "gl_includes.h"
 
 GLfloat lamp1[4] = {0., 0.4, 0., 1.};
@@ -7,15 +8,7 @@ GLfloat black[4] = {.0, 0., 0., 0.};
 GLfloat dir[3] = {0., -1., 0.1};
 
 void show_light_effect() {
-
-  glEnable(GL_LIGHTING);
-
-  glEnable(GL_LIGHT0);
-  glLightfv(GL_LIGHT0, GL_POSITION, lamp1);
-  glLightfv(GL_LIGHT0, GL_DIFFUSE, white);
-  glLightfv(GL_LIGHT0, GL_SPECULAR, black);
-
-  glEnable(GL_COLOR_MATERIAL);
-  glColorMaterial(GL_FRONT, GL_AMBIENT_AND_DIFFUSE);
-  glMaterialfv(GL_FRONT, GL_SPECULAR, black);
-}
\ No newline at end of file
+  // Positioned while the modelview is identity: the lamp rides with the
+  // camera. Surfaces take ambient & diffuse from their colour.
+  gfx::set_light(lamp1, white);
+}
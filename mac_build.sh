@@ -14,15 +14,16 @@ fi
 # -framework GLUT: Standard GLUT
 # -framework OpenAL: Audio
 # -DUSE_OPENAL: Activates the audio code in audio.cpp
+# -pthread: Simulation, frame build and recording pool threads
 # -Wno-deprecated-declarations: Suppress warnings about OpenGL/OpenAL deprecation on Mac
 # Use /usr/bin/clang++ to ensure we use the system compiler which should have correct SDK paths
-/usr/bin/clang++ -o DesktopSimulation main.cpp audio.cpp \
+/usr/bin/clang++ -o DesktopSimulation main.cpp alloc_track.cpp audio.cpp bvh.cpp capture.cpp gfx.cpp gfx_gl3.cpp gfx_replay.cpp gfx_soft.cpp headless.cpp hud.cpp jobs.cpp label_layout.cpp metrics.cpp profiler.cpp trace.cpp \
     -framework OpenGL \
     -framework GLUT \
     -framework OpenAL \
     -DUSE_OPENAL \
     -Wno-deprecated-declarations \
-    -std=c++11
+    -std=c++11 -pthread
 
 if [ $? -eq 0 ]; then
     echo "Build successful! Executable is 'DesktopSimulation'"
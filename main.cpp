@@ -9,177 +9,975 @@ project. Any improvements made will be accepted, mail the code to :
 adarshrevankar0123@gmail.com
 */
 #include "gl_includes.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
 #include <cstdlib>
+#include <cstring>
 #include <iostream>
+#include <string>
+#ifdef __linux__
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
 
+#include "alloc_track.h"
 #include "audio.h"
 #include "bitmap.h"
+#include "capture.h"
+#include "frame_pipeline.h"
+#include "gfx.h"
+#include "headless.h"
+#include "hud.h"
+#include "input_log.h"
+#include "input_script.h"
+#include "jobs.h"
 #include "light.h"
+#include "metrics.h"
+#include "profiler.h"
+#include "sim_clock.h"
 #include "tooltip.h"
+#include "trace.h"
 
 TooltipSystem tooltipSystem;
+SimClock simClock;
 #include "motion.h"
+#include "micro_bench.h"
 #include "objects.h"
 #include "parameter.h"
+#include "part_picker.h"
+#include "scene_record.h"
 
 /* TEXTURE HANDLING */
 void loadTexture(GLuint texture, const char *filename) {
+  trace::Scope timing("load texture", "load", filename);
   BmpLoader image(filename);
-  glBindTexture(GL_TEXTURE_2D, texture);
-
-  glTexEnvf(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_MODULATE);
-  glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER,
-                  GL_LINEAR_MIPMAP_NEAREST);
-  glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-  glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-  glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-
-  gluBuild2DMipmaps(GL_TEXTURE_2D, GL_RGB, image.iWidth, image.iHeight, GL_RGB,
-                    GL_UNSIGNED_BYTE, image.data);
+  metrics::asset_loaded(metrics::ASSET_TEXTURE,
+                        image.iWidth > 0 && image.iHeight > 0);
+  gfx::upload_texture(texture, image.iWidth, image.iHeight, image.data);
 }
 
 void textureInit() {
+  PROF_SCOPE("load textures");
   // Create Texture.
   textures = new GLuint[NUM_TEXTURE];
-  glGenTextures(NUM_TEXTURE, textures);
+  for (int i = 0; i < NUM_TEXTURE; i++)
+    textures[i] = gfx::create_texture();
 
   // Load the Texture.
   for (int i = 0; i < NUM_TEXTURE; i++)
     loadTexture(textures[i], texPath[i]);
 }
 
-/* REDNDERING HANDLING */
-void change_size(int w, int h) {
-  // Update global parameters
-  width = w;
-  hight = h;
-  // Do reshape
-  glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-  float ratio = 0.0f;
-  h = h == 0 ? 1 : h;
-  ratio = (float)w / (float)h;
-  glViewport(0, 0, w, h);
-  glMatrixMode(GL_PROJECTION);
-  glLoadIdentity();
-  gluPerspective(80.0f, ratio, 0.7f, 100.0f);
-  glMatrixMode(GL_MODELVIEW);
+/* SIMULATION HANDLING (simulation thread) */
+/// INPUT_SET from a timeline script: drives a global directly.
+void setScriptVar(int var, float value) {
+  switch (var) {
+  case VAR_X:
+    x = value;
+    break;
+  case VAR_Z:
+    z = value;
+    break;
+  case VAR_Y:
+    y = value;
+    break;
+  case VAR_ANGLE:
+    angle = value;
+    lx = sin(angle);
+    lz = -cos(angle);
+    break;
+  case VAR_OBJ_INDEX:
+    objIndex = (int)floor(value + 0.5f);
+    break;
+  case VAR_ENTER_PRESSED:
+    enterPressed = value != 0.0f;
+    break;
+  case VAR_ASSEMBLE:
+    assemble = value != 0.0f;
+    break;
+  case VAR_DISASSEMBLE_SPEED:
+    disassembleSpeed = value;
+    break;
+  }
 }
 
-void renderScene() {
-  glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-  glLoadIdentity();
-  gluLookAt(x, 5.0f, z, x + lx, y, z + lz, 0.0f, 1.0f, 0.0f);
+/// Applies one GLUT, script or logged event to the simulation state.
+void dispatchInput(const InputEvent &e) {
+  if (trace::recording()) {
+    static const char *names[] = {"key",   "key up", "special", "special up",
+                                  "mouse", "resize", "set"};
+    char detail[32];
+    if (e.type == INPUT_MOUSE || e.type == INPUT_RESIZE)
+      std::snprintf(detail, sizeof(detail), "%d %d", e.x, e.y);
+    else if (e.type == INPUT_SET)
+      std::snprintf(detail, sizeof(detail), "%s %g", scriptVarNames[e.key],
+                    e.value);
+    else
+      std::snprintf(detail, sizeof(detail), "%d", e.key);
+    trace::instant(names[e.type], "input", detail);
+  }
+  switch (e.type) {
+  case INPUT_KEY:
+    processNormalKeys((unsigned char)e.key, e.x, e.y);
+    break;
+  case INPUT_SPECIAL:
+    processSpecialKeys(e.key, e.x, e.y);
+    break;
+  case INPUT_SPECIAL_UP:
+    processSpecialUpKeys(e.key, e.x, e.y);
+    break;
+  case INPUT_MOUSE:
+    mouse_follow(e.x, e.y);
+    break;
+  case INPUT_RESIZE:
+    width = e.x;
+    hight = e.y;
+    break;
+  case INPUT_SET:
+    setScriptVar(e.key, e.value);
+    break;
+  }
+}
+
+InputLog inputLog;          /// --record-input / --replay-input
+unsigned long simSteps = 0; /// Steps simulate() has run
+
+/// Queued input, from the pipeline: logged as it is applied, or dropped
+/// while a log replays.
+void applyInput(const InputEvent &e) {
+  if (inputLog.replaying())
+    return;
+  inputLog.log(simSteps, e);
+  dispatchInput(e);
+}
+
+/// One fixed SIM_DT step of the world: camera, disassembly, loading wheel.
+void simulate() {
+  PROF_SCOPE("simulate");
+  inputLog.replayDue(simSteps, dispatchInput);
+  updateCamera(simClock.now());
+  if (page == 1) {
+    cpuView();
+    updateCPU();
+  } else
+    advance_progress_wheel(SIM_DT);
 
   // 3D audio listener follows the camera.
   audio::update_listener({(float)x, 5.0f, (float)z},
-                         {(float)lx, (float)(y - 5.0), (float)lz},
-                         {0.0f, 1.0f, 0.0f});
+                         {lx, (float)(y - 5.0), lz}, {0.0f, 1.0f, 0.0f});
+  audio::update();
+  simSteps++;
+}
+
+
+void takeSnapshot(FrameSnapshot &s) {
+  s.cameraPrev = prevCamera;
+  s.camera = cameraState();
+  snapshotCPU(s.parts);
+  s.page = page;
+  s.objIndex = objIndex;
+  s.prompt = cpuPrompt;
+  s.progress = prog;
+  s.width = width;
+  s.height = hight;
+  s.mouseX = mouseGlobalX;
+  s.mouseY = mouseGlobalY;
+}
+
+/* FRAME BUILDING (build thread) */
+jobs::Pool *recordPool = nullptr; /// Records CPU view jobs, see scene_record.h
+unsigned rasterWorkers = 0;        /// Software renderer tile pool size
+SceneRecorder sceneRecorder;
+
+/// Where the scene camera is and looks at for snapshot 's', blended 't'
+/// past its previous step. recordScene() places the view from here, and
+/// picking its own copy (see drawTooltips()), so the two can't disagree.
+void sceneView(const FrameSnapshot &s, float t, float eye[3],
+               float center[3]) {
+  CameraState cam = lerp(s.cameraPrev, s.camera, t);
+  eye[0] = cam.x;
+  eye[1] = 5.0f;
+  eye[2] = cam.z;
+  center[0] = cam.x + cam.lx;
+  center[1] = cam.y;
+  center[2] = cam.z + cam.lz;
+}
+
+/// Records the whole scene for snapshot 's', blended 't' past its previous
+/// step. Reads nothing but the snapshot.
+void recordScene(const FrameSnapshot &s, float t, gfx::CommandList &out) {
+  PROF_SCOPE("record scene");
+  out.clear();
+  gfx::record_into(&out);
+
+  float eye[3], center[3];
+  sceneView(s, t, eye, center);
+  gfx::load_identity();
+  gfx::look_at(eye[0], eye[1], eye[2], center[0], center[1], center[2]);
+
+  if (s.page == 0) {
+    front_page(s.width, s.height);
+    progress_wheel(s.width, s.height, s.progress);
+  }
+  gfx::record_into(nullptr);
+
+  if (s.page == 1)
+    sceneRecorder.record(s, t, *recordPool, out);
+}
+
+/// --record-bench [copies]: times recording the CPU view, 'copies' rooms
+/// big, with 1, 2, 4 and 8 workers. Needs no window.
+void recordBench(int copies) {
+  textures = new GLuint[NUM_TEXTURE](); // No GL: texture names stay 0
+  FrameSnapshot s;
+  takeSnapshot(s);
+  s.page = 1;
+  s.cameraPrev = s.camera;
+
+  const int workerCounts[] = {1, 2, 4, 8};
+  const int frames = 200;
+  double serialMs = 0.0;
+  gfx::CommandList out;
+  std::printf("recording %d room(s), %d jobs each, %u core(s)\n", copies,
+              SCENE_JOB_COUNT, std::thread::hardware_concurrency());
+  for (int w : workerCounts) {
+    jobs::Pool pool(w);
+    SceneRecorder recorder;
+    for (int i = 0; i < 20; i++) { // Warm up buffers
+      out.clear();
+      recorder.record(s, 1.0f, pool, out, copies);
+    }
+    pool.reset_stats();
+
+    std::chrono::steady_clock::time_point start =
+        std::chrono::steady_clock::now();
+    for (int i = 0; i < frames; i++) {
+      out.clear();
+      recorder.record(s, 1.0f, pool, out, copies);
+    }
+    double ms = std::chrono::duration<double, std::milli>(
+                    std::chrono::steady_clock::now() - start)
+                    .count() /
+                frames;
+    if (w == 1)
+      serialMs = ms;
+    jobs::Stats stats = pool.stats();
+    std::printf("%d worker(s): %8.3f ms/frame  x%.2f  %zu commands  "
+                "%.1f steals/frame\n",
+                w, ms, serialMs / ms, out.size(),
+                (double)stats.steals / frames);
+  }
+}
+
+FramePipeline pipeline(simClock, applyInput, simulate, takeSnapshot,
+                       recordScene);
+
+/* REDNDERING HANDLING (GL thread) */
+gfx::Camera pickCamera; /// The scene camera, for picking (see drawTooltips())
+
+void change_size(int w, int h) {
+  InputEvent e = {INPUT_RESIZE, 0, w, h};
+  pipeline.input.push(e);
+  // Do reshape
+  gfx::clear();
+  gfx::resize(w, h, 80.0f, 0.7f, 100.0f);
+  pickCamera.resize(w, h, 80.0f, 0.7f, 100.0f);
+  capture::resize(w, h);
+}
+
+void queueKey(unsigned char key, int x, int y) {
+  InputEvent e = {INPUT_KEY, key, x, y};
+  pipeline.input.push(e);
+}
+
+void queueSpecialKey(int key, int x, int y) {
+  InputEvent e = {INPUT_SPECIAL, key, x, y};
+  pipeline.input.push(e);
+}
+
+void queueSpecialUpKey(int key, int x, int y) {
+  InputEvent e = {INPUT_SPECIAL_UP, key, x, y};
+  pipeline.input.push(e);
+}
+
+void queueMouse(int x, int y) {
+  InputEvent e = {INPUT_MOUSE, 0, x, y};
+  pipeline.input.push(e);
+}
+
+gfx::CommandList tooltipOverlay;
+
+/// A labelled part: its tooltip handle and where the label sits while the
+/// part is in place. The part's offset moves it from there.
+struct PartTooltip {
+  int part;
+  ComponentId id;
+  float3 home;
+};
+PartTooltip partTooltips[6];
+PartPicker partPicker; /// Finds the part under the mouse, see part_picker.h
+
+/// Tooltips pick along a ray from the camera's own matrices, so no GL state
+/// is read back, against the parts' triangles. They are updated and recorded
+/// here on the GL thread, right after the scene.
+void drawTooltips(const FrameSnapshot &s, float t, float dt) {
+  // Update dynamic positions and visibility based on offset
+  for (const PartTooltip &p : partTooltips) {
+    point3D off = s.parts[p.part].at(t);
+    float3 at = {p.home.x + (float)off.x, p.home.y + (float)off.y,
+                 p.home.z + (float)off.z};
+    tooltipSystem.updateComponent(p.id, at, (float)off.x);
+  }
 
   // Update and Draw Tooltips (AR Overlay)
-  // Update and Draw Tooltips (AR Overlay)
-  tooltipSystem.update(mouseGlobalX, mouseGlobalY);
+  float eye[3], center[3];
+  sceneView(s, t, eye, center);
+  {
+    PROF_SCOPE("tooltip update");
+    pickCamera.look_at(eye[0], eye[1], eye[2], center[0], center[1],
+                       center[2]);
+    partPicker.update(s, t);
+    ComponentId under = partPicker.pick(pickCamera.ray(s.mouseX, s.mouseY));
+    // Parts out of sight lose their label. The one under the pointer is in
+    // sight, whatever the few points its test samples say.
+    for (const PartTooltip &p : partTooltips)
+      tooltipSystem.setOccluded(p.id, p.id != under &&
+                                          !partPicker.visible(p.part, eye));
+    tooltipSystem.update(under, dt);
+  }
 
-  if (page == 1) {
-    drawGround();
-    drawCube();
-    cpuView();
-    drawCPU();
-
-    // Update dynamic positions and visibility based on offset
-    point3D gpuOff = gpu_.getOffset();
-    tooltipSystem.updateComponent("NVIDIA GTX Graphics", 7.55f + gpuOff.x,
-                                  4.2f + gpuOff.y, -4.65f + gpuOff.z, gpuOff.x);
-
-    point3D fanOff = fan_.getOffset();
-    // Fan position: glTranslatef(-0.974, .52, -0.745) +
-    // glTranslatef(8.72, 4.321, -3.821) = (7.746, 4.841, -4.566)
-    tooltipSystem.updateComponent("CPU Cooling Unit", 7.746f + fanOff.x,
-                                  4.841f + fanOff.y, -4.566f + fanOff.z,
-                                  fanOff.x);
-
-    point3D ramOff = ram_.getOffset();
-    // RAM renders in 3 spots, we track the main one or the one that moves first
-    tooltipSystem.updateComponent("DDR4 RAM", 8.0f + ramOff.x, 4.8f + ramOff.y,
-                                  -4.3f + ramOff.z, ramOff.x);
-
-    point3D psuOff = psu_.getOffset();
-    tooltipSystem.updateComponent("Power Supply", 8.0f + psuOff.x,
-                                  3.4f + psuOff.y, -4.79f + psuOff.z, psuOff.x);
-
-    point3D hddOff = harddisk_.getOffset();
-    // HDD has scale factor 0.4, base pos was translated by 1/scale.
-    // The render function: glScalef(0.4...); glTranslatef(8./0.4, 3.86/0.4,
-    // -3.2/0.4); So world position is (8.0, 3.86, -3.2) + offset.
-    tooltipSystem.updateComponent("Hard Disk", 8.0f + hddOff.x,
-                                  3.86f + hddOff.y, -3.2f + hddOff.z, hddOff.x);
-
-    // Processor (chipset) position update
-    point3D chipOff = chipset_.getOffset();
-    tooltipSystem.updateComponent("Processor", 8.0f + chipOff.x,
-                                  4.77f + chipOff.y, -4.7f + chipOff.z,
-                                  chipOff.x);
-
-    // Draw tooltips on top of the CPU view
-    tooltipSystem.draw((float)x, 5.0f, (float)z);
-  } else if (page == 0) {
-    front_page();
-    progress_wheel();
-  }
-  glutSwapBuffers();
-}
-
-void opengl_init(void) {
-  glEnable(GL_DEPTH_TEST);
-  // Optional 3D audio (enabled when built with USE_OPENAL).
-  if (audio::init()) {
-    audio::preload_defaults();
-    std::atexit(audio::shutdown);
+  tooltipOverlay.clear();
+  gfx::record_into(&tooltipOverlay);
+  if (labelAll) {
+    PROF_SCOPE("label layout");
+    tooltipSystem.drawAll(pickCamera);
+  } else {
+    tooltipSystem.draw(eye[0], eye[1], eye[2]);
+  }
+  gfx::record_into(nullptr);
+  PROF_GPU_SCOPE("tooltip submit");
+  gfx::submit(tooltipOverlay);
+}
+
+gfx::CommandList profilerList;
+
+/// The F3 timing table, on top of everything else.
+void drawProfilerOverlay(const FrameSnapshot &s) {
+  profilerList.clear();
+  gfx::record_into(&profilerList);
+  prof::record_overlay(s.width, s.height);
+  gfx::record_into(nullptr);
+  gfx::submit(profilerList);
+}
+
+bool headlessRun = false;       /// No window: see runHeadless()
+unsigned long framesDrawn = 0; /// Frames drawFrame() has finished
+
+void drawFrame(const FrameData &frame) {
+  static std::chrono::steady_clock::time_point lastFrame =
+      std::chrono::steady_clock::now();
+  std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+  float wall = std::chrono::duration<float>(now - lastFrame).count();
+  float dt = simClock.fixed() > 0.0f ? simClock.fixed() : wall;
+  lastFrame = now;
+  hud::add_frame(wall * 1000.0f);
+  metrics::frame(wall * 1000.0f);
+  trace::counter("frame ms", wall * 1000.0f);
+  trace::counter("scene commands", (double)frame.scene.size());
+
+  {
+    PROF_SCOPE("frame");
+    {
+      PROF_GPU_SCOPE("scene submit");
+      gfx::clear();
+      gfx::submit(frame.scene);
+    }
+    if (frame.snapshot.page == 1)
+      drawTooltips(frame.snapshot, frame.t, dt);
+    if (hudOverlay) {
+      PROF_GPU_SCOPE("hud");
+      hud::draw(frame.snapshot.width, frame.snapshot.height);
+    }
+    if (profilerOverlay)
+      drawProfilerOverlay(frame.snapshot);
+    {
+      PROF_GPU_SCOPE("present");
+      gfx::present();
+    }
+    {
+      PROF_SCOPE("capture");
+      capture::frame();
+    }
+    PROF_SCOPE("swap");
+    if (headlessRun)
+      headless::finish_frame();
+    else
+      glutSwapBuffers();
+  }
+  prof::end_frame();
+  alloc::end_frame();
+  framesDrawn++;
+}
+
+const char *profilePath = nullptr; /// --profile
+const char *tracePath = nullptr;   /// --trace
+
+/// F4: starts a trace, or writes the one running and stops it.
+void traceKey() {
+  if (!trace::recording()) {
+    trace::start();
+    std::printf("trace: recording, F4 again to write it\n");
+    return;
+  }
+  trace::write(tracePath ? tracePath : "desksim_trace.json");
+  trace::stop();
+}
+
+/// Flushes what the run wrote out: captured frames, timing report, trace.
+void finishOutputs() {
+  metrics::stop();
+  inputLog.close(simSteps);
+  capture::stop();
+  if (profilePath)
+    prof::export_csv(profilePath);
+  prof::shutdown_gpu();
+  if (tracePath && trace::recording())
+    trace::write(tracePath);
+}
+
+/// Idle: submit whatever the builder finished since last time.
+void renderScene() {
+  if (quitRequested) {
+    pipeline.stop();
+    finishOutputs();
+    exit(0);
   }
+  if (traceRequested.exchange(false))
+    traceKey();
+  const FrameData *frame = pipeline.acquire(8);
+  if (frame)
+    drawFrame(*frame);
+}
+
+/// Expose / redisplay: a new frame if there is one, else the last again.
+void displayScene() {
+  const FrameData *frame = pipeline.acquire(0);
+  if (!frame)
+    frame = pipeline.last();
+  if (frame)
+    drawFrame(*frame);
+}
+
+const char *capturePath = nullptr; /// --capture
+
+/// GL and scene setup, once a context is current. 'loader' resolves GL
+/// entry points for the renderer.
+void opengl_init(gfx::ProcLoader loader) {
+  if (!gfx::init_renderer(loader, rasterWorkers)) {
+    std::cerr << "Renderer '" << gfx::renderer_name(gfx::renderer())
+              << "' is not supported here" << std::endl;
+    exit(1);
+  }
+  int captureFps =
+      simClock.fixed() > 0.0f ? (int)(1.0f / simClock.fixed() + 0.5f) : 60;
+  if (capturePath && !capture::start(capturePath, captureFps, loader))
+    exit(1);
+  prof::init_gpu(loader); // Without timer queries: CPU timings only
+  // Optional 3D audio (enabled when built with USE_OPENAL), brought up in
+  // the background: the first frame doesn't wait for the audio device.
+  audio::init_async();
+  std::atexit(audio::shutdown);
 
   // Register AR Tooltips
   // Positions derived from cpu_gpu.h, cpu_fan.h, etc.
-  tooltipSystem.registerComponent("NVIDIA GTX Graphics", "High performance GPU",
-                                  7.55f, 4.2f, -4.65f, 0.6f);
-  // Fan position: (-0.974 + 8.72, 0.52 + 4.321, -0.745 + -3.821) =
-  // (7.746, 4.841, -4.566)
-  tooltipSystem.registerComponent("CPU Cooling Unit", "Spinning at 2000 RPM",
-                                  7.746f, 4.841f, -4.566f, 0.5f);
-  tooltipSystem.registerComponent("DDR4 RAM", "16GB 3200MHz", 8.0f, 4.8f, -4.3f,
-                                  0.4f);
-  // Processor is behind the fan - only show label after fan is removed
+  const float3 gpuAt = {7.55f, 4.2f, -4.65f};
+  // Fan position: glTranslatef(-0.974, .52, -0.745) +
+  // glTranslatef(8.72, 4.321, -3.821) = (7.746, 4.841, -4.566)
+  const float3 fanAt = {7.746f, 4.841f, -4.566f};
+  // RAM renders in 3 spots, we track the main one or the one that moves first
+  const float3 ramAt = {8.0f, 4.8f, -4.3f};
   // Position: glTranslatef(8., 4.77, -4.7) in cpu_chipset.h
-  tooltipSystem.registerComponent("Processor", "Intel Core i7 CPU", 8.0f, 4.77f,
-                                  -4.7f, 0.3f, "CPU Cooling Unit");
-  // New Components
-  tooltipSystem.registerComponent("Power Supply", "750W Gold Rated", 8.0f, 3.4f,
-                                  -4.79f, 0.6f);
-  tooltipSystem.registerComponent("Hard Disk", "2TB Mechanical Storage", 8.0f,
-                                  3.86f, -3.2f, 0.5f);
+  const float3 chipAt = {8.0f, 4.77f, -4.7f};
+  const float3 psuAt = {8.0f, 3.4f, -4.79f};
+  // HDD has scale factor 0.4, base pos was translated by 1/scale.
+  // The render function: glScalef(0.4...); glTranslatef(8./0.4, 3.86/0.4,
+  // -3.2/0.4); So world position is (8.0, 3.86, -3.2) + offset.
+  const float3 hddAt = {8.0f, 3.86f, -3.2f};
+  ComponentId gpuTip = tooltipSystem.registerComponent(
+      "NVIDIA GTX Graphics", "High performance GPU", gpuAt, 0.6f);
+  ComponentId fanTip = tooltipSystem.registerComponent(
+      "CPU Cooling Unit", "Spinning at 2000 RPM", fanAt, 0.5f);
+  ComponentId ramTip =
+      tooltipSystem.registerComponent("DDR4 RAM", "16GB 3200MHz", ramAt, 0.4f);
+  // Processor is behind the fan - only show label after fan is removed
+  ComponentId chipTip = tooltipSystem.registerComponent(
+      "Processor", "Intel Core i7 CPU", chipAt, 0.3f, fanTip);
+  ComponentId psuTip = tooltipSystem.registerComponent(
+      "Power Supply", "750W Gold Rated", psuAt, 0.6f);
+  ComponentId hddTip = tooltipSystem.registerComponent(
+      "Hard Disk", "2TB Mechanical Storage", hddAt, 0.5f);
+  const PartTooltip tips[] = {
+      {PART_GPU, gpuTip, gpuAt},     {PART_FAN, fanTip, fanAt},
+      {PART_RAM, ramTip, ramAt},     {PART_PSU, psuTip, psuAt},
+      {PART_HDD, hddTip, hddAt},     {PART_CHIPSET, chipTip, chipAt}};
+  std::copy(tips, tips + 6, partTooltips);
 
   textureInit();
-  glutDisplayFunc(renderScene);
+  show_light_effect();
+
+  ComponentId partIds[PART_COUNT];
+  std::fill(partIds, partIds + PART_COUNT, NO_COMPONENT);
+  for (const PartTooltip &p : partTooltips)
+    partIds[p.part] = p.id;
+  partPicker.build(partIds);
+}
+
+void glut_callbacks() {
+  glutDisplayFunc(displayScene);
   glutIdleFunc(renderScene);
   glutReshapeFunc(change_size);
-  glutKeyboardFunc(processNormalKeys);
-  glutSpecialFunc(processSpecialKeys);
-  glutPassiveMotionFunc(mouse_follow); // Track mouse when button IS NOT pressed
-  show_light_effect();
+  // Input is queued for the simulation thread.
+  glutKeyboardFunc(queueKey);
+  glutSpecialFunc(queueSpecialKey);
+  glutSpecialUpFunc(queueSpecialUpKey);
+  glutIgnoreKeyRepeat(1);
+  glutPassiveMotionFunc(queueMouse); // Track mouse when button IS NOT pressed
 }
 
-void setDeltaTime() {
-  int timeSinceStart = glutGet(GLUT_ELAPSED_TIME);
-  deltaTime = (timeSinceStart - oldTimeSinceStart) * 0.2f;
-  oldTimeSinceStart = timeSinceStart;
+/// What runHeadless() measured, one entry per frame drawn.
+struct RunStats {
+  std::vector<double> frameMs;
+  std::vector<gfx::Counters> calls; /// gfx::frame_counters()
+  std::vector<alloc::Counts> allocs; /// alloc::frame_counts()
+  double seconds = 0.0;
+};
+
+bool assertNoAlloc = false; /// --assert-no-alloc
+const unsigned long allocWarmup = 120; /// Frames before the steady state
+
+/// --assert-no-alloc: false, with the scopes that allocated, if frame
+/// 'frame' is past the warm-up and allocated at all, other than in an
+/// alloc::AllowScope (a kept buffer growing to a new largest frame, the
+/// driver compiling a shader variant).
+bool checkFrameAllocs(unsigned long frame) {
+  static std::vector<prof::Stats> scopes;
+  if (assertNoAlloc && scopes.capacity() == 0)
+    scopes.reserve(prof::MAX_SCOPES); // Or the report allocates too
+  alloc::Counts made = alloc::frame_counts();
+  if (!assertNoAlloc || frame <= allocWarmup || made.allocs == made.allowed)
+    return true;
+  static int reported = 0;
+  if (++reported > 5)
+    return false; // The first few say enough
+  prof::stats(scopes);
+  std::fprintf(stderr,
+               "alloc: frame %lu made %lu allocations (%lu bytes, %lu "
+               "allowed)\n",
+               frame, made.allocs, made.bytes, made.allowed);
+  for (const prof::Stats &s : scopes)
+    if (s.allocs.allocs > s.allocs.allowed)
+      std::fprintf(stderr, "alloc:   %*s%s: %lu (%lu bytes, %lu allowed)\n",
+                   2 * s.depth, "", s.name, s.allocs.allocs, s.allocs.bytes,
+                   s.allocs.allowed);
+  return false;
 }
 
+/// Value below which 'p' of the sorted 'values' fall.
+double percentile(const std::vector<double> &sorted, double p) {
+  return sorted[std::min(sorted.size() - 1, (size_t)(p * sorted.size()))];
+}
+
+/// --headless: draws 'frames' frames into a w x h offscreen framebuffer
+/// through the same renderScene() path as the window, feeding 'script'
+/// (if any) as input. Fills 'stats' if given, else prints frame time
+/// statistics.
+int runHeadless(int w, int h, unsigned long frames, InputScript *script,
+                bool threaded, RunStats *stats = nullptr) {
+  if (gfx::renderer() == gfx::RENDERER_LEGACY) {
+    // Legacy text is glutBitmapCharacter, which needs a GLUT window.
+    std::cerr << "--headless needs --renderer gl3 or software" << std::endl;
+    return 1;
+  }
+  if (!headless::create(w, h, gfx::renderer()))
+    return 1;
+  headlessRun = true;
+  gfx::set_windowed(false);
+  opengl_init(headless::proc_loader());
+  change_size(w, h);
+  pipeline.start(threaded);
+
+  RunStats local;
+  RunStats &run = stats ? *stats : local;
+  size_t expected = std::min(frames, 1ul << 16); // Replays: unknown
+  run.frameMs.reserve(expected);
+  if (stats) {
+    run.calls.reserve(expected);
+    run.allocs.reserve(expected);
+  }
+  unsigned long allocFrames = 0; /// Failed checkFrameAllocs()
+  std::chrono::steady_clock::time_point start =
+      std::chrono::steady_clock::now();
+  std::chrono::steady_clock::time_point last = start;
+  bool replay = inputLog.replaying();
+  while (framesDrawn < frames && !quitRequested &&
+         (!replay || inputLog.replaying())) {
+    if (script)
+      script->queueDue(framesDrawn, pipeline.input);
+    unsigned long before = framesDrawn;
+    renderScene();
+    if (framesDrawn == before)
+      continue; // Builder had nothing new yet
+    std::chrono::steady_clock::time_point now =
+        std::chrono::steady_clock::now();
+    run.frameMs.push_back(
+        std::chrono::duration<double, std::milli>(now - last).count());
+    if (stats) {
+      run.calls.push_back(gfx::frame_counters());
+      run.allocs.push_back(alloc::frame_counts());
+    }
+    if (!checkFrameAllocs(framesDrawn))
+      allocFrames++;
+    last = now;
+  }
+  run.seconds = std::chrono::duration<double>(last - start).count();
+  pipeline.stop();
+  finishOutputs();
+  headless::destroy();
+
+  if (allocFrames) {
+    std::fprintf(stderr,
+                 "alloc: %lu frames after the first %lu allocated\n",
+                 allocFrames, allocWarmup);
+    return 1;
+  }
+  if (stats || run.frameMs.empty())
+    return 0;
+  std::vector<double> sorted(run.frameMs);
+  std::sort(sorted.begin(), sorted.end());
+  double sum = 0.0;
+  for (double ms : run.frameMs)
+    sum += ms;
+  std::printf("renderer %s, %dx%d, %s, %zu frames in %.3f s (%.1f fps)\n",
+              gfx::renderer_name(gfx::renderer()), w, h,
+              threaded ? "pipelined" : "serial", run.frameMs.size(),
+              run.seconds, run.frameMs.size() / run.seconds);
+  std::printf("frame ms: mean %.3f  min %.3f  p50 %.3f  p95 %.3f  p99 %.3f  "
+              "max %.3f\n",
+              sum / run.frameMs.size(), sorted.front(),
+              percentile(sorted, 0.50), percentile(sorted, 0.95),
+              percentile(sorted, 0.99), sorted.back());
+  return 0;
+}
+
+#ifdef __linux__
+/// Camera paths --bench runs, each from bench/<name>.txt.
+const char *const benchScenarios[] = {"walk", "approach_case",
+                                      "enter_cpu_view", "disassembly",
+                                      "tooltip_sweep"};
+
+/// One --bench scenario, in a forked child so it starts from the world as
+/// loaded: writes its results as a JSON object to 'out'.
+int runBenchScenario(const char *name, int w, int h, unsigned workers,
+                     FILE *out) {
+  char path[64];
+  std::snprintf(path, sizeof(path), "bench/%s.txt", name);
+  InputScript script;
+  if (!script.load(path))
+    return 1;
+  jobs::Pool pool(workers);
+  recordPool = &pool;
+  rasterWorkers = workers;
+  simClock.setFixedDelta(1.0f / 60.0f); // Same path every run
+
+  RunStats run;
+  if (runHeadless(w, h, script.lastFrame() + 1, &script, false, &run) != 0 ||
+      run.frameMs.empty())
+    return 1;
+  std::vector<double> sorted(run.frameMs);
+  std::sort(sorted.begin(), sorted.end());
+  double sum = 0.0;
+  double callSum[gfx::COUNTER_KINDS] = {};
+  unsigned long callMax[gfx::COUNTER_KINDS] = {};
+  double allocSum = 0.0, allocBytes = 0.0;
+  unsigned long allocMax = 0;
+  for (size_t i = 0; i < run.frameMs.size(); i++) {
+    sum += run.frameMs[i];
+    allocSum += run.allocs[i].allocs;
+    allocBytes += run.allocs[i].bytes;
+    allocMax = std::max(allocMax, run.allocs[i].allocs);
+    for (int k = 0; k < gfx::COUNTER_KINDS; k++) {
+      callSum[k] += run.calls[i].n[k];
+      callMax[k] = std::max(callMax[k], run.calls[i].n[k]);
+    }
+  }
+  size_t frames = run.frameMs.size();
+  std::string calls; // Per frame, absent without counters
+  for (int k = 0; gfx::COUNTERS_ENABLED && k < gfx::COUNTER_KINDS; k++) {
+    char field[96];
+    std::snprintf(field, sizeof(field), "%s\"%s\":{\"mean\":%.1f,\"max\":%lu}",
+                  k ? "," : ",\"gfx_calls\":{", gfx::counter_name(k),
+                  callSum[k] / frames, callMax[k]);
+    calls += field;
+    if (k == gfx::COUNTER_KINDS - 1)
+      calls += "}";
+  }
+  if (alloc::TRACKING_ENABLED) { // Per frame, absent without tracking
+    char field[96];
+    std::snprintf(field, sizeof(field),
+                  ",\"allocs\":{\"mean\":%.1f,\"max\":%lu,\"bytes_mean\":%.0f}",
+                  allocSum / frames, allocMax, allocBytes / frames);
+    calls += field;
+  }
+  struct rusage usage;
+  getrusage(RUSAGE_SELF, &usage); // ru_maxrss is in KB on Linux
+  std::fprintf(out,
+               "{\"name\":\"%s\",\"frames\":%zu,\"seconds\":%.3f,"
+               "\"frame_ms\":{\"mean\":%.3f,\"p50\":%.3f,\"p95\":%.3f,"
+               "\"p99\":%.3f,\"max\":%.3f}%s,"
+               "\"memory_kb\":{\"peak_rss\":%ld}}",
+               name, frames, run.seconds, sum / frames,
+               percentile(sorted, 0.50), percentile(sorted, 0.95),
+               percentile(sorted, 0.99), sorted.back(), calls.c_str(),
+               usage.ru_maxrss);
+  std::printf("%-16s %7zu %8.3f %8.3f %8.3f %8.3f %7.0f %7.1f %9ld\n", name,
+              frames, sum / frames, percentile(sorted, 0.50),
+              percentile(sorted, 0.95), percentile(sorted, 0.99),
+              callSum[gfx::COUNT_DRAWS] / frames, allocSum / frames,
+              usage.ru_maxrss);
+  return 0;
+}
+
+/// --bench OUT.json: every scenario at 60 simulated fps, results to OUT
+/// ("-": stdout) and a summary table on stdout.
+int runBench(const char *outPath, int w, int h, unsigned workers) {
+  std::string scenarios;
+  std::printf("%-16s %7s %8s %8s %8s %8s %7s %7s %9s\n", "scenario",
+              "frames", "mean ms", "p50", "p95", "p99", "draws", "allocs",
+              "rss KB");
+  for (const char *name : benchScenarios) {
+    int fds[2];
+    if (pipe(fds) != 0) {
+      std::perror("pipe");
+      return 1;
+    }
+    std::fflush(stdout); // Or the child flushes our buffer again
+    pid_t child = fork();
+    if (child == 0) {
+      close(fds[0]);
+      FILE *out = fdopen(fds[1], "w");
+      int status = runBenchScenario(name, w, h, workers, out);
+      std::fclose(out);
+      std::fflush(stdout);
+      _exit(status);
+    }
+    close(fds[1]);
+    std::string result;
+    char buf[512];
+    ssize_t n;
+    while ((n = read(fds[0], buf, sizeof(buf))) > 0)
+      result.append(buf, n);
+    close(fds[0]);
+    int status = 1;
+    if (child < 0 || waitpid(child, &status, 0) < 0 || status != 0 ||
+        result.empty()) {
+      std::fprintf(stderr, "bench: scenario '%s' failed\n", name);
+      return 1;
+    }
+    if (!scenarios.empty())
+      scenarios += ",\n    ";
+    scenarios += result;
+  }
+
+  FILE *f = std::strcmp(outPath, "-") == 0 ? stdout : std::fopen(outPath, "w");
+  if (!f) {
+    std::fprintf(stderr, "bench: can't write '%s'\n", outPath);
+    return 1;
+  }
+  std::fprintf(f,
+               "{\"renderer\":\"%s\",\"width\":%d,\"height\":%d,"
+               "\"sim_fps\":60,\n  \"scenarios\":[\n    %s\n  ]}\n",
+               gfx::renderer_name(gfx::renderer()), w, h, scenarios.c_str());
+  if (f != stdout)
+    std::fclose(f);
+  return 0;
+}
+#endif
+
 int main(int argc, char **argv) {
+  // --serial runs simulation, build and submit on the GL thread, in order.
+  // --workers N sets the scene recording and software raster pool sizes
+  // (default: core count).
+  // --renderer legacy|gl3|software picks the GL 1.x, the GL 3.3 core or
+  // the CPU renderer.
+  // --headless WxH renders offscreen, no window or display needed:
+  //   --frames N     frames to draw (default 600)
+  //   --script FILE  input to feed in, see input_script.h
+  //   --fps N        advance the simulation 1/N s per frame instead of by
+  //                  the wall clock; reproducible, implies --serial
+  // --capture PATH writes every frame drawn to disk, see capture.h
+  // --profile FILE writes per-scope frame timings as CSV on exit (F3 shows
+  // them on screen), see profiler.h
+  // --trace FILE records a timeline from the start and writes it on exit
+  // (and on F4) as Chrome trace JSON, see trace.h. Without it F4 starts
+  // one and the next F4 writes desksim_trace.json.
+  // --bench OUT.json runs the camera paths in bench/ headless (at the
+  // --headless size, default 1280x720) and writes frame time percentiles,
+  // gfx calls and allocations per frame and peak memory per path to OUT
+  // ("-": stdout).
+  // Linux only.
+  // --assert-no-alloc fails a --headless or --bench run if a frame after
+  // the first 120 allocates outside an alloc::AllowScope (kept buffers
+  // growing, driver shader compiles), naming the profiler scopes that did;
+  // see alloc_track.h.
+  // --metrics-socket PATH serves live Prometheus metrics (frame times,
+  // dropped frames, memory, asset loads) on a Unix socket, see metrics.h.
+  // --record-input FILE logs the session's input, --replay-input FILE plays
+  // a log back instead of live input (headless: to its end), see
+  // input_log.h. --replay-speed max steps it at --fps (default 60) frames
+  // as fast as they draw instead of in real time.
+  // --micro-bench [filter] times loaders, picking and geometry recording,
+  // see micro_bench.h.
+  bool threaded = true;
+  unsigned workers = 0;
+  int headlessW = 0, headlessH = 0;
+  unsigned long headlessFrames = 600;
+  const char *scriptPath = nullptr;
+  const char *benchPath = nullptr;
+  const char *metricsPath = nullptr;
+  const char *recordInputPath = nullptr, *replayInputPath = nullptr;
+  bool replayMax = false, framesGiven = false;
+  for (int i = 1; i < argc; i++) {
+    if (std::strcmp(argv[i], "--serial") == 0)
+      threaded = false;
+    else if (std::strcmp(argv[i], "--headless") == 0 && i + 1 < argc) {
+      if (std::sscanf(argv[++i], "%dx%d", &headlessW, &headlessH) != 2 ||
+          headlessW <= 0 || headlessH <= 0) {
+        std::cerr << "--headless wants WxH, e.g. 1920x1080" << std::endl;
+        return 1;
+      }
+    } else if (std::strcmp(argv[i], "--frames") == 0 && i + 1 < argc) {
+      headlessFrames = std::strtoul(argv[++i], nullptr, 10);
+      framesGiven = true;
+    }
+    else if (std::strcmp(argv[i], "--script") == 0 && i + 1 < argc)
+      scriptPath = argv[++i];
+    else if (std::strcmp(argv[i], "--capture") == 0 && i + 1 < argc)
+      capturePath = argv[++i];
+    else if (std::strcmp(argv[i], "--profile") == 0 && i + 1 < argc)
+      profilePath = argv[++i];
+    else if (std::strcmp(argv[i], "--trace") == 0 && i + 1 < argc)
+      tracePath = argv[++i];
+    else if (std::strcmp(argv[i], "--assert-no-alloc") == 0)
+      assertNoAlloc = true;
+    else if (std::strcmp(argv[i], "--metrics-socket") == 0 && i + 1 < argc)
+      metricsPath = argv[++i];
+    else if (std::strcmp(argv[i], "--bench") == 0 && i + 1 < argc)
+      benchPath = argv[++i];
+    else if (std::strcmp(argv[i], "--record-input") == 0 && i + 1 < argc)
+      recordInputPath = argv[++i];
+    else if (std::strcmp(argv[i], "--replay-input") == 0 && i + 1 < argc)
+      replayInputPath = argv[++i];
+    else if (std::strcmp(argv[i], "--replay-speed") == 0 && i + 1 < argc) {
+      const char *speed = argv[++i];
+      if (std::strcmp(speed, "max") != 0 &&
+          std::strcmp(speed, "original") != 0) {
+        std::cerr << "--replay-speed wants original or max" << std::endl;
+        return 1;
+      }
+      replayMax = std::strcmp(speed, "max") == 0;
+    }
+    else if (std::strcmp(argv[i], "--fps") == 0 && i + 1 < argc) {
+      simClock.setFixedDelta(1.0f / std::max(1, std::atoi(argv[++i])));
+      threaded = false;
+    }
+    else if (std::strcmp(argv[i], "--workers") == 0 && i + 1 < argc)
+      workers = std::atoi(argv[++i]);
+    else if (std::strcmp(argv[i], "--renderer") == 0 && i + 1 < argc) {
+      gfx::Renderer r;
+      if (!gfx::parse_renderer(argv[++i], r)) {
+        std::cerr << "Unknown renderer '" << argv[i] << "'" << std::endl;
+        return 1;
+      }
+      gfx::set_renderer(r);
+    }
+    else if (std::strcmp(argv[i], "--record-bench") == 0) {
+      recordBench(i + 1 < argc ? std::max(1, std::atoi(argv[i + 1])) : 64);
+      return 0;
+    }
+    else if (std::strcmp(argv[i], "--micro-bench") == 0) {
+      microBench(i + 1 < argc ? argv[i + 1] : nullptr);
+      return 0;
+    }
+  }
+  if (benchPath) {
+#ifdef __linux__
+    // Forks per scenario, so before any worker threads exist.
+    if (gfx::renderer() == gfx::RENDERER_LEGACY)
+      gfx::set_renderer(gfx::RENDERER_GL3);
+    return runBench(benchPath, headlessW > 0 ? headlessW : 1280,
+                    headlessW > 0 ? headlessH : 720, workers);
+#else
+    std::cerr << "--bench needs Linux" << std::endl;
+    return 1;
+#endif
+  }
+  if (recordInputPath && replayInputPath) {
+    std::cerr << "--record-input and --replay-input don't mix" << std::endl;
+    return 1;
+  }
+  if (recordInputPath && !inputLog.record(recordInputPath))
+    return 1;
+  if (replayInputPath) {
+    if (!inputLog.load(replayInputPath))
+      return 1;
+    if (replayMax) {
+      if (simClock.fixed() == 0.0f)
+        simClock.setFixedDelta(1.0f / 60.0f);
+      threaded = false;
+    }
+    if (!framesGiven)
+      headlessFrames = (unsigned long)-1; // Until the log ends
+  }
+  if (metricsPath && !metrics::start(metricsPath))
+    return 1;
+  trace::name_thread("GL");
+  if (tracePath)
+    trace::start();
+  jobs::Pool pool(workers);
+  recordPool = &pool;
+  rasterWorkers = workers;
+
+  if (headlessW > 0) {
+    InputScript script;
+    if (scriptPath && !script.load(scriptPath))
+      return 1;
+    return runHeadless(headlessW, headlessH, headlessFrames,
+                       scriptPath ? &script : nullptr, threaded);
+  }
+
   glutInit(&argc, argv);
-  glutInitDisplayMode(GLUT_DOUBLE | GLUT_RGBA | GLUT_DEPTH);
+  unsigned displayMode = GLUT_DOUBLE | GLUT_RGBA | GLUT_DEPTH;
+  if (gfx::renderer() == gfx::RENDERER_GL3) {
+#ifdef __APPLE__
+    displayMode |= GLUT_3_2_CORE_PROFILE; // Newest core profile available
+#else
+    glutInitContextVersion(3, 3);
+    glutInitContextProfile(GLUT_CORE_PROFILE);
+#endif
+  }
+  glutInitDisplayMode(displayMode);
   glutInitWindowSize(width, hight);
   glutCreateWindow("Graphical Simulation of Desktop & it's Components");
-  opengl_init();
+#ifdef __APPLE__
+  opengl_init(nullptr); // gl3.h prototypes link directly
+#else
+  opengl_init((gfx::ProcLoader)glutGetProcAddress);
+#endif
+  glut_callbacks();
   glutFullScreen();
-  setDeltaTime();
+  pipeline.start(threaded);
   glutMainLoop();
   audio::shutdown();
   getchar();
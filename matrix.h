@@ -0,0 +1,149 @@
+#pragma once
+
+#include <cmath>
+
+namespace gfx {
+
+// 4x4 matrices stored column-major, exactly as GL 1.x keeps its matrix
+// stack, so the results of the helpers below match glTranslatef & co. and
+// can be handed to GL / GLU unchanged.
+struct mat4 {
+	float m[16];
+
+	float& operator()(int row, int col) { return m[col * 4 + row]; }
+	float operator()(int row, int col) const { return m[col * 4 + row]; }
+};
+
+inline mat4 mat4_identity() {
+	mat4 r = {{1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1}};
+	return r;
+}
+
+inline mat4 operator*(const mat4& a, const mat4& b) {
+	mat4 r;
+	for (int col = 0; col < 4; col++) {
+		for (int row = 0; row < 4; row++) {
+			r(row, col) = a(row, 0) * b(0, col) + a(row, 1) * b(1, col) + a(row, 2) * b(2, col) + a(row, 3) * b(3, col);
+		}
+	}
+	return r;
+}
+
+inline mat4 mat4_translate(float x, float y, float z) {
+	mat4 r = mat4_identity();
+	r(0, 3) = x;
+	r(1, 3) = y;
+	r(2, 3) = z;
+	return r;
+}
+
+inline mat4 mat4_scale(float x, float y, float z) {
+	mat4 r = mat4_identity();
+	r(0, 0) = x;
+	r(1, 1) = y;
+	r(2, 2) = z;
+	return r;
+}
+
+// 'degrees' about (x, y, z), as glRotatef.
+inline mat4 mat4_rotate(float degrees, float x, float y, float z) {
+	mat4 r = mat4_identity();
+	float len = std::sqrt(x * x + y * y + z * z);
+	if (len <= 0.0f) return r;
+	x /= len;
+	y /= len;
+	z /= len;
+	float a = degrees * 3.14159265358979f / 180.0f;
+	float c = std::cos(a), s = std::sin(a), t = 1.0f - c;
+	r(0, 0) = x * x * t + c;
+	r(0, 1) = x * y * t - z * s;
+	r(0, 2) = x * z * t + y * s;
+	r(1, 0) = y * x * t + z * s;
+	r(1, 1) = y * y * t + c;
+	r(1, 2) = y * z * t - x * s;
+	r(2, 0) = z * x * t - y * s;
+	r(2, 1) = z * y * t + x * s;
+	r(2, 2) = z * z * t + c;
+	return r;
+}
+
+// As glOrtho; gluOrtho2D is near = -1, far = 1.
+inline mat4 mat4_ortho(float left, float right, float bottom, float top, float zNear, float zFar) {
+	mat4 r = mat4_identity();
+	r(0, 0) = 2.0f / (right - left);
+	r(1, 1) = 2.0f / (top - bottom);
+	r(2, 2) = -2.0f / (zFar - zNear);
+	r(0, 3) = -(right + left) / (right - left);
+	r(1, 3) = -(top + bottom) / (top - bottom);
+	r(2, 3) = -(zFar + zNear) / (zFar - zNear);
+	return r;
+}
+
+// As gluPerspective.
+inline mat4 mat4_perspective(float fovY, float aspect, float zNear, float zFar) {
+	mat4 r = {{0}};
+	float f = 1.0f / std::tan(fovY * 3.14159265358979f / 360.0f);
+	r(0, 0) = f / aspect;
+	r(1, 1) = f;
+	r(2, 2) = (zFar + zNear) / (zNear - zFar);
+	r(2, 3) = 2.0f * zFar * zNear / (zNear - zFar);
+	r(3, 2) = -1.0f;
+	return r;
+}
+
+// As gluLookAt with +Y up.
+inline mat4 mat4_look_at(float eyeX, float eyeY, float eyeZ, float centerX, float centerY, float centerZ) {
+	float f[3] = {centerX - eyeX, centerY - eyeY, centerZ - eyeZ};
+	float fl = std::sqrt(f[0] * f[0] + f[1] * f[1] + f[2] * f[2]);
+	if (fl > 0.0f) {
+		f[0] /= fl;
+		f[1] /= fl;
+		f[2] /= fl;
+	}
+	// side = f x up, up = (0, 1, 0)
+	float s[3] = {-f[2], 0.0f, f[0]};
+	float sl = std::sqrt(s[0] * s[0] + s[2] * s[2]);
+	if (sl > 0.0f) {
+		s[0] /= sl;
+		s[2] /= sl;
+	}
+	// u = s x f
+	float u[3] = {s[1] * f[2] - s[2] * f[1], s[2] * f[0] - s[0] * f[2], s[0] * f[1] - s[1] * f[0]};
+
+	mat4 r = mat4_identity();
+	for (int i = 0; i < 3; i++) {
+		r(0, i) = s[i];
+		r(1, i) = u[i];
+		r(2, i) = -f[i];
+	}
+	return r * mat4_translate(-eyeX, -eyeY, -eyeZ);
+}
+
+// out = m * (x, y, z, w)
+inline void mat4_transform(const mat4& m, const float in[4], float out[4]) {
+	for (int row = 0; row < 4; row++) {
+		out[row] = m(row, 0) * in[0] + m(row, 1) * in[1] + m(row, 2) * in[2] + m(row, 3) * in[3];
+	}
+}
+
+// Eye-space normal GL 1.x uses for the default object normal (0, 0, 1):
+// the third column of the inverse transpose of the upper 3x3. Like GL
+// without GL_NORMALIZE, the result is not renormalised.
+inline void mat4_default_normal(const mat4& m, float out[3]) {
+	float a = m(0, 0), b = m(0, 1), c = m(0, 2);
+	float d = m(1, 0), e = m(1, 1), f = m(1, 2);
+	float g = m(2, 0), h = m(2, 1), i = m(2, 2);
+	float det = a * (e * i - f * h) - b * (d * i - f * g) + c * (d * h - e * g);
+	if (det == 0.0f) {
+		out[0] = 0.0f;
+		out[1] = 0.0f;
+		out[2] = 1.0f;
+		return;
+	}
+	// Row 2 of the inverse == column 2 of its transpose.
+	out[0] = (d * h - e * g) / det;
+	out[1] = (b * g - a * h) / det;
+	out[2] = (a * e - b * d) / det;
+}
+
+} // namespace gfx
@@ -0,0 +1,288 @@
+#include "metrics.h"
+
+#include "gfx.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <thread>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define METRICS_POSIX 1
+#include <poll.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+namespace metrics {
+
+namespace {
+
+const int WINDOW = 240;                    // Frames the quantiles cover
+const float REFRESH_MS = 1000.0f / 60.0f;  // A frame longer than this misses refreshes
+const int MEMORY_EVERY = 60;               // Frames between memory reads
+
+enum Metric {
+	FRAMES,
+	DROPPED,
+	FRAME_P50,
+	FRAME_P99,
+	FRAME_SUM,
+	FRAME_COUNT,
+	FRAME_MAX,
+	RESIDENT,
+	PEAK_RESIDENT,
+	TEXTURE_BYTES,
+	DRAWS,
+	TEXTURES_LOADED,
+	SOUNDS_LOADED,
+	TEXTURES_FAILED,
+	SOUNDS_FAILED,
+	METRIC_COUNT,
+};
+
+// One exposition line each. A line without 'type' continues the family
+// above it (labels, or a summary's _sum / _count).
+struct Info {
+	const char* name;
+	const char* labels;
+	const char* type;
+	const char* help;
+};
+
+const Info INFO[METRIC_COUNT] = {
+	{"desksim_frames_total", "", "counter", "Frames drawn."},
+	{"desksim_dropped_frames_total", "", "counter", "60 Hz refreshes missed by frames running long."},
+	{"desksim_frame_seconds", "{quantile=\"0.5\"}", "summary", "Wall-clock time between frames, quantiles over the last 240."},
+	{"desksim_frame_seconds", "{quantile=\"0.99\"}", nullptr, nullptr},
+	{"desksim_frame_seconds_sum", "", nullptr, nullptr},
+	{"desksim_frame_seconds_count", "", nullptr, nullptr},
+	{"desksim_frame_seconds_max", "", "gauge", "Longest of the last 240 frames."},
+	{"desksim_resident_memory_bytes", "", "gauge", "Resident set size (Linux only)."},
+	{"desksim_peak_resident_memory_bytes", "", "gauge", "Largest resident set size so far."},
+	{"desksim_texture_memory_bytes", "", "gauge", "Uploaded textures with their mip chains, estimated."},
+	{"desksim_draw_calls", "", "gauge", "Draw calls recorded for the last frame (0 without counters)."},
+	{"desksim_assets_loaded_total", "{kind=\"texture\"}", "counter", "Assets loaded."},
+	{"desksim_assets_loaded_total", "{kind=\"sound\"}", nullptr, nullptr},
+	{"desksim_asset_failures_total", "{kind=\"texture\"}", "counter", "Assets that failed to load."},
+	{"desksim_asset_failures_total", "{kind=\"sound\"}", nullptr, nullptr},
+};
+
+static std::atomic<unsigned long> g_assets[ASSET_KINDS][2]; // [kind][ok]
+
+// GL thread
+static double g_values[METRIC_COUNT];
+static float g_window[WINDOW];
+static int g_count = 0, g_next = 0;
+
+// Seqlock: odd while the GL thread is writing g_published.
+static std::atomic<unsigned> g_seq{0};
+static std::atomic<double> g_published[METRIC_COUNT];
+
+static void publish() {
+	unsigned seq = g_seq.load(std::memory_order_relaxed);
+	g_seq.store(seq + 1, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+	for (int i = 0; i < METRIC_COUNT; i++) g_published[i].store(g_values[i], std::memory_order_relaxed);
+	g_seq.store(seq + 2, std::memory_order_release);
+}
+
+// Server thread: a consistent copy of the latest publish().
+static void read_published(double out[METRIC_COUNT]) {
+	while (true) {
+		unsigned seq = g_seq.load(std::memory_order_acquire);
+		if (seq & 1) {
+			std::this_thread::yield();
+			continue;
+		}
+		for (int i = 0; i < METRIC_COUNT; i++) out[i] = g_published[i].load(std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_acquire);
+		if (g_seq.load(std::memory_order_relaxed) == seq) return;
+	}
+}
+
+static void read_memory() {
+#ifdef __linux__
+	FILE* f = std::fopen("/proc/self/statm", "r");
+	unsigned long pages = 0, resident = 0;
+	if (f) {
+		if (std::fscanf(f, "%lu %lu", &pages, &resident) == 2) g_values[RESIDENT] = (double)resident * sysconf(_SC_PAGESIZE);
+		std::fclose(f);
+	}
+#endif
+#ifdef METRICS_POSIX
+	struct rusage usage;
+	getrusage(RUSAGE_SELF, &usage);
+#ifdef __APPLE__
+	g_values[PEAK_RESIDENT] = (double)usage.ru_maxrss; // Bytes
+#else
+	g_values[PEAK_RESIDENT] = (double)usage.ru_maxrss * 1024.0; // KB
+#endif
+#endif
+}
+
+#ifdef METRICS_POSIX
+static std::atomic<bool> g_running{false};
+static std::thread g_server;
+static int g_listen = -1;
+static std::string g_path;
+
+static void format(std::string& out) {
+	double values[METRIC_COUNT];
+	read_published(values);
+	out.clear();
+	char line[256];
+	for (int i = 0; i < METRIC_COUNT; i++) {
+		const Info& m = INFO[i];
+		if (i == RESIDENT && values[i] == 0.0) continue; // Not measured here
+		if (m.type) {
+			std::snprintf(line, sizeof(line), "# HELP %s %s\n# TYPE %s %s\n", m.name, m.help, m.name, m.type);
+			out += line;
+		}
+		std::snprintf(line, sizeof(line), "%s%s %.9g\n", m.name, m.labels, values[i]);
+		out += line;
+	}
+}
+
+static bool send_all(int fd, const char* data, size_t size) {
+	int flags = 0;
+#ifdef MSG_NOSIGNAL
+	flags = MSG_NOSIGNAL; // A scraper hanging up mustn't SIGPIPE the simulator
+#endif
+	while (size > 0) {
+		ssize_t sent = send(fd, data, size, flags);
+		if (sent <= 0) return false;
+		data += sent;
+		size -= (size_t)sent;
+	}
+	return true;
+}
+
+// Plain text to whatever connects; an HTTP GET gets a response header too.
+static void respond(int client, std::string& body) {
+	char request[512];
+	ssize_t got = 0;
+	pollfd p = {client, POLLIN, 0};
+	if (poll(&p, 1, 50) > 0) got = recv(client, request, sizeof(request), 0);
+	bool http = got >= 4 && std::memcmp(request, "GET ", 4) == 0;
+
+	format(body);
+	if (http) {
+		char header[160];
+		std::snprintf(header, sizeof(header),
+		              "HTTP/1.0 200 OK\r\nContent-Type: text/plain; version=0.0.4\r\nContent-Length: %zu\r\n\r\n",
+		              body.size());
+		if (!send_all(client, header, std::strlen(header))) return;
+	}
+	send_all(client, body.data(), body.size());
+}
+
+static void serve() {
+	std::string body;
+	while (g_running.load()) {
+		pollfd p = {g_listen, POLLIN, 0};
+		if (poll(&p, 1, 200) <= 0) continue;
+		int client = accept(g_listen, nullptr, nullptr);
+		if (client < 0) continue;
+#ifdef SO_NOSIGPIPE
+		int on = 1;
+		setsockopt(client, SOL_SOCKET, SO_NOSIGPIPE, &on, sizeof(on));
+#endif
+		struct timeval timeout = {1, 0}; // A stuck scraper only holds up the next one
+		setsockopt(client, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+		respond(client, body);
+		close(client);
+	}
+}
+#endif
+
+} // namespace
+
+bool start(const char* path) {
+#ifdef METRICS_POSIX
+	if (g_running) return true;
+	sockaddr_un addr;
+	std::memset(&addr, 0, sizeof(addr));
+	addr.sun_family = AF_UNIX;
+	if (std::strlen(path) >= sizeof(addr.sun_path)) {
+		std::fprintf(stderr, "metrics: socket path '%s' is too long\n", path);
+		return false;
+	}
+	std::strcpy(addr.sun_path, path);
+
+	struct stat st;
+	if (lstat(path, &st) == 0) {
+		if (!S_ISSOCK(st.st_mode)) {
+			std::fprintf(stderr, "metrics: '%s' exists and isn't a socket\n", path);
+			return false;
+		}
+		unlink(path); // Left by a run that didn't stop()
+	}
+	g_listen = socket(AF_UNIX, SOCK_STREAM, 0);
+	if (g_listen < 0 || bind(g_listen, (sockaddr*)&addr, sizeof(addr)) != 0 || listen(g_listen, 4) != 0) {
+		std::fprintf(stderr, "metrics: can't listen on '%s'\n", path);
+		if (g_listen >= 0) close(g_listen);
+		g_listen = -1;
+		return false;
+	}
+	g_path = path;
+	read_memory();
+	publish();
+	g_running = true;
+	g_server = std::thread(serve);
+	std::printf("metrics: serving on %s\n", path);
+	return true;
+#else
+	std::fprintf(stderr, "metrics: '%s': Unix domain sockets need a POSIX system\n", path);
+	return false;
+#endif
+}
+
+void stop() {
+#ifdef METRICS_POSIX
+	if (!g_running) return;
+	g_running = false;
+	g_server.join();
+	close(g_listen);
+	g_listen = -1;
+	unlink(g_path.c_str());
+#endif
+}
+
+void asset_loaded(Asset kind, bool ok) { g_assets[kind][ok ? 1 : 0].fetch_add(1, std::memory_order_relaxed); }
+
+void frame(float ms) {
+	g_values[FRAMES] += 1.0;
+	int refreshes = (int)(ms / REFRESH_MS + 0.5f);
+	if (refreshes > 1) g_values[DROPPED] += refreshes - 1;
+	g_values[FRAME_SUM] += ms / 1000.0;
+	g_values[FRAME_COUNT] += 1.0;
+	g_window[g_next] = ms;
+	g_next = (g_next + 1) % WINDOW;
+	if (g_count < WINDOW) g_count++;
+#ifdef METRICS_POSIX
+	if (!g_running.load(std::memory_order_relaxed)) return;
+
+	float sorted[WINDOW];
+	std::copy(g_window, g_window + g_count, sorted);
+	std::sort(sorted, sorted + g_count);
+	g_values[FRAME_P50] = sorted[g_count / 2] / 1000.0;
+	g_values[FRAME_P99] = sorted[std::min(g_count - 1, g_count * 99 / 100)] / 1000.0;
+	g_values[FRAME_MAX] = sorted[g_count - 1] / 1000.0;
+	if ((unsigned long)g_values[FRAMES] % MEMORY_EVERY == 0) read_memory();
+	g_values[TEXTURE_BYTES] = (double)gfx::texture_bytes();
+	g_values[DRAWS] = (double)gfx::frame_counters().n[gfx::COUNT_DRAWS];
+	g_values[TEXTURES_LOADED] = (double)g_assets[ASSET_TEXTURE][1].load(std::memory_order_relaxed);
+	g_values[SOUNDS_LOADED] = (double)g_assets[ASSET_SOUND][1].load(std::memory_order_relaxed);
+	g_values[TEXTURES_FAILED] = (double)g_assets[ASSET_TEXTURE][0].load(std::memory_order_relaxed);
+	g_values[SOUNDS_FAILED] = (double)g_assets[ASSET_SOUND][0].load(std::memory_order_relaxed);
+	publish();
+#endif
+}
+
+} // namespace metrics
@@ -0,0 +1,34 @@
+#pragma once
+
+namespace metrics {
+
+// Live metrics for monitoring without a screen: --metrics-socket PATH
+// serves a Prometheus text snapshot to anything connecting to the Unix
+// domain socket at PATH (e.g. curl --unix-socket PATH http://localhost/,
+// or plain nc -U PATH). A background thread does all the serving.
+//
+// The GL thread publishes the numbers once per frame into a seqlock: it
+// never waits, and a scrape that races a publish simply reads again, so
+// scraping can't hold up a frame. POSIX only; elsewhere start() fails.
+
+// Opens the socket and starts the server. False (with a message) if it
+// can't; a stale socket left at 'path' is replaced, any other file isn't.
+bool start(const char* path);
+
+// Stops the server and removes the socket. Safe to call when not started.
+void stop();
+
+enum Asset {
+	ASSET_TEXTURE,
+	ASSET_SOUND,
+	ASSET_KINDS,
+};
+
+// An asset finished loading ('ok') or failed to. Any thread, started or not.
+void asset_loaded(Asset kind, bool ok);
+
+// GL thread, once per frame drawn: wall-clock time since the previous one.
+// Publishes a new snapshot while the server runs; otherwise returns at once.
+void frame(float ms);
+
+} // namespace metrics
@@ -0,0 +1,347 @@
+#ifndef MICRO_BENCH_H
+#define MICRO_BENCH_H
+
+#include "audio.h"
+#include "bmpLoader.h"
+#include "gfx.h"
+#include "objects.h"
+#include "parameter.h"
+#include "part_picker.h"
+#include "tooltip.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+/*
+  MICRO BENCHMARKS
+  --micro-bench [filter] times the leaf routines one at a time, no window
+  or GL needed: BMP and WAV loading, tooltip picking and recording the fan
+  and case geometry. Only cases whose name contains 'filter' run.
+
+  Each case is run in batches long enough (>= 2 ms) for the clock not to
+  matter, warmed up for 100 ms, then timed over MICRO_SAMPLES batches.
+  Batches further than 3 MADs (median absolute deviations) from the median
+  are dropped as noise (preemption, page faults); the rest give ns/op, its
+  spread and bytes/s.
+*/
+
+const int MICRO_SAMPLES = 31;
+volatile size_t microSink; /// Results land here so no case is optimised out
+
+/// Times 'op' (returns anything to feed microSink), which touches
+/// 'bytesPerOp' bytes, and prints a result line.
+template <class Op>
+void microCase(const char *filter, const char *name, double bytesPerOp,
+               Op op) {
+  if (filter && !std::strstr(name, filter))
+    return;
+  typedef std::chrono::steady_clock clock;
+  auto runBatch = [&](unsigned long ops) {
+    clock::time_point start = clock::now();
+    size_t sink = 0;
+    for (unsigned long i = 0; i < ops; i++)
+      sink += op();
+    microSink = microSink + sink;
+    return std::chrono::duration<double, std::nano>(clock::now() - start)
+        .count();
+  };
+
+  unsigned long batch = 1;
+  while (runBatch(batch) < 2e6 && batch < (1ul << 30))
+    batch *= 2;
+  for (clock::time_point start = clock::now();
+       clock::now() - start < std::chrono::milliseconds(100);)
+    runBatch(batch);
+
+  std::vector<double> ns(MICRO_SAMPLES);
+  for (double &sample : ns)
+    sample = runBatch(batch) / batch;
+  std::vector<double> sorted(ns);
+  std::sort(sorted.begin(), sorted.end());
+  double median = sorted[sorted.size() / 2];
+  std::vector<double> deviation;
+  for (double sample : ns)
+    deviation.push_back(std::fabs(sample - median));
+  std::sort(deviation.begin(), deviation.end());
+  double limit = 3.0 * 1.4826 * deviation[deviation.size() / 2];
+
+  double sum = 0.0, sumSq = 0.0;
+  int kept = 0;
+  for (double sample : ns)
+    if (std::fabs(sample - median) <= limit) {
+      sum += sample;
+      sumSq += sample * sample;
+      kept++;
+    }
+  double mean = sum / kept;
+  double spread = std::sqrt(std::max(0.0, sumSq / kept - mean * mean));
+  std::printf("%-28s %12.1f ns/op  +-%5.2f%%  %10.1f MB/s  %2d/%d\n", name,
+              mean, 100.0 * spread / mean, bytesPerOp / mean * 1e3, kept,
+              MICRO_SAMPLES);
+}
+
+/// A w x h 24-bit BMP of noise, laid out as BmpLoader reads it.
+void microWriteBmp(const char *path, int w, int h) {
+  unsigned char header[54] = {'B', 'M'};
+  header[10] = 54;
+  header[14] = 40;
+  header[18] = w & 0xff;
+  header[19] = w >> 8;
+  header[22] = h & 0xff;
+  header[23] = h >> 8;
+  header[26] = 1;
+  header[28] = 24;
+  std::vector<unsigned char> pixels((size_t)w * h * 3);
+  unsigned int seed = 1;
+  for (unsigned char &p : pixels)
+    p = (unsigned char)((seed = seed * 1103515245u + 12345u) >> 16);
+  FILE *f = std::fopen(path, "wb");
+  std::fwrite(header, 1, sizeof(header), f);
+  std::fwrite(pixels.data(), 1, pixels.size(), f);
+  std::fclose(f);
+}
+
+/// 'seconds' of 44.1 kHz stereo sine in the given WAV encoding
+/// (format 1: PCM, 3: IEEE float).
+void microWriteWav(const char *path, int format, int bits, float seconds) {
+  const int rate = 44100, channels = 2;
+  unsigned int frames = (unsigned int)(rate * seconds);
+  unsigned int dataBytes = frames * channels * (bits / 8);
+  std::vector<unsigned char> out;
+  auto u16 = [&](unsigned int v) {
+    out.push_back(v & 0xff);
+    out.push_back((v >> 8) & 0xff);
+  };
+  auto u32 = [&](unsigned int v) {
+    u16(v & 0xffff);
+    u16(v >> 16);
+  };
+  out.insert(out.end(), {'R', 'I', 'F', 'F'});
+  u32(36 + dataBytes);
+  out.insert(out.end(), {'W', 'A', 'V', 'E', 'f', 'm', 't', ' '});
+  u32(16);
+  u16(format);
+  u16(channels);
+  u32(rate);
+  u32(rate * channels * (bits / 8));
+  u16(channels * (bits / 8));
+  u16(bits);
+  out.insert(out.end(), {'d', 'a', 't', 'a'});
+  u32(dataBytes);
+  for (unsigned int i = 0; i < frames * channels; i++) {
+    float s = 0.8f * std::sin(i * 0.05f);
+    if (format == 3) {
+      unsigned int v;
+      std::memcpy(&v, &s, 4);
+      u32(v);
+    } else if (bits == 8)
+      out.push_back((unsigned char)(128 + s * 127));
+    else {
+      long long v = (long long)(s * ((1ll << (bits - 1)) - 1));
+      for (int b = 0; b < bits / 8; b++)
+        out.push_back((unsigned char)(v >> (8 * b)));
+    }
+  }
+  FILE *f = std::fopen(path, "wb");
+  std::fwrite(out.data(), 1, out.size(), f);
+  std::fclose(f);
+}
+
+/// --micro-bench [filter]
+void microBench(const char *filter) {
+  std::printf("%-28s %18s %10s %17s  %s\n", "case", "time", "spread",
+              "throughput", "kept");
+
+  // Loaders: files are written next to the binary's working directory
+  // and removed after, so reads come from the page cache.
+  const int bmpSizes[] = {256, 1024};
+  for (int size : bmpSizes) {
+    char name[64];
+    std::snprintf(name, sizeof(name), "bmp load %dx%d", size, size);
+    const char *path = "microbench.bmp";
+    microWriteBmp(path, size, size);
+    microCase(filter, name, 54.0 + size * size * 3.0, [&]() {
+      BmpLoader image(path);
+      return (size_t)image.data[0];
+    });
+    std::remove(path);
+  }
+
+  struct WavCase {
+    const char *name;
+    int format, bits;
+  };
+  const WavCase wavs[] = {{"wav load 8-bit pcm", 1, 8},
+                          {"wav load 16-bit pcm", 1, 16},
+                          {"wav load 24-bit pcm", 1, 24},
+                          {"wav load 32-bit pcm", 1, 32},
+                          {"wav load 32-bit float", 3, 32}};
+  for (const WavCase &c : wavs) {
+    const char *path = "microbench.wav";
+    microWriteWav(path, c.format, c.bits, 1.0f);
+    double bytes = 44.0 + 44100 * 2 * (c.bits / 8);
+    microCase(filter, c.name, bytes, [&]() {
+      audio::WavData wav;
+      if (!audio::load_wav_file(path, wav))
+        std::printf("%s: load failed\n", c.name);
+      return wav.pcm.size();
+    });
+    std::remove(path);
+  }
+
+  // Picking: camera at the origin looking down -z, spheres scattered in
+  // front of it, the mouse stepping over a grid so the focus changes between
+  // calls.
+  gfx::Camera camera;
+  camera.resize(1280, 720, 80.0f, 0.7f, 100.0f);
+  const int componentCounts[] = {6, 100, 10000};
+  for (int count : componentCounts) {
+    TooltipSystem tooltips;
+    unsigned int seed = 7;
+    auto random = [&](float lo, float hi) {
+      seed = seed * 1103515245u + 12345u;
+      return lo + (hi - lo) * ((seed >> 8) & 0xffff) / 65535.0f;
+    };
+    for (int i = 0; i < count; i++) {
+      float3 center = {random(-6, 6), random(-3, 3), random(-20, -3)};
+      tooltips.registerComponent("part " + std::to_string(i), "", center, 0.4f);
+    }
+    char name[64];
+    std::snprintf(name, sizeof(name), "tooltip update %d", count);
+    int step = 0;
+    // Bytes update() streams: center, squared radius, hit distance, hover
+    microCase(filter, name, (double)count * 6 * sizeof(float), [&]() {
+      step = (step + 1) % 64;
+      tooltips.update(camera.ray(step % 8 * 160 + 80, step / 8 * 90 + 45),
+                      1.0f / 60.0f);
+      return (size_t)step;
+    });
+  }
+
+  // Label layout (label_layout.h): 300 text-sized labels over a 1280 x 720
+  // window, anchors scattered, so many are left out. Still, every solve()
+  // starts from the last one's boxes; moving, each anchor drifts a pixel or
+  // two a call, as they do while the camera turns.
+  std::vector<labels::Label> labelList(300);
+  unsigned int labelSeed = 11;
+  auto labelRandom = [&](float lo, float hi) {
+    labelSeed = labelSeed * 1103515245u + 12345u;
+    return lo + (hi - lo) * ((labelSeed >> 8) & 0xffff) / 65535.0f;
+  };
+  for (labels::Label &l : labelList) {
+    l.anchor[0] = labelRandom(0, 1280);
+    l.anchor[1] = labelRandom(0, 720);
+    l.size[0] = labelRandom(60, 140);
+    l.size[1] = 24.0f;
+    l.visible = true;
+  }
+  const double labelBytes =
+      labelList.size() * (sizeof(labels::Label) + sizeof(labels::Box));
+  labels::Layout labelLayout;
+  microCase(filter, "label layout 300 still", labelBytes, [&]() {
+    labelLayout.solve(labelList.data(), labelList.size(), 1280, 720);
+    return labelLayout.tests();
+  });
+  microCase(filter, "label layout 300 moving", labelBytes, [&]() {
+    for (labels::Label &l : labelList) {
+      l.anchor[0] += labelRandom(-2, 2);
+      l.anchor[1] += labelRandom(-2, 2);
+    }
+    labelLayout.solve(labelList.data(), labelList.size(), 1280, 720);
+    return labelLayout.tests();
+  });
+
+  if (!textures)
+    textures = new GLuint[NUM_TEXTURE](); // No GL: texture names stay 0
+
+  // Exact picking against the parts' triangles (part_picker.h), the mouse
+  // stepping over the same grid from beside the case. Then a dense scene: a
+  // 10 x 10 wall of copies of every part, 1000 instances, picked and refit.
+  ComponentId partIds[PART_COUNT];
+  for (int p = 0; p < PART_COUNT; p++)
+    partIds[p] = p;
+  PartPicker picker;
+  picker.build(partIds);
+  // Throughput counts every triangle and node, what testing them all would
+  // read; a pick through the trees reads only a few of them.
+  double meshBytes = 0.0;
+  for (int p = 0; p <= PICK_CASE; p++)
+    meshBytes += picker.mesh(p).triangle_count() * 36.0 +
+                 picker.mesh(p).node_count() * sizeof(bvh::Node);
+  camera.look_at(3.0f, 5.0f, -3.0f, 8.0f, 4.5f, -4.3f);
+  int pickStep = 0;
+  microCase(filter, "bvh pick parts", meshBytes, [&]() {
+    pickStep = (pickStep + 1) % 64;
+    return (size_t)(picker.pick(camera.ray(pickStep % 8 * 160 + 80,
+                                           pickStep / 8 * 90 + 45)) + 1);
+  });
+  // Occlusion test of every part with a tooltip, as drawTooltips() does
+  float eye[3];
+  camera.position(eye);
+  microCase(filter, "bvh visibility parts", meshBytes, [&]() {
+    size_t seen = 0;
+    for (int p = 0; p < PART_COUNT; p++)
+      seen += picker.visible(p, eye);
+    return seen;
+  });
+
+  bvh::Scene dense;
+  for (int copy = 0; copy < 100; copy++) {
+    for (int p = 0; p <= PICK_CASE; p++) {
+      int i = dense.add(&picker.mesh(p), p);
+      dense.move(i, copy % 10 * 3.0f - 15.0f, copy / 10 * 3.0f - 15.0f, 0.0f);
+    }
+  }
+  dense.update();
+  camera.look_at(8.0f, 4.0f, 20.0f, 8.0f, 4.0f, -4.0f);
+  microCase(filter, "bvh pick 1000 instances", meshBytes, [&]() {
+    pickStep = (pickStep + 1) % 64;
+    bvh::Hit hit =
+        dense.intersect(camera.ray(pickStep % 8 * 160 + 80, pickStep / 8 * 90 + 45));
+    return (size_t)(hit.instance + 1);
+  });
+  int refitStep = 0;
+  microCase(filter, "bvh refit 1000 instances",
+            (double)dense.size() * sizeof(bvh::Node), [&]() {
+              refitStep = (refitStep + 1) % 64;
+              for (int i = 0; i < (int)dense.size(); i++) {
+                int copy = i / (PICK_CASE + 1);
+                dense.move(i, copy % 10 * 3.0f - 15.0f - refitStep * 0.01f,
+                           copy / 10 * 3.0f - 15.0f, 0.0f);
+              }
+              dense.update();
+              return dense.size();
+            });
+
+  // Geometry: recording the procedural fan (blades, hub, rim, grills) and
+  // the case (with its rim) into a command list.
+  gfx::CommandList list;
+  PartPose fanPose = fan_.pose();
+  gfx::record_into(&list);
+  fan_.render(fanPose, 1.0f);
+  double fanBytes = list.size() * sizeof(gfx::Command) + list.text.size();
+  list.clear();
+  microCase(filter, "record fan", fanBytes, [&]() {
+    list.clear();
+    fan_.render(fanPose, 1.0f);
+    return list.size();
+  });
+  PartPose panelPose = case_.pose();
+  list.clear();
+  case_.render(panelPose, 1.0f);
+  double caseBytes = list.size() * sizeof(gfx::Command) + list.text.size();
+  microCase(filter, "record case", caseBytes, [&]() {
+    list.clear();
+    case_.render(panelPose, 1.0f);
+    return list.size();
+  });
+  gfx::record_into(nullptr);
+}
+
+#endif
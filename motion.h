@@ -2,83 +2,138 @@
 #define MOTION
 
 #include "audio.h"
+#include "frame_snapshot.h"
+#include "gfx.h"
 #include "objects.h"
 #include "parameter.h"
 
 int prev_x = 0, prev_y = 0;
 bool escape_pressed = false;
 bool reposition = false;
+int cpuPrompt = PROMPT_NONE; /// What drawCpuPrompt() shows, set by cpuView()
 
-void processSpecialKeys(int key, int xx, int yy) {
-  float fraction = 0.001f;
-  float fraction_rotate = 0.001f;
-  static int lastStepMs = 0;
+// CAMERA STATE
+/// The camera as of the previous sim step; frames blend towards the live one.
+CameraState prevCamera = {.0, 5.0, 5.0, 0.0f, -1.0f};
 
-  if (!motion_present)
-    return;
+CameraState cameraState() {
+  CameraState c = {x, y, z, lx, lz};
+  return c;
+}
 
-  auto maybeStep = [&]() {
-    // Avoid spamming on key repeat.
-    int now = glutGet(GLUT_ELAPSED_TIME);
-    if (now - lastStepMs < 180)
-      return;
-    lastStepMs = now;
-    audio::play_step("data/sfx/step.wav", 0.35f);
-  };
+/// Call after teleporting the camera so the next frames don't sweep across.
+void snapCamera() { prevCamera = cameraState(); }
+
+// HELD KEYS
+/// Special keys only flag what is held; updateCamera() integrates the motion
+/// at a fixed rate so walking speed doesn't depend on key repeat or FPS.
+enum { HOLD_LEFT, HOLD_RIGHT, HOLD_UP, HOLD_DOWN, HOLD_HOME, HOLD_END,
+       HOLD_PAGE_UP, HOLD_PAGE_DOWN, HOLD_COUNT };
+bool keyHeld[HOLD_COUNT] = {false};
 
+int holdSlot(int key) {
   switch (key) {
-  case GLUT_KEY_LEFT:
-    x -= cos(angle) * deltaTime * fraction;
-    z -= sin(angle) * deltaTime * fraction;
-    maybeStep();
-    break;
-  case GLUT_KEY_RIGHT:
-    x += cos(angle) * deltaTime * fraction;
-    z += sin(angle) * deltaTime * fraction;
-    maybeStep();
+  case GLUT_KEY_LEFT: return HOLD_LEFT;
+  case GLUT_KEY_RIGHT: return HOLD_RIGHT;
+  case GLUT_KEY_UP: return HOLD_UP;
+  case GLUT_KEY_DOWN: return HOLD_DOWN;
+  case GLUT_KEY_HOME: return HOLD_HOME;
+  case GLUT_KEY_END: return HOLD_END;
+  case GLUT_KEY_PAGE_UP: return HOLD_PAGE_UP;
+  case GLUT_KEY_PAGE_DOWN: return HOLD_PAGE_DOWN;
+  }
+  return -1;
+}
 
-    break;
-  case GLUT_KEY_UP:
+void processSpecialKeys(int key, int xx, int yy) {
+  if (key == GLUT_KEY_F2) {
+    hudOverlay = !hudOverlay;
+    return;
+  }
+  if (key == GLUT_KEY_F3) {
+    profilerOverlay = !profilerOverlay;
+    return;
+  }
+  if (key == GLUT_KEY_F4) {
+    traceRequested = true;
+    return;
+  }
+  if (key == GLUT_KEY_F5) {
+    labelAll = !labelAll;
+    return;
+  }
+  int slot = holdSlot(key);
+  if (slot < 0)
+    return;
+  if (!keyHeld[slot] && motion_present &&
+      (slot == HOLD_HOME || slot == HOLD_END))
+    audio::play_ui("data/sfx/ui_click.wav", 0.25f);
+  keyHeld[slot] = true;
+}
 
-    x += lx * deltaTime * fraction;
-    z += lz * deltaTime * fraction;
-    maybeStep();
+void processSpecialUpKeys(int key, int xx, int yy) {
+  int slot = holdSlot(key);
+  if (slot >= 0)
+    keyHeld[slot] = false;
+}
 
-    break;
-  case GLUT_KEY_DOWN:
-    x -= lx * deltaTime * fraction;
-    z -= lz * deltaTime * fraction;
-    maybeStep();
+/// One SIM_DT step of walking / turning from the held keys.
+void updateCamera(double simTime) {
+  static double lastStep = -1.;
+  prevCamera = cameraState();
 
-    break;
-  case GLUT_KEY_HOME:
-    angle -= deltaTime * fraction_rotate;
-    lx = sin(angle);
-    lz = -cos(angle);
-    audio::play_ui("data/sfx/ui_click.wav", 0.25f);
-    break;
-  case GLUT_KEY_END:
-    angle += deltaTime * fraction_rotate;
+  if (!motion_present)
+    return;
+
+  float step = walkSpeed * SIM_DT;
+  float turn = turnSpeed * SIM_DT;
+  float look = lookSpeed * SIM_DT;
+  bool walking = false;
+
+  if (keyHeld[HOLD_LEFT]) {
+    x -= cos(angle) * step;
+    z -= sin(angle) * step;
+    walking = true;
+  }
+  if (keyHeld[HOLD_RIGHT]) {
+    x += cos(angle) * step;
+    z += sin(angle) * step;
+    walking = true;
+  }
+  if (keyHeld[HOLD_UP]) {
+    x += lx * step;
+    z += lz * step;
+    walking = true;
+  }
+  if (keyHeld[HOLD_DOWN]) {
+    x -= lx * step;
+    z -= lz * step;
+    walking = true;
+  }
+  if (keyHeld[HOLD_HOME] || keyHeld[HOLD_END]) {
+    angle += keyHeld[HOLD_END] ? turn : -turn;
     lx = sin(angle);
     lz = -cos(angle);
-    audio::play_ui("data/sfx/ui_click.wav", 0.25f);
-    break;
-  case GLUT_KEY_PAGE_UP:
-    y < 1.4f ? y += deltaTime *fraction_rotate * 0.5 : y = 1.4f;
-    break;
-  case GLUT_KEY_PAGE_DOWN:
-    y > -0.8f ? y -= deltaTime *fraction_rotate * 0.5 : y = -0.8f;
-    break;
+  }
+  if (keyHeld[HOLD_PAGE_UP])
+    y < 1.4f ? y += look : y = 1.4f;
+  if (keyHeld[HOLD_PAGE_DOWN])
+    y > -0.8f ? y -= look : y = -0.8f;
+
+  // Footsteps, at most one every 180 ms of simulated time.
+  if (walking && simTime - lastStep >= 0.18) {
+    lastStep = simTime;
+    audio::play_step("data/sfx/step.wav", 0.35f);
   }
 }
 
 void processNormalKeys(unsigned char key, int x, int y) {
-  static int lastActionMs = 0;
+  static double lastAction = -1.;
   auto allowAction = [&]() {
-    int now = glutGet(GLUT_ELAPSED_TIME);
-    if (now - lastActionMs < 180)
+    double now = simClock.now();
+    if (now - lastAction < 0.18)
       return false;
-    lastActionMs = now;
+    lastAction = now;
     return true;
   };
 
@@ -126,7 +181,8 @@ void processNormalKeys(unsigned char key, int x, int y) {
       audio::stop(audio::Channel::ACTION);
       motion_present = true;
     } else
-      exit(0);
+      quitRequested = true; // The GL thread shuts the pipeline down
+
   }
 }
 
@@ -134,7 +190,6 @@ void mouse_follow(int new_x, int new_y) {
   mouseGlobalX = new_x;
   mouseGlobalY = new_y;
 
-  float fraction = 0.0001f;    // For the rotation tuner.
   float fast_fraction = 0.001; // For the fast rotation around edges.
   float fast_move_percentage =
       0.01; // What percentile of area has to be used to move fast from mouse.
@@ -150,13 +205,13 @@ void mouse_follow(int new_x, int new_y) {
   if (variation_x < 0) {
     if (new_x > width * (1 - fast_move_percentage)) // appox. > 1200
       angle += abs(variation_x) * fast_fraction;
-    angle += deltaTime * fraction;
+    angle += mouseNudge;
     lx = sin(angle);
     lz = -cos(angle);
   } else if (variation_x > 0) {
     if (new_x < width * fast_move_percentage) // appox. 400s
       angle -= abs(variation_x) * fast_fraction;
-    angle -= deltaTime * fraction;
+    angle -= mouseNudge;
     lx = sin(angle);
     lz = -cos(angle);
   }
@@ -169,27 +224,25 @@ void mouse_follow(int new_x, int new_y) {
     float fastMoveY = 0;
     if (new_y < hight * fast_move_percentage)
       fastMoveY = abs(variation_y) * fast_fraction * 0.4;
-    y - deltaTime *fraction - fastMoveY > LOWER_Y
-        ? y -= deltaTime *fraction - fastMoveY
-        : y = LOWER_Y;
+    y - mouseNudge - fastMoveY > LOWER_Y ? y -= mouseNudge - fastMoveY
+                                         : y = LOWER_Y;
   } else if (variation_y > 0) {
     float fastMoveY = 0;
     if (new_y > hight * (1 - fast_move_percentage))
       fastMoveY = abs(variation_y) * fast_fraction * 0.4;
-    y + deltaTime *fraction + fastMoveY < UPPER_Y
-        ? y += deltaTime *fraction + fastMoveY
-        : y = UPPER_Y;
+    y + mouseNudge + fastMoveY < UPPER_Y ? y += mouseNudge + fastMoveY
+                                         : y = UPPER_Y;
   }
   prev_y = new_y;
 }
 
 void printMsg(char *message, GLfloat mX, GLfloat mY, GLfloat mZ) {
-  glRasterPos3f(mX, mY, mZ);
-  for (char *c = message; *c != '\0'; c++) {
-    glutBitmapCharacter(GLUT_BITMAP_HELVETICA_18, *c);
-  }
+  gfx::raster_pos3f(mX, mY, mZ);
+  gfx::bitmap_string(GLUT_BITMAP_HELVETICA_18, message);
 }
 
+/// CPU view logic, one sim step: prompts, and the jump to the disassembly
+/// viewpoint once the user answers Y.
 void cpuView() {
 
   // For CPU View
@@ -203,20 +256,17 @@ void cpuView() {
   // glVertex3f(baseX, baseY, baseZ - baseWidth);
   // glEnd();
 
+  cpuPrompt = PROMPT_NONE;
   if (x >= baseX && z <= baseZ) { // Inside ?
-    glColor3f(1., 1., 1.);
     if (choice == '1') {
-      printMsg((char *)"Do you want to Disassemble ? Enter Y / N", 3., 5., -6.);
+      cpuPrompt = PROMPT_ASK_DISASSEMBLE;
       reposition = true;
     } else if (choice == 'n') { /// Set camera position
       enterPressed = false;
     } else if (choice == 'y') {
 
-      if (!escape_pressed) {
-        printMsg((char *)"Press Enter to disassemble / Backspace to assemble",
-                 5.24, 4.1, -4.275);
-        printMsg((char *)"Esc to exit view", 5.24, 3.8, -5.35);
-      }
+      if (!escape_pressed)
+        cpuPrompt = PROMPT_CONTROLS;
       if (reposition == true) {
         x = disXYZ[0];
         lx = disLxLyLz[0];
@@ -224,6 +274,7 @@ void cpuView() {
         lz = disLxLyLz[2];
         reposition = false;
         motion_present = false;
+        snapCamera();
       }
     }
   } else {
@@ -233,4 +284,15 @@ void cpuView() {
     audio::stop(audio::Channel::ACTION);
   }
 }
+
+void drawCpuPrompt(int prompt) {
+  gfx::color3f(1., 1., 1.);
+  if (prompt == PROMPT_ASK_DISASSEMBLE) {
+    printMsg((char *)"Do you want to Disassemble ? Enter Y / N", 3., 5., -6.);
+  } else if (prompt == PROMPT_CONTROLS) {
+    printMsg((char *)"Press Enter to disassemble / Backspace to assemble",
+             5.24, 4.1, -4.275);
+    printMsg((char *)"Esc to exit view", 5.24, 3.8, -5.35);
+  }
+}
 #endif MOTION
\ No newline at end of file
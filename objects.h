@@ -2,6 +2,8 @@
 #define OBJECTS
 
 #include "bmpLoader.h"
+#include "frame_snapshot.h"
+#include "gfx.h"
 #include "gl_includes.h"
 
 #include "cpu_cable.h"
@@ -30,102 +32,113 @@ cable sata_;
 
 void drawCube() {
 
-  glPushMatrix();
+  gfx::push_matrix();
 
   GLfloat wallHeight = 9.;
 
-  glColor3f(0.792f + 0.1f, 0.561f + 0.1f, 0.258f + 0.1f);
-  glBegin(GL_POLYGON);
-  glVertex3f(-10.0f, 0.0f, -10.0f);
-  glVertex3f(-10.0f, 0.0f, 10.0f);
-  glVertex3f(-10.0f, wallHeight, 10.0f);
-  glVertex3f(-10.0f, wallHeight, -10.0f);
-  glEnd();
-
-  glBegin(GL_POLYGON);
-  glVertex3f(10.f, 0.0f, -10.0f);
-  glVertex3f(10.f, 0.0f, 10.f);
-  glVertex3f(10.f, wallHeight, 10.f);
-  glVertex3f(10.f, wallHeight, -10.0f);
-  glEnd();
+  gfx::color3f(0.792f + 0.1f, 0.561f + 0.1f, 0.258f + 0.1f);
+  gfx::begin(GL_POLYGON);
+  gfx::vertex3f(-10.0f, 0.0f, -10.0f);
+  gfx::vertex3f(-10.0f, 0.0f, 10.0f);
+  gfx::vertex3f(-10.0f, wallHeight, 10.0f);
+  gfx::vertex3f(-10.0f, wallHeight, -10.0f);
+  gfx::end();
+
+  gfx::begin(GL_POLYGON);
+  gfx::vertex3f(10.f, 0.0f, -10.0f);
+  gfx::vertex3f(10.f, 0.0f, 10.f);
+  gfx::vertex3f(10.f, wallHeight, 10.f);
+  gfx::vertex3f(10.f, wallHeight, -10.0f);
+  gfx::end();
 
   // front face
-  glBegin(GL_POLYGON);
-  glVertex3f(-10.0f, 0.0f, -10.0f);
-  glVertex3f(10.f, 0.0f, -10.0f);
-  glVertex3f(10.f, wallHeight, -10.0f);
-  glVertex3f(-10.0f, wallHeight, -10.0f);
-  glEnd();
-
-  glBegin(GL_POLYGON);
-  glVertex3f(-10.0f, 0.0f, 10.f);
-  glVertex3f(10.f, 0.0f, 10.f);
-  glVertex3f(10.f, wallHeight, 10.f);
-
-  glVertex3f(-10.0f, wallHeight, 10.0f);
-  glEnd();
-
-  glEnable(GL_TEXTURE_2D);
-  glBindTexture(GL_TEXTURE_2D, textures[WALL]);
+  gfx::begin(GL_POLYGON);
+  gfx::vertex3f(-10.0f, 0.0f, -10.0f);
+  gfx::vertex3f(10.f, 0.0f, -10.0f);
+  gfx::vertex3f(10.f, wallHeight, -10.0f);
+  gfx::vertex3f(-10.0f, wallHeight, -10.0f);
+  gfx::end();
+
+  gfx::begin(GL_POLYGON);
+  gfx::vertex3f(-10.0f, 0.0f, 10.f);
+  gfx::vertex3f(10.f, 0.0f, 10.f);
+  gfx::vertex3f(10.f, wallHeight, 10.f);
+
+  gfx::vertex3f(-10.0f, wallHeight, 10.0f);
+  gfx::end();
+
+  gfx::enable(GL_TEXTURE_2D);
+  gfx::bind_texture(textures[WALL]);
   /////fill
-  glDisable(GL_TEXTURE_2D);
+  gfx::disable(GL_TEXTURE_2D);
 
-  glEnable(GL_TEXTURE_2D);
-  glColor3f(1, 1, 1);
-  glBindTexture(GL_TEXTURE_2D, textures[CEILING]);
+  gfx::enable(GL_TEXTURE_2D);
+  gfx::color3f(1, 1, 1);
+  gfx::bind_texture(textures[CEILING]);
 
-  glBegin(GL_POLYGON);
-  glTexCoord2f(3., 3.);
-  glVertex3f(-10.0f, wallHeight, -10.0f);
-  glTexCoord2f(3., 0.);
-  glVertex3f(10.1f, wallHeight, -10.0f);
-  glTexCoord2f(0., 3.);
-  glVertex3f(10.1f, wallHeight, 10.0f);
-  glTexCoord2f(0., 0.);
-  glVertex3f(-10.0f, wallHeight, 10.0f);
+  gfx::begin(GL_POLYGON);
+  gfx::tex_coord2f(3., 3.);
+  gfx::vertex3f(-10.0f, wallHeight, -10.0f);
+  gfx::tex_coord2f(3., 0.);
+  gfx::vertex3f(10.1f, wallHeight, -10.0f);
+  gfx::tex_coord2f(0., 3.);
+  gfx::vertex3f(10.1f, wallHeight, 10.0f);
+  gfx::tex_coord2f(0., 0.);
+  gfx::vertex3f(-10.0f, wallHeight, 10.0f);
 
-  glEnd();
+  gfx::end();
 
-  glDisable(GL_TEXTURE_2D);
+  gfx::disable(GL_TEXTURE_2D);
 
-  glPopMatrix();
+  gfx::pop_matrix();
 }
 
 void drawGround() {
 
-  glColor3f(1., 1., 1.);
-  glPushMatrix();
-  glEnable(GL_TEXTURE_2D);
-  glBindTexture(GL_TEXTURE_2D, textures[WOODEN_FINISH]);
-  glColor3f(1., 1., 1.);
-  glBegin(GL_QUADS);
-  glTexCoord2f(3., 3.);
-  glVertex3f(-15., -0.3f, -15.f);
-  glTexCoord2f(3., 0.);
-  glVertex3f(-15.f, -0.3f, 15.f);
-  glTexCoord2f(0., 0.);
-  glVertex3f(15.f, -0.3f, 15.f);
-  glTexCoord2f(0., 3.);
-  glVertex3f(15.f, -0.3f, -15.f);
-  glEnd();
-  glPopMatrix();
-  glDisable(GL_TEXTURE_2D);
+  gfx::color3f(1., 1., 1.);
+  gfx::push_matrix();
+  gfx::enable(GL_TEXTURE_2D);
+  gfx::bind_texture(textures[WOODEN_FINISH]);
+  gfx::color3f(1., 1., 1.);
+  gfx::begin(GL_QUADS);
+  gfx::tex_coord2f(3., 3.);
+  gfx::vertex3f(-15., -0.3f, -15.f);
+  gfx::tex_coord2f(3., 0.);
+  gfx::vertex3f(-15.f, -0.3f, 15.f);
+  gfx::tex_coord2f(0., 0.);
+  gfx::vertex3f(15.f, -0.3f, 15.f);
+  gfx::tex_coord2f(0., 3.);
+  gfx::vertex3f(15.f, -0.3f, -15.f);
+  gfx::end();
+  gfx::pop_matrix();
+  gfx::disable(GL_TEXTURE_2D);
 }
 
-void drawCPU() {
-  fan_.render(); // Renders Fan
-  motherboard_.render();
-  ram_.render(8., 4.845, -4.296);
-  ram_.render(8., 4.845, -4.268);
-  ram_.render(8., 4.845, -4.235);
-  chipset_.render();
-  gpu_.render();
-  psu_.render();
-  harddisk_.render();
-  env_.render();
-  envTable_.render();
-  sata_.render();
-  case_.render();
+/// Advances every component's disassembly animation by one SIM_DT step.
+/// Order matters: the first part to finish clears 'enterPressed'.
+void updateCPU() {
+  fan_.update();
+  motherboard_.update();
+  ram_.update();
+  chipset_.update();
+  gpu_.update();
+  psu_.update();
+  harddisk_.update();
+  sata_.update();
+  case_.update();
+}
+
+/// Copies every removable part's pose into the frame snapshot.
+void snapshotCPU(PartPose parts[PART_COUNT]) {
+  parts[PART_FAN] = fan_.pose();
+  parts[PART_MOTHERBOARD] = motherboard_.pose();
+  parts[PART_RAM] = ram_.pose();
+  parts[PART_CHIPSET] = chipset_.pose();
+  parts[PART_GPU] = gpu_.pose();
+  parts[PART_PSU] = psu_.pose();
+  parts[PART_HDD] = harddisk_.pose();
+  parts[PART_SIDE_PANEL] = case_.pose();
+  parts[PART_CABLE] = sata_.pose();
 }
 
 #endif OBJECTS
\ No newline at end of file
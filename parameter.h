@@ -2,6 +2,8 @@
 #define PARAM
 #define _USE_MATH_DEFINES
 #include "gl_includes.h"
+#include "sim_clock.h"
+#include <atomic>
 #include <math.h>
 
 class point3D {
@@ -12,6 +14,12 @@ public:
   void assign(double a, double b, double c) { x = a, y = b, z = c; }
 };
 
+/// Blend between two simulation states (t = 0 -> a, t = 1 -> b).
+point3D lerp(const point3D &a, const point3D &b, float t) {
+  return point3D(a.x + (b.x - a.x) * t, a.y + (b.y - a.y) * t,
+                 a.z + (b.z - a.z) * t);
+}
+
 class point2D {
 
 public:
@@ -25,6 +33,11 @@ public:
 int width = 1920, hight = 1080;
 int page = 0;
 int mouseGlobalX = 0, mouseGlobalY = 0;
+std::atomic<bool> quitRequested(false); /// Esc outside CPU view
+std::atomic<bool> hudOverlay(false);      /// F2: performance HUD
+std::atomic<bool> profilerOverlay(false); /// F3: frame timing table
+std::atomic<bool> traceRequested(false);  /// F4, handled on the GL thread
+std::atomic<bool> labelAll(false);        /// F5: label every visible part
 
 // MOTION PARAMETERS
 #define UPPER_Y 7.0
@@ -35,12 +48,19 @@ float zx = 0.0f, zz = 0.0f;
 double x = .0f, z = 5.0f, y = 5.0;
 bool motion_present = false;
 float angle = 0.0f;
-int oldTimeSinceStart = 0, deltaTime;
 float fraction = 0.3f;
 float xmin = -8.5, xmax = 8.5, /// MOTION RESTRICTION PARAMETERS
     zmin = -8.5, zmax = 8.5, bounceVal = 1.;
 float motion_gap = 0.0001;
 
+// SIMULATION RATES (per second, applied in SIM_DT steps)
+float walkSpeed = 3.0f;         /// Arrow keys, units / sec
+float turnSpeed = 1.5f;         /// Home / End, radians / sec
+float lookSpeed = 0.75f;        /// Page Up / Down, units / sec
+float mouseNudge = 0.003f;      /// Rotation per mouse event, radians
+float disassembleSpeed = 0.42f; /// Parts sliding in / out, units / sec
+float fanSpinSpeed = 120.0f;    /// Degrees / sec
+
 // Texture count
 GLuint *textures;
 #define NUM_TEXTURE 40
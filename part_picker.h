@@ -0,0 +1,98 @@
+#ifndef PART_PICKER_H
+#define PART_PICKER_H
+
+#include "bvh.h"
+#include "camera.h"
+#include "frame_snapshot.h"
+#include "gfx.h"
+#include "scene_record.h"
+#include "tooltip.h"
+
+#include <vector>
+
+/*
+  EXACT PART PICKING
+  Every CPU part is recorded once at rest and its opaque triangles go into a
+  BVH of their own (bvh::Mesh). A bvh::Scene holds one instance per part,
+  moved by the part's offset every frame, so the mouse ray finds the first
+  part it really hits instead of the nearest bounding sphere. Parts without a
+  tooltip (motherboard, cables, the case) are in the scene too: they hide
+  whatever is behind them.
+*/
+
+/// The case body: never moves, and has no PART_* of its own
+const int PICK_CASE = PART_COUNT;
+
+namespace pick_jobs {
+void side_panel(const FrameSnapshot &s, float t) {
+  case_.render_side_panel(s.parts[PART_SIDE_PANEL], t);
+}
+void case_body(const FrameSnapshot &s, float t) {
+  PartPose noPanel = s.parts[PART_SIDE_PANEL];
+  noPanel.visible = false;
+  case_.render(noPanel, t);
+}
+} // namespace pick_jobs
+
+/// How each part records itself, by PART_* (then PICK_CASE)
+void (*const pickRecorders[PART_COUNT + 1])(const FrameSnapshot &, float) = {
+    scene_jobs::fan,      scene_jobs::motherboard, scene_jobs::ram,
+    scene_jobs::chipset,  scene_jobs::gpu,         scene_jobs::psu,
+    scene_jobs::harddisk, pick_jobs::side_panel,   scene_jobs::cable,
+    pick_jobs::case_body};
+
+class PartPicker {
+private:
+  bvh::Mesh meshes[PART_COUNT + 1]; /// By PART_* (then PICK_CASE)
+  bvh::Scene scene;                 /// Instance i is meshes[i]
+
+public:
+  /// Records every part at rest and builds the BVHs. 'tooltips[part]' is the
+  /// component a hit on that part reports (NO_COMPONENT: none). Needs
+  /// 'textures', as recording does.
+  void build(const ComponentId tooltips[PART_COUNT]) {
+    FrameSnapshot rest = FrameSnapshot();
+    for (int p = 0; p < PART_COUNT; p++)
+      rest.parts[p].visible = true;
+    gfx::CommandList list;
+    std::vector<float> triangles;
+    for (int p = 0; p <= PICK_CASE; p++) {
+      list.clear();
+      triangles.clear();
+      gfx::record_into(&list);
+      pickRecorders[p](rest, 1.0f);
+      gfx::record_into(nullptr);
+      bvh::collect_triangles(list, triangles);
+      meshes[p].build(triangles);
+      scene.add(&meshes[p], p < PART_COUNT ? tooltips[p] : NO_COMPONENT);
+    }
+    scene.update();
+  }
+
+  /// Moves the parts to where snapshot 's' has them, 't' past its step.
+  void update(const FrameSnapshot &s, float t) {
+    for (int p = 0; p < PART_COUNT; p++) {
+      point3D at = s.parts[p].at(t);
+      scene.move(p, (float)at.x, (float)at.y, (float)at.z);
+      scene.set_visible(p, s.parts[p].visible);
+    }
+    scene.update();
+  }
+
+  /// Tooltip of the first part along 'ray'; NO_COMPONENT if it hits
+  /// nothing or a part without one.
+  ComponentId pick(const gfx::Ray &ray) const {
+    bvh::Hit hit = scene.intersect(ray);
+    return hit.instance < 0 ? NO_COMPONENT : hit.id;
+  }
+
+  /// Whether 'part' can be seen from 'eye' past the other parts (see
+  /// bvh::Scene::visible()). As of the last update().
+  bool visible(int part, const float eye[3]) const {
+    return scene.visible(part, eye);
+  }
+
+  const bvh::Mesh &mesh(int part) const { return meshes[part]; }
+};
+
+#endif
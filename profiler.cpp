@@ -0,0 +1,388 @@
+#include "profiler.h"
+
+#ifndef NO_PROFILER
+
+#include "font_atlas.h"
+#include "trace.h"
+
+#ifndef __APPLE__
+#include <GL/glext.h>
+#endif
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+
+namespace prof {
+
+namespace {
+
+// Timer query entry points (GL 3.3 / ARB_timer_query), resolved in init_gpu().
+#ifndef __APPLE__
+#define PROF_FUNCTIONS(X) \
+	X(PFNGLGENQUERIESPROC, glGenQueries) \
+	X(PFNGLDELETEQUERIESPROC, glDeleteQueries) \
+	X(PFNGLBEGINQUERYPROC, glBeginQuery) \
+	X(PFNGLENDQUERYPROC, glEndQuery) \
+	X(PFNGLGETQUERYOBJECTIVPROC, glGetQueryObjectiv) \
+	X(PFNGLGETQUERYOBJECTUI64VPROC, glGetQueryObjectui64v)
+
+#define PROF_DECLARE(type, name) static type name = nullptr;
+PROF_FUNCTIONS(PROF_DECLARE)
+#undef PROF_DECLARE
+#endif
+
+const int QUERY_RING = 4; // Frames a GPU result may take before its query is reused
+
+struct Window {
+	float ms[WINDOW];
+	unsigned int count = 0, next = 0;
+
+	void push(float v) {
+		ms[next] = v;
+		next = (next + 1) % WINDOW;
+		if (count < WINDOW) count++;
+	}
+};
+
+struct Scope {
+	const char* name = nullptr;
+	int parent = -1;
+	std::atomic<unsigned long long> ns{0}; // This frame so far, any thread
+	std::atomic<unsigned int> runs{0};
+	std::atomic<unsigned long> calls[gfx::COUNTER_KINDS] = {}; // This frame so far
+	gfx::Counters last_calls = {}; // GL thread only
+	std::atomic<unsigned long> allocs{0}, alloc_bytes{0}, alloc_allowed{0}; // This frame so far
+	alloc::Counts last_allocs = {}; // GL thread only
+	Window cpu, gpu; // GL thread only
+	GLuint queries[QUERY_RING] = {};
+	bool pending[QUERY_RING] = {};
+	unsigned long issued[QUERY_RING] = {}; // Frame number
+};
+
+static Scope g_scopes[MAX_SCOPES];
+static std::atomic<int> g_count{0};
+static std::mutex g_register_lock;
+static thread_local int t_open = -1; // Innermost CPU scope on this thread
+
+static bool g_timer = false;
+static int g_gpu_open = -1; // GPU scope with a query running
+static unsigned long g_frame = 0;
+
+// Reads slot 'i' of 's' if the GPU is done with it.
+static void resolve(Scope& s, int i) {
+	GLint ready = 0;
+	glGetQueryObjectiv(s.queries[i], GL_QUERY_RESULT_AVAILABLE, &ready);
+	if (!ready) return;
+	GLuint64 ns = 0;
+	glGetQueryObjectui64v(s.queries[i], GL_QUERY_RESULT, &ns);
+	// The first frame is driver warm-up; Mesa's llvmpipe even reports an
+	// absolute timestamp for it.
+	if (s.issued[i] > 0) s.gpu.push((float)(ns / 1e6));
+	s.pending[i] = false;
+}
+
+static Timing timing(const Window& w) {
+	Timing t = {w.count, 0.0, 0.0, 0.0};
+	if (!w.count) return t;
+	float sorted[WINDOW];
+	std::copy(w.ms, w.ms + w.count, sorted);
+	std::sort(sorted, sorted + w.count);
+	double sum = 0.0;
+	for (unsigned int i = 0; i < w.count; i++) sum += sorted[i];
+	t.min = sorted[0];
+	t.avg = sum / w.count;
+	t.p99 = sorted[std::min(w.count - 1, w.count * 99 / 100)];
+	return t;
+}
+
+static void collect(int parent, int depth, int count, std::vector<Stats>& out) {
+	for (int i = 0; i < count; i++) {
+		const Scope& s = g_scopes[i];
+		if (s.parent != parent) continue;
+		if (s.cpu.count) {
+			Stats st = {s.name, depth, timing(s.cpu), timing(s.gpu), s.last_calls, s.last_allocs};
+			out.push_back(st);
+		}
+		collect(i, depth + 1, count, out);
+	}
+}
+
+// Pixel width of 'text' in Helvetica 12.
+static int text_width(const char* text) {
+	int w = 0;
+	for (; *text; text++) w += gfx::font_advance(gfx::FONT_HELVETICA_12, (unsigned char)*text);
+	return w;
+}
+
+static void text_right(float right, float y, const char* text) {
+	gfx::raster_pos2f(right - text_width(text), y);
+	gfx::bitmap_string(GLUT_BITMAP_HELVETICA_12, text);
+}
+
+} // namespace
+
+int register_scope(const char* name) {
+	std::lock_guard<std::mutex> guard(g_register_lock);
+	int count = g_count.load();
+	for (int i = 0; i < count; i++) {
+		if (std::strcmp(g_scopes[i].name, name) == 0) return i;
+	}
+	if (count == MAX_SCOPES) return -1;
+	g_scopes[count].name = name;
+	g_scopes[count].parent = t_open;
+	g_count.store(count + 1);
+	return count;
+}
+
+CpuScope::CpuScope(int id) : id(id), parent(t_open), traced(false) {
+	if (id >= 0) {
+		t_open = id;
+		traced = trace::recording();
+		if (traced) trace::begin(g_scopes[id].name, "frame");
+	}
+#ifndef NO_GFX_COUNTERS
+	counts = gfx::thread_counters();
+#endif
+#ifndef NO_ALLOC_TRACKING
+	allocs = alloc::thread_counts();
+#endif
+	start = std::chrono::steady_clock::now();
+}
+
+CpuScope::~CpuScope() {
+	if (id < 0) return;
+	if (traced) trace::end(g_scopes[id].name, "frame");
+	t_open = parent;
+	std::chrono::nanoseconds ns = std::chrono::steady_clock::now() - start;
+	g_scopes[id].ns.fetch_add((unsigned long long)ns.count(), std::memory_order_relaxed);
+	g_scopes[id].runs.fetch_add(1, std::memory_order_relaxed);
+#ifndef NO_GFX_COUNTERS
+	gfx::Counters now = gfx::thread_counters();
+	for (int k = 0; k < gfx::COUNTER_KINDS; k++) {
+		if (now.n[k] != counts.n[k]) g_scopes[id].calls[k].fetch_add(now.n[k] - counts.n[k], std::memory_order_relaxed);
+	}
+#endif
+#ifndef NO_ALLOC_TRACKING
+	alloc::Counts made = alloc::thread_counts();
+	if (made.allocs != allocs.allocs) {
+		g_scopes[id].allocs.fetch_add(made.allocs - allocs.allocs, std::memory_order_relaxed);
+		g_scopes[id].alloc_bytes.fetch_add(made.bytes - allocs.bytes, std::memory_order_relaxed);
+		g_scopes[id].alloc_allowed.fetch_add(made.allowed - allocs.allowed, std::memory_order_relaxed);
+	}
+#endif
+}
+
+GpuScope::GpuScope(int id) : id(-1), slot(0) {
+	if (!g_timer || id < 0 || g_gpu_open >= 0) return;
+	Scope& s = g_scopes[id];
+	if (!s.queries[0]) glGenQueries(QUERY_RING, s.queries);
+	int i = (int)(g_frame % QUERY_RING);
+	if (s.pending[i]) resolve(s, i);
+	if (s.pending[i]) return; // GPU still busy with it: skip rather than wait
+	glBeginQuery(GL_TIME_ELAPSED, s.queries[i]);
+	s.issued[i] = g_frame;
+	this->id = id;
+	slot = i;
+	g_gpu_open = id;
+}
+
+GpuScope::~GpuScope() {
+	if (id < 0) return;
+	glEndQuery(GL_TIME_ELAPSED);
+	g_scopes[id].pending[slot] = true;
+	g_gpu_open = -1;
+}
+
+bool init_gpu(gfx::ProcLoader loader) {
+#ifdef __APPLE__
+	(void)loader;
+	return false; // No GL_TIME_ELAPSED in the 2.1 headers; CPU scopes only
+#else
+	int major = 0, minor = 0;
+	const char* version = loader ? (const char*)glGetString(GL_VERSION) : nullptr;
+	if (version) std::sscanf(version, "%d.%d", &major, &minor);
+	bool ok = loader != nullptr && major * 10 + minor >= 33;
+#define PROF_LOAD(type, name) \
+	name = ok ? (type)loader(#name) : nullptr; \
+	ok = ok && name;
+	PROF_FUNCTIONS(PROF_LOAD)
+#undef PROF_LOAD
+	g_timer = ok;
+	return ok;
+#endif
+}
+
+void shutdown_gpu() {
+	if (!g_timer) return;
+	int count = g_count.load();
+	for (int i = 0; i < count; i++) {
+		Scope& s = g_scopes[i];
+		if (!s.queries[0]) continue;
+		glDeleteQueries(QUERY_RING, s.queries);
+		std::memset(s.queries, 0, sizeof(s.queries));
+		std::memset(s.pending, 0, sizeof(s.pending));
+	}
+	g_timer = false;
+}
+
+void end_frame() {
+	int count = g_count.load();
+	for (int i = 0; i < count; i++) {
+		Scope& s = g_scopes[i];
+		if (s.runs.exchange(0, std::memory_order_relaxed)) {
+			s.cpu.push((float)(s.ns.exchange(0, std::memory_order_relaxed) / 1e6));
+			for (int k = 0; k < gfx::COUNTER_KINDS; k++) s.last_calls.n[k] = s.calls[k].exchange(0, std::memory_order_relaxed);
+		}
+		// Unlike the calls, zero for a frame it didn't run: a one-off
+		// scope's allocations would otherwise be reported every frame.
+		s.last_allocs.allocs = s.allocs.exchange(0, std::memory_order_relaxed);
+		s.last_allocs.bytes = s.alloc_bytes.exchange(0, std::memory_order_relaxed);
+		s.last_allocs.allowed = s.alloc_allowed.exchange(0, std::memory_order_relaxed);
+		if (!g_timer) continue;
+		for (int q = 0; q < QUERY_RING; q++) {
+			if (s.pending[q]) resolve(s, q);
+		}
+	}
+	g_frame++;
+}
+
+void stats(std::vector<Stats>& out) {
+	out.clear();
+	collect(-1, 0, g_count.load(), out);
+}
+
+void record_overlay(int w, int h) {
+	static std::vector<Stats> rows;
+	stats(rows);
+	const float lineH = 15.0f, pad = 8.0f;
+	const float nameW = 150.0f, colW = 56.0f;
+	// Timings, then draws / vertices, then allocations
+	const int allocCol = gfx::COUNTERS_ENABLED ? 8 : 6;
+	const int cols = allocCol + (alloc::TRACKING_ENABLED ? 1 : 0);
+	const float tableW = nameW + colW * cols + pad * 2;
+	const float top = h - pad;
+	const size_t lines = rows.size() + 1 + (gfx::COUNTERS_ENABLED ? 1 : 0) + (alloc::TRACKING_ENABLED ? 1 : 0);
+	const float bottom = top - lineH * lines - pad * 2;
+
+	gfx::matrix_mode(GL_PROJECTION);
+	gfx::push_matrix();
+	gfx::load_identity();
+	gfx::ortho2d(0, w, 0, h);
+	gfx::matrix_mode(GL_MODELVIEW);
+	gfx::push_matrix();
+	gfx::load_identity();
+
+	gfx::disable(GL_LIGHTING);
+	gfx::disable(GL_TEXTURE_2D);
+	gfx::disable(GL_DEPTH_TEST);
+	gfx::enable(GL_BLEND);
+	gfx::blend_func(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+	gfx::color4f(0.0f, 0.0f, 0.0f, 0.65f);
+	gfx::begin(GL_QUADS);
+	gfx::vertex2f(pad, bottom);
+	gfx::vertex2f(pad + tableW, bottom);
+	gfx::vertex2f(pad + tableW, top);
+	gfx::vertex2f(pad, top);
+	gfx::end();
+	gfx::disable(GL_BLEND);
+
+	static const char* headers[8] = {"cpu min", "avg", "p99", "gpu min", "avg", "p99", "draws", "verts"};
+	float x0 = pad * 2, y = top - pad - 11.0f;
+	gfx::color3f(0.6f, 0.9f, 1.0f);
+	char num[32];
+	std::snprintf(num, sizeof(num), "ms, last %d frames", WINDOW);
+	gfx::raster_pos2f(x0, y);
+	gfx::bitmap_string(GLUT_BITMAP_HELVETICA_12, num);
+	for (int c = 0; c < allocCol; c++) text_right(x0 + nameW + colW * (c + 1), y, headers[c]);
+	if (alloc::TRACKING_ENABLED) text_right(x0 + nameW + colW * cols, y, "allocs");
+
+	for (size_t r = 0; r < rows.size(); r++) {
+		const Stats& s = rows[r];
+		y -= lineH;
+		gfx::color3f(1.0f, 1.0f, 1.0f);
+		gfx::raster_pos2f(x0 + 10.0f * s.depth, y);
+		gfx::bitmap_string(GLUT_BITMAP_HELVETICA_12, s.name);
+		const Timing* t[2] = {&s.cpu, &s.gpu};
+		for (int k = 0; k < 2; k++) {
+			if (!t[k]->samples) continue;
+			const double v[3] = {t[k]->min, t[k]->avg, t[k]->p99};
+			for (int c = 0; c < 3; c++) {
+				std::snprintf(num, sizeof(num), "%.2f", v[c]);
+				gfx::color3f(k ? 0.6f : 1.0f, 1.0f, k ? 0.6f : 1.0f);
+				text_right(x0 + nameW + colW * (k * 3 + c + 1), y, num);
+			}
+		}
+		if (alloc::TRACKING_ENABLED && s.allocs.allocs) {
+			gfx::color3f(1.0f, 0.6f, 0.6f);
+			std::snprintf(num, sizeof(num), "%lu", s.allocs.allocs);
+			text_right(x0 + nameW + colW * cols, y, num);
+		}
+		if (!gfx::COUNTERS_ENABLED || !(s.calls.n[gfx::COUNT_DRAWS] + s.calls.n[gfx::COUNT_VERTICES])) continue;
+		gfx::color3f(1.0f, 0.85f, 0.5f);
+		std::snprintf(num, sizeof(num), "%lu", s.calls.n[gfx::COUNT_DRAWS]);
+		text_right(x0 + nameW + colW * 7, y, num);
+		std::snprintf(num, sizeof(num), "%lu", s.calls.n[gfx::COUNT_VERTICES]);
+		text_right(x0 + nameW + colW * 8, y, num);
+	}
+
+	if (gfx::COUNTERS_ENABLED) {
+		gfx::Counters frame = gfx::frame_counters();
+		char line[160];
+		std::snprintf(line, sizeof(line), "frame: %lu draws, %lu vertices, %lu primitives, %lu binds, %lu states, %lu glyphs",
+		              frame.n[gfx::COUNT_DRAWS], frame.n[gfx::COUNT_VERTICES], frame.n[gfx::COUNT_PRIMITIVES],
+		              frame.n[gfx::COUNT_BINDS], frame.n[gfx::COUNT_STATES], frame.n[gfx::COUNT_GLYPHS]);
+		y -= lineH;
+		gfx::color3f(1.0f, 0.85f, 0.5f);
+		gfx::raster_pos2f(x0, y);
+		gfx::bitmap_string(GLUT_BITMAP_HELVETICA_12, line);
+	}
+	if (alloc::TRACKING_ENABLED) {
+		alloc::Counts frame = alloc::frame_counts();
+		char line[160];
+		std::snprintf(line, sizeof(line), "frame: %lu allocations, %lu bytes, %lu frees", frame.allocs, frame.bytes,
+		              frame.frees);
+		y -= lineH;
+		gfx::color3f(1.0f, 0.6f, 0.6f);
+		gfx::raster_pos2f(x0, y);
+		gfx::bitmap_string(GLUT_BITMAP_HELVETICA_12, line);
+	}
+
+	gfx::enable(GL_DEPTH_TEST);
+	gfx::enable(GL_LIGHTING);
+	gfx::pop_matrix();
+	gfx::matrix_mode(GL_PROJECTION);
+	gfx::pop_matrix();
+	gfx::matrix_mode(GL_MODELVIEW);
+}
+
+bool export_csv(const char* path) {
+	FILE* f = std::fopen(path, "w");
+	if (!f) {
+		std::fprintf(stderr, "profiler: can't write '%s'\n", path);
+		return false;
+	}
+	std::vector<Stats> rows;
+	stats(rows);
+	std::fprintf(f, "scope,depth,cpu_samples,cpu_min_ms,cpu_avg_ms,cpu_p99_ms,"
+	                "gpu_samples,gpu_min_ms,gpu_avg_ms,gpu_p99_ms");
+	for (int k = 0; gfx::COUNTERS_ENABLED && k < gfx::COUNTER_KINDS; k++) std::fprintf(f, ",%s", gfx::counter_name(k));
+	if (alloc::TRACKING_ENABLED) std::fprintf(f, ",allocs,alloc_bytes");
+	std::fprintf(f, "\n");
+	for (size_t i = 0; i < rows.size(); i++) {
+		const Stats& s = rows[i];
+		std::fprintf(f, "%s,%d,%u,%.4f,%.4f,%.4f,%u,%.4f,%.4f,%.4f", s.name, s.depth, s.cpu.samples, s.cpu.min,
+		             s.cpu.avg, s.cpu.p99, s.gpu.samples, s.gpu.min, s.gpu.avg, s.gpu.p99);
+		for (int k = 0; gfx::COUNTERS_ENABLED && k < gfx::COUNTER_KINDS; k++) std::fprintf(f, ",%lu", s.calls.n[k]);
+		if (alloc::TRACKING_ENABLED) std::fprintf(f, ",%lu,%lu", s.allocs.allocs, s.allocs.bytes);
+		std::fprintf(f, "\n");
+	}
+	std::fclose(f);
+	return true;
+}
+
+} // namespace prof
+
+#endif
@@ -0,0 +1,126 @@
+#pragma once
+
+#include "alloc_track.h"
+#include "gfx.h"
+
+#include <chrono>
+#include <vector>
+
+namespace prof {
+
+// Where the frame time goes. PROF_SCOPE("name") times the rest of the
+// enclosing block on the CPU, on any thread. PROF_GPU_SCOPE("name") also
+// wraps the block in a GL_TIME_ELAPSED query (GL thread only). The GPU
+// result is read a few frames later, once it is ready, so timing never
+// waits for the GPU. GPU scopes can't nest: an inner one only gets CPU time.
+//
+// A scope adds up all of its runs within a frame. end_frame() turns each
+// total into one sample and keeps the last WINDOW samples; stats() reports
+// their min / average / 99th percentile. CPU scopes also add up the gfx
+// calls recorded inside them (see gfx::Counters) and the heap allocations
+// made inside them (see alloc_track.h).
+//
+// Built with -DNO_PROFILER the macros expand to nothing and the functions
+// become empty inlines.
+
+const int WINDOW = 240; // Samples kept per scope, 4 s at 60 fps
+const int MAX_SCOPES = 64;
+
+struct Timing {
+	unsigned int samples; // In the window, 0: never ran
+	double min, avg, p99; // Milliseconds
+};
+
+struct Stats {
+	const char* name;
+	int depth; // Nesting under the scope that was open when it first ran
+	Timing cpu;
+	Timing gpu;
+	gfx::Counters calls; // Recorded in the latest frame it ran
+	alloc::Counts allocs; // Made in the last frame
+};
+
+#ifndef NO_PROFILER
+
+// Id for scope 'name' (the same for the same name); the macros call it
+// once per site. -1 once MAX_SCOPES are taken.
+int register_scope(const char* name);
+
+class CpuScope {
+public:
+	explicit CpuScope(int id);
+	~CpuScope();
+
+private:
+	int id;
+	int parent; // Scope open on this thread before this one
+	bool traced; // Also on the trace timeline, see trace.h
+	std::chrono::steady_clock::time_point start;
+#ifndef NO_GFX_COUNTERS
+	gfx::Counters counts; // gfx::thread_counters() at the start
+#endif
+#ifndef NO_ALLOC_TRACKING
+	alloc::Counts allocs; // alloc::thread_counts() at the start
+#endif
+};
+
+class GpuScope {
+public:
+	explicit GpuScope(int id);
+	~GpuScope();
+
+private:
+	int id; // -1: not timed
+	int slot;
+};
+
+// With the context current. False if it has no timer queries, or there is
+// no context ('loader' null); GPU scopes then record nothing.
+bool init_gpu(gfx::ProcLoader loader);
+void shutdown_gpu();
+
+// GL thread, once per frame drawn, after the swap.
+void end_frame();
+
+// Every scope that ran, parents before their children. GL thread.
+void stats(std::vector<Stats>& out);
+
+// Records stats() as a table into the current gfx target, top left of a
+// w x h window, with the last frame's gfx::frame_counters() and
+// alloc::frame_counts() below.
+void record_overlay(int w, int h);
+
+// Writes stats() as CSV. False if 'path' can't be written.
+bool export_csv(const char* path);
+
+#define PROF_CONCAT2(a, b) a##b
+#define PROF_CONCAT(a, b) PROF_CONCAT2(a, b)
+#define PROF_SCOPE(name) \
+	static const int PROF_CONCAT(prof_id_, __LINE__) = prof::register_scope(name); \
+	prof::CpuScope PROF_CONCAT(prof_cpu_, __LINE__)(PROF_CONCAT(prof_id_, __LINE__))
+#define PROF_GPU_SCOPE(name) \
+	PROF_SCOPE(name); \
+	prof::GpuScope PROF_CONCAT(prof_gpu_, __LINE__)(PROF_CONCAT(prof_id_, __LINE__))
+
+#else
+
+inline int register_scope(const char*) { return -1; }
+
+class CpuScope {
+public:
+	explicit CpuScope(int) {}
+};
+
+inline bool init_gpu(gfx::ProcLoader) { return false; }
+inline void shutdown_gpu() {}
+inline void end_frame() {}
+inline void stats(std::vector<Stats>& out) { out.clear(); }
+inline void record_overlay(int, int) {}
+inline bool export_csv(const char*) { return false; }
+
+#define PROF_SCOPE(name) ((void)0)
+#define PROF_GPU_SCOPE(name) ((void)0)
+
+#endif
+
+} // namespace prof
@@ -0,0 +1,153 @@
+#ifndef SCENE_RECORD_H
+#define SCENE_RECORD_H
+
+#include "frame_snapshot.h"
+#include "gfx.h"
+#include "jobs.h"
+#include "motion.h"
+#include "objects.h"
+#include "profiler.h"
+
+#include <vector>
+
+/*
+  PARALLEL SCENE RECORDING
+  The 3D scene is cut into independent record jobs - the room, each CPU part,
+  each furniture group - that the job pool records into a command list of
+  their own, each worker through its thread-local gfx target. The lists are
+  then merged by key into one frame list for the GL thread.
+
+  Keys follow the order the scene was always drawn in, so the merged frame is
+  exactly what a single thread would have recorded: GL state that leaks from
+  one object to the next (colour, texturing, blending) still leaks the same.
+*/
+
+enum SceneLayer {
+  LAYER_ROOM,  /// Floor, walls, prompt text
+  LAYER_PARTS, /// CPU parts and furniture
+  LAYER_CASE   /// Cable and case last: the side panel is see-through
+};
+
+#define SCENE_KEY(layer, order) ((unsigned)(layer) << 8 | (order))
+
+struct SceneJob {
+  unsigned key;
+  const char *name; /// Profiler scope
+  void (*record)(const FrameSnapshot &, float);
+};
+
+namespace scene_jobs {
+void ground(const FrameSnapshot &, float) { drawGround(); }
+void walls(const FrameSnapshot &, float) { drawCube(); }
+void prompt(const FrameSnapshot &s, float) { drawCpuPrompt(s.prompt); }
+
+void fan(const FrameSnapshot &s, float t) { fan_.render(s.parts[PART_FAN], t); }
+void motherboard(const FrameSnapshot &s, float t) {
+  motherboard_.render(s.parts[PART_MOTHERBOARD], t);
+}
+void ram(const FrameSnapshot &s, float t) {
+  ram_.render(s.parts[PART_RAM], t, 8., 4.845, -4.296);
+  ram_.render(s.parts[PART_RAM], t, 8., 4.845, -4.268);
+  ram_.render(s.parts[PART_RAM], t, 8., 4.845, -4.235);
+}
+void chipset(const FrameSnapshot &s, float t) {
+  chipset_.render(s.parts[PART_CHIPSET], t);
+}
+void gpu(const FrameSnapshot &s, float t) { gpu_.render(s.parts[PART_GPU], t); }
+void psu(const FrameSnapshot &s, float t) { psu_.render(s.parts[PART_PSU], t); }
+void harddisk(const FrameSnapshot &s, float t) {
+  harddisk_.render(s.parts[PART_HDD], t);
+}
+
+void desktop(const FrameSnapshot &s, float) { env_.desktop(s.objIndex); }
+void keyboard(const FrameSnapshot &, float) { env_.keyboard(); }
+void couch(const FrameSnapshot &, float) { env_.couch(); }
+void tv(const FrameSnapshot &, float) { env_.tv(); }
+void tvTable(const FrameSnapshot &, float) { env_.tvTable(); }
+void speaker(const FrameSnapshot &, float) { env_.speaker(); }
+void table(const FrameSnapshot &, float) { envTable_.render(); }
+
+void cable(const FrameSnapshot &s, float) { sata_.render(s.parts[PART_CABLE]); }
+void side_panel(const FrameSnapshot &s, float t) {
+  case_.render(s.parts[PART_SIDE_PANEL], t);
+}
+} // namespace scene_jobs
+
+const SceneJob sceneJobs[] = {
+    {SCENE_KEY(LAYER_ROOM, 0), "ground", scene_jobs::ground},
+    {SCENE_KEY(LAYER_ROOM, 1), "walls", scene_jobs::walls},
+    {SCENE_KEY(LAYER_ROOM, 2), "prompt", scene_jobs::prompt},
+    {SCENE_KEY(LAYER_PARTS, 0), "fan", scene_jobs::fan},
+    {SCENE_KEY(LAYER_PARTS, 1), "motherboard", scene_jobs::motherboard},
+    {SCENE_KEY(LAYER_PARTS, 2), "ram", scene_jobs::ram},
+    {SCENE_KEY(LAYER_PARTS, 3), "chipset", scene_jobs::chipset},
+    {SCENE_KEY(LAYER_PARTS, 4), "graphics card", scene_jobs::gpu},
+    {SCENE_KEY(LAYER_PARTS, 5), "psu", scene_jobs::psu},
+    {SCENE_KEY(LAYER_PARTS, 6), "harddisk", scene_jobs::harddisk},
+    {SCENE_KEY(LAYER_PARTS, 7), "desktop", scene_jobs::desktop},
+    {SCENE_KEY(LAYER_PARTS, 8), "keyboard", scene_jobs::keyboard},
+    {SCENE_KEY(LAYER_PARTS, 9), "couch", scene_jobs::couch},
+    {SCENE_KEY(LAYER_PARTS, 10), "tv", scene_jobs::tv},
+    {SCENE_KEY(LAYER_PARTS, 11), "tv table", scene_jobs::tvTable},
+    {SCENE_KEY(LAYER_PARTS, 12), "speaker", scene_jobs::speaker},
+    {SCENE_KEY(LAYER_PARTS, 13), "table", scene_jobs::table},
+    {SCENE_KEY(LAYER_CASE, 0), "cable", scene_jobs::cable},
+    {SCENE_KEY(LAYER_CASE, 1), "side panel", scene_jobs::side_panel},
+};
+const int SCENE_JOB_COUNT = sizeof(sceneJobs) / sizeof(sceneJobs[0]);
+
+class SceneRecorder {
+private:
+  std::vector<gfx::SortedList> buckets; /// One per job, kept between frames
+  int scopes[SCENE_JOB_COUNT];           /// Profiler ids, per job
+  bool registered = false;
+  const FrameSnapshot *snap = nullptr;
+  float t = 0.0f;
+  int copies = 1;
+  float spacing = 0.0f;
+
+  void recordJob(size_t index) {
+    gfx::SortedList &bucket = buckets[index];
+    const SceneJob &job = sceneJobs[index % SCENE_JOB_COUNT];
+    int copy = (int)(index / SCENE_JOB_COUNT);
+    bucket.key = job.key | (unsigned)copy << 16;
+    prof::CpuScope timing(scopes[index % SCENE_JOB_COUNT]);
+    bucket.list.clear();
+    gfx::record_into(&bucket.list);
+    if (copy > 0) {
+      // Stress copies of the room, laid out in rows beside the real one.
+      gfx::push_matrix();
+      gfx::translatef(spacing * (copy % 8), 0.0f, -spacing * (copy / 8));
+    }
+    job.record(*snap, t);
+    if (copy > 0)
+      gfx::pop_matrix();
+    gfx::record_into(nullptr);
+  }
+
+public:
+  /// Records the 3D part of snapshot 's' (CPU view) into 'out', after
+  /// whatever it already holds. 'copies' > 1 repeats the whole room side by
+  /// side, 'spacing' apart, to stress the recorder.
+  void record(const FrameSnapshot &s, float blend, jobs::Pool &pool,
+              gfx::CommandList &out, int roomCopies = 1,
+              float roomSpacing = 22.0f) {
+    snap = &s;
+    t = blend;
+    copies = roomCopies < 1 ? 1 : roomCopies;
+    spacing = roomSpacing;
+    size_t count = (size_t)SCENE_JOB_COUNT * copies;
+    if (buckets.size() < count)
+      buckets.resize(count);
+    if (!registered) { // Here, so the jobs nest under the caller's scope
+      for (int i = 0; i < SCENE_JOB_COUNT; i++)
+        scopes[i] = prof::register_scope(sceneJobs[i].name);
+      registered = true;
+    }
+
+    pool.parallel_for(count, [this](size_t i) { recordJob(i); });
+    gfx::merge(buckets.data(), count, out);
+  }
+};
+
+#endif
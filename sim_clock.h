@@ -0,0 +1,68 @@
+#ifndef SIM_CLOCK_H
+#define SIM_CLOCK_H
+
+#include <chrono>
+
+// FIXED SIMULATION STEP
+// Every motionHandle() / camera update advances the world by exactly SIM_DT
+// seconds, however often we happen to render.
+#define SIM_HZ 120
+const float SIM_DT = 1.0f / SIM_HZ;
+
+// Longest wall-clock gap we try to catch up on (texture loads, window drags,
+// breakpoints). Anything beyond this is simply dropped.
+const float SIM_MAX_FRAME = 0.25f;
+
+class SimClock {
+private:
+  typedef std::chrono::steady_clock clock;
+  clock::time_point last;
+  bool started = false;
+  float accumulator = 0.0f;
+  float frameDelta = 0.0f;
+  float fixedDelta = 0.0f;
+  double simTime = 0.0;
+
+public:
+  /// Accumulates the wall time since the previous call and returns how many
+  /// fixed steps are due. The caller runs exactly that many updates.
+  int advance() {
+    clock::time_point now = clock::now();
+    if (!started) {
+      last = now;
+      started = true;
+    }
+    frameDelta = fixedDelta > 0.0f
+                     ? fixedDelta
+                     : std::chrono::duration<float>(now - last).count();
+    last = now;
+    if (frameDelta > SIM_MAX_FRAME)
+      frameDelta = SIM_MAX_FRAME;
+
+    accumulator += frameDelta;
+    int steps = 0;
+    while (accumulator >= SIM_DT) {
+      accumulator -= SIM_DT;
+      simTime += SIM_DT;
+      steps++;
+    }
+    return steps;
+  }
+
+  /// Makes every advance() count exactly 'seconds' instead of the wall
+  /// time, for reproducible offscreen runs; 0 goes back to the wall clock.
+  void setFixedDelta(float seconds) { fixedDelta = seconds; }
+  float fixed() const { return fixedDelta; }
+
+  /// Fraction [0, 1) of a step left over, used to blend previous and current
+  /// simulation state when drawing.
+  float alpha() const { return accumulator / SIM_DT; }
+
+  /// Wall-clock seconds between the last two advance() calls.
+  float frameTime() const { return frameDelta; }
+
+  /// Total simulated seconds.
+  double now() const { return simTime; }
+};
+
+#endif
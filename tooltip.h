@@ -1,7 +1,10 @@
 #ifndef TOOLTIP_H
 #define TOOLTIP_H
 
+#include "camera.h"
+#include "gfx.h"
 #include "gl_includes.h"
+#include "label_layout.h"
 #include <cmath>
 #include <iostream>
 #include <string>
@@ -11,43 +14,115 @@
 #define M_PI 3.14159265358979323846
 #endif
 
-// Structure to hold component data
+/// Handle to a component, returned by TooltipSystem::registerComponent().
+typedef int ComponentId;
+const ComponentId NO_COMPONENT = -1;
+
+/// A point in world space.
+struct float3 {
+  float x, y, z;
+};
+
+// Per-component data that picking does not touch
 struct ComponentInfo {
   std::string name;
   std::string description;
-  float x, y, z;
   float radius;
-  float hoverTime; // Track how long component has been hovered
-  bool isVisible;  // Whether the component is visible (not disassembled out of
-                   // view)
-  std::string blockedBy; // Name of component that blocks this one's label
-                         // (empty = not blocked)
-  bool blockerRemoved;   // Whether the blocking component has been removed
+  ComponentId blockedBy; // Component that blocks this one's label
+                         // (NO_COMPONENT = not blocked)
+  bool isVisible;      // Whether the component is visible (not disassembled out
+                       // of view)
+  bool blockerRemoved; // Whether the blocking component has been removed
+  bool isOccluded;     // Whether other geometry hides it from the camera
+  GLuint panelTexture; // Label panel drawn once (0 = not yet, see cachePanel())
+  bool panelDirty;     // Whether the text changed since
 };
 
+// Area of a label's billboard that its panel texture covers, in world units
+// from the bottom centre of the panel, and the texture's size: 128 texels a
+// unit, enough for the text to come out as it does drawn directly.
+const float PANEL_LEFT = -1.25f, PANEL_BOTTOM = -0.2f;
+const float PANEL_WIDTH = 2.5f, PANEL_HEIGHT = 1.25f;
+const int PANEL_TEXELS_X = 320, PANEL_TEXELS_Y = 160;
+
+// Pixels a world unit of panel takes when every label is drawn flat on the
+// screen (see drawAll())
+const float LABEL_SCALE = 96.0f;
+
 class TooltipSystem {
 private:
   std::vector<ComponentInfo> components;
+  // What update() reads for every component, every frame, as one array per
+  // field so the ray test streams through them in a vectorizable loop. All
+  // sized in registerComponent(), so a frame never allocates, and padded to
+  // whole groups of PICK_LANES with entries that never hit.
+  static const size_t PICK_LANES = 4;
+  std::vector<float> centerX, centerY, centerZ;
+  std::vector<float> pickRadius2; // Squared detection radius; -1 = not pickable
+  std::vector<float> hoverTime;   // Track how long component has been hovered
+  std::vector<float> hitT;        // Scratch: distance along the ray, 1e9 = miss
+  std::vector<ComponentId> blocked; // Components with a blocker
   int focusedIndex = -1;
   int prevFocusedIndex = -1;
+  int labelIndex = -1; // Component whose label is drawn (see update())
+  gfx::CommandList panelList; // Scratch for cachePanel()
+  labels::Layout layout;                  // Where drawAll() puts the labels
+  std::vector<labels::Label> labelAnchors; // Scratch for drawAll(), by id
   float globalPulse = 0.0f;
 
+  // Components rounded up to whole groups of PICK_LANES. Computed rather than
+  // read from a vector's size so the compiler can see the loops need no
+  // scalar tail; at -O2 GCC only vectorizes loops that don't.
+  size_t pickLanes() const {
+    return (components.size() + PICK_LANES - 1) & ~(PICK_LANES - 1);
+  }
+
+  // Ray-Sphere Intersection: hit[i] is how far along the ray (origin o,
+  // normalized direction d) sphere i is hit, or 1e9 if it is missed. No
+  // branches, so the compiler can run it several spheres per instruction.
+  // Hidden and blocked components have a negative squared radius and never
+  // hit. '__restrict' promises the output overlaps none of the inputs.
+  static void rayTest(const float *cx, const float *cy, const float *cz,
+                      const float *r2, float *__restrict hit, size_t lanes,
+                      float ox, float oy, float oz, float dx, float dy,
+                      float dz) {
+    for (size_t i = 0; i < lanes; i++) {
+      // Vector from Ray Origin to Sphere Center
+      float fx = cx[i] - ox;
+      float fy = cy[i] - oy;
+      float fz = cz[i] - oz;
+      // Project f onto d (t_ca); behind the ray origin if negative
+      float t = fx * dx + fy * dy + fz * dz;
+      // Distance squared from center to ray
+      float d2 = fx * fx + fy * fy + fz * fz - t * t;
+      // '&', not '&&': a short-circuit is a branch and stops vectorization
+      hit[i] = ((t >= 0.0f) & (d2 < r2[i])) ? t : 1e9f;
+    }
+  }
+
+  // Recompute whether a component can be picked after its visibility or
+  // blocker changes
+  void refreshPick(ComponentId id) {
+    const ComponentInfo &c = components[id];
+    bool pickable = c.isVisible && !c.isOccluded &&
+                    (c.blockedBy == NO_COMPONENT || c.blockerRemoved);
+    // Use slightly larger detection radius for easier hovering
+    float detectionRadius = c.radius * 1.2f;
+    pickRadius2[id] = pickable ? detectionRadius * detectionRadius : -1.0f;
+  }
+
   // Helper to render text at a specific 3D location with shadow for better
   // visibility
-  void renderTextWithShadow(std::string text, float x, float y,
+  void renderTextWithShadow(const std::string &text, float x, float y,
                             void *font = GLUT_BITMAP_HELVETICA_18) {
     // Draw shadow first (offset slightly)
-    glColor4f(0.0f, 0.0f, 0.0f, 0.8f);
-    glRasterPos2f(x + 0.02f, y - 0.02f);
-    for (char c : text) {
-      glutBitmapCharacter(font, c);
-    }
+    gfx::color4f(0.0f, 0.0f, 0.0f, 0.8f);
+    gfx::raster_pos2f(x + 0.02f, y - 0.02f);
+    gfx::bitmap_string(font, text.c_str(), text.size());
     // Draw main text
-    glColor3f(1.0f, 1.0f, 1.0f);
-    glRasterPos2f(x, y);
-    for (char c : text) {
-      glutBitmapCharacter(font, c);
-    }
+    gfx::color3f(1.0f, 1.0f, 1.0f);
+    gfx::raster_pos2f(x, y);
+    gfx::bitmap_string(font, text.c_str(), text.size());
   }
 
   // Draw glow effect around an object
@@ -55,24 +130,24 @@ private:
     float r = radius * 1.3f;
     int segments = 32;
 
-    glEnable(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE);
+    gfx::enable(GL_BLEND);
+    gfx::blend_func(GL_SRC_ALPHA, GL_ONE);
 
     // Multiple layers of glow for better effect
     for (int layer = 0; layer < 3; layer++) {
       float layerRadius = r * (1.0f + layer * 0.15f);
       float alpha = intensity * (0.3f - layer * 0.08f);
 
-      glColor4f(0.0f, 0.8f, 1.0f, alpha);
-      glBegin(GL_LINE_LOOP);
+      gfx::color4f(0.0f, 0.8f, 1.0f, alpha);
+      gfx::begin(GL_LINE_LOOP);
       for (int i = 0; i < segments; i++) {
         float angle = 2.0f * M_PI * i / segments;
-        glVertex3f(layerRadius * cos(angle), 0.0f, layerRadius * sin(angle));
+        gfx::vertex3f(layerRadius * cos(angle), 0.0f, layerRadius * sin(angle));
       }
-      glEnd();
+      gfx::end();
     }
 
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    gfx::blend_func(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
   }
 
   // Draw an enhanced fancy bracket around the object with glow
@@ -84,392 +159,525 @@ private:
     float scale = 1.0f + 0.08f * sin(globalPulse) * hoverIntensity;
 
     // Draw glow layers first
-    glPushMatrix();
-    glEnable(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE);
+    gfx::push_matrix();
+    gfx::enable(GL_BLEND);
+    gfx::blend_func(GL_SRC_ALPHA, GL_ONE);
 
     for (int glow = 2; glow >= 0; glow--) {
       float glowWidth = 2.5f + glow * 2.0f;
       float alpha = (0.4f - glow * 0.12f) * hoverIntensity;
-      glLineWidth(glowWidth);
-      glColor4f(0.0f, 0.8f, 1.0f, alpha);
+      gfx::line_width(glowWidth);
+      gfx::color4f(0.0f, 0.8f, 1.0f, alpha);
 
-      glPushMatrix();
-      glScalef(scale, scale, scale);
+      gfx::push_matrix();
+      gfx::scalef(scale, scale, scale);
 
-      glBegin(GL_LINES);
+      gfx::begin(GL_LINES);
       // Bottom-Left-Front
-      glVertex3f(-r, -r, r);
-      glVertex3f(-r + corner, -r, r);
-      glVertex3f(-r, -r, r);
-      glVertex3f(-r, -r + corner, r);
-      glVertex3f(-r, -r, r);
-      glVertex3f(-r, -r, r - corner);
+      gfx::vertex3f(-r, -r, r);
+      gfx::vertex3f(-r + corner, -r, r);
+      gfx::vertex3f(-r, -r, r);
+      gfx::vertex3f(-r, -r + corner, r);
+      gfx::vertex3f(-r, -r, r);
+      gfx::vertex3f(-r, -r, r - corner);
       // Top-Right-Front
-      glVertex3f(r, r, r);
-      glVertex3f(r - corner, r, r);
-      glVertex3f(r, r, r);
-      glVertex3f(r, r - corner, r);
-      glVertex3f(r, r, r);
-      glVertex3f(r, r, r - corner);
+      gfx::vertex3f(r, r, r);
+      gfx::vertex3f(r - corner, r, r);
+      gfx::vertex3f(r, r, r);
+      gfx::vertex3f(r, r - corner, r);
+      gfx::vertex3f(r, r, r);
+      gfx::vertex3f(r, r, r - corner);
       // Top-Left-Back
-      glVertex3f(-r, r, -r);
-      glVertex3f(-r + corner, r, -r);
-      glVertex3f(-r, r, -r);
-      glVertex3f(-r, r - corner, -r);
-      glVertex3f(-r, r, -r);
-      glVertex3f(-r, r, -r + corner);
+      gfx::vertex3f(-r, r, -r);
+      gfx::vertex3f(-r + corner, r, -r);
+      gfx::vertex3f(-r, r, -r);
+      gfx::vertex3f(-r, r - corner, -r);
+      gfx::vertex3f(-r, r, -r);
+      gfx::vertex3f(-r, r, -r + corner);
       // Bottom-Right-Back
-      glVertex3f(r, -r, -r);
-      glVertex3f(r - corner, -r, -r);
-      glVertex3f(r, -r, -r);
-      glVertex3f(r, -r + corner, -r);
-      glVertex3f(r, -r, -r);
-      glVertex3f(r, -r, -r + corner);
-      glEnd();
-
-      glPopMatrix();
+      gfx::vertex3f(r, -r, -r);
+      gfx::vertex3f(r - corner, -r, -r);
+      gfx::vertex3f(r, -r, -r);
+      gfx::vertex3f(r, -r + corner, -r);
+      gfx::vertex3f(r, -r, -r);
+      gfx::vertex3f(r, -r, -r + corner);
+      gfx::end();
+
+      gfx::pop_matrix();
     }
 
     // Main sharp bracket
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-    glLineWidth(3.0f);
-    glColor4f(0.0f, 1.0f, 1.0f, 1.0f); // Brighter cyan
+    gfx::blend_func(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    gfx::line_width(3.0f);
+    gfx::color4f(0.0f, 1.0f, 1.0f, 1.0f); // Brighter cyan
 
-    glPushMatrix();
-    glScalef(scale, scale, scale);
+    gfx::push_matrix();
+    gfx::scalef(scale, scale, scale);
 
-    glBegin(GL_LINES);
+    gfx::begin(GL_LINES);
     // All 8 corners
     // Bottom-Left-Front
-    glVertex3f(-r, -r, r);
-    glVertex3f(-r + corner, -r, r);
-    glVertex3f(-r, -r, r);
-    glVertex3f(-r, -r + corner, r);
-    glVertex3f(-r, -r, r);
-    glVertex3f(-r, -r, r - corner);
+    gfx::vertex3f(-r, -r, r);
+    gfx::vertex3f(-r + corner, -r, r);
+    gfx::vertex3f(-r, -r, r);
+    gfx::vertex3f(-r, -r + corner, r);
+    gfx::vertex3f(-r, -r, r);
+    gfx::vertex3f(-r, -r, r - corner);
     // Top-Right-Front
-    glVertex3f(r, r, r);
-    glVertex3f(r - corner, r, r);
-    glVertex3f(r, r, r);
-    glVertex3f(r, r - corner, r);
-    glVertex3f(r, r, r);
-    glVertex3f(r, r, r - corner);
+    gfx::vertex3f(r, r, r);
+    gfx::vertex3f(r - corner, r, r);
+    gfx::vertex3f(r, r, r);
+    gfx::vertex3f(r, r - corner, r);
+    gfx::vertex3f(r, r, r);
+    gfx::vertex3f(r, r, r - corner);
     // Top-Left-Back
-    glVertex3f(-r, r, -r);
-    glVertex3f(-r + corner, r, -r);
-    glVertex3f(-r, r, -r);
-    glVertex3f(-r, r - corner, -r);
-    glVertex3f(-r, r, -r);
-    glVertex3f(-r, r, -r + corner);
+    gfx::vertex3f(-r, r, -r);
+    gfx::vertex3f(-r + corner, r, -r);
+    gfx::vertex3f(-r, r, -r);
+    gfx::vertex3f(-r, r - corner, -r);
+    gfx::vertex3f(-r, r, -r);
+    gfx::vertex3f(-r, r, -r + corner);
     // Bottom-Right-Back
-    glVertex3f(r, -r, -r);
-    glVertex3f(r - corner, -r, -r);
-    glVertex3f(r, -r, -r);
-    glVertex3f(r, -r + corner, -r);
-    glVertex3f(r, -r, -r);
-    glVertex3f(r, -r, -r + corner);
+    gfx::vertex3f(r, -r, -r);
+    gfx::vertex3f(r - corner, -r, -r);
+    gfx::vertex3f(r, -r, -r);
+    gfx::vertex3f(r, -r + corner, -r);
+    gfx::vertex3f(r, -r, -r);
+    gfx::vertex3f(r, -r, -r + corner);
     // Additional corners for full visibility
     // Top-Left-Front
-    glVertex3f(-r, r, r);
-    glVertex3f(-r + corner, r, r);
-    glVertex3f(-r, r, r);
-    glVertex3f(-r, r - corner, r);
-    glVertex3f(-r, r, r);
-    glVertex3f(-r, r, r - corner);
+    gfx::vertex3f(-r, r, r);
+    gfx::vertex3f(-r + corner, r, r);
+    gfx::vertex3f(-r, r, r);
+    gfx::vertex3f(-r, r - corner, r);
+    gfx::vertex3f(-r, r, r);
+    gfx::vertex3f(-r, r, r - corner);
     // Bottom-Right-Front
-    glVertex3f(r, -r, r);
-    glVertex3f(r - corner, -r, r);
-    glVertex3f(r, -r, r);
-    glVertex3f(r, -r + corner, r);
-    glVertex3f(r, -r, r);
-    glVertex3f(r, -r, r - corner);
+    gfx::vertex3f(r, -r, r);
+    gfx::vertex3f(r - corner, -r, r);
+    gfx::vertex3f(r, -r, r);
+    gfx::vertex3f(r, -r + corner, r);
+    gfx::vertex3f(r, -r, r);
+    gfx::vertex3f(r, -r, r - corner);
     // Top-Right-Back
-    glVertex3f(r, r, -r);
-    glVertex3f(r - corner, r, -r);
-    glVertex3f(r, r, -r);
-    glVertex3f(r, r - corner, -r);
-    glVertex3f(r, r, -r);
-    glVertex3f(r, r, -r + corner);
+    gfx::vertex3f(r, r, -r);
+    gfx::vertex3f(r - corner, r, -r);
+    gfx::vertex3f(r, r, -r);
+    gfx::vertex3f(r, r - corner, -r);
+    gfx::vertex3f(r, r, -r);
+    gfx::vertex3f(r, r, -r + corner);
     // Bottom-Left-Back
-    glVertex3f(-r, -r, -r);
-    glVertex3f(-r + corner, -r, -r);
-    glVertex3f(-r, -r, -r);
-    glVertex3f(-r, -r + corner, -r);
-    glVertex3f(-r, -r, -r);
-    glVertex3f(-r, -r, -r + corner);
-    glEnd();
-
-    glPopMatrix();
-    glDisable(GL_BLEND);
-    glPopMatrix();
+    gfx::vertex3f(-r, -r, -r);
+    gfx::vertex3f(-r + corner, -r, -r);
+    gfx::vertex3f(-r, -r, -r);
+    gfx::vertex3f(-r, -r + corner, -r);
+    gfx::vertex3f(-r, -r, -r);
+    gfx::vertex3f(-r, -r, -r + corner);
+    gfx::end();
+
+    gfx::pop_matrix();
+    gfx::disable(GL_BLEND);
+    gfx::pop_matrix();
   }
 
-public:
-  void registerComponent(std::string name, std::string description, float x,
-                         float y, float z, float radius = 0.5f,
-                         std::string blockedBy = "") {
-    components.push_back(
-        {name, description, x, y, z, radius, 0.0f, true, blockedBy, false});
-  }
+  // The label panel of 'c' in its billboard's space: background, glow,
+  // borders and text, faded by 'hoverIntensity'
+  void drawPanel(const ComponentInfo &c, float hoverIntensity) {
+    // Larger panel for better visibility
+    float panelWidth = 2.2f;
+    float panelHeight = 0.8f;
+    float panelPadding = 0.08f;
 
-  // Dynamic update for moving parts - this keeps tooltip synced with component
-  // position. Also tracks visibility based on whether component has moved
-  // outside the case
-  void updateComponent(std::string name, float x, float y, float z,
-                       float offsetX = 0.0f) {
-    bool componentRemoved = (offsetX < -3.5f); // Component fully disassembled
-
-    for (auto &c : components) {
-      if (c.name == name) {
-        c.x = x;
-        c.y = y;
-        c.z = z;
-        // Hide tooltip if component has moved significantly out of the case
-        // (disassembled) Components move in negative X direction when
-        // disassembling
-        c.isVisible = (offsetX > -1.5f);
-      }
-      // If this component was blocking others, mark them as unblocked
-      if (componentRemoved && c.blockedBy == name) {
-        c.blockerRemoved = true;
-      }
-    }
-  }
+    gfx::enable(GL_BLEND);
 
-  // Raycast from mouse position with improved detection
-  void update(int mouseX, int mouseY) {
-    prevFocusedIndex = focusedIndex;
-    focusedIndex = -1;
+    // Outer glow effect for panel
+    gfx::blend_func(GL_SRC_ALPHA, GL_ONE);
+    gfx::color4f(0.0f, 0.5f, 0.8f, 0.3f * hoverIntensity);
+    gfx::begin(GL_QUADS);
+    gfx::vertex3f(-panelWidth / 2 - 0.1f, -0.05f, 0.01f);
+    gfx::vertex3f(panelWidth / 2 + 0.1f, -0.05f, 0.01f);
+    gfx::vertex3f(panelWidth / 2 + 0.1f, panelHeight + 0.1f, 0.01f);
+    gfx::vertex3f(-panelWidth / 2 - 0.1f, panelHeight + 0.1f, 0.01f);
+    gfx::end();
 
-    // Update global pulse for animations
-    globalPulse += 0.1f;
-    if (globalPulse > 2 * M_PI)
-      globalPulse -= 2 * M_PI;
+    gfx::blend_func(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
-    GLint viewport[4];
-    GLdouble modelview[16];
-    GLdouble projection[16];
-    GLdouble nearX, nearY, nearZ;
-    GLdouble farX, farY, farZ;
-
-    glGetDoublev(GL_MODELVIEW_MATRIX, modelview);
-    glGetDoublev(GL_PROJECTION_MATRIX, projection);
-    glGetIntegerv(GL_VIEWPORT, viewport);
-
-    // Flip Y for viewport coordinates
-    GLint winY = viewport[3] - mouseY;
-
-    // Unproject near plane (z=0)
-    gluUnProject(mouseX, winY, 0.0, modelview, projection, viewport, &nearX,
-                 &nearY, &nearZ);
-    // Unproject far plane (z=1)
-    gluUnProject(mouseX, winY, 1.0, modelview, projection, viewport, &farX,
-                 &farY, &farZ);
-
-    // Ray Origin and Direction
-    double ox = nearX;
-    double oy = nearY;
-    double oz = nearZ;
-
-    double dx = farX - nearX;
-    double dy = farY - nearY;
-    double dz = farZ - nearZ;
-
-    // Normalize direction
-    double len = sqrt(dx * dx + dy * dy + dz * dz);
-    dx /= len;
-    dy /= len;
-    dz /= len;
+    // Main dark panel background with gradient effect
+    gfx::color4f(0.02f, 0.08f, 0.15f, 0.92f * hoverIntensity);
+    gfx::begin(GL_QUADS);
+    gfx::vertex3f(-panelWidth / 2, 0.0f, 0.0f);
+    gfx::vertex3f(panelWidth / 2, 0.0f, 0.0f);
+    gfx::vertex3f(panelWidth / 2, panelHeight, 0.0f);
+    gfx::vertex3f(-panelWidth / 2, panelHeight, 0.0f);
+    gfx::end();
 
-    float closestT = 1e9f;
+    // Glowing border with multiple layers
+    for (int b = 0; b < 2; b++) {
+      float borderOffset = b * 0.02f;
+      float borderAlpha = (1.0f - b * 0.4f) * hoverIntensity;
+      gfx::color4f(0.0f, 0.9f, 1.0f, borderAlpha);
+      gfx::line_width(2.5f - b * 0.8f);
+      gfx::begin(GL_LINE_LOOP);
+      gfx::vertex3f(-panelWidth / 2 - borderOffset, -borderOffset, 0.001f);
+      gfx::vertex3f(panelWidth / 2 + borderOffset, -borderOffset, 0.001f);
+      gfx::vertex3f(panelWidth / 2 + borderOffset, panelHeight + borderOffset,
+                 0.001f);
+      gfx::vertex3f(-panelWidth / 2 - borderOffset, panelHeight + borderOffset,
+                 0.001f);
+      gfx::end();
+    }
 
-    // Ray-Sphere Intersection for each component with improved detection radius
-    for (int i = 0; i < components.size(); i++) {
-      auto &c = components[i];
+    // Header bar accent
+    gfx::color4f(0.0f, 0.7f, 0.9f, 0.4f * hoverIntensity);
+    gfx::begin(GL_QUADS);
+    gfx::vertex3f(-panelWidth / 2 + panelPadding, panelHeight - 0.02f, 0.001f);
+    gfx::vertex3f(panelWidth / 2 - panelPadding, panelHeight - 0.02f, 0.001f);
+    gfx::vertex3f(panelWidth / 2 - panelPadding, panelHeight - 0.04f, 0.001f);
+    gfx::vertex3f(-panelWidth / 2 + panelPadding, panelHeight - 0.04f, 0.001f);
+    gfx::end();
 
-      // Skip components that have been disassembled out of view
-      if (!c.isVisible)
-        continue;
+    // Text with shadow effect for better readability
+    if (hoverIntensity > 0.3f) {
+      renderTextWithShadow(c.name, -panelWidth / 2 + 0.12f,
+                           panelHeight - 0.30f, GLUT_BITMAP_HELVETICA_18);
 
-      // Skip components that are blocked by another component that hasn't been
-      // removed
-      if (!c.blockedBy.empty() && !c.blockerRemoved)
-        continue;
+      gfx::color3f(0.7f, 0.9f, 1.0f); // Slight blue tint for description
+      gfx::raster_pos2f(-panelWidth / 2 + 0.12f, panelHeight - 0.55f);
+      gfx::bitmap_string(GLUT_BITMAP_HELVETICA_12, c.description.c_str(),
+                         c.description.size());
+    }
 
-      // Use slightly larger detection radius for easier hovering
-      float detectionRadius = c.radius * 1.2f;
+    gfx::disable(GL_BLEND);
+  }
 
-      // Vector from Ray Origin to Sphere Center
-      double fx = c.x - ox;
-      double fy = c.y - oy;
-      double fz = c.z - oz;
+  // Renders 'id's panel into its texture, unless it already holds the
+  // current text. False where the renderer has no render targets, and the
+  // panel is drawn every frame instead. Runs a GL pass right away, so call
+  // it on the GL thread.
+  bool cachePanel(ComponentId id) {
+    if (!gfx::has_render_targets())
+      return false;
+    ComponentInfo &c = components[id];
+    if (c.panelTexture && !c.panelDirty)
+      return true;
+    if (!c.panelTexture)
+      c.panelTexture = gfx::create_texture();
+
+    gfx::CommandList *outer = gfx::recording();
+    panelList.clear();
+    gfx::record_into(&panelList);
+    gfx::matrix_mode(GL_PROJECTION);
+    gfx::ortho2d(PANEL_LEFT, PANEL_LEFT + PANEL_WIDTH, PANEL_BOTTOM,
+                 PANEL_BOTTOM + PANEL_HEIGHT);
+    gfx::matrix_mode(GL_MODELVIEW);
+    drawPanel(c, 1.0f);
+    gfx::record_into(outer);
+    gfx::render_to_texture(c.panelTexture, PANEL_TEXELS_X, PANEL_TEXELS_Y,
+                           panelList);
+    c.panelDirty = false;
+    return true;
+  }
 
-      // Project f onto d (t_ca)
-      double t = fx * dx + fy * dy + fz * dz;
+  // A cached panel: one quad, its premultiplied texels scaled by the fade
+  void drawCachedPanel(GLuint texture, float hoverIntensity) {
+    float right = PANEL_LEFT + PANEL_WIDTH, top = PANEL_BOTTOM + PANEL_HEIGHT;
+    gfx::enable(GL_TEXTURE_2D);
+    gfx::bind_texture(texture);
+    gfx::enable(GL_BLEND);
+    gfx::blend_func(GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+    gfx::color4f(hoverIntensity, hoverIntensity, hoverIntensity,
+                 hoverIntensity);
+    gfx::begin(GL_QUADS);
+    gfx::tex_coord2f(0.0f, 0.0f);
+    gfx::vertex3f(PANEL_LEFT, PANEL_BOTTOM, 0.0f);
+    gfx::tex_coord2f(1.0f, 0.0f);
+    gfx::vertex3f(right, PANEL_BOTTOM, 0.0f);
+    gfx::tex_coord2f(1.0f, 1.0f);
+    gfx::vertex3f(right, top, 0.0f);
+    gfx::tex_coord2f(0.0f, 1.0f);
+    gfx::vertex3f(PANEL_LEFT, top, 0.0f);
+    gfx::end();
+    gfx::disable(GL_TEXTURE_2D);
+    gfx::blend_func(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    gfx::disable(GL_BLEND);
+  }
 
-      if (t < 0)
-        continue; // Sphere is behind the ray origin
+public:
+  ComponentId registerComponent(const std::string &name,
+                                const std::string &description, float3 center,
+                                float radius = 0.5f,
+                                ComponentId blockedBy = NO_COMPONENT) {
+    ComponentId id = (ComponentId)components.size();
+    components.push_back(
+        {name, description, radius, blockedBy, true, false, false, 0, true});
+    size_t lanes = pickLanes();
+    centerX.resize(lanes, 0.0f);
+    centerY.resize(lanes, 0.0f);
+    centerZ.resize(lanes, 0.0f);
+    pickRadius2.resize(lanes, -1.0f);
+    hoverTime.resize(lanes, 0.0f);
+    hitT.resize(lanes, 1e9f);
+    centerX[id] = center.x;
+    centerY[id] = center.y;
+    centerZ[id] = center.z;
+    if (blockedBy != NO_COMPONENT)
+      blocked.push_back(id);
+    refreshPick(id);
+    return id;
+  }
 
-      // Closest point on ray to center
-      double px = ox + t * dx;
-      double py = oy + t * dy;
-      double pz = oz + t * dz;
+  size_t size() const { return components.size(); }
 
-      // Distance squared from center to ray
-      double d2 = (c.x - px) * (c.x - px) + (c.y - py) * (c.y - py) +
-                  (c.z - pz) * (c.z - pz);
+  // Changes a component's label text; its cached panel is redrawn on the
+  // next draw(), and only then.
+  void setText(ComponentId id, const std::string &name,
+               const std::string &description) {
+    ComponentInfo &c = components[id];
+    if (c.name == name && c.description == description)
+      return;
+    c.name = name;
+    c.description = description;
+    c.panelDirty = true;
+  }
 
-      if (d2 < (detectionRadius * detectionRadius) && t < closestT) {
-        // Intersection! Take the closest one
-        closestT = t;
-        focusedIndex = i;
+  // Dynamic update for moving parts - this keeps tooltip synced with component
+  // position. Also tracks visibility based on whether component has moved
+  // outside the case
+  void updateComponent(ComponentId id, float3 center, float offsetX = 0.0f) {
+    centerX[id] = center.x;
+    centerY[id] = center.y;
+    centerZ[id] = center.z;
+    // Hide tooltip if component has moved significantly out of the case
+    // (disassembled) Components move in negative X direction when
+    // disassembling
+    components[id].isVisible = (offsetX > -1.5f);
+    refreshPick(id);
+
+    // If this component was blocking others, mark them as unblocked
+    if (offsetX < -3.5f) { // Component fully disassembled
+      for (ComponentId b : blocked) {
+        if (components[b].blockedBy == id && !components[b].blockerRemoved) {
+          components[b].blockerRemoved = true;
+          refreshPick(b);
+        }
       }
     }
+  }
 
-    // Update hover times for smooth animations
-    for (int i = 0; i < components.size(); i++) {
-      if (i == focusedIndex) {
-        components[i].hoverTime =
-            std::min(components[i].hoverTime + 0.1f, 1.0f);
-      } else {
-        components[i].hoverTime =
-            std::max(components[i].hoverTime - 0.15f, 0.0f);
+  // Marks a component hidden behind other geometry (or back in sight), e.g.
+  // from an occlusion test on its bounds. Hidden components are not picked
+  // and lose the focus, so their label fades out.
+  void setOccluded(ComponentId id, bool occluded) {
+    if (components[id].isOccluded == occluded)
+      return;
+    components[id].isOccluded = occluded;
+    refreshPick(id);
+  }
+
+  // Closest component whose bounding sphere (slightly enlarged, for easier
+  // hovering) 'ray' passes through, or NO_COMPONENT. Skips hidden and blocked
+  // components.
+  ComponentId pick(const gfx::Ray &ray) {
+    // Ray-Sphere Intersection for every component at once
+    const size_t n = components.size();
+    rayTest(centerX.data(), centerY.data(), centerZ.data(), pickRadius2.data(),
+            hitT.data(), pickLanes(), ray.origin[0], ray.origin[1],
+            ray.origin[2], ray.dir[0], ray.dir[1], ray.dir[2]);
+    const float *hit = hitT.data();
+
+    // Take the closest hit
+    ComponentId closest = NO_COMPONENT;
+    float closestT = 1e9f;
+    for (size_t i = 0; i < n; i++) {
+      if (hit[i] < closestT) {
+        closestT = hit[i];
+        closest = (ComponentId)i;
       }
     }
+    return closest;
+  }
+
+  // Focuses 'focused' (from pick() or an exact picker; NO_COMPONENT for
+  // none) unless it is hidden or blocked. 'dt' is the wall time since the
+  // last frame (seconds) and drives the pulse / hover fades.
+  void update(ComponentId focused, float dt) {
+    prevFocusedIndex = focusedIndex;
+    focusedIndex = -1;
+    if (focused != NO_COMPONENT && pickRadius2[focused] >= 0.0f)
+      focusedIndex = focused;
+
+    // Update global pulse for animations
+    globalPulse += 6.0f * dt;
+    if (globalPulse > 2 * M_PI)
+      globalPulse -= 2 * M_PI;
+
+    // Update hover times for smooth animations
+    const size_t lanes = pickLanes();
+    float *hover = hoverTime.data();
+    float focusedHover = focusedIndex == -1 ? 0.0f : hover[focusedIndex];
+    for (size_t i = 0; i < lanes; i++)
+      hover[i] = std::max(hover[i] - 9.0f * dt, 0.0f);
+    if (focusedIndex != -1)
+      hover[focusedIndex] = std::min(focusedHover + 6.0f * dt, 1.0f);
+
+    // The focused component's label fades in; once nothing is focused the
+    // last one stays up until it has faded out
+    if (focusedIndex != -1)
+      labelIndex = focusedIndex;
+    else if (labelIndex != -1 && hover[labelIndex] <= 0.0f)
+      labelIndex = -1;
   }
 
+  // Picks by bounding sphere along 'ray' (see gfx::Camera::ray())
+  void update(const gfx::Ray &ray, float dt) { update(pick(ray), dt); }
+
   // Draw now requires camera position to calculate billboard rotation
   void draw(float camX, float camY, float camZ) {
-    if (focusedIndex == -1)
+    if (labelIndex == -1)
       return;
 
-    auto &c = components[focusedIndex];
-    float hoverIntensity = c.hoverTime; // Smooth fade-in
+    const ComponentInfo &c = components[labelIndex];
+    float cx = centerX[labelIndex];
+    float cy = centerY[labelIndex];
+    float cz = centerZ[labelIndex];
+    float hoverIntensity = hoverTime[labelIndex]; // Smooth fade in / out
 
-    glDisable(GL_LIGHTING);
-    glDisable(GL_TEXTURE_2D);
-    glDisable(GL_DEPTH_TEST); // Draw on top of everything
+    gfx::disable(GL_LIGHTING);
+    gfx::disable(GL_TEXTURE_2D);
+    gfx::disable(GL_DEPTH_TEST); // Draw on top of everything
 
     // 1. Draw the enhanced "Target" Bracket at the object location
-    glPushMatrix();
-    glTranslatef(c.x, c.y, c.z);
+    gfx::push_matrix();
+    gfx::translatef(cx, cy, cz);
     drawBracket(c.radius, hoverIntensity);
-    glPopMatrix();
+    gfx::pop_matrix();
 
     // 2. Draw glowing "Leader Line" floating upwards
     float textHeightOffset = c.radius + 1.0f;
 
-    glEnable(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE);
+    gfx::enable(GL_BLEND);
+    gfx::blend_func(GL_SRC_ALPHA, GL_ONE);
 
     // Glow effect for leader line
     for (int glow = 2; glow >= 0; glow--) {
       float glowWidth = 1.0f + glow * 1.5f;
       float alpha = (0.5f - glow * 0.15f) * hoverIntensity;
-      glLineWidth(glowWidth);
-      glColor4f(0.0f, 0.8f, 1.0f, alpha);
-      glBegin(GL_LINES);
-      glVertex3f(c.x, c.y + c.radius * 0.3f, c.z);
-      glVertex3f(c.x, c.y + textHeightOffset, c.z);
-      glEnd();
+      gfx::line_width(glowWidth);
+      gfx::color4f(0.0f, 0.8f, 1.0f, alpha);
+      gfx::begin(GL_LINES);
+      gfx::vertex3f(cx, cy + c.radius * 0.3f, cz);
+      gfx::vertex3f(cx, cy + textHeightOffset, cz);
+      gfx::end();
     }
 
     // Main leader line
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-    glLineWidth(2.0f);
-    glColor4f(0.0f, 1.0f, 1.0f, hoverIntensity);
-    glBegin(GL_LINES);
-    glVertex3f(c.x, c.y + c.radius * 0.3f, c.z);
-    glVertex3f(c.x, c.y + textHeightOffset, c.z);
-    glEnd();
+    gfx::blend_func(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    gfx::line_width(2.0f);
+    gfx::color4f(0.0f, 1.0f, 1.0f, hoverIntensity);
+    gfx::begin(GL_LINES);
+    gfx::vertex3f(cx, cy + c.radius * 0.3f, cz);
+    gfx::vertex3f(cx, cy + textHeightOffset, cz);
+    gfx::end();
 
     // Small connecting dot
-    glPointSize(6.0f);
-    glBegin(GL_POINTS);
-    glVertex3f(c.x, c.y + textHeightOffset, c.z);
-    glEnd();
+    gfx::point_size(6.0f);
+    gfx::begin(GL_POINTS);
+    gfx::vertex3f(cx, cy + textHeightOffset, cz);
+    gfx::end();
 
     // 3. Billboarded Text Panel with enhanced visibility
-    float dx = camX - c.x;
-    float dz = camZ - c.z;
+    float dx = camX - cx;
+    float dz = camZ - cz;
     float angleY = atan2(dx, dz) * 180.0f / M_PI;
 
-    glPushMatrix();
-    glTranslatef(c.x, c.y + textHeightOffset + 0.05f, c.z);
-    glRotatef(angleY, 0.0f, 1.0f, 0.0f);
+    gfx::push_matrix();
+    gfx::translatef(cx, cy + textHeightOffset + 0.05f, cz);
+    gfx::rotatef(angleY, 0.0f, 1.0f, 0.0f);
 
-    // Larger panel for better visibility
-    float panelWidth = 2.2f;
-    float panelHeight = 0.8f;
-    float panelPadding = 0.08f;
-
-    glEnable(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-
-    // Outer glow effect for panel
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE);
-    glColor4f(0.0f, 0.5f, 0.8f, 0.3f * hoverIntensity);
-    glBegin(GL_QUADS);
-    glVertex3f(-panelWidth / 2 - 0.1f, -0.05f, 0.01f);
-    glVertex3f(panelWidth / 2 + 0.1f, -0.05f, 0.01f);
-    glVertex3f(panelWidth / 2 + 0.1f, panelHeight + 0.1f, 0.01f);
-    glVertex3f(-panelWidth / 2 - 0.1f, panelHeight + 0.1f, 0.01f);
-    glEnd();
+    if (cachePanel(labelIndex))
+      drawCachedPanel(c.panelTexture, hoverIntensity);
+    else
+      drawPanel(c, hoverIntensity);
+    gfx::pop_matrix();
 
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-
-    // Main dark panel background with gradient effect
-    glColor4f(0.02f, 0.08f, 0.15f, 0.92f * hoverIntensity);
-    glBegin(GL_QUADS);
-    glVertex3f(-panelWidth / 2, 0.0f, 0.0f);
-    glVertex3f(panelWidth / 2, 0.0f, 0.0f);
-    glVertex3f(panelWidth / 2, panelHeight, 0.0f);
-    glVertex3f(-panelWidth / 2, panelHeight, 0.0f);
-    glEnd();
+    gfx::enable(GL_DEPTH_TEST); // Restore depth test
+    gfx::enable(GL_LIGHTING);   // Restore lighting
+  }
 
-    // Glowing border with multiple layers
-    for (int b = 0; b < 2; b++) {
-      float borderOffset = b * 0.02f;
-      float borderAlpha = (1.0f - b * 0.4f) * hoverIntensity;
-      glColor4f(0.0f, 0.9f, 1.0f, borderAlpha);
-      glLineWidth(2.5f - b * 0.8f);
-      glBegin(GL_LINE_LOOP);
-      glVertex3f(-panelWidth / 2 - borderOffset, -borderOffset, 0.001f);
-      glVertex3f(panelWidth / 2 + borderOffset, -borderOffset, 0.001f);
-      glVertex3f(panelWidth / 2 + borderOffset, panelHeight + borderOffset,
-                 0.001f);
-      glVertex3f(-panelWidth / 2 - borderOffset, panelHeight + borderOffset,
-                 0.001f);
-      glEnd();
+  // Labels every pickable component at once, flat on the screen: each panel
+  // goes where labels::Layout finds room for it near the component as
+  // 'camera' sees it, with a leader line back, or is left out if there is
+  // none. Instead of draw().
+  void drawAll(const gfx::Camera &camera) {
+    int w = camera.viewport[2], h = camera.viewport[3];
+    labelAnchors.resize(components.size());
+    for (size_t i = 0; i < components.size(); i++) {
+      labels::Label &l = labelAnchors[i];
+      float center[3] = {centerX[i], centerY[i], centerZ[i]};
+      l.visible = pickRadius2[i] >= 0.0f && camera.project(center, l.anchor);
+      l.size[0] = PANEL_WIDTH * LABEL_SCALE;
+      l.size[1] = PANEL_HEIGHT * LABEL_SCALE;
     }
-
-    // Header bar accent
-    glColor4f(0.0f, 0.7f, 0.9f, 0.4f * hoverIntensity);
-    glBegin(GL_QUADS);
-    glVertex3f(-panelWidth / 2 + panelPadding, panelHeight - 0.02f, 0.001f);
-    glVertex3f(panelWidth / 2 - panelPadding, panelHeight - 0.02f, 0.001f);
-    glVertex3f(panelWidth / 2 - panelPadding, panelHeight - 0.04f, 0.001f);
-    glVertex3f(-panelWidth / 2 + panelPadding, panelHeight - 0.04f, 0.001f);
-    glEnd();
-
-    // Text with shadow effect for better readability
-    if (hoverIntensity > 0.3f) {
-      renderTextWithShadow(c.name, -panelWidth / 2 + 0.12f, panelHeight - 0.30f,
-                           GLUT_BITMAP_HELVETICA_18);
-
-      glColor3f(0.7f, 0.9f, 1.0f); // Slight blue tint for description
-      glRasterPos2f(-panelWidth / 2 + 0.12f, panelHeight - 0.55f);
-      for (char ch : c.description) {
-        glutBitmapCharacter(GLUT_BITMAP_HELVETICA_12, ch);
-      }
+    layout.solve(labelAnchors.data(), labelAnchors.size(), w, h);
+
+    gfx::disable(GL_LIGHTING);
+    gfx::disable(GL_TEXTURE_2D);
+    gfx::disable(GL_DEPTH_TEST);
+    gfx::matrix_mode(GL_PROJECTION);
+    gfx::push_matrix();
+    gfx::load_identity();
+    gfx::ortho2d(0.0f, (float)w, 0.0f, (float)h);
+    gfx::matrix_mode(GL_MODELVIEW);
+    gfx::push_matrix();
+    gfx::load_identity();
+
+    // Leader lines, from the part to the nearest point of its panel
+    gfx::enable(GL_BLEND);
+    gfx::blend_func(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    gfx::line_width(2.0f);
+    gfx::color4f(0.0f, 1.0f, 1.0f, 0.8f);
+    gfx::begin(GL_LINES);
+    for (size_t i = 0; i < components.size(); i++) {
+      if (!layout.placed(i))
+        continue;
+      const labels::Box &b = layout.box(i);
+      const float *a = labelAnchors[i].anchor;
+      gfx::vertex3f(a[0], a[1], 0.0f);
+      gfx::vertex3f(std::min(std::max(a[0], b.min[0]), b.max[0]),
+                    std::min(std::max(a[1], b.min[1]), b.max[1]), 0.0f);
+    }
+    gfx::end();
+    gfx::point_size(6.0f);
+    gfx::begin(GL_POINTS);
+    for (size_t i = 0; i < components.size(); i++)
+      if (layout.placed(i))
+        gfx::vertex3f(labelAnchors[i].anchor[0], labelAnchors[i].anchor[1],
+                      0.0f);
+    gfx::end();
+    gfx::disable(GL_BLEND);
+
+    // Panels, their billboard space scaled to pixels
+    for (size_t i = 0; i < components.size(); i++) {
+      if (!layout.placed(i))
+        continue;
+      const labels::Box &b = layout.box(i);
+      gfx::push_matrix();
+      gfx::translatef(b.min[0] - PANEL_LEFT * LABEL_SCALE,
+                      b.min[1] - PANEL_BOTTOM * LABEL_SCALE, 0.0f);
+      gfx::scalef(LABEL_SCALE, LABEL_SCALE, 1.0f);
+      if (cachePanel((ComponentId)i))
+        drawCachedPanel(components[i].panelTexture, 1.0f);
+      else
+        drawPanel(components[i], 1.0f);
+      gfx::pop_matrix();
     }
 
-    glDisable(GL_BLEND);
-    glPopMatrix();
-
-    glEnable(GL_DEPTH_TEST); // Restore depth test
-    glEnable(GL_LIGHTING);   // Restore lighting
+    gfx::pop_matrix();
+    gfx::matrix_mode(GL_PROJECTION);
+    gfx::pop_matrix();
+    gfx::matrix_mode(GL_MODELVIEW);
+    gfx::enable(GL_DEPTH_TEST);
+    gfx::enable(GL_LIGHTING);
   }
 };
 
@@ -0,0 +1,213 @@
+#include "trace.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <vector>
+
+namespace trace {
+
+namespace {
+
+const size_t CHUNK_EVENTS = 4096;
+const size_t MAX_CHUNKS = 256; // Per thread: ~1M events, 64 MB
+
+struct Event {
+	long long ns; // Since start()
+	const char* name;
+	const char* category;
+	double value;
+	char phase; // Chrome trace "ph": B, E, i, C
+	char detail[31];
+};
+
+// Filled by its thread only. 'count' is published after the events it
+// covers, so a reader never sees half-written ones.
+struct Chunk {
+	Event events[CHUNK_EVENTS];
+	std::atomic<size_t> count{0};
+	std::atomic<Chunk*> next{nullptr};
+};
+
+struct Buffer {
+	unsigned int tid;
+	std::atomic<const char*> thread_name{nullptr};
+	unsigned long trace; // g_trace it holds events of; changed under g_lock
+	Chunk* head;
+	Chunk* tail; // Owner thread only
+	size_t chunks = 1;
+	std::atomic<unsigned long> dropped{0};
+};
+
+static std::atomic<bool> g_recording{false};
+static std::atomic<unsigned long> g_trace{0}; // Bumped by stop()
+static std::atomic<long long> g_origin{0};    // start(), steady_clock ns
+static std::mutex g_lock; // Guards g_buffers; buffers outlive their threads
+static std::vector<Buffer*> g_buffers;
+static thread_local Buffer* t_buffer = nullptr;
+static thread_local const char* t_name = nullptr;
+
+static long long now_ns() {
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+	    .count();
+}
+
+// The calling thread's buffer for the current trace. Made on the thread's
+// first event, so threads that never record while tracing cost nothing; one
+// left from a trace stop() ended is emptied here, by its owner, as writing
+// to it can't race with that.
+static Buffer* buffer() {
+	unsigned long trace = g_trace.load(std::memory_order_acquire);
+	Buffer* b = t_buffer;
+	if (b && b->trace == trace) return b;
+	std::lock_guard<std::mutex> guard(g_lock); // write() may be reading it
+	if (!b) {
+		b = new Buffer();
+		b->head = b->tail = new Chunk();
+		b->tid = (unsigned int)g_buffers.size() + 1;
+		b->thread_name = t_name;
+		g_buffers.push_back(b);
+		t_buffer = b;
+	} else {
+		for (Chunk* c = b->head->next.load(std::memory_order_relaxed); c;) {
+			Chunk* next = c->next.load(std::memory_order_relaxed);
+			delete c;
+			c = next;
+		}
+		b->head->next.store(nullptr, std::memory_order_relaxed);
+		b->head->count.store(0, std::memory_order_relaxed);
+		b->tail = b->head;
+		b->chunks = 1;
+		b->dropped = 0;
+	}
+	b->trace = trace;
+	return b;
+}
+
+static void record(char phase, const char* name, const char* category, const char* detail, double value) {
+	Buffer* b = buffer();
+	Chunk* c = b->tail;
+	size_t n = c->count.load(std::memory_order_relaxed);
+	if (n == CHUNK_EVENTS) {
+		if (b->chunks == MAX_CHUNKS) {
+			b->dropped.fetch_add(1, std::memory_order_relaxed);
+			return;
+		}
+		Chunk* fresh = new Chunk();
+		c->next.store(fresh, std::memory_order_release);
+		b->tail = c = fresh;
+		b->chunks++;
+		n = 0;
+	}
+	Event& e = c->events[n];
+	e.ns = now_ns() - g_origin.load(std::memory_order_relaxed);
+	e.name = name;
+	e.category = category;
+	e.value = value;
+	e.phase = phase;
+	e.detail[0] = 0;
+	if (detail) {
+		std::strncpy(e.detail, detail, sizeof(e.detail) - 1);
+		e.detail[sizeof(e.detail) - 1] = 0;
+	}
+	c->count.store(n + 1, std::memory_order_release);
+}
+
+static void write_string(FILE* f, const char* s) {
+	std::fputc('"', f);
+	for (; *s; s++) {
+		unsigned char ch = (unsigned char)*s;
+		if (ch == '"' || ch == '\\') std::fprintf(f, "\\%c", ch);
+		else if (ch < 0x20) std::fprintf(f, "\\u%04x", ch);
+		else std::fputc(ch, f);
+	}
+	std::fputc('"', f);
+}
+
+} // namespace
+
+void start() {
+	if (g_recording) return;
+	g_origin = now_ns();
+	g_recording = true;
+}
+
+void stop() {
+	g_recording = false;
+	g_trace++;
+}
+
+bool recording() { return g_recording.load(std::memory_order_acquire); }
+
+void begin(const char* name, const char* category, const char* detail) {
+	if (recording()) record('B', name, category, detail, 0.0);
+}
+
+void end(const char* name, const char* category) {
+	if (recording()) record('E', name, category, nullptr, 0.0);
+}
+
+void instant(const char* name, const char* category, const char* detail) {
+	if (recording()) record('i', name, category, detail, 0.0);
+}
+
+void counter(const char* name, double value) {
+	if (recording()) record('C', name, "counter", nullptr, value);
+}
+
+void name_thread(const char* name) {
+	t_name = name;
+	if (t_buffer) t_buffer->thread_name = name;
+}
+
+bool write(const char* path) {
+	FILE* f = std::fopen(path, "w");
+	if (!f) {
+		std::fprintf(stderr, "trace: can't write '%s'\n", path);
+		return false;
+	}
+	std::lock_guard<std::mutex> guard(g_lock);
+	unsigned long events = 0, dropped = 0;
+	std::fprintf(f, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+	std::fprintf(f, "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{\"name\":\"Desktop Simulator\"}}");
+	unsigned long trace = g_trace.load();
+	for (size_t i = 0; i < g_buffers.size(); i++) {
+		Buffer* b = g_buffers[i];
+		if (b->trace != trace) continue; // Events of a trace stop() ended
+		const char* thread = b->thread_name.load();
+		if (thread) {
+			std::fprintf(f, ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":", b->tid);
+			write_string(f, thread);
+			std::fprintf(f, "}}");
+		}
+		dropped += b->dropped.load();
+		for (Chunk* c = b->head; c; c = c->next.load(std::memory_order_acquire)) {
+			size_t n = c->count.load(std::memory_order_acquire);
+			for (size_t k = 0; k < n; k++) {
+				const Event& e = c->events[k];
+				std::fprintf(f, ",\n{\"ph\":\"%c\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"name\":", e.phase, b->tid, e.ns / 1e3);
+				write_string(f, e.name);
+				std::fprintf(f, ",\"cat\":");
+				write_string(f, e.category);
+				if (e.phase == 'C') {
+					std::fprintf(f, ",\"args\":{\"value\":%g}", e.value);
+				} else if (e.detail[0]) {
+					std::fprintf(f, ",\"args\":{\"detail\":");
+					write_string(f, e.detail);
+					std::fputc('}', f);
+				}
+				if (e.phase == 'i') std::fprintf(f, ",\"s\":\"t\"");
+				std::fputc('}', f);
+			}
+			events += n;
+		}
+	}
+	std::fprintf(f, "\n]}\n");
+	bool ok = std::fclose(f) == 0;
+	std::printf("trace: %lu events (%lu dropped) to %s\n", events, dropped, path);
+	return ok;
+}
+
+} // namespace trace
@@ -0,0 +1,54 @@
+#pragma once
+
+namespace trace {
+
+// Timeline recording for chasing stutters, written as Chrome trace JSON
+// (chrome://tracing, ui.perfetto.dev). Every thread appends to a buffer of
+// its own, made by its first event, so recording takes no locks after
+// that; write() can read the buffers while they are still being filled.
+//
+// Names and categories must be string literals (or otherwise outlive the
+// trace): only the pointer is kept. 'detail' is copied, up to 31 chars.
+// Each thread keeps at most about a million events; later ones are
+// counted and dropped.
+
+// Starts recording (again a no-op). Nothing is recorded before.
+void start();
+bool recording();
+
+// Stops recording and drops the trace, so the next start() begins an empty
+// one. Each thread's buffer goes back to a single chunk when it next
+// records.
+void stop();
+
+void begin(const char* name, const char* category, const char* detail = nullptr);
+void end(const char* name, const char* category);
+void instant(const char* name, const char* category, const char* detail = nullptr);
+void counter(const char* name, double value);
+
+// Shown as the calling thread's name in the viewer. Only remembered: the
+// thread gets a buffer when it first records.
+void name_thread(const char* name);
+
+// Writes everything recorded so far; recording goes on. False if 'path'
+// can't be written.
+bool write(const char* path);
+
+// begin() / end() around a block, if recording when it starts.
+class Scope {
+public:
+	Scope(const char* name, const char* category, const char* detail = nullptr) : name(name), category(category) {
+		active = recording();
+		if (active) begin(name, category, detail);
+	}
+	~Scope() {
+		if (active) end(name, category);
+	}
+
+private:
+	const char* name;
+	const char* category;
+	bool active;
+};
+
+} // namespace trace